@@ -0,0 +1,113 @@
+#include "benchmark_runner.hpp"
+#include "duckdb_benchmark_macro.hpp"
+
+using namespace duckdb;
+
+//////////////////////////////
+// FLOATING POINT COLUMNS //
+//////////////////////////////
+// sensor-like data: slowly changing readings with a fixed amount of decimals
+#define SENSOR_ROW_COUNT 10000000
+#define SENSOR_CREATE_STATEMENT                                                                                        \
+	"CREATE TABLE sensors AS SELECT ROUND(20 + SIN(i / 1000.0) * 5 + (i % 7) * 0.01, 2)::DOUBLE AS temperature, "     \
+	"(1000 + (i % 100) * 0.5)::DOUBLE AS pressure, (i % 1000)::FLOAT / 4 AS humidity FROM range(0, 10000000) t(i)"
+// the amount of blocks the three columns take up without compression
+#define SENSOR_UNCOMPRESSED_BLOCKS (SENSOR_ROW_COUNT * (8 + 8 + 4) / Storage::BLOCK_SIZE)
+
+#define FLOAT_COMPRESSION_LOAD(COMPRESSION)                                                                            \
+	void Load(DuckDBBenchmarkState *state) override {                                                                  \
+		state->conn.Query("PRAGMA force_compression='" COMPRESSION "'");                                               \
+		state->conn.Query(SENSOR_CREATE_STATEMENT);                                                                    \
+		state->conn.Query("CHECKPOINT");                                                                               \
+	}                                                                                                                  \
+	bool InMemory() override {                                                                                         \
+		return false;                                                                                                  \
+	}
+
+#define FLOAT_COMPRESSION_SCAN(COMPRESSION)                                                                            \
+	FLOAT_COMPRESSION_LOAD(COMPRESSION)                                                                                \
+	string GetQuery() override {                                                                                       \
+		return "SELECT SUM(temperature), SUM(pressure), SUM(humidity) FROM sensors";                                   \
+	}                                                                                                                  \
+	string VerifyResult(QueryResult *result) override {                                                                \
+		if (!result->success) {                                                                                        \
+			return result->error;                                                                                      \
+		}                                                                                                              \
+		auto &materialized = (MaterializedQueryResult &)*result;                                                       \
+		if (materialized.collection.Count() != 1) {                                                                    \
+			return "Incorrect amount of rows in result";                                                               \
+		}                                                                                                              \
+		return string();                                                                                               \
+	}                                                                                                                  \
+	string BenchmarkInfo() override {                                                                                  \
+		return "Scan 10M rows of DOUBLE/FLOAT sensor readings stored with " COMPRESSION " compression";               \
+	}
+
+DUCKDB_BENCHMARK(FloatScanUncompressed, "[compression]")
+FLOAT_COMPRESSION_SCAN("uncompressed")
+FINISH_BENCHMARK(FloatScanUncompressed)
+
+DUCKDB_BENCHMARK(FloatScanChimp, "[compression]")
+FLOAT_COMPRESSION_SCAN("chimp")
+FINISH_BENCHMARK(FloatScanChimp)
+
+DUCKDB_BENCHMARK(FloatFilterChimp, "[compression]")
+FLOAT_COMPRESSION_LOAD("chimp")
+string GetQuery() override {
+	return "SELECT COUNT(*) FROM sensors WHERE pressure = 1010.5";
+}
+string VerifyResult(QueryResult *result) override {
+	if (!result->success) {
+		return result->error;
+	}
+	auto &materialized = (MaterializedQueryResult &)*result;
+	if (materialized.GetValue<int64_t>(0, 0) != SENSOR_ROW_COUNT / 100) {
+		return "Incorrect result returned, expected " + std::to_string(SENSOR_ROW_COUNT / 100);
+	}
+	return string();
+}
+string BenchmarkInfo() override {
+	return "Filter 10M rows of Chimp compressed DOUBLE values";
+}
+FINISH_BENCHMARK(FloatFilterChimp)
+
+// the checkpoint that compresses the data, the result verifies the space saved by the compression
+#define FLOAT_COMPRESSION_CHECKPOINT(COMPRESSION, MAX_BLOCK_FRACTION)                                                  \
+	void Load(DuckDBBenchmarkState *state) override {                                                                  \
+		state->conn.Query("PRAGMA force_compression='" COMPRESSION "'");                                               \
+	}                                                                                                                  \
+	void RunBenchmark(DuckDBBenchmarkState *state) override {                                                          \
+		state->conn.Query(SENSOR_CREATE_STATEMENT);                                                                    \
+		state->conn.Query("CHECKPOINT");                                                                               \
+		state->result = state->conn.Query("SELECT used_blocks FROM pragma_database_size()");                           \
+	}                                                                                                                  \
+	void Cleanup(DuckDBBenchmarkState *state) override {                                                               \
+		state->conn.Query("DROP TABLE sensors");                                                                       \
+		state->conn.Query("CHECKPOINT");                                                                               \
+	}                                                                                                                  \
+	string VerifyResult(QueryResult *result) override {                                                                \
+		if (!result->success) {                                                                                        \
+			return result->error;                                                                                      \
+		}                                                                                                              \
+		auto &materialized = (MaterializedQueryResult &)*result;                                                       \
+		auto used_blocks = materialized.GetValue<int64_t>(0, 0);                                                       \
+		if (used_blocks > SENSOR_UNCOMPRESSED_BLOCKS * MAX_BLOCK_FRACTION) {                                           \
+			return "Compressed size of " + std::to_string(used_blocks) + " blocks exceeds expected size of " +         \
+			       std::to_string(SENSOR_UNCOMPRESSED_BLOCKS * MAX_BLOCK_FRACTION) + " blocks";                        \
+		}                                                                                                              \
+		return string();                                                                                               \
+	}                                                                                                                  \
+	bool InMemory() override {                                                                                         \
+		return false;                                                                                                  \
+	}                                                                                                                  \
+	string BenchmarkInfo() override {                                                                                  \
+		return "Checkpoint 10M rows of DOUBLE/FLOAT sensor readings with " COMPRESSION " compression";                \
+	}
+
+DUCKDB_BENCHMARK(FloatCheckpointUncompressed, "[compression]")
+FLOAT_COMPRESSION_CHECKPOINT("uncompressed", 1.1)
+FINISH_BENCHMARK(FloatCheckpointUncompressed)
+
+DUCKDB_BENCHMARK(FloatCheckpointChimp, "[compression]")
+FLOAT_COMPRESSION_CHECKPOINT("chimp", 0.5)
+FINISH_BENCHMARK(FloatCheckpointChimp)
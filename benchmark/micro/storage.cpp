@@ -38,3 +38,54 @@ string BenchmarkInfo() override {
 	return "Run the query \"SELECT 1\" 50K times in in-memory mode";
 }
 FINISH_BENCHMARK(SELECT1Disk)
+
+//////////////////////////////
+// COLD SCANS //
+//////////////////////////////
+// scan a persistent table after evicting it from the buffer pool, so every block has to be read from the file again
+// the difference between the thread counts shows how well the block reads scale
+#define COLD_SCAN_ROW_COUNT 20000000
+#define COLD_SCAN_BENCHMARK(THREADS)                                                                                   \
+	void Load(DuckDBBenchmarkState *state) override {                                                                  \
+		state->conn.Query("PRAGMA force_compression='uncompressed'");                                                  \
+		state->conn.Query("CREATE TABLE cold AS SELECT i, i * 7 AS j, i % 1000 AS k, i::DOUBLE / 3 AS d FROM "        \
+		                  "range(0, 20000000) t(i)");                                                                  \
+		state->conn.Query("CHECKPOINT");                                                                               \
+		state->conn.Query("PRAGMA threads=" #THREADS);                                                                 \
+	}                                                                                                                  \
+	void RunBenchmark(DuckDBBenchmarkState *state) override {                                                          \
+		state->result = state->conn.Query("SELECT COUNT(*), SUM(i), SUM(j), SUM(k), SUM(d) FROM cold");                \
+	}                                                                                                                  \
+	void Cleanup(DuckDBBenchmarkState *state) override {                                                               \
+		/* evict all blocks from the buffer pool by temporarily lowering the memory limit */                           \
+		state->conn.Query("PRAGMA memory_limit='1MB'");                                                                \
+		state->conn.Query("PRAGMA memory_limit=-1");                                                                   \
+	}                                                                                                                  \
+	string VerifyResult(QueryResult *result) override {                                                                \
+		if (!result->success) {                                                                                        \
+			return result->error;                                                                                      \
+		}                                                                                                              \
+		auto &materialized = (MaterializedQueryResult &)*result;                                                       \
+		if (materialized.GetValue<int64_t>(0, 0) != COLD_SCAN_ROW_COUNT) {                                             \
+			return "Incorrect amount of rows in result";                                                               \
+		}                                                                                                              \
+		return string();                                                                                               \
+	}                                                                                                                  \
+	bool InMemory() override {                                                                                         \
+		return false;                                                                                                  \
+	}                                                                                                                  \
+	string BenchmarkInfo() override {                                                                                  \
+		return "Scan 20M rows of a persistent table that is not cached in the buffer pool with " #THREADS " threads"; \
+	}
+
+DUCKDB_BENCHMARK(ColdScan1Thread, "[storage]")
+COLD_SCAN_BENCHMARK(1)
+FINISH_BENCHMARK(ColdScan1Thread)
+
+DUCKDB_BENCHMARK(ColdScan4Threads, "[storage]")
+COLD_SCAN_BENCHMARK(4)
+FINISH_BENCHMARK(ColdScan4Threads)
+
+DUCKDB_BENCHMARK(ColdScan16Threads, "[storage]")
+COLD_SCAN_BENCHMARK(16)
+FINISH_BENCHMARK(ColdScan16Threads)
@@ -62,10 +62,16 @@ TableCatalogEntry::TableCatalogEntry(Catalog *catalog, SchemaCatalogEntry *schem
 		name_map["rowid"] = COLUMN_IDENTIFIER_ROW_ID;
 	}
 	if (!storage) {
+		// the indexes that were persisted for the UNIQUE and PRIMARY KEY constraints (if any)
+		vector<PersistentIndexData> persistent_indexes;
+		if (info->data) {
+			persistent_indexes = move(info->data->indexes);
+		}
 		// create the physical storage
 		storage = make_shared<DataTable>(catalog->db, schema->name, name, GetTypes(), move(info->data));
 
 		// create the unique indexes for the UNIQUE and PRIMARY KEY constraints
+		idx_t index_idx = 0;
 		for (idx_t i = 0; i < bound_constraints.size(); i++) {
 			auto &constraint = bound_constraints[i];
 			if (constraint->type == ConstraintType::UNIQUE) {
@@ -87,7 +93,15 @@ TableCatalogEntry::TableCatalogEntry(Catalog *catalog, SchemaCatalogEntry *schem
 				}
 				// create an adaptive radix tree around the expressions
 				auto art = make_unique<ART>(column_ids, move(unbound_expressions), true);
-				storage->AddIndex(move(art), bound_expressions);
+				if (index_idx < persistent_indexes.size()) {
+					// the index was persisted: load it from storage instead of rebuilding it from the table data
+					auto &index = persistent_indexes[index_idx];
+					art->LoadFromStorage(catalog->db, index.root, index.blocks);
+					storage->info->indexes.push_back(move(art));
+				} else {
+					storage->AddIndex(move(art), bound_expressions);
+				}
+				index_idx++;
 			}
 		}
 	}
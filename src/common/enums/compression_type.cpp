@@ -0,0 +1,55 @@
+#include "duckdb/common/enums/compression_type.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/string_util.hpp"
+
+namespace duckdb {
+
+string CompressionTypeToString(CompressionType type) {
+	switch (type) {
+	case CompressionType::COMPRESSION_AUTO:
+		return "Auto";
+	case CompressionType::COMPRESSION_UNCOMPRESSED:
+		return "Uncompressed";
+	case CompressionType::COMPRESSION_RLE:
+		return "RLE";
+	case CompressionType::COMPRESSION_BITPACKING:
+		return "BitPacking";
+	case CompressionType::COMPRESSION_FOR:
+		return "FOR";
+	case CompressionType::COMPRESSION_DICTIONARY:
+		return "Dictionary";
+	case CompressionType::COMPRESSION_FSST:
+		return "FSST";
+	case CompressionType::COMPRESSION_CHIMP:
+		return "Chimp";
+	default:
+		return "INVALID";
+	}
+}
+
+CompressionType CompressionTypeFromString(const string &str) {
+	auto compression = StringUtil::Lower(str);
+	if (compression == "auto") {
+		return CompressionType::COMPRESSION_AUTO;
+	} else if (compression == "uncompressed" || compression == "none") {
+		return CompressionType::COMPRESSION_UNCOMPRESSED;
+	} else if (compression == "rle") {
+		return CompressionType::COMPRESSION_RLE;
+	} else if (compression == "bitpacking") {
+		return CompressionType::COMPRESSION_BITPACKING;
+	} else if (compression == "for") {
+		return CompressionType::COMPRESSION_FOR;
+	} else if (compression == "dictionary") {
+		return CompressionType::COMPRESSION_DICTIONARY;
+	} else if (compression == "fsst") {
+		return CompressionType::COMPRESSION_FSST;
+	} else if (compression == "chimp") {
+		return CompressionType::COMPRESSION_CHIMP;
+	} else {
+		throw ParserException("Unrecognized compression type '%s', expected either auto, uncompressed, rle, "
+		                      "bitpacking, for, dictionary, fsst or chimp",
+		                      str);
+	}
+}
+
+} // namespace duckdb
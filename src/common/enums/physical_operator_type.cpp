@@ -60,6 +60,8 @@ string PhysicalOperatorToString(PhysicalOperatorType type) {
 		return "INDEX_JOIN";
 	case PhysicalOperatorType::PIECEWISE_MERGE_JOIN:
 		return "PIECEWISE_MERGE_JOIN";
+	case PhysicalOperatorType::IE_JOIN:
+		return "IE_JOIN";
 	case PhysicalOperatorType::CROSS_PRODUCT:
 		return "CROSS_PRODUCT";
 	case PhysicalOperatorType::UNION:
@@ -88,6 +90,8 @@ string PhysicalOperatorToString(PhysicalOperatorType type) {
 		return "EXECUTE";
 	case PhysicalOperatorType::VACUUM:
 		return "VACUUM";
+	case PhysicalOperatorType::RESULT_COLLECTOR:
+		return "RESULT_COLLECTOR";
 	case PhysicalOperatorType::RECURSIVE_CTE:
 		return "REC_CTE";
 	case PhysicalOperatorType::RECURSIVE_CTE_SCAN:
@@ -44,6 +44,10 @@ FileBuffer::~FileBuffer() {
 void FileBuffer::Read(FileHandle &handle, uint64_t location) {
 	// read the buffer from disk
 	handle.Read(internal_buffer, internal_size, location);
+	VerifyChecksum();
+}
+
+void FileBuffer::VerifyChecksum() {
 	// compute the checksum
 	auto stored_checksum = Load<uint64_t>(internal_buffer);
 	uint64_t computed_checksum = Checksum(buffer, size);
@@ -55,11 +59,15 @@ void FileBuffer::Read(FileHandle &handle, uint64_t location) {
 }
 
 void FileBuffer::Write(FileHandle &handle, uint64_t location) {
+	StoreChecksum();
+	// now write the buffer
+	handle.Write(internal_buffer, internal_size, location);
+}
+
+void FileBuffer::StoreChecksum() {
 	// compute the checksum and write it to the start of the buffer
 	uint64_t checksum = Checksum(buffer, size);
 	Store<uint64_t>(checksum, internal_buffer);
-	// now write the buffer
-	handle.Write(internal_buffer, internal_size, location);
 }
 
 void FileBuffer::Clear() {
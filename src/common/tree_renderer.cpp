@@ -405,6 +405,9 @@ unique_ptr<RenderTreeNode> TreeRenderer::CreateNode(const QueryProfiler::TreeNod
 	result->extra_text += "\n" + to_string(op.info.elements);
 	string timing = StringUtil::Format("%.2f", op.info.time);
 	result->extra_text += "\n(" + timing + "s)";
+	if (op.spilled_bytes > 0) {
+		result->extra_text += "\nSpilled: " + to_string(op.spilled_bytes.load()) + " bytes";
+	}
 	return result;
 }
 
@@ -191,17 +191,15 @@ static int32_t compare_value(Vector &left_vec, Vector &right_vec, idx_t vector_i
 	return false;
 }
 
-static int compare_tuple(ChunkCollection *sort_by, vector<OrderType> &desc, vector<OrderByNullType> &null_order,
-                         idx_t left, idx_t right) {
-	D_ASSERT(sort_by);
-
+int ChunkCollection::CompareRows(ChunkCollection &left_collection, ChunkCollection &right_collection, idx_t left,
+                                 idx_t right, vector<OrderType> &desc, vector<OrderByNullType> &null_order) {
 	idx_t chunk_idx_left = left / STANDARD_VECTOR_SIZE;
 	idx_t chunk_idx_right = right / STANDARD_VECTOR_SIZE;
 	idx_t vector_idx_left = left % STANDARD_VECTOR_SIZE;
 	idx_t vector_idx_right = right % STANDARD_VECTOR_SIZE;
 
-	auto &left_chunk = sort_by->GetChunk(chunk_idx_left);
-	auto &right_chunk = sort_by->GetChunk(chunk_idx_right);
+	auto &left_chunk = left_collection.GetChunk(chunk_idx_left);
+	auto &right_chunk = right_collection.GetChunk(chunk_idx_right);
 
 	for (idx_t col_idx = 0; col_idx < desc.size(); col_idx++) {
 		auto order_type = desc[col_idx];
@@ -224,6 +222,12 @@ static int compare_tuple(ChunkCollection *sort_by, vector<OrderType> &desc, vect
 	return 0;
 }
 
+static int compare_tuple(ChunkCollection *sort_by, vector<OrderType> &desc, vector<OrderByNullType> &null_order,
+                         idx_t left, idx_t right) {
+	D_ASSERT(sort_by);
+	return ChunkCollection::CompareRows(*sort_by, *sort_by, left, right, desc, null_order);
+}
+
 static int64_t _quicksort_initial(ChunkCollection *sort_by, vector<OrderType> &desc,
                                   vector<OrderByNullType> &null_order, idx_t *result) {
 	// select pivot
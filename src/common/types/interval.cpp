@@ -312,7 +312,7 @@ interval_t Interval::GetDifference(timestamp_t timestamp_1, timestamp_t timestam
 	return interval;
 }
 
-static void normalize_interval_entries(interval_t input, int64_t &months, int64_t &days, int64_t &micros) {
+void Interval::Normalize(interval_t input, int64_t &months, int64_t &days, int64_t &micros) {
 	int64_t extra_months_d = input.days / Interval::DAYS_PER_MONTH;
 	int64_t extra_months_micros = input.micros / Interval::MICROS_PER_MONTH;
 	input.days -= extra_months_d * Interval::DAYS_PER_MONTH;
@@ -333,8 +333,8 @@ bool Interval::Equals(interval_t left, interval_t right) {
 bool Interval::GreaterThan(interval_t left, interval_t right) {
 	int64_t lmonths, ldays, lmicros;
 	int64_t rmonths, rdays, rmicros;
-	normalize_interval_entries(left, lmonths, ldays, lmicros);
-	normalize_interval_entries(right, rmonths, rdays, rmicros);
+	Normalize(left, lmonths, ldays, lmicros);
+	Normalize(right, rmonths, rdays, rmicros);
 
 	if (lmonths > rmonths) {
 		return true;
@@ -0,0 +1,310 @@
+#include "duckdb/common/types/sort_key.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/types/interval.hpp"
+#include "duckdb/execution/index/art/art_key.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace duckdb {
+
+//! Returns the amount of bytes the value of a column of the given type occupies in the key, or 0 if the type cannot
+//! be encoded
+static idx_t GetEncodedWidth(PhysicalType type) {
+	switch (type) {
+	case PhysicalType::BOOL:
+	case PhysicalType::INT8:
+	case PhysicalType::INT16:
+	case PhysicalType::INT32:
+	case PhysicalType::INT64:
+	case PhysicalType::UINT8:
+	case PhysicalType::UINT16:
+	case PhysicalType::UINT32:
+	case PhysicalType::UINT64:
+	case PhysicalType::INT128:
+	case PhysicalType::FLOAT:
+	case PhysicalType::DOUBLE:
+		return GetTypeIdSize(type);
+	case PhysicalType::INTERVAL:
+		// the normalized months, days and micros
+		return 3 * sizeof(int64_t);
+	case PhysicalType::VARCHAR:
+		return SortKeyLayout::STRING_PREFIX_SIZE;
+	default:
+		return 0;
+	}
+}
+
+SortKeyLayout::SortKeyLayout(vector<LogicalType> &types, vector<OrderType> order_types_p,
+                             vector<OrderByNullType> null_orders_p)
+    : order_types(move(order_types_p)), null_orders(move(null_orders_p)), key_width(0), exact(true),
+      inexact_column(types.size()) {
+	D_ASSERT(types.size() == order_types.size() && types.size() == null_orders.size());
+	for (idx_t col_idx = 0; col_idx < types.size(); col_idx++) {
+		auto width = GetEncodedWidth(types[col_idx].InternalType());
+		if (width == 0) {
+			// this column (and all columns after it) cannot be encoded
+			exact = false;
+			inexact_column = col_idx;
+			break;
+		}
+		column_offsets.push_back(key_width);
+		key_width += 1 + width;
+		if (types[col_idx].InternalType() == PhysicalType::VARCHAR) {
+			// the columns after a string prefix cannot be compared with memcmp
+			exact = false;
+			inexact_column = col_idx;
+			break;
+		}
+	}
+	entry_size = key_width + sizeof(idx_t);
+}
+
+//===--------------------------------------------------------------------===//
+// Encode
+//===--------------------------------------------------------------------===//
+template <class T>
+static void EncodeBigEndian(T value, data_ptr_t target) {
+	for (idx_t i = 0; i < sizeof(T); i++) {
+		target[i] = (value >> ((sizeof(T) - i - 1) * 8)) & 0xFF;
+	}
+}
+
+template <class T>
+static void EncodeValue(T value, data_ptr_t target);
+
+template <>
+void EncodeValue(bool value, data_ptr_t target) {
+	target[0] = value ? 1 : 0;
+}
+template <>
+void EncodeValue(int8_t value, data_ptr_t target) {
+	EncodeBigEndian<uint8_t>((uint8_t)value ^ 0x80, target);
+}
+template <>
+void EncodeValue(int16_t value, data_ptr_t target) {
+	EncodeBigEndian<uint16_t>((uint16_t)value ^ 0x8000, target);
+}
+template <>
+void EncodeValue(int32_t value, data_ptr_t target) {
+	EncodeBigEndian<uint32_t>((uint32_t)value ^ 0x80000000u, target);
+}
+template <>
+void EncodeValue(int64_t value, data_ptr_t target) {
+	EncodeBigEndian<uint64_t>((uint64_t)value ^ 0x8000000000000000ull, target);
+}
+template <>
+void EncodeValue(uint8_t value, data_ptr_t target) {
+	EncodeBigEndian<uint8_t>(value, target);
+}
+template <>
+void EncodeValue(uint16_t value, data_ptr_t target) {
+	EncodeBigEndian<uint16_t>(value, target);
+}
+template <>
+void EncodeValue(uint32_t value, data_ptr_t target) {
+	EncodeBigEndian<uint32_t>(value, target);
+}
+template <>
+void EncodeValue(uint64_t value, data_ptr_t target) {
+	EncodeBigEndian<uint64_t>(value, target);
+}
+template <>
+void EncodeValue(hugeint_t value, data_ptr_t target) {
+	EncodeValue<int64_t>(value.upper, target);
+	EncodeValue<uint64_t>(value.lower, target + sizeof(int64_t));
+}
+template <>
+void EncodeValue(float value, data_ptr_t target) {
+	EncodeBigEndian<uint32_t>(Key::EncodeFloat(value), target);
+}
+template <>
+void EncodeValue(double value, data_ptr_t target) {
+	EncodeBigEndian<uint64_t>(Key::EncodeDouble(value), target);
+}
+template <>
+void EncodeValue(interval_t value, data_ptr_t target) {
+	int64_t months, days, micros;
+	Interval::Normalize(value, months, days, micros);
+	EncodeValue<int64_t>(months, target);
+	EncodeValue<int64_t>(days, target + sizeof(int64_t));
+	EncodeValue<int64_t>(micros, target + 2 * sizeof(int64_t));
+}
+template <>
+void EncodeValue(string_t value, data_ptr_t target) {
+	auto len = MinValue<idx_t>(value.GetSize(), SortKeyLayout::STRING_PREFIX_SIZE);
+	memcpy(target, value.GetDataUnsafe(), len);
+	memset(target + len, 0, SortKeyLayout::STRING_PREFIX_SIZE - len);
+}
+
+template <class T>
+static void TemplatedEncodeColumn(VectorData &vdata, idx_t count, data_ptr_t target, idx_t entry_size,
+                                  data_t null_byte, idx_t width) {
+	auto data = (T *)vdata.data;
+	data_t valid_byte = 1 - null_byte;
+	for (idx_t i = 0; i < count; i++) {
+		auto idx = vdata.sel->get_index(i);
+		if ((*vdata.nullmask)[idx]) {
+			target[0] = null_byte;
+			memset(target + 1, 0, width);
+		} else {
+			target[0] = valid_byte;
+			EncodeValue<T>(data[idx], target + 1);
+		}
+		target += entry_size;
+	}
+}
+
+static void EncodeColumn(Vector &vector, idx_t count, data_ptr_t target, idx_t entry_size, data_t null_byte) {
+	VectorData vdata;
+	vector.Orrify(count, vdata);
+	auto width = GetEncodedWidth(vector.type.InternalType());
+	switch (vector.type.InternalType()) {
+	case PhysicalType::BOOL:
+		TemplatedEncodeColumn<bool>(vdata, count, target, entry_size, null_byte, width);
+		break;
+	case PhysicalType::INT8:
+		TemplatedEncodeColumn<int8_t>(vdata, count, target, entry_size, null_byte, width);
+		break;
+	case PhysicalType::INT16:
+		TemplatedEncodeColumn<int16_t>(vdata, count, target, entry_size, null_byte, width);
+		break;
+	case PhysicalType::INT32:
+		TemplatedEncodeColumn<int32_t>(vdata, count, target, entry_size, null_byte, width);
+		break;
+	case PhysicalType::INT64:
+		TemplatedEncodeColumn<int64_t>(vdata, count, target, entry_size, null_byte, width);
+		break;
+	case PhysicalType::UINT8:
+		TemplatedEncodeColumn<uint8_t>(vdata, count, target, entry_size, null_byte, width);
+		break;
+	case PhysicalType::UINT16:
+		TemplatedEncodeColumn<uint16_t>(vdata, count, target, entry_size, null_byte, width);
+		break;
+	case PhysicalType::UINT32:
+		TemplatedEncodeColumn<uint32_t>(vdata, count, target, entry_size, null_byte, width);
+		break;
+	case PhysicalType::UINT64:
+		TemplatedEncodeColumn<uint64_t>(vdata, count, target, entry_size, null_byte, width);
+		break;
+	case PhysicalType::INT128:
+		TemplatedEncodeColumn<hugeint_t>(vdata, count, target, entry_size, null_byte, width);
+		break;
+	case PhysicalType::FLOAT:
+		TemplatedEncodeColumn<float>(vdata, count, target, entry_size, null_byte, width);
+		break;
+	case PhysicalType::DOUBLE:
+		TemplatedEncodeColumn<double>(vdata, count, target, entry_size, null_byte, width);
+		break;
+	case PhysicalType::INTERVAL:
+		TemplatedEncodeColumn<interval_t>(vdata, count, target, entry_size, null_byte, width);
+		break;
+	case PhysicalType::VARCHAR:
+		TemplatedEncodeColumn<string_t>(vdata, count, target, entry_size, null_byte, width);
+		break;
+	default:
+		throw InternalException("Unsupported type for sort key encoding");
+	}
+}
+
+void SortKeyLayout::Encode(DataChunk &keys, data_ptr_t entries) {
+	auto count = keys.size();
+	for (idx_t col_idx = 0; col_idx < column_offsets.size(); col_idx++) {
+		auto target = entries + column_offsets[col_idx];
+		// NULLs compare smaller than all other values when they go first
+		data_t null_byte = null_orders[col_idx] == OrderByNullType::NULLS_FIRST ? 0 : 1;
+		EncodeColumn(keys.data[col_idx], count, target, entry_size, null_byte);
+		if (order_types[col_idx] == OrderType::DESCENDING) {
+			// invert all bytes of the column (including the NULL byte) to reverse its order
+			auto width = (col_idx + 1 < column_offsets.size() ? column_offsets[col_idx + 1] : key_width) -
+			             column_offsets[col_idx];
+			for (idx_t i = 0; i < count; i++) {
+				auto column_data = target + i * entry_size;
+				for (idx_t byte_idx = 0; byte_idx < width; byte_idx++) {
+					column_data[byte_idx] = ~column_data[byte_idx];
+				}
+			}
+		}
+	}
+}
+
+//===--------------------------------------------------------------------===//
+// Sort
+//===--------------------------------------------------------------------===//
+void SortKeyLayout::Sort(data_ptr_t entries, idx_t count, const sort_tie_compare_t &compare_ties) {
+	if (count <= 1) {
+		return;
+	}
+	auto temp = unique_ptr<data_t[]>(new data_t[count * entry_size]);
+	RadixSort(entries, temp.get(), count, 0, compare_ties);
+}
+
+void SortKeyLayout::RadixSort(data_ptr_t entries, data_ptr_t temp, idx_t count, idx_t offset,
+                              const sort_tie_compare_t &compare_ties) {
+	idx_t counts[256];
+	while (true) {
+		if (count <= RADIX_SORT_THRESHOLD || offset == key_width) {
+			ComparisonSort(entries, temp, count, offset, compare_ties);
+			return;
+		}
+		// compute the histogram of the byte at the current offset
+		memset(counts, 0, sizeof(counts));
+		for (idx_t i = 0; i < count; i++) {
+			counts[entries[i * entry_size + offset]]++;
+		}
+		if (counts[entries[offset]] == count) {
+			// all entries share this byte: continue with the next byte without moving the entries
+			offset++;
+			continue;
+		}
+		break;
+	}
+	// scatter the entries into their buckets
+	idx_t positions[256];
+	idx_t position = 0;
+	for (idx_t bucket = 0; bucket < 256; bucket++) {
+		positions[bucket] = position;
+		position += counts[bucket];
+	}
+	for (idx_t i = 0; i < count; i++) {
+		auto entry = entries + i * entry_size;
+		memcpy(temp + positions[entry[offset]]++ * entry_size, entry, entry_size);
+	}
+	memcpy(entries, temp, count * entry_size);
+	// sort the buckets on the next byte
+	position = 0;
+	for (idx_t bucket = 0; bucket < 256; bucket++) {
+		if (counts[bucket] > 1) {
+			RadixSort(entries + position * entry_size, temp, counts[bucket], offset + 1, compare_ties);
+		}
+		position += counts[bucket];
+	}
+}
+
+void SortKeyLayout::ComparisonSort(data_ptr_t entries, data_ptr_t temp, idx_t count, idx_t offset,
+                                   const sort_tie_compare_t &compare_ties) {
+	if (offset == key_width && exact) {
+		// all keys are equal
+		return;
+	}
+	vector<data_ptr_t> pointers(count);
+	for (idx_t i = 0; i < count; i++) {
+		pointers[i] = entries + i * entry_size;
+	}
+	// the bytes before the offset are equal for all entries
+	auto compare_width = key_width - offset;
+	std::sort(pointers.begin(), pointers.end(), [&](const data_ptr_t left, const data_ptr_t right) {
+		auto result = memcmp(left + offset, right + offset, compare_width);
+		if (result != 0 || exact) {
+			return result < 0;
+		}
+		return compare_ties(left, right) < 0;
+	});
+	for (idx_t i = 0; i < count; i++) {
+		memcpy(temp + i * entry_size, pointers[i], entry_size);
+	}
+	memcpy(entries, temp, count * entry_size);
+}
+
+} // namespace duckdb
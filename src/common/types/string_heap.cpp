@@ -62,7 +62,8 @@ void StringHeap::MergeHeap(StringHeap &other) {
 	other.tail->prev = move(chunk);
 	this->chunk = move(other.chunk);
 	if (!tail) {
-		tail = this->chunk.get();
+		// the oldest chunk of the other heap is now the oldest chunk of this heap
+		tail = other.tail;
 	}
 	other.tail = nullptr;
 }
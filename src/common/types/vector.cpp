@@ -123,6 +123,15 @@ void Vector::Slice(const SelectionVector &sel, idx_t count, SelCache &cache) {
 	}
 }
 
+void Vector::Dictionary(buffer_ptr<VectorBuffer> dictionary, const SelectionVector &sel) {
+	D_ASSERT(dictionary->type == VectorBufferType::VECTOR_CHILD_BUFFER);
+	D_ASSERT(((VectorChildBuffer &)*dictionary).data.type == type);
+	vector_type = VectorType::DICTIONARY_VECTOR;
+	buffer = make_buffer<DictionaryBuffer>(sel);
+	auxiliary = move(dictionary);
+	nullmask.reset();
+}
+
 void Vector::Initialize(LogicalType new_type, bool zero_data) {
 	if (new_type.id() != LogicalTypeId::INVALID) {
 		type = new_type;
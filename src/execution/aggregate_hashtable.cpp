@@ -34,7 +34,7 @@ GroupedAggregateHashTable::GroupedAggregateHashTable(BufferManager &buffer_manag
                                                      vector<AggregateObject> aggregate_objects_p,
                                                      HtEntryType entry_type)
     : BaseAggregateHashTable(buffer_manager, move(group_types_p), move(payload_types_p), move(aggregate_objects_p)),
-      entry_type(entry_type), capacity(0), entries(0), payload_page_offset(0), is_finalized(false),
+      entry_type(entry_type), capacity(0), entries(0), is_pinned(true), payload_page_offset(0), is_finalized(false),
       ht_offsets(LogicalTypeId::BIGINT), hash_salts(LogicalTypeId::SMALLINT),
       group_compare_vector(STANDARD_VECTOR_SIZE), no_match_vector(STANDARD_VECTOR_SIZE),
       empty_vector(STANDARD_VECTOR_SIZE) {
@@ -45,8 +45,10 @@ GroupedAggregateHashTable::GroupedAggregateHashTable(BufferManager &buffer_manag
 	tuple_size = BaseAggregateHashTable::Align(tuple_size);
 #endif
 
-	D_ASSERT(tuple_size <= Storage::BLOCK_ALLOC_SIZE);
-	tuples_per_block = Storage::BLOCK_ALLOC_SIZE / tuple_size;
+	// the tuples have to fit in the usable part of a block, the block header is written with the block when the
+	// block is evicted
+	D_ASSERT(tuple_size <= Storage::BLOCK_SIZE);
+	tuples_per_block = Storage::BLOCK_SIZE / tuple_size;
 	hashes_hdl = buffer_manager.Allocate(Storage::BLOCK_ALLOC_SIZE);
 	hashes_hdl_ptr = hashes_hdl->Ptr();
 
@@ -93,6 +95,7 @@ void GroupedAggregateHashTable::PayloadApply(FUNC fun) {
 	if (entries == 0) {
 		return;
 	}
+	D_ASSERT(is_pinned);
 	idx_t apply_entries = entries;
 	idx_t page_nr = 0;
 	idx_t page_offset = 0;
@@ -111,7 +114,11 @@ void GroupedAggregateHashTable::PayloadApply(FUNC fun) {
 }
 
 void GroupedAggregateHashTable::NewBlock() {
-	auto pin = buffer_manager.Allocate(Storage::BLOCK_ALLOC_SIZE);
+	D_ASSERT(is_pinned);
+	// the payload blocks can be written to the temporary directory while the HT is unpinned
+	auto block = buffer_manager.RegisterMemory(Storage::BLOCK_ALLOC_SIZE, false);
+	auto pin = buffer_manager.Pin(block);
+	payload_blocks.push_back(move(block));
 	payload_hds.push_back(move(pin));
 	payload_hds_ptrs.push_back(payload_hds.back()->Ptr());
 	payload_page_offset = 0;
@@ -125,9 +132,11 @@ void GroupedAggregateHashTable::Destroy() {
 			has_destructor = true;
 		}
 	}
-	if (!has_destructor) {
+	if (!has_destructor || entries == 0) {
 		return;
 	}
+	// the states have to be in memory to be destroyed
+	Pin();
 	// there are aggregates with destructors: loop over the hash table
 	// and call the destructor method for each of the aggregates
 	data_ptr_t data_pointers[STANDARD_VECTOR_SIZE];
@@ -179,7 +188,7 @@ idx_t GroupedAggregateHashTable::MaxCapacity() {
 		break;
 	}
 
-	return max_pages * MinValue(max_tuples, (idx_t)Storage::BLOCK_ALLOC_SIZE / tuple_size);
+	return max_pages * MinValue(max_tuples, (idx_t)Storage::BLOCK_SIZE / tuple_size);
 }
 
 void GroupedAggregateHashTable::Verify() {
@@ -213,8 +222,8 @@ void GroupedAggregateHashTable::Resize(idx_t size) {
 	bitmask = size - 1;
 
 	auto byte_size = size * sizeof(T);
-	if (byte_size > (idx_t)Storage::BLOCK_ALLOC_SIZE) {
-		hashes_hdl = buffer_manager.Allocate(byte_size);
+	if (byte_size > (idx_t)Storage::BLOCK_SIZE) {
+		hashes_hdl = buffer_manager.Allocate(byte_size + Storage::BLOCK_HEADER_SIZE);
 		hashes_hdl_ptr = hashes_hdl->Ptr();
 	}
 	memset(hashes_hdl_ptr, 0, byte_size);
@@ -732,8 +741,71 @@ idx_t GroupedAggregateHashTable::FindOrCreateGroupsInternal(DataChunk &groups, V
 
 // this is to support distinct aggregations where we need to record whether we
 // have already seen a value for a group
+idx_t GroupedAggregateHashTable::FindOrCreateDictionaryGroups(DataChunk &groups, Vector &group_hashes,
+                                                              Vector &addresses_out, SelectionVector &new_groups_out) {
+	auto &dictionary_sel = DictionaryVector::SelVector(groups.data[0]);
+	auto entry_count = DictionaryVector::DictionarySize(groups.data[0]);
+	D_ASSERT(entry_count <= STANDARD_VECTOR_SIZE);
+
+	// figure out the distinct dictionary entries used by the groups, and the first row that references each entry
+	// STANDARD_VECTOR_SIZE marks entries that are not used by any row
+	sel_t entry_positions[STANDARD_VECTOR_SIZE];
+	for (idx_t i = 0; i < entry_count; i++) {
+		entry_positions[i] = STANDARD_VECTOR_SIZE;
+	}
+	SelectionVector distinct_rows(STANDARD_VECTOR_SIZE);
+	idx_t distinct_count = 0;
+	for (idx_t i = 0; i < groups.size(); i++) {
+		auto entry = dictionary_sel.get_index(i);
+		if (entry_positions[entry] == STANDARD_VECTOR_SIZE) {
+			entry_positions[entry] = distinct_count;
+			distinct_rows.set_index(distinct_count++, i);
+		}
+	}
+
+	// find or create the groups of the distinct entries
+	DataChunk distinct_groups;
+	distinct_groups.InitializeEmpty(group_types);
+	distinct_groups.Slice(groups, distinct_rows, distinct_count);
+	Vector distinct_hashes;
+	distinct_hashes.Slice(group_hashes, distinct_rows, distinct_count);
+	Vector distinct_addresses(LogicalType::POINTER);
+	SelectionVector distinct_new_groups(STANDARD_VECTOR_SIZE);
+	idx_t new_group_count;
+	switch (entry_type) {
+	case HtEntryType::HT_WIDTH_64:
+		new_group_count = FindOrCreateGroupsInternal<aggr_ht_entry_64>(distinct_groups, distinct_hashes,
+		                                                               distinct_addresses, distinct_new_groups);
+		break;
+	case HtEntryType::HT_WIDTH_32:
+		new_group_count = FindOrCreateGroupsInternal<aggr_ht_entry_32>(distinct_groups, distinct_hashes,
+		                                                               distinct_addresses, distinct_new_groups);
+		break;
+	default:
+		throw NotImplementedException("Unknown HT entry width");
+	}
+	for (idx_t i = 0; i < new_group_count; i++) {
+		new_groups_out.set_index(i, distinct_rows.get_index(distinct_new_groups.get_index(i)));
+	}
+
+	// now scatter the addresses of the distinct entries to all rows
+	addresses_out.Normalify(groups.size());
+	auto distinct_addresses_ptr = FlatVector::GetData<data_ptr_t>(distinct_addresses);
+	auto addresses_ptr = FlatVector::GetData<data_ptr_t>(addresses_out);
+	for (idx_t i = 0; i < groups.size(); i++) {
+		addresses_ptr[i] = distinct_addresses_ptr[entry_positions[dictionary_sel.get_index(i)]];
+	}
+	return new_group_count;
+}
+
 idx_t GroupedAggregateHashTable::FindOrCreateGroups(DataChunk &groups, Vector &group_hashes, Vector &addresses_out,
                                                     SelectionVector &new_groups_out) {
+	if (groups.ColumnCount() == 1 && groups.data[0].vector_type == VectorType::DICTIONARY_VECTOR) {
+		auto entry_count = DictionaryVector::DictionarySize(groups.data[0]);
+		if (entry_count > 0 && entry_count < groups.size()) {
+			return FindOrCreateDictionaryGroups(groups, group_hashes, addresses_out, new_groups_out);
+		}
+	}
 	switch (entry_type) {
 	case HtEntryType::HT_WIDTH_64:
 		return FindOrCreateGroupsInternal<aggr_ht_entry_64>(groups, group_hashes, addresses_out, new_groups_out);
@@ -874,17 +946,20 @@ void GroupedAggregateHashTable::Partition(vector<GroupedAggregateHashTable *> &p
 }
 
 idx_t GroupedAggregateHashTable::Scan(idx_t &scan_position, DataChunk &result) {
+	// the scan does not touch the state of the HT, so different parts of a HT can be scanned concurrently
+	Vector addresses(LogicalType::POINTER);
 	auto data_pointers = FlatVector::GetData<data_ptr_t>(addresses);
 
 	auto remaining = entries - scan_position;
 	if (remaining == 0) {
 		return 0;
 	}
+	D_ASSERT(is_pinned);
 	auto this_n = MinValue((idx_t)STANDARD_VECTOR_SIZE, remaining);
 
 	auto chunk_idx = scan_position / tuples_per_block;
 	auto chunk_offset = (scan_position % tuples_per_block) * tuple_size;
-	D_ASSERT(chunk_offset + tuple_size <= Storage::BLOCK_ALLOC_SIZE);
+	D_ASSERT(chunk_offset + tuple_size <= Storage::BLOCK_SIZE);
 
 	auto read_ptr = payload_hds_ptrs[chunk_idx++];
 	for (idx_t i = 0; i < this_n; i++) {
@@ -916,11 +991,44 @@ idx_t GroupedAggregateHashTable::Scan(idx_t &scan_position, DataChunk &result) {
 }
 
 void GroupedAggregateHashTable::Finalize() {
-	D_ASSERT(!is_finalized);
+	if (is_finalized) {
+		return;
+	}
 
 	// early release hashes, not needed for partition/scan
 	hashes_hdl.reset();
 	is_finalized = true;
 }
 
+void GroupedAggregateHashTable::Unpin() {
+	// the pointer table refers to the payload blocks by their position, not by their address, but it cannot be used
+	// while the blocks are unpinned anyway
+	D_ASSERT(is_finalized);
+	payload_hds.clear();
+	payload_hds_ptrs.clear();
+	is_pinned = false;
+}
+
+idx_t GroupedAggregateHashTable::Pin() {
+	if (is_pinned) {
+		return 0;
+	}
+	idx_t spilled_bytes = 0;
+	for (auto &block : payload_blocks) {
+		if (!block->IsLoaded()) {
+			spilled_bytes += Storage::BLOCK_ALLOC_SIZE;
+		}
+		payload_hds.push_back(buffer_manager.Pin(block));
+		payload_hds_ptrs.push_back(payload_hds.back()->Ptr());
+	}
+	is_pinned = true;
+	return spilled_bytes;
+}
+
+idx_t GroupedAggregateHashTable::SizeInBytes() {
+	idx_t entry_size = entry_type == HtEntryType::HT_WIDTH_32 ? sizeof(aggr_ht_entry_32) : sizeof(aggr_ht_entry_64);
+	idx_t hashes_size = is_finalized ? 0 : MaxValue<idx_t>(capacity * entry_size, Storage::BLOCK_ALLOC_SIZE);
+	return payload_blocks.size() * Storage::BLOCK_ALLOC_SIZE + hashes_size;
+}
+
 } // namespace duckdb
@@ -84,6 +84,37 @@ Value ExpressionExecutor::EvaluateScalar(Expression &expr) {
 	return result_value;
 }
 
+bool ExpressionExecutor::ExecuteOnDictionary(ExpressionState &state, Vector &input, idx_t count, Vector &result,
+                                             const dictionary_function_t &function) {
+	if (input.vector_type != VectorType::DICTIONARY_VECTOR) {
+		return false;
+	}
+	auto entry_count = DictionaryVector::DictionarySize(input);
+	if (entry_count == 0) {
+		// the dictionary is private to this vector (e.g. the result of a filter)
+		return false;
+	}
+	auto &dictionary = DictionaryVector::ChildBuffer(input);
+	if (state.dictionary != dictionary) {
+		if (entry_count > count) {
+			// evaluating the dictionary is more expensive than evaluating the rows
+			return false;
+		}
+		auto &entries = DictionaryVector::Child(input);
+		auto dictionary_result = make_buffer<VectorChildBuffer>();
+		auto &evaluated = dictionary_result->data;
+		evaluated.Initialize(result.type);
+		function(entries, entry_count, evaluated);
+		evaluated.Normalify(entry_count);
+		dictionary_result->dictionary_size = entry_count;
+		// keep a reference to the dictionary, so that it is not freed (and its address reused) while it is cached
+		state.dictionary = dictionary;
+		state.dictionary_result = move(dictionary_result);
+	}
+	result.Dictionary(state.dictionary_result, DictionaryVector::SelVector(input));
+	return true;
+}
+
 void ExpressionExecutor::Verify(Expression &expr, Vector &vector, idx_t count) {
 	D_ASSERT(expr.return_type == vector.type);
 	vector.Verify(count);
@@ -229,9 +260,13 @@ idx_t ExpressionExecutor::DefaultSelect(Expression &expr, ExpressionState *state
 	bool intermediate_bools[STANDARD_VECTOR_SIZE];
 	Vector intermediate(LogicalType::BOOLEAN, (data_ptr_t)intermediate_bools);
 	Execute(expr, state, sel, count, intermediate);
+	return SelectBooleans(intermediate, sel, count, true_sel, false_sel);
+}
 
+idx_t ExpressionExecutor::SelectBooleans(Vector &booleans, const SelectionVector *sel, idx_t count,
+                                         SelectionVector *true_sel, SelectionVector *false_sel) {
 	VectorData idata;
-	intermediate.Orrify(count, idata);
+	booleans.Orrify(count, idata);
 	if (!sel) {
 		sel = &FlatVector::IncrementalSelectionVector;
 	}
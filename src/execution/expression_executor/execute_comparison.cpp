@@ -15,17 +15,8 @@ unique_ptr<ExpressionState> ExpressionExecutor::InitializeState(BoundComparisonE
 	return result;
 }
 
-void ExpressionExecutor::Execute(BoundComparisonExpression &expr, ExpressionState *state, const SelectionVector *sel,
-                                 idx_t count, Vector &result) {
-	// resolve the children
-	Vector left, right;
-	left.Reference(state->intermediate_chunk.data[0]);
-	right.Reference(state->intermediate_chunk.data[1]);
-
-	Execute(*expr.left, state->child_states[0].get(), sel, count, left);
-	Execute(*expr.right, state->child_states[1].get(), sel, count, right);
-
-	switch (expr.type) {
+static void ExecuteComparison(ExpressionType type, Vector &left, Vector &right, Vector &result, idx_t count) {
+	switch (type) {
 	case ExpressionType::COMPARE_EQUAL:
 		VectorOperations::Equals(left, right, result, count);
 		break;
@@ -55,6 +46,37 @@ void ExpressionExecutor::Execute(BoundComparisonExpression &expr, ExpressionStat
 	}
 }
 
+//! Evaluates the comparison on the dictionary entries of the non-constant side, if that side is a dictionary vector
+static bool ExecuteComparisonOnDictionary(BoundComparisonExpression &expr, ExpressionState *state, Vector &left,
+                                          Vector &right, idx_t count, Vector &result) {
+	if (state->dictionary_child == INVALID_INDEX) {
+		return false;
+	}
+	bool dictionary_left = state->dictionary_child == 0;
+	return ExpressionExecutor::ExecuteOnDictionary(
+	    *state, dictionary_left ? left : right, count, result,
+	    [&](Vector &entries, idx_t entry_count, Vector &entry_result) {
+		    ExecuteComparison(expr.type, dictionary_left ? entries : left, dictionary_left ? right : entries,
+		                      entry_result, entry_count);
+	    });
+}
+
+void ExpressionExecutor::Execute(BoundComparisonExpression &expr, ExpressionState *state, const SelectionVector *sel,
+                                 idx_t count, Vector &result) {
+	// resolve the children
+	Vector left, right;
+	left.Reference(state->intermediate_chunk.data[0]);
+	right.Reference(state->intermediate_chunk.data[1]);
+
+	Execute(*expr.left, state->child_states[0].get(), sel, count, left);
+	Execute(*expr.right, state->child_states[1].get(), sel, count, right);
+
+	if (ExecuteComparisonOnDictionary(expr, state, left, right, count, result)) {
+		return;
+	}
+	ExecuteComparison(expr.type, left, right, result, count);
+}
+
 template <class OP>
 static idx_t templated_select_operation(Vector &left, Vector &right, const SelectionVector *sel, idx_t count,
                                         SelectionVector *true_sel, SelectionVector *false_sel) {
@@ -104,6 +126,10 @@ idx_t ExpressionExecutor::Select(BoundComparisonExpression &expr, ExpressionStat
 	Execute(*expr.left, state->child_states[0].get(), sel, count, left);
 	Execute(*expr.right, state->child_states[1].get(), sel, count, right);
 
+	Vector dictionary_result(LogicalType::BOOLEAN, nullptr);
+	if (ExecuteComparisonOnDictionary(expr, state, left, right, count, dictionary_result)) {
+		return SelectBooleans(dictionary_result, sel, count, true_sel, false_sel);
+	}
 	switch (expr.type) {
 	case ExpressionType::COMPARE_EQUAL:
 		return templated_select_operation<duckdb::Equals>(left, right, sel, count, true_sel, false_sel);
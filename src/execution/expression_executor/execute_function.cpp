@@ -38,6 +38,23 @@ void ExpressionExecutor::Execute(BoundFunctionExpression &expr, ExpressionState
 #endif
 		}
 		arguments.Verify();
+		if (state->dictionary_child != INVALID_INDEX && !expr.function.has_side_effects) {
+			// all other arguments are constant: try to evaluate the function once for every dictionary entry
+			auto dictionary_child = state->dictionary_child;
+			auto execute_on_dictionary = [&](Vector &entries, idx_t entry_count, Vector &entry_result) {
+				DataChunk input;
+				input.InitializeEmpty(state->types);
+				for (idx_t i = 0; i < input.ColumnCount(); i++) {
+					input.data[i].Reference(i == dictionary_child ? entries : arguments.data[i]);
+				}
+				input.SetCardinality(entry_count);
+				expr.function.function(input, *state, entry_result);
+			};
+			if (ExecuteOnDictionary(*state, arguments.data[dictionary_child], count, result,
+			                        execute_on_dictionary)) {
+				return;
+			}
+		}
 	}
 	arguments.SetCardinality(count);
 	expr.function.function(arguments, *state, result);
@@ -5,6 +5,10 @@
 namespace duckdb {
 
 void ExpressionState::AddChild(Expression *expr) {
+	if (!expr->IsFoldable()) {
+		dictionary_child = non_foldable_children == 0 ? types.size() : INVALID_INDEX;
+		non_foldable_children++;
+	}
 	types.push_back(expr->return_type);
 	child_states.push_back(ExpressionExecutor::InitializeState(*expr, root));
 }
@@ -1,6 +1,8 @@
 #include "duckdb/execution/index/art/art.hpp"
 #include "duckdb/execution/expression_executor.hpp"
 #include "duckdb/common/vector_operations/vector_operations.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+#include "duckdb/storage/meta_block_writer.hpp"
 #include <algorithm>
 #include <ctgmath>
 #include <cstring>
@@ -8,7 +10,7 @@
 namespace duckdb {
 
 ART::ART(vector<column_t> column_ids, vector<unique_ptr<Expression>> unbound_expressions, bool is_unique)
-    : Index(IndexType::ART, column_ids, move(unbound_expressions)), is_unique(is_unique) {
+    : Index(IndexType::ART, column_ids, move(unbound_expressions)), is_unique(is_unique), db(nullptr) {
 	tree = nullptr;
 	expression_result.Initialize(logical_types);
 	int n = 1;
@@ -288,6 +290,7 @@ bool ART::InsertToLeaf(Leaf &leaf, row_t row_id) {
 
 bool ART::Insert(unique_ptr<Node> &node, unique_ptr<Key> value, unsigned depth, row_t row_id) {
 	Key &key = *value;
+	Node::Unswizzle(node);
 	if (!node) {
 		// node is currently empty, create a leaf here with the key
 		node = make_unique<Leaf>(*this, move(value), row_id);
@@ -381,6 +384,7 @@ void ART::Erase(unique_ptr<Node> &node, Key &key, unsigned depth, row_t row_id)
 	if (!node) {
 		return;
 	}
+	Node::Unswizzle(node);
 	// Delete a leaf from a tree
 	if (node->type == NodeType::NLeaf) {
 		// Make sure we have the right leaf
@@ -485,6 +489,7 @@ void ART::SearchEqualJoinNoFetch(Value &equal_value, idx_t &result_size) {
 }
 
 Node *ART::Lookup(unique_ptr<Node> &node, Key &key, unsigned depth) {
+	Node::Unswizzle(node);
 	auto node_val = node.get();
 
 	while (node_val) {
@@ -601,6 +606,7 @@ bool ART::Bound(unique_ptr<Node> &n, Key &key, Iterator &it, bool inclusive) {
 	if (!n) {
 		return false;
 	}
+	Node::Unswizzle(n);
 	Node *node = n.get();
 
 	idx_t depth = 0;
@@ -700,35 +706,12 @@ bool ART::SearchGreater(ARTIndexScanState *state, bool inclusive, idx_t max_coun
 // Less Than
 //===--------------------------------------------------------------------===//
 static Leaf &FindMinimum(Iterator &it, Node &node) {
-	Node *next = nullptr;
-	idx_t pos = 0;
-	switch (node.type) {
-	case NodeType::NLeaf:
+	if (node.type == NodeType::NLeaf) {
 		it.node = (Leaf *)&node;
 		return (Leaf &)node;
-	case NodeType::N4:
-		next = ((Node4 &)node).child[0].get();
-		break;
-	case NodeType::N16:
-		next = ((Node16 &)node).child[0].get();
-		break;
-	case NodeType::N48: {
-		auto &n48 = (Node48 &)node;
-		while (n48.childIndex[pos] == Node::EMPTY_MARKER) {
-			pos++;
-		}
-		next = n48.child[n48.childIndex[pos]].get();
-		break;
-	}
-	case NodeType::N256: {
-		auto &n256 = (Node256 &)node;
-		while (!n256.child[pos]) {
-			pos++;
-		}
-		next = n256.child[pos].get();
-		break;
-	}
 	}
+	auto pos = node.GetMin();
+	auto next = node.GetChild(pos)->get();
 	it.SetEntry(it.depth, IteratorEntry(&node, pos));
 	it.depth++;
 	return FindMinimum(it, *next);
@@ -744,6 +727,7 @@ bool ART::SearchLess(ARTIndexScanState *state, bool inclusive, idx_t max_count,
 
 	if (!it->start) {
 		// first find the minimum value in the ART: we start scanning from this value
+		Node::Unswizzle(tree);
 		auto &minimum = FindMinimum(state->iterator, *tree);
 		// early out min value higher than upper bound query
 		if (*minimum.value > *upper_bound) {
@@ -759,6 +743,49 @@ bool ART::SearchLess(ARTIndexScanState *state, bool inclusive, idx_t max_count,
 	}
 }
 
+//===--------------------------------------------------------------------===//
+// Serialization
+//===--------------------------------------------------------------------===//
+BlockPointer ART::Serialize(MetaBlockWriter &writer, vector<block_id_t> &blocks) {
+	lock_guard<mutex> l(lock);
+	BlockPointer root;
+	root.block_id = INVALID_BLOCK;
+	root.offset = 0;
+	if (tree) {
+		auto add_block = [&](block_id_t block_id) {
+			if (blocks.empty() || blocks.back() != block_id) {
+				blocks.push_back(block_id);
+			}
+		};
+		add_block(writer.block->id);
+		idx_t written_block_count = writer.written_blocks.size();
+		// serializing the tree loads any nodes that were not loaded from storage yet
+		Node::Unswizzle(tree);
+		root = tree->Serialize(*this, writer);
+		for (idx_t i = written_block_count; i < writer.written_blocks.size(); i++) {
+			add_block(writer.written_blocks[i]);
+		}
+		add_block(writer.block->id);
+	}
+	// the tree is fully loaded now: we no longer need the blocks it was loaded from
+	block_handles.clear();
+	return root;
+}
+
+void ART::LoadFromStorage(DatabaseInstance &db, BlockPointer root, const vector<block_id_t> &blocks) {
+	D_ASSERT(!tree);
+	this->db = &db;
+	if (root.block_id == INVALID_BLOCK) {
+		return;
+	}
+	// register the blocks so they stay cached while the nodes are loaded, nothing is read from disk yet
+	auto &buffer_manager = BufferManager::GetBufferManager(db);
+	for (auto &block_id : blocks) {
+		block_handles.push_back(buffer_manager.RegisterBlock(block_id));
+	}
+	tree = make_unique<SwizzledNode>(*this, root);
+}
+
 //===--------------------------------------------------------------------===//
 // Closed Range Query
 //===--------------------------------------------------------------------===//
@@ -13,6 +13,15 @@ Leaf::Leaf(ART &art, unique_ptr<Key> value, row_t row_id) : Node(art, NodeType::
 	this->num_elements = 1;
 }
 
+Leaf::Leaf(ART &art, unique_ptr<Key> value, unique_ptr<row_t[]> row_ids, idx_t num_elements)
+    : Node(art, NodeType::NLeaf, 0) {
+	D_ASSERT(num_elements > 0);
+	this->value = move(value);
+	this->capacity = num_elements;
+	this->row_ids = move(row_ids);
+	this->num_elements = num_elements;
+}
+
 void Leaf::Insert(row_t row_id) {
 	// Grow array
 	if (num_elements == capacity) {
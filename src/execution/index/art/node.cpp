@@ -1,6 +1,8 @@
 #include "duckdb/execution/index/art/node.hpp"
 #include "duckdb/execution/index/art/art.hpp"
 #include "duckdb/common/exception.hpp"
+#include "duckdb/storage/meta_block_reader.hpp"
+#include "duckdb/storage/meta_block_writer.hpp"
 
 namespace duckdb {
 
@@ -75,4 +77,148 @@ void Node::Erase(ART &art, unique_ptr<Node> &node, idx_t pos) {
 	}
 }
 
+//===--------------------------------------------------------------------===//
+// Serialization
+//===--------------------------------------------------------------------===//
+// Nodes are serialized bottom-up, so that every inner node can store the pointers to its children. The layout is:
+// [uint8_t type][uint32_t prefix_length][prefix]
+// leaves: [uint32_t key_length][key][uint32_t num_elements][row_t row_ids[num_elements]]
+// inner nodes: [uint16_t count] followed by [uint8_t key_byte][block_id_t block_id][uint32_t offset] per child
+BlockPointer Node::Serialize(ART &art, MetaBlockWriter &writer) {
+	vector<uint8_t> child_keys;
+	vector<BlockPointer> child_pointers;
+	if (type != NodeType::NLeaf) {
+		// serialize the children first
+		for (auto pos = GetNextPos(INVALID_INDEX); pos != INVALID_INDEX; pos = GetNextPos(pos)) {
+			switch (type) {
+			case NodeType::N4:
+				child_keys.push_back(((Node4 *)this)->key[pos]);
+				break;
+			case NodeType::N16:
+				child_keys.push_back(((Node16 *)this)->key[pos]);
+				break;
+			default:
+				// Node48 and Node256 are indexed by the key byte
+				child_keys.push_back(pos);
+				break;
+			}
+			child_pointers.push_back((*GetChild(pos))->Serialize(art, writer));
+		}
+		D_ASSERT(child_pointers.size() == count);
+	}
+	BlockPointer pointer;
+	pointer.block_id = writer.block->id;
+	pointer.offset = writer.offset;
+
+	writer.Write<uint8_t>((uint8_t)type);
+	writer.Write<uint32_t>(prefix_length);
+	writer.WriteData(prefix.get(), prefix_length);
+	if (type == NodeType::NLeaf) {
+		auto leaf = (Leaf *)this;
+		writer.Write<uint32_t>(leaf->value->len);
+		writer.WriteData(leaf->value->data.get(), leaf->value->len);
+		writer.Write<uint32_t>(leaf->num_elements);
+		for (idx_t i = 0; i < leaf->num_elements; i++) {
+			writer.Write<row_t>(leaf->GetRowId(i));
+		}
+		return pointer;
+	}
+	writer.Write<uint16_t>(child_pointers.size());
+	for (idx_t i = 0; i < child_pointers.size(); i++) {
+		writer.Write<uint8_t>(child_keys[i]);
+		writer.Write<block_id_t>(child_pointers[i].block_id);
+		writer.Write<uint32_t>(child_pointers[i].offset);
+	}
+	return pointer;
+}
+
+unique_ptr<Node> Node::Deserialize(ART &art, BlockPointer pointer) {
+	D_ASSERT(art.db);
+	// the blocks of the index are marked as modified when the index is loaded
+	MetaBlockReader reader(*art.db, pointer.block_id, false);
+	reader.offset = pointer.offset;
+
+	auto node_type = (NodeType)reader.Read<uint8_t>();
+	auto prefix_length = reader.Read<uint32_t>();
+	auto prefix = unique_ptr<uint8_t[]>(new uint8_t[prefix_length]);
+	reader.ReadData(prefix.get(), prefix_length);
+
+	unique_ptr<Node> result;
+	if (node_type == NodeType::NLeaf) {
+		auto key_length = reader.Read<uint32_t>();
+		auto key_data = unique_ptr<data_t[]>(new data_t[key_length]);
+		reader.ReadData(key_data.get(), key_length);
+		auto num_elements = reader.Read<uint32_t>();
+		auto row_ids = unique_ptr<row_t[]>(new row_t[num_elements]);
+		reader.ReadData((data_ptr_t)row_ids.get(), num_elements * sizeof(row_t));
+		result = make_unique<Leaf>(art, make_unique<Key>(move(key_data), key_length), move(row_ids), num_elements);
+	} else {
+		auto child_count = reader.Read<uint16_t>();
+		switch (node_type) {
+		case NodeType::N4:
+			result = make_unique<Node4>(art, prefix_length);
+			break;
+		case NodeType::N16:
+			result = make_unique<Node16>(art, prefix_length);
+			break;
+		case NodeType::N48:
+			result = make_unique<Node48>(art, prefix_length);
+			break;
+		case NodeType::N256:
+			result = make_unique<Node256>(art, prefix_length);
+			break;
+		default:
+			throw InternalException("Unrecognized node type in ART deserialization");
+		}
+		// the children are not loaded yet: they are loaded on first access
+		for (idx_t i = 0; i < child_count; i++) {
+			auto key_byte = reader.Read<uint8_t>();
+			BlockPointer child_pointer;
+			child_pointer.block_id = reader.Read<block_id_t>();
+			child_pointer.offset = reader.Read<uint32_t>();
+			auto child = make_unique<SwizzledNode>(art, child_pointer);
+			switch (node_type) {
+			case NodeType::N4: {
+				auto n = (Node4 *)result.get();
+				n->key[i] = key_byte;
+				n->child[i] = move(child);
+				break;
+			}
+			case NodeType::N16: {
+				auto n = (Node16 *)result.get();
+				n->key[i] = key_byte;
+				n->child[i] = move(child);
+				break;
+			}
+			case NodeType::N48: {
+				auto n = (Node48 *)result.get();
+				n->childIndex[key_byte] = i;
+				n->child[i] = move(child);
+				break;
+			}
+			default: {
+				auto n = (Node256 *)result.get();
+				n->child[key_byte] = move(child);
+				break;
+			}
+			}
+		}
+		result->count = child_count;
+	}
+	result->prefix_length = prefix_length;
+	result->prefix = move(prefix);
+	return result;
+}
+
+void Node::Unswizzle(unique_ptr<Node> &node) {
+	if (node && node->type == NodeType::NSwizzled) {
+		auto &swizzled = (SwizzledNode &)*node;
+		node = Deserialize(swizzled.art, swizzled.pointer);
+	}
+}
+
+SwizzledNode::SwizzledNode(ART &art, BlockPointer pointer)
+    : Node(art, NodeType::NSwizzled, 0), art(art), pointer(pointer) {
+}
+
 } // namespace duckdb
@@ -45,6 +45,7 @@ idx_t Node16::GetNextPos(idx_t pos) {
 
 unique_ptr<Node> *Node16::GetChild(idx_t pos) {
 	D_ASSERT(pos < count);
+	Unswizzle(child[pos]);
 	return &child[pos];
 }
 
@@ -48,6 +48,7 @@ idx_t Node256::GetNextPos(idx_t pos) {
 
 unique_ptr<Node> *Node256::GetChild(idx_t pos) {
 	D_ASSERT(child[pos]);
+	Unswizzle(child[pos]);
 	return &child[pos];
 }
 
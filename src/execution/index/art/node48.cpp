@@ -43,6 +43,7 @@ idx_t Node48::GetNextPos(idx_t pos) {
 
 unique_ptr<Node> *Node48::GetChild(idx_t pos) {
 	D_ASSERT(childIndex[pos] != Node::EMPTY_MARKER);
+	Unswizzle(child[childIndex[pos]]);
 	return &child[childIndex[pos]];
 }
 
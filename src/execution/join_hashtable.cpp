@@ -7,6 +7,9 @@
 #include "duckdb/common/vector_operations/vector_operations.hpp"
 #include "duckdb/common/vector_operations/unary_executor.hpp"
 #include "duckdb/common/operator/comparison_operators.hpp"
+#include "duckdb/execution/runtime_join_filter.hpp"
+
+#include <atomic>
 
 namespace duckdb {
 
@@ -15,7 +18,8 @@ using ScanStructure = JoinHashTable::ScanStructure;
 JoinHashTable::JoinHashTable(BufferManager &buffer_manager, vector<JoinCondition> &conditions,
                              vector<LogicalType> btypes, JoinType type)
     : buffer_manager(buffer_manager), build_types(move(btypes)), equality_size(0), condition_size(0), build_size(0),
-      entry_size(0), tuple_size(0), join_type(type), finalized(false), has_null(false), count(0) {
+      entry_size(0), tuple_size(0), join_type(type), finalized(false), has_null(false), perfect_hash(false),
+      perfect_hash_min(0), perfect_hash_capacity(0), bloom_filter(nullptr), count(0) {
 	for (auto &condition : conditions) {
 		D_ASSERT(condition.left->return_type == condition.right->return_type);
 		auto type = condition.left->return_type;
@@ -52,6 +56,8 @@ JoinHashTable::JoinHashTable(BufferManager &buffer_manager, vector<JoinCondition
 		entry_size += sizeof(bool);
 		pointer_offset += sizeof(bool);
 	}
+	// the hash is stored in the slot of the next pointer until the pointer table is constructed
+	hash_offset = pointer_offset;
 	// compute the per-block capacity of this HT
 	block_capacity = MaxValue<idx_t>(STANDARD_VECTOR_SIZE, (Storage::BLOCK_ALLOC_SIZE / entry_size) + 1);
 }
@@ -198,7 +204,6 @@ void JoinHashTable::SerializeVectorData(VectorData &vdata, PhysicalType type, co
 			Store<string_t>(new_val, key_locations[i]);
 			key_locations[i] += sizeof(string_t);
 		}
-		lock_guard<mutex> append_lock(ht_lock);
 		string_heap.MergeHeap(local_heap);
 		break;
 	}
@@ -224,6 +229,49 @@ idx_t JoinHashTable::AppendToBlock(HTDataBlock &block, BufferHandle &handle, vec
 	return append_count;
 }
 
+void JoinHashTable::AllocateEntries(idx_t entry_count, vector<unique_ptr<BufferHandle>> &handles,
+                                    data_ptr_t key_locations[]) {
+	vector<BlockAppendEntry> append_entries;
+	idx_t remaining = entry_count;
+	// first append to the last block (if any)
+	// the blocks belong to the HT of this thread, so no lock is required
+	if (blocks.size() != 0) {
+		auto &last_block = blocks.back();
+		if (last_block.count < last_block.capacity) {
+			// last block has space: pin the buffer of this block
+			auto handle = buffer_manager.Pin(last_block.block);
+			// now append to the block
+			idx_t append_count = AppendToBlock(last_block, *handle, append_entries, remaining);
+			remaining -= append_count;
+			handles.push_back(move(handle));
+		}
+	}
+	while (remaining > 0) {
+		// now for the remaining data, allocate new buffers to store the data and append there
+		auto block = buffer_manager.RegisterMemory(block_capacity * entry_size, false);
+		auto handle = buffer_manager.Pin(block);
+
+		HTDataBlock new_block;
+		new_block.count = 0;
+		new_block.capacity = block_capacity;
+		new_block.block = move(block);
+
+		idx_t append_count = AppendToBlock(new_block, *handle, append_entries, remaining);
+		remaining -= append_count;
+		handles.push_back(move(handle));
+		blocks.push_back(move(new_block));
+	}
+	// now set up the key_locations based on the append entries
+	idx_t append_idx = 0;
+	for (auto &append_entry : append_entries) {
+		idx_t next = append_idx + append_entry.count;
+		for (; append_idx < next; append_idx++) {
+			key_locations[append_idx] = append_entry.baseptr;
+			append_entry.baseptr += entry_size;
+		}
+	}
+}
+
 static idx_t FilterNullValues(VectorData &vdata, const SelectionVector &sel, idx_t count, SelectionVector &result) {
 	auto &nullmask = *vdata.nullmask;
 	idx_t result_count = 0;
@@ -298,49 +346,9 @@ void JoinHashTable::Build(DataChunk &keys, DataChunk &payload) {
 	count += added_count;
 
 	vector<unique_ptr<BufferHandle>> handles;
-	vector<BlockAppendEntry> append_entries;
 	data_ptr_t key_locations[STANDARD_VECTOR_SIZE];
 	// first allocate space of where to serialize the keys and payload columns
-	idx_t remaining = added_count;
-	{
-		// first append to the last block (if any)
-		lock_guard<mutex> append_lock(ht_lock);
-		if (blocks.size() != 0) {
-			auto &last_block = blocks.back();
-			if (last_block.count < last_block.capacity) {
-				// last block has space: pin the buffer of this block
-				auto handle = buffer_manager.Pin(last_block.block);
-				// now append to the block
-				idx_t append_count = AppendToBlock(last_block, *handle, append_entries, remaining);
-				remaining -= append_count;
-				handles.push_back(move(handle));
-			}
-		}
-		while (remaining > 0) {
-			// now for the remaining data, allocate new buffers to store the data and append there
-			auto block = buffer_manager.RegisterMemory(block_capacity * entry_size, false);
-			auto handle = buffer_manager.Pin(block);
-
-			HTDataBlock new_block;
-			new_block.count = 0;
-			new_block.capacity = block_capacity;
-			new_block.block = move(block);
-
-			idx_t append_count = AppendToBlock(new_block, *handle, append_entries, remaining);
-			remaining -= append_count;
-			handles.push_back(move(handle));
-			blocks.push_back(move(new_block));
-		}
-	}
-	// now set up the key_locations based on the append entries
-	idx_t append_idx = 0;
-	for (auto &append_entry : append_entries) {
-		idx_t next = append_idx + append_entry.count;
-		for (; append_idx < next; append_idx++) {
-			key_locations[append_idx] = append_entry.baseptr;
-			append_entry.baseptr += entry_size;
-		}
-	}
+	AllocateEntries(added_count, handles, key_locations);
 
 	// hash the keys and obtain an entry in the list
 	// note that we only hash the keys used in the equality comparison
@@ -364,7 +372,44 @@ void JoinHashTable::Build(DataChunk &keys, DataChunk &payload) {
 	SerializeVector(hash_values, payload.size(), *current_sel, added_count, key_locations);
 }
 
-void JoinHashTable::InsertHashes(Vector &hashes, idx_t count, data_ptr_t key_locations[]) {
+void JoinHashTable::Merge(JoinHashTable &other) {
+	D_ASSERT(!finalized && !other.finalized);
+	lock_guard<mutex> merge_lock(ht_lock);
+	for (auto &block : other.blocks) {
+		blocks.push_back(move(block));
+	}
+	other.blocks.clear();
+	string_heap.MergeHeap(other.string_heap);
+	count += other.count;
+	has_null = has_null || other.has_null;
+	other.count = 0;
+}
+
+template <bool PARALLEL>
+static inline void InsertHashesLoop(std::atomic<data_ptr_t> pointers[], const hash_t indices[], idx_t count,
+                                    const data_ptr_t key_locations[], idx_t pointer_offset) {
+	for (idx_t i = 0; i < count; i++) {
+		auto index = indices[i];
+		if (PARALLEL) {
+			// set prev in current key to the head of the chain and swap in the current key
+			// if another thread changed the head in the meantime, the prev pointer is set again
+			data_ptr_t head;
+			do {
+				head = pointers[index];
+				Store<data_ptr_t>(head, key_locations[i] + pointer_offset);
+			} while (!pointers[index].compare_exchange_weak(head, key_locations[i]));
+		} else {
+			// set prev in current key to the value (NOTE: this will be nullptr if
+			// there is none)
+			Store<data_ptr_t>(pointers[index].load(std::memory_order_relaxed), key_locations[i] + pointer_offset);
+
+			// set pointer to current tuple
+			pointers[index].store(key_locations[i], std::memory_order_relaxed);
+		}
+	}
+}
+
+void JoinHashTable::InsertHashes(Vector &hashes, idx_t count, data_ptr_t key_locations[], bool parallel) {
 	D_ASSERT(hashes.type.id() == LogicalTypeId::HASH);
 
 	// use bitmask to get position in array
@@ -373,24 +418,35 @@ void JoinHashTable::InsertHashes(Vector &hashes, idx_t count, data_ptr_t key_loc
 	hashes.Normalify(count);
 
 	D_ASSERT(hashes.vector_type == VectorType::FLAT_VECTOR);
-	auto pointers = (data_ptr_t *)hash_map->node->buffer;
+	static_assert(sizeof(std::atomic<data_ptr_t>) == sizeof(data_ptr_t),
+	              "the pointer table must be accessible as atomic pointers");
+	auto pointers = (std::atomic<data_ptr_t> *)hash_map->node->buffer;
 	auto indices = FlatVector::GetData<hash_t>(hashes);
-	for (idx_t i = 0; i < count; i++) {
-		auto index = indices[i];
-		// set prev in current key to the value (NOTE: this will be nullptr if
-		// there is none)
-		auto prev_pointer = (data_ptr_t *)(key_locations[i] + pointer_offset);
-		Store<data_ptr_t>(pointers[index], (data_ptr_t)prev_pointer);
-
-		// set pointer to current tuple
-		pointers[index] = key_locations[i];
+	if (parallel) {
+		InsertHashesLoop<true>(pointers, indices, count, key_locations, pointer_offset);
+	} else {
+		InsertHashesLoop<false>(pointers, indices, count, key_locations, pointer_offset);
 	}
 }
 
 void JoinHashTable::Finalize() {
-	// the build has finished, now iterate over all the nodes and construct the final hash table
+	InitializePointerTable();
+	Finalize(0, blocks.size(), false);
+	finalized = true;
+}
+
+idx_t JoinHashTable::PointerTableCapacity() {
 	// select a HT that has at least 50% empty space
-	idx_t capacity = NextPowerOfTwo(MaxValue<idx_t>(count * 2, (Storage::BLOCK_ALLOC_SIZE / sizeof(data_ptr_t)) + 1));
+	return NextPowerOfTwo(MaxValue<idx_t>(count * 2, (Storage::BLOCK_ALLOC_SIZE / sizeof(data_ptr_t)) + 1));
+}
+
+idx_t JoinHashTable::SizeInBytes() {
+	return count * entry_size + PointerTableCapacity() * sizeof(data_ptr_t);
+}
+
+void JoinHashTable::InitializePointerTable() {
+	// the build has finished, now construct the final hash table
+	idx_t capacity = PointerTableCapacity();
 	// size needs to be a power of 2
 	D_ASSERT((capacity & (capacity - 1)) == 0);
 	bitmask = capacity - 1;
@@ -399,38 +455,213 @@ void JoinHashTable::Finalize() {
 	hash_map = buffer_manager.Allocate(capacity * sizeof(data_ptr_t));
 	memset(hash_map->node->buffer, 0, capacity * sizeof(data_ptr_t));
 
+	// we pin all the blocks of the HT and keep them pinned until the HT is destroyed
+	// this is so that we can keep pointers around to the blocks
+	// FIXME: if we cannot keep everything pinned in memory, we could switch to an out-of-memory merge join or so
+	D_ASSERT(pinned_handles.empty());
+	for (auto &block : blocks) {
+		pinned_handles.push_back(buffer_manager.Pin(block.block));
+	}
+}
+
+void JoinHashTable::Finalize(idx_t block_idx_start, idx_t block_idx_end, bool parallel) {
+	D_ASSERT(pinned_handles.size() == blocks.size());
+	D_ASSERT(block_idx_end <= blocks.size());
+	D_ASSERT(!finalized);
+
 	Vector hashes(LogicalType::HASH);
 	auto hash_data = FlatVector::GetData<hash_t>(hashes);
 	data_ptr_t key_locations[STANDARD_VECTOR_SIZE];
 	// now construct the actual hash table; scan the nodes
-	// as we can the nodes we pin all the blocks of the HT and keep them pinned until the HT is destroyed
-	// this is so that we can keep pointers around to the blocks
-	// FIXME: if we cannot keep everything pinned in memory, we could switch to an out-of-memory merge join or so
-	for (auto &block : blocks) {
-		auto handle = buffer_manager.Pin(block.block);
-		data_ptr_t dataptr = handle->node->buffer;
+	for (idx_t block_idx = block_idx_start; block_idx < block_idx_end; block_idx++) {
+		auto &block = blocks[block_idx];
+		data_ptr_t dataptr = pinned_handles[block_idx]->node->buffer;
 		idx_t entry = 0;
 		while (entry < block.count) {
 			// fetch the next vector of entries from the blocks
 			idx_t next = MinValue<idx_t>(STANDARD_VECTOR_SIZE, block.count - entry);
 			for (idx_t i = 0; i < next; i++) {
-				hash_data[i] = Load<hash_t>((data_ptr_t)(dataptr + pointer_offset));
+				hash_data[i] = Load<hash_t>((data_ptr_t)(dataptr + hash_offset));
 				key_locations[i] = dataptr;
 				dataptr += entry_size;
 			}
+			if (bloom_filter) {
+				for (idx_t i = 0; i < next; i++) {
+					bloom_filter->Insert(hash_data[i]);
+				}
+			}
 			// now insert into the hash table
-			InsertHashes(hashes, next, key_locations);
+			InsertHashes(hashes, next, key_locations, parallel);
 
 			entry += next;
 		}
-		pinned_handles.push_back(move(handle));
 	}
+}
+
+template <class T>
+static bool TemplatedInsertPerfectHash(data_ptr_t key_locations[], idx_t count, int64_t min_key, idx_t capacity,
+                                       data_ptr_t pointers[]) {
+	for (idx_t i = 0; i < count; i++) {
+		auto key = int64_t(Load<T>(key_locations[i]));
+		auto slot = idx_t(key) - idx_t(min_key);
+		if (key < min_key || slot >= capacity || pointers[slot]) {
+			// the key is outside of the range or it occurs more than once
+			return false;
+		}
+		pointers[slot] = key_locations[i];
+	}
+	return true;
+}
 
+static bool InsertPerfectHash(PhysicalType type, data_ptr_t key_locations[], idx_t count, int64_t min_key,
+                              idx_t capacity, data_ptr_t pointers[]) {
+	switch (type) {
+	case PhysicalType::INT8:
+		return TemplatedInsertPerfectHash<int8_t>(key_locations, count, min_key, capacity, pointers);
+	case PhysicalType::INT16:
+		return TemplatedInsertPerfectHash<int16_t>(key_locations, count, min_key, capacity, pointers);
+	case PhysicalType::INT32:
+		return TemplatedInsertPerfectHash<int32_t>(key_locations, count, min_key, capacity, pointers);
+	case PhysicalType::INT64:
+		return TemplatedInsertPerfectHash<int64_t>(key_locations, count, min_key, capacity, pointers);
+	default:
+		throw InternalException("Unsupported type for perfect hash join");
+	}
+}
+
+bool JoinHashTable::FinalizePerfectHash(int64_t min_key, idx_t capacity) {
+	D_ASSERT(!finalized);
+	if (predicates.size() != 1 || null_values_are_equal[0]) {
+		return false;
+	}
+	D_ASSERT(predicates[0] == ExpressionType::COMPARE_EQUAL);
+	auto key_type = condition_types[0].InternalType();
+	switch (key_type) {
+	case PhysicalType::INT8:
+	case PhysicalType::INT16:
+	case PhysicalType::INT32:
+	case PhysicalType::INT64:
+		break;
+	default:
+		return false;
+	}
+	if (capacity > PointerTableCapacity()) {
+		// the keys are too sparse: the pointer table of the regular HT is smaller
+		return false;
+	}
+	hash_map = buffer_manager.Allocate(
+	    MaxValue<idx_t>(capacity * sizeof(data_ptr_t) + Storage::BLOCK_HEADER_SIZE, Storage::BLOCK_ALLOC_SIZE));
+	auto pointers = (data_ptr_t *)hash_map->node->buffer;
+	memset(pointers, 0, capacity * sizeof(data_ptr_t));
+	D_ASSERT(pinned_handles.empty());
+	for (auto &block : blocks) {
+		pinned_handles.push_back(buffer_manager.Pin(block.block));
+	}
+
+	// the key is stored at the start of the entries
+	data_ptr_t key_locations[STANDARD_VECTOR_SIZE];
+	for (idx_t block_idx = 0; block_idx < blocks.size(); block_idx++) {
+		auto &block = blocks[block_idx];
+		data_ptr_t dataptr = pinned_handles[block_idx]->node->buffer;
+		idx_t entry = 0;
+		while (entry < block.count) {
+			idx_t next = MinValue<idx_t>(STANDARD_VECTOR_SIZE, block.count - entry);
+			for (idx_t i = 0; i < next; i++) {
+				key_locations[i] = dataptr;
+				dataptr += entry_size;
+			}
+			if (!InsertPerfectHash(key_type, key_locations, next, min_key, capacity, pointers)) {
+				// the regular HT has to be constructed instead
+				hash_map.reset();
+				pinned_handles.clear();
+				return false;
+			}
+			entry += next;
+		}
+	}
+	// the keys are unique, so no entry has a next entry. The hash is stored in the slot of the next pointer, which is
+	// why the next pointers are only cleared after all keys have been inserted successfully.
+	for (idx_t block_idx = 0; block_idx < blocks.size(); block_idx++) {
+		data_ptr_t dataptr = pinned_handles[block_idx]->node->buffer;
+		for (idx_t i = 0; i < blocks[block_idx].count; i++) {
+			if (bloom_filter) {
+				bloom_filter->Insert(Load<hash_t>(dataptr + hash_offset));
+			}
+			Store<data_ptr_t>(nullptr, dataptr + pointer_offset);
+			dataptr += entry_size;
+		}
+	}
+	perfect_hash = true;
+	perfect_hash_min = min_key;
+	perfect_hash_capacity = capacity;
 	finalized = true;
+	return true;
+}
+
+void JoinHashTable::Unpin() {
+	// the hashes of the entries of a partition are stored separately from the next pointers, so that the pointer
+	// table can be constructed again after it has been released
+	D_ASSERT(hash_offset != pointer_offset);
+	hash_map.reset();
+	pinned_handles.clear();
+	perfect_hash = false;
+	finalized = false;
+}
+
+void JoinHashTable::Partition(vector<unique_ptr<JoinHashTable>> &partitions, idx_t radix_bits) {
+	D_ASSERT(!finalized);
+	D_ASSERT(partitions.size() == (idx_t(1) << radix_bits));
+	for (auto &partition : partitions) {
+		D_ASSERT(partition->count == 0 && partition->entry_size == entry_size);
+		// the hash is stored after the next pointer, so a partition can be finalized more than once
+		partition->hash_offset = entry_size;
+		partition->entry_size = entry_size + sizeof(hash_t);
+		partition->block_capacity =
+		    MaxValue<idx_t>(STANDARD_VECTOR_SIZE, (Storage::BLOCK_ALLOC_SIZE / partition->entry_size) + 1);
+		partition->has_null = has_null;
+	}
+	vector<vector<data_ptr_t>> partition_entries(partitions.size());
+	data_ptr_t key_locations[STANDARD_VECTOR_SIZE];
+	for (auto &block : blocks) {
+		// assign the entries of the block to the partitions on the upper bits of their hash
+		auto handle = buffer_manager.Pin(block.block);
+		data_ptr_t dataptr = handle->node->buffer;
+		for (idx_t i = 0; i < block.count; i++) {
+			auto hash = Load<hash_t>(dataptr + hash_offset);
+			if (bloom_filter) {
+				bloom_filter->Insert(hash);
+			}
+			partition_entries[RadixPartition(hash, radix_bits)].push_back(dataptr);
+			dataptr += entry_size;
+		}
+		// now copy the entries to the blocks of the partitions
+		for (idx_t partition_idx = 0; partition_idx < partitions.size(); partition_idx++) {
+			auto &partition = *partitions[partition_idx];
+			auto &entries = partition_entries[partition_idx];
+			for (idx_t entry_idx = 0; entry_idx < entries.size(); entry_idx += STANDARD_VECTOR_SIZE) {
+				idx_t next = MinValue<idx_t>(STANDARD_VECTOR_SIZE, entries.size() - entry_idx);
+				vector<unique_ptr<BufferHandle>> handles;
+				partition.AllocateEntries(next, handles, key_locations);
+				for (idx_t i = 0; i < next; i++) {
+					auto source = entries[entry_idx + i];
+					memcpy(key_locations[i], source, entry_size);
+					Store<hash_t>(Load<hash_t>(source + hash_offset), key_locations[i] + partition.hash_offset);
+				}
+			}
+			partition.count += entries.size();
+			entries.clear();
+		}
+		// the entries have been copied: release the block
+		handle.reset();
+		block.block.reset();
+	}
+	// the strings remain in the string heap of this HT
+	blocks.clear();
 }
 
 unique_ptr<ScanStructure> JoinHashTable::Probe(DataChunk &keys) {
-	D_ASSERT(count > 0); // should be handled before
+	// an empty HT is handled before, except for the partitions of a partitioned HT
+	D_ASSERT(count > 0 || hash_offset != pointer_offset);
 	D_ASSERT(finalized);
 
 	// set up the scan structure
@@ -448,6 +679,12 @@ unique_ptr<ScanStructure> JoinHashTable::Probe(DataChunk &keys) {
 		return ss;
 	}
 
+	if (perfect_hash) {
+		// the pointer table is indexed on the key itself: the keys do not have to be hashed
+		ss->count = ProbePerfectHash(ss->key_data[0], *current_sel, ss->count, ss->pointers, ss->sel_vector);
+		return ss;
+	}
+
 	// hash all the keys
 	Vector hashes(LogicalType::HASH);
 	Hash(keys, *current_sel, ss->count, hashes);
@@ -470,6 +707,51 @@ unique_ptr<ScanStructure> JoinHashTable::Probe(DataChunk &keys) {
 	return ss;
 }
 
+template <class T>
+static idx_t TemplatedProbePerfectHash(VectorData &key_data, const SelectionVector &sel, idx_t count, int64_t min_key,
+                                       idx_t capacity, data_ptr_t table[], data_ptr_t pointers[],
+                                       SelectionVector &result) {
+	auto keys = (T *)key_data.data;
+	idx_t result_count = 0;
+	for (idx_t i = 0; i < count; i++) {
+		auto idx = sel.get_index(i);
+		auto key = int64_t(keys[key_data.sel->get_index(idx)]);
+		auto slot = idx_t(key) - idx_t(min_key);
+		if (key < min_key || slot >= capacity) {
+			// outside of the range of the build-side keys
+			continue;
+		}
+		pointers[idx] = table[slot];
+		if (pointers[idx]) {
+			result.set_index(result_count++, idx);
+		}
+	}
+	return result_count;
+}
+
+idx_t JoinHashTable::ProbePerfectHash(VectorData &key_data, const SelectionVector &sel, idx_t count, Vector &pointers,
+                                      SelectionVector &result) {
+	D_ASSERT(perfect_hash);
+	auto table = (data_ptr_t *)hash_map->node->buffer;
+	auto pointer_data = FlatVector::GetData<data_ptr_t>(pointers);
+	switch (condition_types[0].InternalType()) {
+	case PhysicalType::INT8:
+		return TemplatedProbePerfectHash<int8_t>(key_data, sel, count, perfect_hash_min, perfect_hash_capacity, table,
+		                                         pointer_data, result);
+	case PhysicalType::INT16:
+		return TemplatedProbePerfectHash<int16_t>(key_data, sel, count, perfect_hash_min, perfect_hash_capacity,
+		                                          table, pointer_data, result);
+	case PhysicalType::INT32:
+		return TemplatedProbePerfectHash<int32_t>(key_data, sel, count, perfect_hash_min, perfect_hash_capacity,
+		                                          table, pointer_data, result);
+	case PhysicalType::INT64:
+		return TemplatedProbePerfectHash<int64_t>(key_data, sel, count, perfect_hash_min, perfect_hash_capacity,
+		                                          table, pointer_data, result);
+	default:
+		throw InternalException("Unsupported type for perfect hash join");
+	}
+}
+
 ScanStructure::ScanStructure(JoinHashTable &ht) : sel_vector(STANDARD_VECTOR_SIZE), ht(ht), finished(false) {
 	pointers.Initialize(LogicalType::POINTER);
 }
@@ -590,6 +872,13 @@ static idx_t GatherSwitch(VectorData &data, PhysicalType type, Vector &pointers,
 
 template <bool NO_MATCH_SEL>
 idx_t ScanStructure::ResolvePredicates(DataChunk &keys, SelectionVector *match_sel, SelectionVector *no_match_sel) {
+	if (ht.perfect_hash) {
+		// a key only points to the entry of a perfect HT that has the same key
+		for (idx_t i = 0; i < this->count; i++) {
+			match_sel->set_index(i, this->sel_vector.get_index(i));
+		}
+		return this->count;
+	}
 	SelectionVector *current_sel = &this->sel_vector;
 	idx_t remaining_count = this->count;
 	idx_t offset = 0;
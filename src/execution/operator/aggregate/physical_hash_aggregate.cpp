@@ -6,9 +6,11 @@
 #include "duckdb/execution/partitionable_hashtable.hpp"
 #include "duckdb/main/client_context.hpp"
 #include "duckdb/parallel/pipeline.hpp"
+#include "duckdb/parallel/task_context.hpp"
 #include "duckdb/parallel/task_scheduler.hpp"
 #include "duckdb/planner/expression/bound_aggregate_expression.hpp"
 #include "duckdb/planner/expression/bound_constant_expression.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
 
 namespace duckdb {
 
@@ -70,11 +72,18 @@ PhysicalHashAggregate::PhysicalHashAggregate(ClientContext &context, vector<Logi
 class HashAggregateGlobalState : public GlobalOperatorState {
 public:
 	HashAggregateGlobalState(PhysicalHashAggregate &_op, ClientContext &context)
-	    : op(_op), is_empty(true), lossy_total_groups(0),
-	      partition_info((idx_t)TaskScheduler::GetScheduler(context).NumberOfThreads()) {
+	    : op(_op), context(context), is_empty(true), lossy_total_groups(0),
+	      partition_info((idx_t)TaskScheduler::GetScheduler(context).NumberOfThreads() *
+	                     PhysicalHashAggregate::PARTITIONS_PER_THREAD) {
+		// every thread adds to one HT per partition at a time, the other HTs are unpinned and can be evicted
+		auto threads = (idx_t)TaskScheduler::GetScheduler(context).NumberOfThreads();
+		auto max_memory = BufferManager::GetBufferManager(context).GetMaxMemory();
+		max_ht_size = MaxValue<idx_t>(max_memory / (2 * threads * partition_info.n_partitions),
+		                              PhysicalHashAggregate::MIN_HT_SIZE);
 	}
 
 	PhysicalHashAggregate &op;
+	ClientContext &context;
 	vector<unique_ptr<PartitionableHashTable>> intermediate_hts;
 	vector<unique_ptr<GroupedAggregateHashTable>> finalized_hts;
 
@@ -86,6 +95,8 @@ public:
 	idx_t lossy_total_groups;
 
 	RadixPartitionInfo partition_info;
+	//! The size after which a thread-local HT is unpinned and a new one is started
+	idx_t max_ht_size;
 };
 
 class HashAggregateLocalState : public LocalSinkState {
@@ -190,19 +201,23 @@ void PhysicalHashAggregate::Sink(ExecutionContext &context, GlobalOperatorState
 
 	if (!llstate.ht) {
 		llstate.ht = make_unique<PartitionableHashTable>(BufferManager::GetBufferManager(context.client),
-		                                                 gstate.partition_info, group_types, payload_types, bindings);
+		                                                 gstate.partition_info, group_types, payload_types, bindings,
+		                                                 gstate.max_ht_size);
 	}
 
-	gstate.lossy_total_groups +=
-	    llstate.ht->AddChunk(group_chunk, aggregate_input_chunk,
-	                         gstate.lossy_total_groups > radix_limit && gstate.partition_info.n_partitions > 1);
+	bool do_partition = gstate.lossy_total_groups > radix_limit && gstate.partition_info.n_partitions > 1;
+	if (do_partition && !llstate.ht->IsPartitioned()) {
+		context.client.profiler.AddSpilledBytes(this, llstate.ht->Partition());
+	}
+	gstate.lossy_total_groups += llstate.ht->AddChunk(group_chunk, aggregate_input_chunk, do_partition);
 }
 
 class PhysicalHashAggregateState : public PhysicalOperatorState {
 public:
 	PhysicalHashAggregateState(PhysicalOperator &op, vector<LogicalType> &group_types,
 	                           vector<LogicalType> &aggregate_types, PhysicalOperator *child)
-	    : PhysicalOperatorState(op, child), ht_index(0), ht_scan_position(0) {
+	    : PhysicalOperatorState(op, child), ht_index(0), ht_scan_position(0), initialized(false),
+	      parallel_state(nullptr), morsel_end(0) {
 		auto scan_chunk_types = group_types;
 		for (auto &aggr_type : aggregate_types) {
 			scan_chunk_types.push_back(aggr_type);
@@ -216,6 +231,31 @@ public:
 	//! The current position to scan the HT for output tuples
 	idx_t ht_index;
 	idx_t ht_scan_position;
+
+	//! Whether or not the scan has checked for a parallel state
+	bool initialized;
+	//! The state of the parallel scan, or nullptr if the HTs are scanned by a single thread
+	ParallelState *parallel_state;
+	//! The end of the morsel that is being scanned in a parallel scan
+	idx_t morsel_end;
+};
+
+//! The state of a parallel scan of the finalized HTs. The HTs are handed out to the threads in morsels of MORSEL_SIZE
+//! groups; a HT is pinned when its first morsel is handed out and destroyed when all of its morsels have been scanned.
+class HashAggregateParallelState : public ParallelState {
+public:
+	explicit HashAggregateParallelState(idx_t ht_count)
+	    : ht_index(0), ht_position(0), batch_index(0), pending_morsels(ht_count, 0) {
+	}
+
+	mutex lock;
+	//! The HT and the position in it of the next morsel
+	idx_t ht_index;
+	idx_t ht_position;
+	//! The sequence number of the next morsel
+	idx_t batch_index;
+	//! The amount of morsels of each HT that are being scanned
+	vector<idx_t> pending_morsels;
 };
 
 void PhysicalHashAggregate::Combine(ExecutionContext &context, GlobalOperatorState &state, LocalSinkState &lstate) {
@@ -236,7 +276,7 @@ void PhysicalHashAggregate::Combine(ExecutionContext &context, GlobalOperatorSta
 
 	if (!llstate.ht->IsPartitioned() && gstate.partition_info.n_partitions > 1 &&
 	    gstate.lossy_total_groups > radix_limit) {
-		llstate.ht->Partition();
+		context.client.profiler.AddSpilledBytes(this, llstate.ht->Partition());
 	}
 
 	lock_guard<mutex> glock(gstate.lock);
@@ -247,7 +287,8 @@ void PhysicalHashAggregate::Combine(ExecutionContext &context, GlobalOperatorSta
 		gstate.is_empty = false;
 	}
 
-	// we will never add new values to these HTs so we can drop the first part of the HT
+	// we will never add new values to these HTs so we can drop the first part of the HT and unpin them until they are
+	// combined
 	llstate.ht->Finalize();
 
 	// at this point we just collect them the PhysicalHashAggregateFinalizeTask (below) will merge them in parallel
@@ -263,17 +304,30 @@ public:
 	}
 	static void FinalizeHT(HashAggregateGlobalState &gstate, idx_t radix) {
 		D_ASSERT(gstate.finalized_hts[radix]);
+		// only the partition that is being combined has to be in memory: the partitions of the other tasks can remain
+		// evicted until those tasks get to them
+		idx_t spilled_bytes = 0;
 		for (auto &pht : gstate.intermediate_hts) {
 			for (auto &ht : pht->GetPartition(radix)) {
+				spilled_bytes += ht->Pin();
 				gstate.finalized_hts[radix]->Combine(*ht);
 				ht.reset();
 			}
 		}
 		gstate.finalized_hts[radix]->Finalize();
+		// the combined partition is pinned again when it is scanned
+		gstate.finalized_hts[radix]->Unpin();
+		gstate.context.profiler.AddSpilledBytes(&gstate.op, spilled_bytes);
 	}
 
 	void Execute() {
-		FinalizeHT(state, radix);
+		try {
+			FinalizeHT(state, radix);
+		} catch (std::exception &ex) {
+			parent.executor.PushError(ex.what());
+		} catch (...) {
+			parent.executor.PushError("Unknown exception in hash aggregate finalize!");
+		}
 		lock_guard<mutex> glock(state.lock);
 		parent.finished_tasks++;
 		// finish the whole pipeline
@@ -325,7 +379,8 @@ void PhysicalHashAggregate::FinalizeInternal(ClientContext &context, unique_ptr<
 		// this should mostly have already happened in Combine, but if not we do it here
 		for (auto &pht : gstate.intermediate_hts) {
 			if (!pht->IsPartitioned()) {
-				pht->Partition();
+				context.profiler.AddSpilledBytes(this, pht->Partition());
+				pht->Finalize();
 			}
 		}
 		// schedule additional tasks to combine the partial HTs
@@ -347,22 +402,87 @@ void PhysicalHashAggregate::FinalizeInternal(ClientContext &context, unique_ptr<
 			}
 		}
 	} else { // in the non-partitioned case we immediately combine all the unpartitioned hts created by the threads.
-		     // TODO possible optimization, if total count < limit for 32 bit ht, use that one
 		     // create this ht here so finalize needs no lock on gstate
-
-		gstate.finalized_hts.push_back(make_unique<GroupedAggregateHashTable>(
-		    BufferManager::GetBufferManager(context), group_types, payload_types, bindings, HtEntryType::HT_WIDTH_64));
+		HashTableList unpartitioned;
 		for (auto &pht : gstate.intermediate_hts) {
-			auto unpartitioned = pht->GetUnpartitioned();
-			for (auto &unpartitioned_ht : unpartitioned) {
+			for (auto &unpartitioned_ht : pht->GetUnpartitioned()) {
 				D_ASSERT(unpartitioned_ht);
-				gstate.finalized_hts[0]->Combine(*unpartitioned_ht);
-				unpartitioned_ht.reset();
+				unpartitioned.push_back(move(unpartitioned_ht));
 			}
-			unpartitioned.clear();
+		}
+		if (unpartitioned.size() == 1) {
+			// a single ht has nothing to be combined with: scan it directly
+			gstate.finalized_hts.push_back(move(unpartitioned[0]));
+			return;
+		}
+		gstate.finalized_hts.push_back(make_unique<GroupedAggregateHashTable>(
+		    BufferManager::GetBufferManager(context), group_types, payload_types, bindings, HtEntryType::HT_WIDTH_64));
+		idx_t spilled_bytes = 0;
+		for (auto &unpartitioned_ht : unpartitioned) {
+			spilled_bytes += unpartitioned_ht->Pin();
+			gstate.finalized_hts[0]->Combine(*unpartitioned_ht);
+			unpartitioned_ht.reset();
 		}
 		gstate.finalized_hts[0]->Finalize();
+		context.profiler.AddSpilledBytes(this, spilled_bytes);
+	}
+}
+
+idx_t PhysicalHashAggregate::MorselCount() {
+	auto &gstate = (HashAggregateGlobalState &)*sink_state;
+	if (gstate.is_empty) {
+		// the scan might have to produce the initial aggregate states: leave it to a single thread
+		return 0;
+	}
+	idx_t morsel_count = 0;
+	for (auto &ht : gstate.finalized_hts) {
+		morsel_count += (ht->Size() + MORSEL_SIZE - 1) / MORSEL_SIZE;
+	}
+	return morsel_count;
+}
+
+unique_ptr<ParallelState> PhysicalHashAggregate::GetParallelState() {
+	auto &gstate = (HashAggregateGlobalState &)*sink_state;
+	return make_unique<HashAggregateParallelState>(gstate.finalized_hts.size());
+}
+
+//! Fetches the next morsel of a parallel scan and releases the morsel that was scanned before, returns false if there
+//! are no morsels left
+static bool NextMorsel(ExecutionContext &context, PhysicalHashAggregate &op, HashAggregateGlobalState &gstate,
+                       PhysicalHashAggregateState &state) {
+	auto &pstate = (HashAggregateParallelState &)*state.parallel_state;
+	lock_guard<mutex> parallel_lock(pstate.lock);
+	if (state.morsel_end > 0) {
+		// the previous morsel is done: destroy its HT if no other thread scans it anymore
+		D_ASSERT(pstate.pending_morsels[state.ht_index] > 0);
+		if (--pstate.pending_morsels[state.ht_index] == 0 && pstate.ht_index > state.ht_index) {
+			gstate.finalized_hts[state.ht_index].reset();
+		}
 	}
+	while (pstate.ht_index < gstate.finalized_hts.size()) {
+		auto &ht = gstate.finalized_hts[pstate.ht_index];
+		if (pstate.ht_position >= ht->Size()) {
+			if (pstate.pending_morsels[pstate.ht_index] == 0) {
+				ht.reset();
+			}
+			pstate.ht_index++;
+			pstate.ht_position = 0;
+			continue;
+		}
+		if (pstate.ht_position == 0) {
+			// the partitions are unpinned after they are combined: pin the one we start scanning
+			context.client.profiler.AddSpilledBytes(&op, ht->Pin());
+		}
+		state.ht_index = pstate.ht_index;
+		state.ht_scan_position = pstate.ht_position;
+		state.morsel_end = MinValue<idx_t>(pstate.ht_position + PhysicalHashAggregate::MORSEL_SIZE, ht->Size());
+		pstate.pending_morsels[pstate.ht_index]++;
+		pstate.ht_position = state.morsel_end;
+		context.task.batch_index = pstate.batch_index++;
+		return true;
+	}
+	state.morsel_end = 0;
+	return false;
 }
 
 void PhysicalHashAggregate::GetChunkInternal(ExecutionContext &context, DataChunk &chunk,
@@ -397,13 +517,38 @@ void PhysicalHashAggregate::GetChunkInternal(ExecutionContext &context, DataChun
 		state.finished = true;
 		return;
 	}
+	if (!state.initialized) {
+		// check if the HTs are scanned in parallel
+		auto task_info = context.task.task_info.find(this);
+		if (task_info != context.task.task_info.end()) {
+			state.parallel_state = task_info->second;
+		}
+		state.initialized = true;
+	}
 	idx_t elements_found = 0;
 
-	while (true) {
+	while (state.parallel_state) {
+		if (state.ht_scan_position >= state.morsel_end && !NextMorsel(context, *this, gstate, state)) {
+			state.finished = true;
+			return;
+		}
+		// the morsels are a multiple of the vector size: the scan never crosses the end of a morsel
+		elements_found = gstate.finalized_hts[state.ht_index]->Scan(state.ht_scan_position, state.scan_chunk);
+		D_ASSERT(state.ht_scan_position <= state.morsel_end);
+		if (elements_found > 0) {
+			break;
+		}
+	}
+
+	while (!state.parallel_state) {
 		if (state.ht_index == gstate.finalized_hts.size()) {
 			state.finished = true;
 			return;
 		}
+		if (state.ht_scan_position == 0) {
+			// the partitions are unpinned after they are combined: pin the one we start scanning
+			context.client.profiler.AddSpilledBytes(this, gstate.finalized_hts[state.ht_index]->Pin());
+		}
 		elements_found = gstate.finalized_hts[state.ht_index]->Scan(state.ht_scan_position, state.scan_chunk);
 
 		if (elements_found > 0) {
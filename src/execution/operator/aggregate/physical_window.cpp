@@ -1,9 +1,14 @@
 #include "duckdb/execution/operator/aggregate/physical_window.hpp"
 
 #include "duckdb/common/types/chunk_collection.hpp"
+#include "duckdb/common/types/null_value.hpp"
 #include "duckdb/common/vector_operations/vector_operations.hpp"
+#include "duckdb/execution/executor.hpp"
 #include "duckdb/execution/expression_executor.hpp"
 #include "duckdb/execution/window_segment_tree.hpp"
+#include "duckdb/parallel/pipeline.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
+#include "duckdb/planner/expression/bound_cast_expression.hpp"
 #include "duckdb/planner/expression/bound_reference_expression.hpp"
 #include "duckdb/planner/expression/bound_window_expression.hpp"
 
@@ -11,33 +16,72 @@
 
 namespace duckdb {
 
+class WindowExecutor;
+
 class WindowGlobalState : public GlobalOperatorState {
 public:
-	WindowGlobalState(PhysicalWindow &_op, ClientContext &context) : op(_op) {
+	WindowGlobalState(PhysicalWindow &_op, idx_t radix_bits) : op(_op), radix_bits(radix_bits) {
+		chunks.resize(idx_t(1) << radix_bits);
+		window_results.resize(chunks.size());
 	}
 
 	PhysicalWindow &op;
 	std::mutex lock;
-	ChunkCollection chunks;
-	ChunkCollection window_results;
+	//! The amount of bits of the hash of the PARTITION BY keys on which the sunk rows are partitioned (if any)
+	idx_t radix_bits;
+	//! The sunk rows, per hash partition
+	vector<ChunkCollection> chunks;
+	//! The results of the window expressions, per hash partition
+	vector<ChunkCollection> window_results;
+
+	//! The hash partition of which the rows are evaluated in parallel, one window expression at a time
+	idx_t range_partition = 0;
+	//! The window expression that is currently evaluated over the range partition
+	idx_t expr_idx = 0;
+	//! The executor of that window expression
+	unique_ptr<WindowExecutor> executor;
+	//! Whether the range tasks construct the segment tree or evaluate the rows of the window expression
+	bool constructing_tree = false;
+	//! The amount of range tasks of the current phase that have not finished yet
+	idx_t pending_tasks = 0;
+	//! Whether or not any range task has failed
+	bool failed = false;
 };
 
 class WindowLocalState : public LocalSinkState {
 public:
-	WindowLocalState(PhysicalWindow &_op) : op(_op) {
+	WindowLocalState(PhysicalWindow &_op, idx_t radix_bits)
+	    : op(_op), radix_bits(radix_bits), hashes(LogicalType::HASH) {
+		chunks.resize(idx_t(1) << radix_bits);
+		if (radix_bits > 0) {
+			auto wexpr = reinterpret_cast<BoundWindowExpression *>(op.select_list[0].get());
+			vector<LogicalType> key_types;
+			for (auto &pexpr : wexpr->partitions) {
+				key_types.push_back(pexpr->return_type);
+				executor.AddExpression(*pexpr);
+			}
+			keys.Initialize(key_types);
+		}
 	}
 
 	PhysicalWindow &op;
-	ChunkCollection chunks;
+	idx_t radix_bits;
+	//! The sunk rows, per hash partition
+	vector<ChunkCollection> chunks;
+	//! Evaluates the PARTITION BY keys of the sunk rows
+	ExpressionExecutor executor;
+	DataChunk keys;
+	Vector hashes;
 };
 
 //! The operator state of the window
 class PhysicalWindowOperatorState : public PhysicalOperatorState {
 public:
 	PhysicalWindowOperatorState(PhysicalOperator &op, PhysicalOperator *child)
-	    : PhysicalOperatorState(op, child), position(0) {
+	    : PhysicalOperatorState(op, child), partition_idx(0), position(0) {
 	}
 
+	idx_t partition_idx;
 	idx_t position;
 };
 
@@ -47,38 +91,6 @@ PhysicalWindow::PhysicalWindow(vector<LogicalType> types, vector<unique_ptr<Expr
     : PhysicalSink(type, move(types)), select_list(move(select_list)) {
 }
 
-static bool EqualsSubset(vector<Value> &a, vector<Value> &b, idx_t start, idx_t end) {
-	D_ASSERT(start <= end);
-	for (idx_t i = start; i < end; i++) {
-		if (a[i] != b[i]) {
-			return false;
-		}
-	}
-	return true;
-}
-
-static idx_t BinarySearchRightmost(ChunkCollection &input, vector<Value> row, idx_t l, idx_t r, idx_t comp_cols) {
-	if (comp_cols == 0) {
-		return r - 1;
-	}
-	while (l < r) {
-		idx_t m = std::floor((l + r) / 2);
-		bool less_than_equals = true;
-		for (idx_t i = 0; i < comp_cols; i++) {
-			if (input.GetRow(m)[i] > row[i]) {
-				less_than_equals = false;
-				break;
-			}
-		}
-		if (less_than_equals) {
-			l = m + 1;
-		} else {
-			r = m;
-		}
-	}
-	return l - 1;
-}
-
 static void MaterializeExpressions(Expression **exprs, idx_t expr_count, ChunkCollection &input,
                                    ChunkCollection &output, bool scalar = false) {
 	if (expr_count == 0) {
@@ -159,263 +171,465 @@ static void SortCollectionForWindow(BoundWindowExpression *wexpr, ChunkCollectio
 	sort_collection.Reorder(sorted_vector.get());
 }
 
-struct WindowBoundariesState {
-	idx_t partition_start = 0;
-	idx_t partition_end = 0;
-	idx_t peer_start = 0;
-	idx_t peer_end = 0;
-	int64_t window_start = -1;
-	int64_t window_end = -1;
-	bool is_same_partition = false;
-	bool is_peer = false;
-	vector<Value> row_prev;
-};
-
-static bool WindowNeedsRank(BoundWindowExpression *wexpr) {
-	return wexpr->type == ExpressionType::WINDOW_PERCENT_RANK || wexpr->type == ExpressionType::WINDOW_RANK ||
-	       wexpr->type == ExpressionType::WINDOW_RANK_DENSE || wexpr->type == ExpressionType::WINDOW_CUME_DIST;
+//! Materializes the expression cast to the given type
+static void MaterializeCastExpression(Expression *expr, const LogicalType &type, ChunkCollection &input,
+                                      ChunkCollection &output, bool scalar = false) {
+	auto cast_expr = BoundCastExpression::AddCastToType(expr->Copy(), type);
+	MaterializeExpression(cast_expr.get(), input, output, scalar);
 }
 
-static void UpdateWindowBoundaries(BoundWindowExpression *wexpr, ChunkCollection &input, idx_t input_size,
-                                   idx_t row_idx, ChunkCollection &boundary_start_collection,
-                                   ChunkCollection &boundary_end_collection, WindowBoundariesState &bounds) {
-
-	if (input.ColumnCount() > 0) {
-		vector<Value> row_cur = input.GetRow(row_idx);
-		idx_t sort_col_count = wexpr->partitions.size() + wexpr->orders.size();
-
-		// determine partition and peer group boundaries to ultimately figure out window size
-		bounds.is_same_partition = EqualsSubset(bounds.row_prev, row_cur, 0, wexpr->partitions.size());
-		bounds.is_peer = bounds.is_same_partition &&
-		                 EqualsSubset(bounds.row_prev, row_cur, wexpr->partitions.size(), sort_col_count);
-		bounds.row_prev = row_cur;
-
-		// when the partition changes, recompute the boundaries
-		if (!bounds.is_same_partition || row_idx == 0) { // special case for first row, need to init
-			bounds.partition_start = row_idx;
-			bounds.peer_start = row_idx;
-
-			// find end of partition
-			bounds.partition_end =
-			    BinarySearchRightmost(input, row_cur, bounds.partition_start, input.Count(), wexpr->partitions.size()) +
-			    1;
-
-		} else if (!bounds.is_peer) {
-			bounds.peer_start = row_idx;
+template <class T>
+static void TemplatedMarkGroupStarts(Vector &prev_vector, idx_t prev_count, Vector &source, idx_t count,
+                                     vector<bool> &group_starts, idx_t offset) {
+	VectorData pdata, vdata;
+	prev_vector.Orrify(prev_count, pdata);
+	source.Orrify(count, vdata);
+	auto prev_values = (T *)pdata.data;
+	auto values = (T *)vdata.data;
+
+	// the row that precedes the first row is the last row of the previous chunk
+	auto prev_idx = pdata.sel->get_index(prev_count - 1);
+	bool prev_null = (*pdata.nullmask)[prev_idx];
+	T prev_value = prev_values[prev_idx];
+	for (idx_t i = 0; i < count; i++) {
+		auto idx = vdata.sel->get_index(i);
+		bool is_null = (*vdata.nullmask)[idx];
+		if (!group_starts[offset + i]) {
+			// NULLs are equal to each other
+			bool equal = prev_null || is_null ? prev_null && is_null : Equals::Operation<T>(prev_value, values[idx]);
+			if (!equal) {
+				group_starts[offset + i] = true;
+			}
 		}
+		prev_null = is_null;
+		prev_value = values[idx];
+	}
+}
 
-		if (wexpr->end == WindowBoundary::CURRENT_ROW_RANGE || wexpr->type == ExpressionType::WINDOW_CUME_DIST) {
-			bounds.peer_end = BinarySearchRightmost(input, row_cur, row_idx, bounds.partition_end, sort_col_count) + 1;
+static void GenericMarkGroupStarts(Vector &prev_vector, idx_t prev_count, Vector &source, idx_t count,
+                                   vector<bool> &group_starts, idx_t offset) {
+	Value prev_value = prev_vector.GetValue(prev_count - 1);
+	for (idx_t i = 0; i < count; i++) {
+		Value value = source.GetValue(i);
+		if (!group_starts[offset + i] && prev_value != value) {
+			group_starts[offset + i] = true;
 		}
-	} else {
-		bounds.is_same_partition = 0;
-		bounds.is_peer = true;
-		bounds.partition_end = input_size;
-		bounds.peer_end = bounds.partition_end;
+		prev_value = move(value);
 	}
+}
 
-	// determine window boundaries depending on the type of expression
-	bounds.window_start = -1;
-	bounds.window_end = -1;
-
-	switch (wexpr->start) {
-	case WindowBoundary::UNBOUNDED_PRECEDING:
-		bounds.window_start = bounds.partition_start;
-		break;
-	case WindowBoundary::CURRENT_ROW_ROWS:
-		bounds.window_start = row_idx;
-		break;
-	case WindowBoundary::CURRENT_ROW_RANGE:
-		bounds.window_start = bounds.peer_start;
-		break;
-	case WindowBoundary::UNBOUNDED_FOLLOWING:
-		D_ASSERT(0); // disallowed
-		break;
-	case WindowBoundary::EXPR_PRECEDING: {
-		D_ASSERT(boundary_start_collection.ColumnCount() > 0);
-		bounds.window_start =
-		    (int64_t)row_idx -
-		    boundary_start_collection.GetValue(0, wexpr->start_expr->IsScalar() ? 0 : row_idx).GetValue<int64_t>();
-		break;
-	}
-	case WindowBoundary::EXPR_FOLLOWING: {
-		D_ASSERT(boundary_start_collection.ColumnCount() > 0);
-		bounds.window_start =
-		    row_idx +
-		    boundary_start_collection.GetValue(0, wexpr->start_expr->IsScalar() ? 0 : row_idx).GetValue<int64_t>();
-		break;
+//! Marks the rows of which the value in the column differs from the value of the preceding row, the first row is
+//! always marked
+static void MarkGroupStarts(ChunkCollection &collection, idx_t column, vector<bool> &group_starts) {
+	D_ASSERT(group_starts.size() == collection.Count());
+	for (idx_t chunk_idx = 0; chunk_idx < collection.ChunkCount(); chunk_idx++) {
+		auto &chunk = collection.GetChunk(chunk_idx);
+		// the first row has no preceding row: compare it to itself
+		auto &prev_chunk = chunk_idx == 0 ? chunk : collection.GetChunk(chunk_idx - 1);
+		auto &prev_vector = prev_chunk.data[column];
+		auto &source = chunk.data[column];
+		auto offset = chunk_idx * STANDARD_VECTOR_SIZE;
+		switch (source.type.InternalType()) {
+		case PhysicalType::BOOL:
+		case PhysicalType::INT8:
+			TemplatedMarkGroupStarts<int8_t>(prev_vector, prev_chunk.size(), source, chunk.size(), group_starts,
+			                                 offset);
+			break;
+		case PhysicalType::INT16:
+			TemplatedMarkGroupStarts<int16_t>(prev_vector, prev_chunk.size(), source, chunk.size(), group_starts,
+			                                  offset);
+			break;
+		case PhysicalType::INT32:
+			TemplatedMarkGroupStarts<int32_t>(prev_vector, prev_chunk.size(), source, chunk.size(), group_starts,
+			                                  offset);
+			break;
+		case PhysicalType::INT64:
+			TemplatedMarkGroupStarts<int64_t>(prev_vector, prev_chunk.size(), source, chunk.size(), group_starts,
+			                                  offset);
+			break;
+		case PhysicalType::UINT8:
+			TemplatedMarkGroupStarts<uint8_t>(prev_vector, prev_chunk.size(), source, chunk.size(), group_starts,
+			                                  offset);
+			break;
+		case PhysicalType::UINT16:
+			TemplatedMarkGroupStarts<uint16_t>(prev_vector, prev_chunk.size(), source, chunk.size(), group_starts,
+			                                   offset);
+			break;
+		case PhysicalType::UINT32:
+			TemplatedMarkGroupStarts<uint32_t>(prev_vector, prev_chunk.size(), source, chunk.size(), group_starts,
+			                                   offset);
+			break;
+		case PhysicalType::UINT64:
+			TemplatedMarkGroupStarts<uint64_t>(prev_vector, prev_chunk.size(), source, chunk.size(), group_starts,
+			                                   offset);
+			break;
+		case PhysicalType::INT128:
+			TemplatedMarkGroupStarts<hugeint_t>(prev_vector, prev_chunk.size(), source, chunk.size(), group_starts,
+			                                    offset);
+			break;
+		case PhysicalType::FLOAT:
+			TemplatedMarkGroupStarts<float>(prev_vector, prev_chunk.size(), source, chunk.size(), group_starts,
+			                                offset);
+			break;
+		case PhysicalType::DOUBLE:
+			TemplatedMarkGroupStarts<double>(prev_vector, prev_chunk.size(), source, chunk.size(), group_starts,
+			                                 offset);
+			break;
+		case PhysicalType::INTERVAL:
+			TemplatedMarkGroupStarts<interval_t>(prev_vector, prev_chunk.size(), source, chunk.size(), group_starts,
+			                                     offset);
+			break;
+		case PhysicalType::VARCHAR:
+			TemplatedMarkGroupStarts<string_t>(prev_vector, prev_chunk.size(), source, chunk.size(), group_starts,
+			                                   offset);
+			break;
+		default:
+			GenericMarkGroupStarts(prev_vector, prev_chunk.size(), source, chunk.size(), group_starts, offset);
+			break;
+		}
 	}
+}
 
-	default:
-		throw NotImplementedException("Unsupported boundary");
+//! Returns the start of the group of the row
+static idx_t FindGroupStart(const vector<bool> &group_starts, idx_t row_idx) {
+	while (!group_starts[row_idx]) {
+		row_idx--;
 	}
+	return row_idx;
+}
 
-	switch (wexpr->end) {
-	case WindowBoundary::UNBOUNDED_PRECEDING:
-		D_ASSERT(0); // disallowed
-		break;
-	case WindowBoundary::CURRENT_ROW_ROWS:
-		bounds.window_end = row_idx + 1;
-		break;
-	case WindowBoundary::CURRENT_ROW_RANGE:
-		bounds.window_end = bounds.peer_end;
-		break;
-	case WindowBoundary::UNBOUNDED_FOLLOWING:
-		bounds.window_end = bounds.partition_end;
-		break;
-	case WindowBoundary::EXPR_PRECEDING:
-		D_ASSERT(boundary_end_collection.ColumnCount() > 0);
-		bounds.window_end =
-		    (int64_t)row_idx -
-		    boundary_end_collection.GetValue(0, wexpr->end_expr->IsScalar() ? 0 : row_idx).GetValue<int64_t>() + 1;
-		break;
-	case WindowBoundary::EXPR_FOLLOWING:
-		D_ASSERT(boundary_end_collection.ColumnCount() > 0);
-		bounds.window_end =
-		    row_idx +
-		    boundary_end_collection.GetValue(0, wexpr->end_expr->IsScalar() ? 0 : row_idx).GetValue<int64_t>() + 1;
-
-		break;
-	default:
-		throw NotImplementedException("Unsupported boundary");
+//! Returns the end of the group that starts at the row
+static idx_t FindGroupEnd(const vector<bool> &group_starts, idx_t row_idx) {
+	for (row_idx++; row_idx < group_starts.size(); row_idx++) {
+		if (group_starts[row_idx]) {
+			break;
+		}
 	}
+	return row_idx;
+}
 
-	// clamp windows to partitions if they should exceed
-	if (bounds.window_start < (int64_t)bounds.partition_start) {
-		bounds.window_start = bounds.partition_start;
-	}
-	if ((idx_t)bounds.window_end > bounds.partition_end) {
-		bounds.window_end = bounds.partition_end;
+//! Reads the (BIGINT) values of a materialized expression for the rows of an output chunk
+static void GetBigintValues(ChunkCollection &collection, bool scalar, idx_t chunk_begin, idx_t count,
+                            int64_t values[]) {
+	auto &chunk = collection.GetChunkForRow(scalar ? 0 : chunk_begin);
+	D_ASSERT(chunk.data[0].type.InternalType() == PhysicalType::INT64);
+	VectorData vdata;
+	chunk.data[0].Orrify(chunk.size(), vdata);
+	auto data = (int64_t *)vdata.data;
+	for (idx_t i = 0; i < count; i++) {
+		auto idx = vdata.sel->get_index(scalar ? 0 : i);
+		values[i] = (*vdata.nullmask)[idx] ? NullValue<int64_t>() : data[idx];
 	}
+}
 
-	if (bounds.window_start < 0 || bounds.window_end < 0) {
-		throw Exception("Failed to compute window boundaries");
+//! Copies the rows source_rows[i] of the column of the collection into the result, skipping the INVALID_INDEX rows
+static void GatherRows(ChunkCollection &source, idx_t column, const idx_t source_rows[], Vector &result, idx_t count) {
+	SelectionVector sel(STANDARD_VECTOR_SIZE);
+	idx_t i = 0;
+	while (i < count) {
+		if (source_rows[i] == INVALID_INDEX) {
+			i++;
+			continue;
+		}
+		// copy the run of rows that are read from the same chunk at once
+		auto chunk_idx = source_rows[i] / STANDARD_VECTOR_SIZE;
+		auto run_start = i;
+		idx_t run_count = 0;
+		while (i < count && source_rows[i] != INVALID_INDEX && source_rows[i] / STANDARD_VECTOR_SIZE == chunk_idx) {
+			sel.set_index(run_count++, source_rows[i] % STANDARD_VECTOR_SIZE);
+			i++;
+		}
+		VectorOperations::Copy(source.GetChunk(chunk_idx).data[column], result, sel, run_count, 0, run_start);
 	}
 }
 
-static void ComputeWindowExpression(BoundWindowExpression *wexpr, ChunkCollection &input, ChunkCollection &output,
-                                    idx_t output_idx) {
+//! The partition, peer group and window frame of the rows of an output chunk
+struct WindowBoundaries {
+	idx_t partition_begin[STANDARD_VECTOR_SIZE];
+	idx_t partition_end[STANDARD_VECTOR_SIZE];
+	idx_t peer_begin[STANDARD_VECTOR_SIZE];
+	idx_t peer_end[STANDARD_VECTOR_SIZE];
+	idx_t dense_rank[STANDARD_VECTOR_SIZE];
+	idx_t window_begin[STANDARD_VECTOR_SIZE];
+	idx_t window_end[STANDARD_VECTOR_SIZE];
+	//! The values of the start and end expressions of the frame
+	int64_t start_values[STANDARD_VECTOR_SIZE];
+	int64_t end_values[STANDARD_VECTOR_SIZE];
+	//! The rows from which the results are copied
+	idx_t source_rows[STANDARD_VECTOR_SIZE];
+	idx_t default_rows[STANDARD_VECTOR_SIZE];
+};
+
+//! The partition and peer group of the row that was processed last
+struct WindowBoundariesState {
+	idx_t partition_start = 0;
+	idx_t partition_end = 0;
+	idx_t peer_start = 0;
+	idx_t peer_end = 0;
+	idx_t dense_rank = 0;
+};
+
+//! Computes a single window expression over the rows of a (hash) partition. The executor sorts the rows, marks where
+//! the partitions and peer groups start and materializes the arguments of the window expression when it is
+//! constructed, after which disjoint ranges of rows can be evaluated concurrently.
+class WindowExecutor {
+public:
+	WindowExecutor(BoundWindowExpression *wexpr, ChunkCollection &input, ChunkCollection &output, idx_t output_idx);
+
+	BoundWindowExpression *wexpr;
+	ChunkCollection &input;
+	ChunkCollection &output;
+	idx_t output_idx;
+
+	//! The rows at which a new partition starts
+	vector<bool> partition_starts;
+	//! The rows at which a new peer group starts, which includes the rows at which a partition starts
+	vector<bool> peer_starts;
 
-	ChunkCollection sort_collection;
+	ChunkCollection payload_collection;
+	ChunkCollection leadlag_offset_collection;
+	ChunkCollection leadlag_default_collection;
+	ChunkCollection boundary_start_collection;
+	ChunkCollection boundary_end_collection;
+	//! The segment tree for frame-adhering aggregates, constructed separately from the executor
+	unique_ptr<WindowSegmentTree> segment_tree;
+
+public:
+	//! Evaluates the window expression for the rows [begin, end), rows of the same output chunk have to be evaluated by
+	//! the same thread
+	void Evaluate(idx_t begin, idx_t end);
+
+private:
+	//! Computes the partition, peer group and frame of the rows of an output chunk
+	void ComputeBoundaries(WindowBoundariesState &state, WindowBoundaries &bounds, idx_t chunk_begin, idx_t count);
+	void EvaluateChunk(WindowSegmentTreeState *tree_state, WindowBoundaries &bounds, idx_t chunk_begin, idx_t count,
+	                   Vector &result);
+};
+
+WindowExecutor::WindowExecutor(BoundWindowExpression *wexpr, ChunkCollection &input, ChunkCollection &output,
+                               idx_t output_idx)
+    : wexpr(wexpr), input(input), output(output), output_idx(output_idx) {
+	partition_starts.resize(input.Count(), false);
+	partition_starts[0] = true;
 	bool needs_sorting = wexpr->partitions.size() + wexpr->orders.size() > 0;
 	if (needs_sorting) {
+		ChunkCollection sort_collection;
 		SortCollectionForWindow(wexpr, input, output, sort_collection);
+		// the sort columns are the partition expressions followed by the order expressions
+		for (idx_t col_idx = 0; col_idx < wexpr->partitions.size(); col_idx++) {
+			MarkGroupStarts(sort_collection, col_idx, partition_starts);
+		}
+		peer_starts = partition_starts;
+		for (idx_t col_idx = wexpr->partitions.size(); col_idx < sort_collection.ColumnCount(); col_idx++) {
+			MarkGroupStarts(sort_collection, col_idx, peer_starts);
+		}
+	} else {
+		peer_starts = partition_starts;
 	}
 
-	// TODO we could evaluate those expressions in parallel
-
 	// evaluate inner expressions of window functions, could be more complex
-	ChunkCollection payload_collection;
 	vector<Expression *> exprs;
 	for (auto &child : wexpr->children) {
 		exprs.push_back(child.get());
 	}
-	// TODO: child may be a scalar, don't need to materialize the whole collection then
-	MaterializeExpressions(exprs.data(), exprs.size(), input, payload_collection);
+	if (wexpr->type == ExpressionType::WINDOW_NTILE) {
+		if (exprs.size() != 1) {
+			throw Exception("NTILE needs a parameter");
+		}
+		MaterializeCastExpression(exprs[0], LogicalType::BIGINT, input, payload_collection);
+	} else {
+		// TODO: child may be a scalar, don't need to materialize the whole collection then
+		MaterializeExpressions(exprs.data(), exprs.size(), input, payload_collection);
+	}
 
-	ChunkCollection leadlag_offset_collection;
-	ChunkCollection leadlag_default_collection;
 	if (wexpr->type == ExpressionType::WINDOW_LEAD || wexpr->type == ExpressionType::WINDOW_LAG) {
 		if (wexpr->offset_expr) {
-			MaterializeExpression(wexpr->offset_expr.get(), input, leadlag_offset_collection,
-			                      wexpr->offset_expr->IsScalar());
+			MaterializeCastExpression(wexpr->offset_expr.get(), LogicalType::BIGINT, input,
+			                          leadlag_offset_collection, wexpr->offset_expr->IsScalar());
 		}
 		if (wexpr->default_expr) {
-			MaterializeExpression(wexpr->default_expr.get(), input, leadlag_default_collection,
-			                      wexpr->default_expr->IsScalar());
+			MaterializeCastExpression(wexpr->default_expr.get(), wexpr->return_type, input,
+			                          leadlag_default_collection, wexpr->default_expr->IsScalar());
 		}
 	}
 
 	// evaluate boundaries if present.
-	ChunkCollection boundary_start_collection;
 	if (wexpr->start_expr &&
 	    (wexpr->start == WindowBoundary::EXPR_PRECEDING || wexpr->start == WindowBoundary::EXPR_FOLLOWING)) {
-		MaterializeExpression(wexpr->start_expr.get(), input, boundary_start_collection, wexpr->start_expr->IsScalar());
+		MaterializeCastExpression(wexpr->start_expr.get(), LogicalType::BIGINT, input, boundary_start_collection,
+		                          wexpr->start_expr->IsScalar());
 	}
-	ChunkCollection boundary_end_collection;
 	if (wexpr->end_expr &&
 	    (wexpr->end == WindowBoundary::EXPR_PRECEDING || wexpr->end == WindowBoundary::EXPR_FOLLOWING)) {
-		MaterializeExpression(wexpr->end_expr.get(), input, boundary_end_collection, wexpr->end_expr->IsScalar());
+		MaterializeCastExpression(wexpr->end_expr.get(), LogicalType::BIGINT, input, boundary_end_collection,
+		                          wexpr->end_expr->IsScalar());
 	}
 
 	// build a segment tree for frame-adhering aggregates
 	// see http://www.vldb.org/pvldb/vol8/p1058-leis.pdf
-	unique_ptr<WindowSegmentTree> segment_tree = nullptr;
-
 	if (wexpr->aggregate) {
 		segment_tree = make_unique<WindowSegmentTree>(*(wexpr->aggregate), wexpr->bind_info.get(), wexpr->return_type,
 		                                              &payload_collection);
 	}
+}
 
-	WindowBoundariesState bounds;
-	uint64_t dense_rank = 1, rank_equal = 0, rank = 1;
+void WindowExecutor::ComputeBoundaries(WindowBoundariesState &state, WindowBoundaries &bounds, idx_t chunk_begin,
+                                       idx_t count) {
+	if (boundary_start_collection.ColumnCount() > 0) {
+		GetBigintValues(boundary_start_collection, wexpr->start_expr->IsScalar(), chunk_begin, count,
+		                bounds.start_values);
+	}
+	if (boundary_end_collection.ColumnCount() > 0) {
+		GetBigintValues(boundary_end_collection, wexpr->end_expr->IsScalar(), chunk_begin, count, bounds.end_values);
+	}
 
-	if (needs_sorting) {
-		bounds.row_prev = sort_collection.GetRow(0);
-	}
-
-	// this is the main loop, go through all sorted rows and compute window function result
-	for (idx_t row_idx = 0; row_idx < input.Count(); row_idx++) {
-		// special case, OVER (), aggregate over everything
-		UpdateWindowBoundaries(wexpr, sort_collection, input.Count(), row_idx, boundary_start_collection,
-		                       boundary_end_collection, bounds);
-		if (WindowNeedsRank(wexpr)) {
-			if (!bounds.is_same_partition || row_idx == 0) { // special case for first row, need to init
-				dense_rank = 1;
-				rank = 1;
-				rank_equal = 0;
-			} else if (!bounds.is_peer) {
-				dense_rank++;
-				rank += rank_equal;
-				rank_equal = 0;
-			}
-			rank_equal++;
+	for (idx_t i = 0; i < count; i++) {
+		auto row_idx = chunk_begin + i;
+		// determine partition and peer group boundaries to ultimately figure out window size
+		if (partition_starts[row_idx]) {
+			state.partition_start = row_idx;
+			state.partition_end = FindGroupEnd(partition_starts, row_idx);
+			state.dense_rank = 0;
+		}
+		if (peer_starts[row_idx]) {
+			state.peer_start = row_idx;
+			state.peer_end = FindGroupEnd(peer_starts, row_idx);
+			state.dense_rank++;
+		}
+		bounds.partition_begin[i] = state.partition_start;
+		bounds.partition_end[i] = state.partition_end;
+		bounds.peer_begin[i] = state.peer_start;
+		bounds.peer_end[i] = state.peer_end;
+		bounds.dense_rank[i] = state.dense_rank;
+
+		// determine window boundaries depending on the type of expression
+		int64_t window_start = -1;
+		int64_t window_end = -1;
+
+		switch (wexpr->start) {
+		case WindowBoundary::UNBOUNDED_PRECEDING:
+			window_start = state.partition_start;
+			break;
+		case WindowBoundary::CURRENT_ROW_ROWS:
+			window_start = row_idx;
+			break;
+		case WindowBoundary::CURRENT_ROW_RANGE:
+			window_start = state.peer_start;
+			break;
+		case WindowBoundary::UNBOUNDED_FOLLOWING:
+			D_ASSERT(0); // disallowed
+			break;
+		case WindowBoundary::EXPR_PRECEDING:
+			window_start = (int64_t)row_idx - bounds.start_values[i];
+			break;
+		case WindowBoundary::EXPR_FOLLOWING:
+			window_start = row_idx + bounds.start_values[i];
+			break;
+		default:
+			throw NotImplementedException("Unsupported boundary");
 		}
 
-		Value res;
+		switch (wexpr->end) {
+		case WindowBoundary::UNBOUNDED_PRECEDING:
+			D_ASSERT(0); // disallowed
+			break;
+		case WindowBoundary::CURRENT_ROW_ROWS:
+			window_end = row_idx + 1;
+			break;
+		case WindowBoundary::CURRENT_ROW_RANGE:
+			window_end = state.peer_end;
+			break;
+		case WindowBoundary::UNBOUNDED_FOLLOWING:
+			window_end = state.partition_end;
+			break;
+		case WindowBoundary::EXPR_PRECEDING:
+			window_end = (int64_t)row_idx - bounds.end_values[i] + 1;
+			break;
+		case WindowBoundary::EXPR_FOLLOWING:
+			window_end = row_idx + bounds.end_values[i] + 1;
+			break;
+		default:
+			throw NotImplementedException("Unsupported boundary");
+		}
 
-		// if no values are read for window, result is NULL
-		if (bounds.window_start >= bounds.window_end) {
-			output.SetValue(output_idx, row_idx, res);
-			continue;
+		// clamp windows to partitions if they should exceed
+		if (window_start < (int64_t)state.partition_start) {
+			window_start = state.partition_start;
+		}
+		if (window_end > (int64_t)state.partition_end) {
+			window_end = state.partition_end;
 		}
 
-		switch (wexpr->type) {
-		case ExpressionType::WINDOW_AGGREGATE: {
-			res = segment_tree->Compute(bounds.window_start, bounds.window_end);
-			break;
+		if (window_start < 0 || window_end < 0) {
+			throw Exception("Failed to compute window boundaries");
 		}
-		case ExpressionType::WINDOW_ROW_NUMBER: {
-			res = Value::Numeric(wexpr->return_type, row_idx - bounds.partition_start + 1);
-			break;
+		bounds.window_begin[i] = window_start;
+		bounds.window_end[i] = window_end;
+	}
+}
+
+void WindowExecutor::EvaluateChunk(WindowSegmentTreeState *tree_state, WindowBoundaries &bounds, idx_t chunk_begin,
+                                   idx_t count, Vector &result) {
+	switch (wexpr->type) {
+	case ExpressionType::WINDOW_AGGREGATE: {
+		segment_tree->Evaluate(*tree_state, bounds.window_begin, bounds.window_end, result, count);
+		break;
+	}
+	case ExpressionType::WINDOW_ROW_NUMBER: {
+		auto result_data = FlatVector::GetData<int64_t>(result);
+		for (idx_t i = 0; i < count; i++) {
+			result_data[i] = chunk_begin + i - bounds.partition_begin[i] + 1;
 		}
-		case ExpressionType::WINDOW_RANK_DENSE: {
-			res = Value::Numeric(wexpr->return_type, dense_rank);
-			break;
+		break;
+	}
+	case ExpressionType::WINDOW_RANK_DENSE: {
+		auto result_data = FlatVector::GetData<int64_t>(result);
+		for (idx_t i = 0; i < count; i++) {
+			result_data[i] = bounds.dense_rank[i];
 		}
-		case ExpressionType::WINDOW_RANK: {
-			res = Value::Numeric(wexpr->return_type, rank);
-			break;
+		break;
+	}
+	case ExpressionType::WINDOW_RANK: {
+		auto result_data = FlatVector::GetData<int64_t>(result);
+		for (idx_t i = 0; i < count; i++) {
+			result_data[i] = bounds.peer_begin[i] - bounds.partition_begin[i] + 1;
 		}
-		case ExpressionType::WINDOW_PERCENT_RANK: {
-			int64_t denom = (int64_t)bounds.partition_end - bounds.partition_start - 1;
-			double percent_rank = denom > 0 ? ((double)rank - 1) / denom : 0;
-			res = Value(percent_rank);
-			break;
+		break;
+	}
+	case ExpressionType::WINDOW_PERCENT_RANK: {
+		auto result_data = FlatVector::GetData<double>(result);
+		for (idx_t i = 0; i < count; i++) {
+			int64_t denom = (int64_t)bounds.partition_end[i] - bounds.partition_begin[i] - 1;
+			int64_t rank = bounds.peer_begin[i] - bounds.partition_begin[i] + 1;
+			result_data[i] = denom > 0 ? ((double)rank - 1) / denom : 0;
 		}
-		case ExpressionType::WINDOW_CUME_DIST: {
-			int64_t denom = (int64_t)bounds.partition_end - bounds.partition_start;
-			double cume_dist = denom > 0 ? ((double)(bounds.peer_end - bounds.partition_start)) / denom : 0;
-			res = Value(cume_dist);
-			break;
+		break;
+	}
+	case ExpressionType::WINDOW_CUME_DIST: {
+		auto result_data = FlatVector::GetData<double>(result);
+		for (idx_t i = 0; i < count; i++) {
+			int64_t denom = (int64_t)bounds.partition_end[i] - bounds.partition_begin[i];
+			result_data[i] =
+			    denom > 0 ? ((double)(bounds.peer_end[i] - bounds.partition_begin[i])) / denom : 0;
 		}
-		case ExpressionType::WINDOW_NTILE: {
-			if (payload_collection.ColumnCount() != 1) {
-				throw Exception("NTILE needs a parameter");
+		break;
+	}
+	case ExpressionType::WINDOW_NTILE: {
+		D_ASSERT(payload_collection.ColumnCount() == 1);
+		auto &payload = payload_collection.GetChunkForRow(chunk_begin).data[0];
+		VectorData pdata;
+		payload.Orrify(count, pdata);
+		auto n_params = (int64_t *)pdata.data;
+		auto result_data = FlatVector::GetData<int64_t>(result);
+		for (idx_t i = 0; i < count; i++) {
+			auto pidx = pdata.sel->get_index(i);
+			if ((*pdata.nullmask)[pidx]) {
+				FlatVector::SetNull(result, i, true);
+				continue;
 			}
-			auto n_param = payload_collection.GetValue(0, row_idx).GetValue<int64_t>();
+			auto n_param = n_params[pidx];
 			// With thanks from SQLite's ntileValueFunc()
-			int64_t n_total = bounds.partition_end - bounds.partition_start;
+			int64_t n_total = bounds.partition_end[i] - bounds.partition_begin[i];
 			if (n_param > n_total) {
 				// more groups allowed than we have values
 				// map every entry to a unique group
@@ -423,8 +637,8 @@ static void ComputeWindowExpression(BoundWindowExpression *wexpr, ChunkCollectio
 			}
 			int64_t n_size = (n_total / n_param);
 			// find the row idx within the group
-			D_ASSERT(row_idx >= bounds.partition_start);
-			int64_t adjusted_row_idx = row_idx - bounds.partition_start;
+			D_ASSERT(chunk_begin + i >= bounds.partition_begin[i]);
+			int64_t adjusted_row_idx = chunk_begin + i - bounds.partition_begin[i];
 			// now compute the ntile
 			int64_t n_large = n_total - n_param * n_size;
 			int64_t i_small = n_large * (n_size + 1);
@@ -439,51 +653,107 @@ static void ComputeWindowExpression(BoundWindowExpression *wexpr, ChunkCollectio
 			}
 			// result has to be between [1, NTILE]
 			D_ASSERT(result_ntile >= 1 && result_ntile <= n_param);
-			res = Value::Numeric(wexpr->return_type, result_ntile);
-			break;
+			result_data[i] = result_ntile;
 		}
-		case ExpressionType::WINDOW_LEAD:
-		case ExpressionType::WINDOW_LAG: {
-			Value def_val = Value(wexpr->return_type);
-			idx_t offset = 1;
-			if (wexpr->offset_expr) {
-				offset = leadlag_offset_collection.GetValue(0, wexpr->offset_expr->IsScalar() ? 0 : row_idx)
-				             .GetValue<int64_t>();
-			}
-			if (wexpr->default_expr) {
-				def_val = leadlag_default_collection.GetValue(0, wexpr->default_expr->IsScalar() ? 0 : row_idx);
+		break;
+	}
+	case ExpressionType::WINDOW_LEAD:
+	case ExpressionType::WINDOW_LAG: {
+		int64_t *offsets = bounds.start_values;
+		if (wexpr->offset_expr) {
+			GetBigintValues(leadlag_offset_collection, wexpr->offset_expr->IsScalar(), chunk_begin, count, offsets);
+		} else {
+			for (idx_t i = 0; i < count; i++) {
+				offsets[i] = 1;
 			}
+		}
+		for (idx_t i = 0; i < count; i++) {
+			auto row_idx = chunk_begin + i;
+			bounds.source_rows[i] = INVALID_INDEX;
 			if (wexpr->type == ExpressionType::WINDOW_LEAD) {
-				auto lead_idx = row_idx + offset;
-				if (lead_idx < bounds.partition_end) {
-					res = payload_collection.GetValue(0, lead_idx);
-				} else {
-					res = def_val;
+				auto lead_idx = row_idx + offsets[i];
+				if (lead_idx < bounds.partition_end[i]) {
+					bounds.source_rows[i] = lead_idx;
 				}
 			} else {
-				int64_t lag_idx = (int64_t)row_idx - offset;
-				if (lag_idx >= 0 && (idx_t)lag_idx >= bounds.partition_start) {
-					res = payload_collection.GetValue(0, lag_idx);
+				int64_t lag_idx = (int64_t)row_idx - offsets[i];
+				if (lag_idx >= 0 && (idx_t)lag_idx >= bounds.partition_begin[i]) {
+					bounds.source_rows[i] = lag_idx;
+				}
+			}
+			// the rows without a preceding/following row get the default value (or NULL)
+			bounds.default_rows[i] = INVALID_INDEX;
+			if (bounds.source_rows[i] == INVALID_INDEX) {
+				if (wexpr->default_expr) {
+					bounds.default_rows[i] = wexpr->default_expr->IsScalar() ? 0 : row_idx;
 				} else {
-					res = def_val;
+					FlatVector::SetNull(result, i, true);
 				}
 			}
-
-			break;
 		}
-		case ExpressionType::WINDOW_FIRST_VALUE: {
-			res = payload_collection.GetValue(0, bounds.window_start);
-			break;
+		GatherRows(payload_collection, 0, bounds.source_rows, result, count);
+		if (wexpr->default_expr) {
+			GatherRows(leadlag_default_collection, 0, bounds.default_rows, result, count);
 		}
-		case ExpressionType::WINDOW_LAST_VALUE: {
-			res = payload_collection.GetValue(0, bounds.window_end - 1);
-			break;
+		break;
+	}
+	case ExpressionType::WINDOW_FIRST_VALUE:
+	case ExpressionType::WINDOW_LAST_VALUE: {
+		for (idx_t i = 0; i < count; i++) {
+			if (bounds.window_begin[i] >= bounds.window_end[i]) {
+				bounds.source_rows[i] = INVALID_INDEX;
+			} else if (wexpr->type == ExpressionType::WINDOW_FIRST_VALUE) {
+				bounds.source_rows[i] = bounds.window_begin[i];
+			} else {
+				bounds.source_rows[i] = bounds.window_end[i] - 1;
+			}
 		}
-		default:
-			throw NotImplementedException("Window aggregate type %s", ExpressionTypeToString(wexpr->type));
+		GatherRows(payload_collection, 0, bounds.source_rows, result, count);
+		break;
+	}
+	default:
+		throw NotImplementedException("Window aggregate type %s", ExpressionTypeToString(wexpr->type));
+	}
+
+	// if no values are read for window, result is NULL
+	for (idx_t i = 0; i < count; i++) {
+		if (bounds.window_begin[i] >= bounds.window_end[i]) {
+			FlatVector::SetNull(result, i, true);
+		}
+	}
+}
+
+void WindowExecutor::Evaluate(idx_t begin, idx_t end) {
+	D_ASSERT(begin % STANDARD_VECTOR_SIZE == 0);
+	unique_ptr<WindowSegmentTreeState> tree_state;
+	if (segment_tree) {
+		tree_state = make_unique<WindowSegmentTreeState>(*segment_tree);
+	}
+
+	WindowBoundariesState state;
+	if (begin > 0) {
+		// continue from the partition and peer group of the row that precedes the range
+		auto prev_idx = begin - 1;
+		state.partition_start = FindGroupStart(partition_starts, prev_idx);
+		state.partition_end = FindGroupEnd(partition_starts, state.partition_start);
+		state.peer_start = FindGroupStart(peer_starts, prev_idx);
+		state.peer_end = FindGroupEnd(peer_starts, state.peer_start);
+		for (idx_t row_idx = state.partition_start; row_idx <= prev_idx; row_idx++) {
+			state.dense_rank += peer_starts[row_idx];
 		}
+	}
 
-		output.SetValue(output_idx, row_idx, res);
+	// this is the main loop, go through all sorted rows and compute window function result chunk by chunk
+	auto bounds = make_unique<WindowBoundaries>();
+	for (idx_t chunk_begin = begin; chunk_begin < end; chunk_begin += STANDARD_VECTOR_SIZE) {
+		auto count = MinValue<idx_t>(STANDARD_VECTOR_SIZE, end - chunk_begin);
+		auto &result = output.GetChunkForRow(chunk_begin).data[output_idx];
+		D_ASSERT(result.vector_type == VectorType::FLAT_VECTOR);
+		// the results were initialized to NULL
+		FlatVector::Nullmask(result).reset();
+
+		ComputeBoundaries(state, *bounds, chunk_begin, count);
+		EvaluateChunk(tree_state.get(), *bounds, chunk_begin, count, result);
 	}
 }
 
@@ -492,17 +762,19 @@ void PhysicalWindow::GetChunkInternal(ExecutionContext &context, DataChunk &chun
 
 	auto &gstate = (WindowGlobalState &)*sink_state;
 
-	ChunkCollection &big_data = gstate.chunks;
-	ChunkCollection &window_results = gstate.window_results;
-
-	if (big_data.Count() == 0) {
-		return;
+	// skip the hash partitions that have been scanned completely
+	while (state->partition_idx < gstate.chunks.size() &&
+	       state->position >= gstate.chunks[state->partition_idx].Count()) {
+		state->partition_idx++;
+		state->position = 0;
 	}
-
-	if (state->position >= big_data.Count()) {
+	if (state->partition_idx >= gstate.chunks.size()) {
 		return;
 	}
 
+	ChunkCollection &big_data = gstate.chunks[state->partition_idx];
+	ChunkCollection &window_results = gstate.window_results[state->partition_idx];
+
 	// just return what was computed before, appending the result cols of the window expressions at the end
 	auto &proj_ch = big_data.GetChunkForRow(state->position);
 	auto &wind_ch = window_results.GetChunkForRow(state->position);
@@ -523,33 +795,227 @@ unique_ptr<PhysicalOperatorState> PhysicalWindow::GetOperatorState() {
 	return make_unique<PhysicalWindowOperatorState>(*this, children[0].get());
 }
 
+static idx_t RadixPartition(hash_t hash, idx_t radix_bits) {
+	D_ASSERT(radix_bits > 0 && radix_bits < sizeof(hash_t) * 8);
+	return hash >> (sizeof(hash_t) * 8 - radix_bits);
+}
+
 void PhysicalWindow::Sink(ExecutionContext &context, GlobalOperatorState &state, LocalSinkState &lstate_,
                           DataChunk &input) {
 	auto &lstate = (WindowLocalState &)lstate_;
-	lstate.chunks.Append(input);
+	if (lstate.radix_bits == 0) {
+		lstate.chunks[0].Append(input);
+		return;
+	}
+
+	// hash the PARTITION BY keys
+	lstate.keys.Reset();
+	lstate.executor.Execute(input, lstate.keys);
+	VectorOperations::Hash(lstate.keys.data[0], lstate.hashes, input.size());
+	for (idx_t i = 1; i < lstate.keys.ColumnCount(); i++) {
+		VectorOperations::CombineHash(lstate.hashes, lstate.keys.data[i], input.size());
+	}
+	VectorData hdata;
+	lstate.hashes.Orrify(input.size(), hdata);
+	auto hash_data = (hash_t *)hdata.data;
+
+	// sort the rows on their hash partition, and append the rows of every partition to its collection
+	idx_t row_partitions[STANDARD_VECTOR_SIZE];
+	vector<idx_t> offsets(lstate.chunks.size() + 1, 0);
+	for (idx_t i = 0; i < input.size(); i++) {
+		row_partitions[i] = RadixPartition(hash_data[hdata.sel->get_index(i)], lstate.radix_bits);
+		offsets[row_partitions[i] + 1]++;
+	}
+	for (idx_t partition_idx = 0; partition_idx < lstate.chunks.size(); partition_idx++) {
+		offsets[partition_idx + 1] += offsets[partition_idx];
+	}
+	SelectionVector sel(STANDARD_VECTOR_SIZE);
+	auto positions = offsets;
+	for (idx_t i = 0; i < input.size(); i++) {
+		sel.set_index(positions[row_partitions[i]]++, i);
+	}
+
+	auto types = input.GetTypes();
+	for (idx_t partition_idx = 0; partition_idx < lstate.chunks.size(); partition_idx++) {
+		auto count = offsets[partition_idx + 1] - offsets[partition_idx];
+		if (count == 0) {
+			continue;
+		}
+		SelectionVector partition_sel(sel.data() + offsets[partition_idx]);
+		DataChunk partition_chunk;
+		partition_chunk.InitializeEmpty(types);
+		partition_chunk.Slice(input, partition_sel, count);
+		lstate.chunks[partition_idx].Append(partition_chunk);
+	}
 }
 
 void PhysicalWindow::Combine(ExecutionContext &context, GlobalOperatorState &gstate_, LocalSinkState &lstate_) {
 	auto &gstate = (WindowGlobalState &)gstate_;
 	auto &lstate = (WindowLocalState &)lstate_;
 	lock_guard<mutex> glock(gstate.lock);
-	gstate.chunks.Merge(lstate.chunks);
+	for (idx_t partition_idx = 0; partition_idx < gstate.chunks.size(); partition_idx++) {
+		gstate.chunks[partition_idx].Merge(lstate.chunks[partition_idx]);
+	}
 }
 
-void PhysicalWindow::Finalize(Pipeline &pipeline, ClientContext &context, unique_ptr<GlobalOperatorState> gstate_) {
-	this->sink_state = move(gstate_);
-	auto &gstate = (WindowGlobalState &)*this->sink_state;
+//! Computes all window expressions over the rows of a hash partition
+static void ComputeWindowExpressions(PhysicalWindow &op, ChunkCollection &input, ChunkCollection &output) {
+	// we can have multiple window functions
+	for (idx_t expr_idx = 0; expr_idx < op.select_list.size(); expr_idx++) {
+		D_ASSERT(op.select_list[expr_idx]->GetExpressionClass() == ExpressionClass::BOUND_WINDOW);
+		// sort by partition and order clause in window def
+		auto wexpr = reinterpret_cast<BoundWindowExpression *>(op.select_list[expr_idx].get());
+		WindowExecutor executor(wexpr, input, output, expr_idx);
+		if (executor.segment_tree) {
+			WindowSegmentTreeState tree_state(*executor.segment_tree);
+			executor.segment_tree->Construct(tree_state);
+		}
+		executor.Evaluate(0, input.Count());
+	}
+}
+
+//! Computes the window expressions over a hash partition, the hash partitions are computed in parallel
+class PhysicalWindowPartitionTask : public Task {
+public:
+	PhysicalWindowPartitionTask(Pipeline &parent, WindowGlobalState &state, idx_t partition_idx)
+	    : parent(parent), state(state), partition_idx(partition_idx) {
+	}
+
+	void Execute() override {
+		try {
+			ComputeWindowExpressions(state.op, state.chunks[partition_idx], state.window_results[partition_idx]);
+		} catch (std::exception &ex) {
+			parent.executor.PushError(ex.what());
+		} catch (...) {
+			parent.executor.PushError("Unknown exception in window computation!");
+		}
+
+		lock_guard<mutex> glock(state.lock);
+		parent.finished_tasks++;
+		// finish the whole pipeline
+		if (parent.total_tasks == parent.finished_tasks) {
+			parent.Finish();
+		}
+	}
+
+private:
+	Pipeline &parent;
+	WindowGlobalState &state;
+	idx_t partition_idx;
+};
+
+static void FinishWindowRanges(Pipeline &pipeline, WindowGlobalState &state);
+
+//! Constructs the segment tree or evaluates the current window expression for a range of rows of the single (large)
+//! partition, the ranges of a partition are processed in parallel
+class PhysicalWindowRangeTask : public Task {
+public:
+	PhysicalWindowRangeTask(Pipeline &parent, WindowGlobalState &state, idx_t begin, idx_t end)
+	    : parent(parent), state(state), begin(begin), end(end) {
+	}
+
+	void Execute() override {
+		bool failed = false;
+		try {
+			auto &executor = *state.executor;
+			if (state.constructing_tree) {
+				WindowSegmentTreeState tree_state(*executor.segment_tree);
+				executor.segment_tree->ConstructFirstLevel(tree_state, begin, end);
+			} else {
+				executor.Evaluate(begin, end);
+			}
+		} catch (std::exception &ex) {
+			parent.executor.PushError(ex.what());
+			failed = true;
+		} catch (...) {
+			parent.executor.PushError("Unknown exception in window computation!");
+			failed = true;
+		}
+
+		lock_guard<mutex> glock(state.lock);
+		state.failed = state.failed || failed;
+		D_ASSERT(state.pending_tasks > 0);
+		if (--state.pending_tasks == 0 && !state.failed) {
+			// the phase is finished: schedule the next phase (if any) before finishing this task
+			try {
+				FinishWindowRanges(parent, state);
+			} catch (std::exception &ex) {
+				parent.executor.PushError(ex.what());
+			} catch (...) {
+				parent.executor.PushError("Unknown exception in window computation!");
+			}
+		}
+		parent.finished_tasks++;
+		// finish the whole pipeline
+		if (parent.total_tasks == parent.finished_tasks) {
+			parent.Finish();
+		}
+	}
+
+private:
+	Pipeline &parent;
+	WindowGlobalState &state;
+	idx_t begin;
+	idx_t end;
+};
 
-	ChunkCollection &big_data = gstate.chunks;
-	ChunkCollection &window_results = gstate.window_results;
+//! Schedules the tasks that construct the segment tree or evaluate the rows of the current window expression, the
+//! lock must be held
+static void ScheduleWindowRanges(Pipeline &pipeline, WindowGlobalState &state) {
+	auto &executor = *state.executor;
+	idx_t count = executor.input.Count();
+	idx_t threads = TaskScheduler::GetScheduler(pipeline.executor.context).NumberOfThreads();
+	idx_t rows_per_task =
+	    MaxValue<idx_t>(count / (threads * PhysicalWindow::TASKS_PER_THREAD), PhysicalWindow::MIN_TASK_ROWS);
+	// every output chunk is evaluated by a single task
+	rows_per_task = (rows_per_task + STANDARD_VECTOR_SIZE - 1) / STANDARD_VECTOR_SIZE * STANDARD_VECTOR_SIZE;
+	vector<unique_ptr<Task>> tasks;
+	for (idx_t begin = 0; begin < count; begin += rows_per_task) {
+		auto end = MinValue<idx_t>(begin + rows_per_task, count);
+		tasks.push_back(make_unique<PhysicalWindowRangeTask>(pipeline, state, begin, end));
+	}
+	state.pending_tasks = tasks.size();
+	pipeline.total_tasks += tasks.size();
+	auto &scheduler = TaskScheduler::GetScheduler(pipeline.executor.context);
+	for (auto &task : tasks) {
+		scheduler.ScheduleTask(pipeline.token, move(task));
+	}
+}
+
+//! Sorts the rows of the single partition for the current window expression and materializes its arguments, then
+//! schedules the construction of its segment tree or the evaluation of its rows. The lock must be held.
+static void StartWindowExpression(Pipeline &pipeline, WindowGlobalState &state) {
+	auto &op = state.op;
+	D_ASSERT(op.select_list[state.expr_idx]->GetExpressionClass() == ExpressionClass::BOUND_WINDOW);
+	auto wexpr = reinterpret_cast<BoundWindowExpression *>(op.select_list[state.expr_idx].get());
+	state.executor = make_unique<WindowExecutor>(wexpr, state.chunks[state.range_partition],
+	                                             state.window_results[state.range_partition], state.expr_idx);
+	auto &segment_tree = state.executor->segment_tree;
+	state.constructing_tree = segment_tree && segment_tree->HasInternalNodes();
+	ScheduleWindowRanges(pipeline, state);
+}
 
-	if (big_data.Count() == 0) {
+//! Starts the next phase after all range tasks of the current phase have finished, the lock must be held
+static void FinishWindowRanges(Pipeline &pipeline, WindowGlobalState &state) {
+	if (state.constructing_tree) {
+		// the first level of the segment tree has been constructed: the upper levels are only a fraction of its size
+		auto &segment_tree = *state.executor->segment_tree;
+		WindowSegmentTreeState tree_state(segment_tree);
+		segment_tree.ConstructUpperLevels(tree_state);
+		state.constructing_tree = false;
+		ScheduleWindowRanges(pipeline, state);
 		return;
 	}
+	state.executor.reset();
+	if (++state.expr_idx < state.op.select_list.size()) {
+		StartWindowExpression(pipeline, state);
+	}
+}
 
+static void InitializeWindowResults(PhysicalWindow &op, ChunkCollection &big_data, ChunkCollection &window_results) {
 	vector<LogicalType> window_types;
-	for (idx_t expr_idx = 0; expr_idx < select_list.size(); expr_idx++) {
-		window_types.push_back(select_list[expr_idx]->return_type);
+	for (idx_t expr_idx = 0; expr_idx < op.select_list.size(); expr_idx++) {
+		window_types.push_back(op.select_list[expr_idx]->return_type);
 	}
 
 	for (idx_t i = 0; i < big_data.ChunkCount(); i++) {
@@ -564,24 +1030,85 @@ void PhysicalWindow::Finalize(Pipeline &pipeline, ClientContext &context, unique
 		window_chunk.Verify();
 		window_results.Append(window_chunk);
 	}
+	D_ASSERT(window_results.ColumnCount() == op.select_list.size());
+}
 
-	D_ASSERT(window_results.ColumnCount() == select_list.size());
-	idx_t window_output_idx = 0;
-	// we can have multiple window functions
-	for (idx_t expr_idx = 0; expr_idx < select_list.size(); expr_idx++) {
-		D_ASSERT(select_list[expr_idx]->GetExpressionClass() == ExpressionClass::BOUND_WINDOW);
-		// sort by partition and order clause in window def
-		auto wexpr = reinterpret_cast<BoundWindowExpression *>(select_list[expr_idx].get());
-		ComputeWindowExpression(wexpr, big_data, window_results, window_output_idx++);
+void PhysicalWindow::Finalize(Pipeline &pipeline, ClientContext &context, unique_ptr<GlobalOperatorState> gstate_) {
+	this->sink_state = move(gstate_);
+	auto &gstate = (WindowGlobalState &)*this->sink_state;
+
+	vector<idx_t> partitions;
+	for (idx_t partition_idx = 0; partition_idx < gstate.chunks.size(); partition_idx++) {
+		if (gstate.chunks[partition_idx].Count() == 0) {
+			continue;
+		}
+		InitializeWindowResults(*this, gstate.chunks[partition_idx], gstate.window_results[partition_idx]);
+		partitions.push_back(partition_idx);
+	}
+	if (partitions.empty()) {
+		return;
+	}
+
+	auto &scheduler = TaskScheduler::GetScheduler(context);
+	if (partitions.size() > 1) {
+		// the hash partitions hold disjoint sets of window partitions: compute them in parallel
+		lock_guard<mutex> glock(gstate.lock);
+		pipeline.total_tasks += partitions.size();
+		for (auto partition_idx : partitions) {
+			scheduler.ScheduleTask(pipeline.token,
+			                       make_unique<PhysicalWindowPartitionTask>(pipeline, gstate, partition_idx));
+		}
+		return;
 	}
+
+	// all rows are in a single partition: evaluate ranges of its rows in parallel if there are enough of them
+	gstate.range_partition = partitions[0];
+	auto &big_data = gstate.chunks[gstate.range_partition];
+	if (scheduler.NumberOfThreads() > 1 && big_data.Count() > MIN_TASK_ROWS) {
+		lock_guard<mutex> glock(gstate.lock);
+		StartWindowExpression(pipeline, gstate);
+		return;
+	}
+	ComputeWindowExpressions(*this, big_data, gstate.window_results[gstate.range_partition]);
 }
 
 unique_ptr<LocalSinkState> PhysicalWindow::GetLocalSinkState(ExecutionContext &context) {
-	return make_unique<WindowLocalState>(*this);
+	return make_unique<WindowLocalState>(*this, GetRadixBits(context.client));
 }
 
 unique_ptr<GlobalOperatorState> PhysicalWindow::GetGlobalState(ClientContext &context) {
-	return make_unique<WindowGlobalState>(*this, context);
+	return make_unique<WindowGlobalState>(*this, GetRadixBits(context));
+}
+
+idx_t PhysicalWindow::GetRadixBits(ClientContext &context) {
+	idx_t threads = TaskScheduler::GetScheduler(context).NumberOfThreads();
+	if (threads <= 1) {
+		return 0;
+	}
+	// the rows can only be hash partitioned if all window expressions have the same PARTITION BY clause
+	auto first = reinterpret_cast<BoundWindowExpression *>(select_list[0].get());
+	if (first->partitions.empty()) {
+		return 0;
+	}
+	for (auto &expr : select_list) {
+		D_ASSERT(expr->GetExpressionClass() == ExpressionClass::BOUND_WINDOW);
+		auto wexpr = reinterpret_cast<BoundWindowExpression *>(expr.get());
+		if (wexpr->partitions.size() != first->partitions.size()) {
+			return 0;
+		}
+		for (idx_t i = 0; i < wexpr->partitions.size(); i++) {
+			// the keys are evaluated again when the partitions are sorted, so they have to be deterministic
+			if (!Expression::Equals(wexpr->partitions[i].get(), first->partitions[i].get()) ||
+			    wexpr->partitions[i]->HasSideEffects()) {
+				return 0;
+			}
+		}
+	}
+	idx_t radix_bits = 0;
+	while ((idx_t(1) << radix_bits) < threads * TASKS_PER_THREAD) {
+		radix_bits++;
+	}
+	return radix_bits;
 }
 
 string PhysicalWindow::ParamsToString() const {
@@ -0,0 +1,119 @@
+#include "duckdb/execution/operator/helper/physical_result_collector.hpp"
+
+#include "duckdb/parallel/task_context.hpp"
+#include "duckdb/execution/execution_context.hpp"
+
+#include <map>
+
+namespace duckdb {
+
+//===--------------------------------------------------------------------===//
+// Sink
+//===--------------------------------------------------------------------===//
+class ResultCollectorGlobalState : public GlobalOperatorState {
+public:
+	//! The lock for updating the global state
+	mutex lock;
+	//! The collected rows
+	ChunkCollection result;
+	//! The rows of every morsel, if the order is preserved. The morsels are concatenated in the Finalize.
+	std::map<idx_t, unique_ptr<ChunkCollection>> batches;
+};
+
+class ResultCollectorLocalState : public LocalSinkState {
+public:
+	ResultCollectorLocalState() : batch_index(0) {
+	}
+
+	//! The rows collected by this thread, or only the rows of the current morsel if the order is preserved
+	ChunkCollection collection;
+	//! The morsel the rows belong to
+	idx_t batch_index;
+};
+
+unique_ptr<GlobalOperatorState> PhysicalResultCollector::GetGlobalState(ClientContext &context) {
+	return make_unique<ResultCollectorGlobalState>();
+}
+
+unique_ptr<LocalSinkState> PhysicalResultCollector::GetLocalSinkState(ExecutionContext &context) {
+	return make_unique<ResultCollectorLocalState>();
+}
+
+static void FlushBatch(ResultCollectorGlobalState &gstate, ResultCollectorLocalState &lstate) {
+	if (lstate.collection.Count() == 0) {
+		return;
+	}
+	lock_guard<mutex> glock(gstate.lock);
+	auto &batch = gstate.batches[lstate.batch_index];
+	if (!batch) {
+		batch = make_unique<ChunkCollection>();
+		batch->Merge(lstate.collection);
+	} else {
+		batch->Append(lstate.collection);
+	}
+	lstate.collection.Reset();
+}
+
+void PhysicalResultCollector::Sink(ExecutionContext &context, GlobalOperatorState &state, LocalSinkState &lstate_,
+                                   DataChunk &input) {
+	auto &gstate = (ResultCollectorGlobalState &)state;
+	auto &lstate = (ResultCollectorLocalState &)lstate_;
+#ifdef DEBUG
+	for (idx_t i = 0; i < input.ColumnCount(); i++) {
+		if (input.data[i].type.id() == LogicalTypeId::VARCHAR) {
+			input.data[i].UTFVerify(input.size());
+		}
+	}
+#endif
+	if (preserve_order && context.task.batch_index != lstate.batch_index) {
+		// the source moved on to the next morsel: hand the rows of the previous morsel to the global state
+		FlushBatch(gstate, lstate);
+		lstate.batch_index = context.task.batch_index;
+	}
+	lstate.collection.Append(input);
+}
+
+void PhysicalResultCollector::Combine(ExecutionContext &context, GlobalOperatorState &state, LocalSinkState &lstate_) {
+	auto &gstate = (ResultCollectorGlobalState &)state;
+	auto &lstate = (ResultCollectorLocalState &)lstate_;
+	if (preserve_order) {
+		FlushBatch(gstate, lstate);
+		return;
+	}
+	lock_guard<mutex> glock(gstate.lock);
+	gstate.result.Merge(lstate.collection);
+	lstate.collection.Reset();
+}
+
+void PhysicalResultCollector::Finalize(Pipeline &pipeline, ClientContext &context,
+                                       unique_ptr<GlobalOperatorState> state) {
+	auto &gstate = (ResultCollectorGlobalState &)*state;
+	// concatenate the morsels in order
+	for (auto &entry : gstate.batches) {
+		auto &batch = *entry.second;
+		if (gstate.result.Count() % STANDARD_VECTOR_SIZE == 0) {
+			// all chunks of the result are full: the chunks of the morsel can be moved without changing the order
+			gstate.result.Merge(batch);
+		} else {
+			gstate.result.Append(batch);
+		}
+	}
+	gstate.batches.clear();
+	PhysicalSink::Finalize(pipeline, context, move(state));
+}
+
+ChunkCollection &PhysicalResultCollector::GetResult() {
+	D_ASSERT(sink_state);
+	auto &gstate = (ResultCollectorGlobalState &)*sink_state;
+	return gstate.result;
+}
+
+//===--------------------------------------------------------------------===//
+// GetChunkInternal
+//===--------------------------------------------------------------------===//
+void PhysicalResultCollector::GetChunkInternal(ExecutionContext &context, DataChunk &chunk,
+                                               PhysicalOperatorState *state) {
+	throw InternalException("PhysicalResultCollector cannot be used as a source");
+}
+
+} // namespace duckdb
@@ -1,10 +1,15 @@
 #include "duckdb/execution/operator/join/physical_hash_join.hpp"
 
 #include "duckdb/storage/storage_manager.hpp"
+#include "duckdb/common/serializer/buffered_deserializer.hpp"
+#include "duckdb/common/serializer/buffered_serializer.hpp"
 #include "duckdb/common/vector_operations/vector_operations.hpp"
 #include "duckdb/execution/expression_executor.hpp"
 #include "duckdb/storage/buffer_manager.hpp"
 #include "duckdb/function/aggregate/distributive_functions.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/parallel/pipeline.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
 
 namespace duckdb {
 
@@ -13,7 +18,8 @@ PhysicalHashJoin::PhysicalHashJoin(LogicalOperator &op, unique_ptr<PhysicalOpera
                                    vector<idx_t> left_projection_map, vector<idx_t> right_projection_map,
                                    vector<LogicalType> delim_types)
     : PhysicalComparisonJoin(op, PhysicalOperatorType::HASH_JOIN, move(cond), join_type),
-      right_projection_map(right_projection_map), delim_types(move(delim_types)) {
+      right_projection_map(right_projection_map), delim_types(move(delim_types)), perfect_hash_min(0),
+      perfect_hash_range(0) {
 	children.push_back(move(left));
 	children.push_back(move(right));
 
@@ -41,15 +47,35 @@ public:
 	DataChunk build_chunk;
 	DataChunk join_keys;
 	ExpressionExecutor build_executor;
+	//! The thread-local HT, merged into the global HT in Combine. Not used for correlated MARK joins.
+	unique_ptr<JoinHashTable> hash_table;
+	//! The minimum and maximum of the equality keys of this thread, only used if there is a runtime filter
+	vector<Value> key_min;
+	vector<Value> key_max;
 };
 
 class HashJoinGlobalState : public GlobalOperatorState {
 public:
-	HashJoinGlobalState() {
+	HashJoinGlobalState() : finished_blocks(0) {
 	}
 
 	//! The HT used by the join
 	unique_ptr<JoinHashTable> hash_table;
+	//! Lock for building the global HT directly (correlated MARK join only) and for merging the key ranges
+	mutex build_lock;
+	//! The minimum and maximum of the equality keys, only used if there is a runtime filter
+	vector<Value> key_min;
+	vector<Value> key_max;
+	//! The amount of blocks inserted by the finalize tasks
+	std::atomic<idx_t> finished_blocks;
+	//! The radix partitions of the HT, only used if the HT did not fit in memory
+	vector<unique_ptr<JoinHashTable>> partitions;
+	//! The amount of radix bits used to partition the HT
+	idx_t radix_bits = 0;
+	//! The amount of probing threads that use each partition, a partition is pinned while it is in use
+	vector<idx_t> partition_users;
+	//! Lock for pinning and unpinning the partitions
+	mutex partition_lock;
 	//! Only used for FULL OUTER JOIN: scan state of the final scan to find unmatched tuples in the build-side
 	JoinHTScanState ht_scan_state;
 };
@@ -100,11 +126,22 @@ unique_ptr<GlobalOperatorState> PhysicalHashJoin::GetGlobalState(ClientContext &
 			info.result_chunk.Initialize(payload_types);
 		}
 	}
+	if (runtime_filter) {
+		// the filter of a previous execution must not be used before the build side is complete
+		runtime_filter->Reset();
+		state->key_min.resize(runtime_filter->key_columns.size());
+		state->key_max.resize(runtime_filter->key_columns.size());
+	}
 	return move(state);
 }
 
 unique_ptr<LocalSinkState> PhysicalHashJoin::GetLocalSinkState(ExecutionContext &context) {
 	auto state = make_unique<HashJoinLocalState>();
+	if (!IsCorrelatedMarkJoin()) {
+		// every thread appends to its own HT, the HTs are merged in Combine
+		state->hash_table = make_unique<JoinHashTable>(BufferManager::GetBufferManager(context.client), conditions,
+		                                               build_types, join_type);
+	}
 	if (right_projection_map.size() > 0) {
 		state->build_chunk.Initialize(build_types);
 	}
@@ -112,15 +149,38 @@ unique_ptr<LocalSinkState> PhysicalHashJoin::GetLocalSinkState(ExecutionContext
 		state->build_executor.AddExpression(*cond.right);
 	}
 	state->join_keys.Initialize(condition_types);
+	if (runtime_filter) {
+		state->key_min.resize(runtime_filter->key_columns.size());
+		state->key_max.resize(runtime_filter->key_columns.size());
+	}
 	return move(state);
 }
 
+void PhysicalHashJoin::BuildHashTable(GlobalOperatorState &state, LocalSinkState &lstate_, DataChunk &payload) {
+	auto &sink = (HashJoinGlobalState &)state;
+	auto &lstate = (HashJoinLocalState &)lstate_;
+	if (lstate.hash_table) {
+		lstate.hash_table->Build(lstate.join_keys, payload);
+	} else {
+		// the correlated MARK join keeps the correlated counts in the global HT: build it directly
+		D_ASSERT(IsCorrelatedMarkJoin());
+		lock_guard<mutex> build_guard(sink.build_lock);
+		sink.hash_table->Build(lstate.join_keys, payload);
+	}
+}
+
 void PhysicalHashJoin::Sink(ExecutionContext &context, GlobalOperatorState &state, LocalSinkState &lstate_,
                             DataChunk &input) {
 	auto &sink = (HashJoinGlobalState &)state;
 	auto &lstate = (HashJoinLocalState &)lstate_;
 	// resolve the join keys for the right chunk
 	lstate.build_executor.Execute(input, lstate.join_keys);
+	for (idx_t i = 0; i < lstate.key_min.size(); i++) {
+		if (RuntimeJoinFilter::SupportsMinMax(condition_types[i]) && !conditions[i].null_values_are_equal) {
+			RuntimeJoinFilter::UpdateMinMax(lstate.join_keys.data[i], lstate.join_keys.size(), lstate.key_min[i],
+			                                lstate.key_max[i]);
+		}
+	}
 	// build the HT
 	if (right_projection_map.size() > 0) {
 		// there is a projection map: fill the build chunk with the projected columns
@@ -129,26 +189,260 @@ void PhysicalHashJoin::Sink(ExecutionContext &context, GlobalOperatorState &stat
 		for (idx_t i = 0; i < right_projection_map.size(); i++) {
 			lstate.build_chunk.data[i].Reference(input.data[right_projection_map[i]]);
 		}
-		sink.hash_table->Build(lstate.join_keys, lstate.build_chunk);
+		BuildHashTable(sink, lstate, lstate.build_chunk);
 	} else {
 		// there is not a projected map: place the entire right chunk in the HT
-		sink.hash_table->Build(lstate.join_keys, input);
+		BuildHashTable(sink, lstate, input);
+	}
+}
+
+void PhysicalHashJoin::Combine(ExecutionContext &context, GlobalOperatorState &gstate, LocalSinkState &lstate_) {
+	auto &sink = (HashJoinGlobalState &)gstate;
+	auto &lstate = (HashJoinLocalState &)lstate_;
+	if (lstate.hash_table) {
+		sink.hash_table->Merge(*lstate.hash_table);
+	}
+	if (!lstate.key_min.empty()) {
+		lock_guard<mutex> build_guard(sink.build_lock);
+		for (idx_t i = 0; i < lstate.key_min.size(); i++) {
+			auto &min = lstate.key_min[i];
+			auto &max = lstate.key_max[i];
+			if (min.is_null) {
+				// no keys (or only NULL keys) for this condition
+				continue;
+			}
+			if (sink.key_min[i].is_null || min < sink.key_min[i]) {
+				sink.key_min[i] = min;
+			}
+			if (sink.key_max[i].is_null || max > sink.key_max[i]) {
+				sink.key_max[i] = max;
+			}
+		}
 	}
 }
 
 //===--------------------------------------------------------------------===//
 // Finalize
 //===--------------------------------------------------------------------===//
+//! Inserts a range of blocks of the HT into its pointer table, the ranges are inserted in parallel
+class PhysicalHashJoinFinalizeTask : public Task {
+public:
+	PhysicalHashJoinFinalizeTask(Pipeline &parent, HashJoinGlobalState &state, idx_t block_idx_start,
+	                             idx_t block_idx_end)
+	    : parent(parent), state(state), block_idx_start(block_idx_start), block_idx_end(block_idx_end) {
+	}
+
+	void Execute() override {
+		try {
+			state.hash_table->Finalize(block_idx_start, block_idx_end, true);
+		} catch (std::exception &ex) {
+			parent.executor.PushError(ex.what());
+		} catch (...) {
+			parent.executor.PushError("Unknown exception in hash join finalize!");
+		}
+		auto finished_blocks = state.finished_blocks += block_idx_end - block_idx_start;
+		if (finished_blocks == state.hash_table->BlockCount()) {
+			// all blocks have been inserted: the HT is ready for probing
+			state.hash_table->finalized = true;
+		}
+		// finish the whole pipeline
+		if (++parent.finished_tasks == parent.total_tasks) {
+			parent.Finish();
+		}
+	}
+
+private:
+	Pipeline &parent;
+	HashJoinGlobalState &state;
+	idx_t block_idx_start;
+	idx_t block_idx_end;
+};
+
+bool PhysicalHashJoin::CanPartition() {
+	if (IsRightOuterJoin(join_type) || IsCorrelatedMarkJoin()) {
+		// the unmatched tuples of the build side are scanned after the probe, so all partitions would have to be kept
+		return false;
+	}
+	// the probe side is spilled as serialized chunks, which do not support nested types
+	for (auto &type : children[0]->GetTypes()) {
+		if (!TypeIsConstantSize(type.InternalType()) && type.InternalType() != PhysicalType::VARCHAR) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void PhysicalHashJoin::SetRuntimeFilter(GlobalOperatorState &state) {
+	auto &sink = (HashJoinGlobalState &)state;
+	auto &hash_table = *sink.hash_table;
+	runtime_filter->Reset();
+	// only probe-side rows within the range of the build-side keys can find a match
+	for (idx_t i = 0; i < sink.key_min.size(); i++) {
+		if (!sink.key_min[i].is_null) {
+			runtime_filter->AddMinMax(i, sink.key_min[i], sink.key_max[i]);
+		}
+	}
+	if (hash_table.size() >= RuntimeJoinFilter::MIN_BLOOM_FILTER_COUNT &&
+	    hash_table.size() <= RuntimeJoinFilter::MAX_BLOOM_FILTER_COUNT) {
+		// the hashes are inserted into the Bloom filter while the pointer table is constructed
+		runtime_filter->bloom_filter = make_unique<BloomFilter>(hash_table.size());
+		hash_table.bloom_filter = runtime_filter->bloom_filter.get();
+	}
+	// the probe side is only scanned after the build side is finalized, so the filter can be marked as ready here
+	runtime_filter->ready = true;
+}
+
 void PhysicalHashJoin::Finalize(Pipeline &pipeline, ClientContext &context, unique_ptr<GlobalOperatorState> state) {
 	auto &sink = (HashJoinGlobalState &)*state;
-	sink.hash_table->Finalize();
-
+	auto &hash_table = *sink.hash_table;
+	if (runtime_filter) {
+		SetRuntimeFilter(sink);
+	}
+	auto &buffer_manager = BufferManager::GetBufferManager(context);
+	idx_t threads = TaskScheduler::GetScheduler(context).NumberOfThreads();
+	idx_t memory_budget = buffer_manager.GetMaxMemory() / HT_MEMORY_FRACTION;
+	if (hash_table.SizeInBytes() > memory_budget && CanPartition()) {
+		// the HT does not fit in memory: radix partition it, so that the probing threads only have to keep a few of
+		// the partitions in memory at a time
+		idx_t partition_budget = MaxValue<idx_t>(memory_budget / MaxValue<idx_t>(threads, 2), 1);
+		idx_t partition_count = NextPowerOfTwo((hash_table.SizeInBytes() + partition_budget - 1) / partition_budget);
+		sink.radix_bits = 1;
+		while ((idx_t(1) << sink.radix_bits) < partition_count && sink.radix_bits < MAX_RADIX_BITS) {
+			sink.radix_bits++;
+		}
+		for (idx_t i = 0; i < (idx_t(1) << sink.radix_bits); i++) {
+			sink.partitions.push_back(make_unique<JoinHashTable>(buffer_manager, conditions, build_types, join_type));
+		}
+		sink.partition_users.resize(sink.partitions.size(), 0);
+		hash_table.Partition(sink.partitions, sink.radix_bits);
+		PhysicalSink::Finalize(pipeline, context, move(state));
+		return;
+	}
+	if (perfect_hash_range > 0 && hash_table.FinalizePerfectHash(perfect_hash_min, perfect_hash_range)) {
+		// the keys are unique and dense: the HT is probed on the key itself instead of on its hash
+		PhysicalSink::Finalize(pipeline, context, move(state));
+		return;
+	}
+	idx_t block_count = hash_table.BlockCount();
+	idx_t task_count = MinValue<idx_t>(threads, block_count / FINALIZE_TASK_BLOCKS);
+	if (task_count <= 1) {
+		// small HT or single thread: insert all blocks on this thread
+		hash_table.Finalize();
+		PhysicalSink::Finalize(pipeline, context, move(state));
+		return;
+	}
+	hash_table.InitializePointerTable();
 	PhysicalSink::Finalize(pipeline, context, move(state));
+
+	// split the blocks evenly over the tasks, which insert them into the pointer table concurrently
+	vector<unique_ptr<Task>> tasks;
+	idx_t blocks_per_task = (block_count + task_count - 1) / task_count;
+	for (idx_t block_idx = 0; block_idx < block_count; block_idx += blocks_per_task) {
+		tasks.push_back(make_unique<PhysicalHashJoinFinalizeTask>(
+		    pipeline, sink, block_idx, MinValue<idx_t>(block_idx + blocks_per_task, block_count)));
+	}
+	pipeline.total_tasks += tasks.size();
+	auto &scheduler = TaskScheduler::GetScheduler(context);
+	for (auto &task : tasks) {
+		scheduler.ScheduleTask(pipeline.token, move(task));
+	}
 }
 
 //===--------------------------------------------------------------------===//
 // GetChunkInternal
 //===--------------------------------------------------------------------===//
+//! The rows of the probe side of a thread, radix partitioned in the same way as the HT. The partitions are serialized
+//! chunk by chunk into buffer-managed blocks, which are written to the temporary directory when memory runs out.
+class ProbeSpill {
+public:
+	ProbeSpill(BufferManager &buffer_manager, vector<LogicalType> types, idx_t partition_count)
+	    : buffer_manager(buffer_manager), types(move(types)), partitions(partition_count), write_offset(0) {
+	}
+
+	//! Appends the selected rows of the chunk to a partition
+	void Append(DataChunk &chunk, const SelectionVector &sel, idx_t count, idx_t partition_idx) {
+		auto &partition = partitions[partition_idx];
+		if (partition.chunk.ColumnCount() == 0) {
+			partition.chunk.Initialize(types);
+		}
+		if (partition.chunk.size() + count > STANDARD_VECTOR_SIZE) {
+			Flush(partition_idx);
+		}
+		for (idx_t col_idx = 0; col_idx < chunk.ColumnCount(); col_idx++) {
+			VectorOperations::Copy(chunk.data[col_idx], partition.chunk.data[col_idx], sel, count, 0,
+			                       partition.chunk.size());
+		}
+		partition.chunk.SetCardinality(partition.chunk.size() + count);
+	}
+	//! Writes the rows that are still buffered to the blocks
+	void Finalize() {
+		for (idx_t partition_idx = 0; partition_idx < partitions.size(); partition_idx++) {
+			Flush(partition_idx);
+			partitions[partition_idx].chunk.Destroy();
+		}
+		write_handle.reset();
+	}
+	//! Whether or not the partition has any spilled rows
+	bool HasRows(idx_t partition_idx) {
+		return !partitions[partition_idx].chunks.empty();
+	}
+	//! Reads the spilled chunk at the given position of a partition, returns false if the partition is exhausted
+	bool Scan(idx_t partition_idx, idx_t &position, DataChunk &result) {
+		auto &chunks = partitions[partition_idx].chunks;
+		if (position >= chunks.size()) {
+			return false;
+		}
+		auto &spilled = chunks[position++];
+		auto handle = buffer_manager.Pin(blocks[spilled.block_idx]);
+		BufferedDeserializer source(handle->node->buffer + spilled.offset, spilled.size);
+		result.Destroy();
+		result.Deserialize(source);
+		return true;
+	}
+
+private:
+	struct SpilledChunk {
+		idx_t block_idx;
+		idx_t offset;
+		idx_t size;
+	};
+	struct Partition {
+		//! The rows that have not been written to the blocks yet
+		DataChunk chunk;
+		//! The chunks of the partition that have been written to the blocks
+		vector<SpilledChunk> chunks;
+	};
+
+	void Flush(idx_t partition_idx) {
+		auto &partition = partitions[partition_idx];
+		if (partition.chunk.size() == 0) {
+			return;
+		}
+		BufferedSerializer serializer;
+		partition.chunk.Serialize(serializer);
+		auto blob = serializer.GetData();
+		if (!write_handle || write_offset + blob.size > write_handle->node->size) {
+			// the chunk does not fit in the current block: continue in a new block
+			auto alloc_size = MaxValue<idx_t>(Storage::BLOCK_ALLOC_SIZE, blob.size + Storage::BLOCK_HEADER_SIZE);
+			blocks.push_back(buffer_manager.RegisterMemory(alloc_size, false));
+			write_handle = buffer_manager.Pin(blocks.back());
+			write_offset = 0;
+		}
+		memcpy(write_handle->node->buffer + write_offset, blob.data.get(), blob.size);
+		partition.chunks.push_back(SpilledChunk {blocks.size() - 1, write_offset, blob.size});
+		write_offset += blob.size;
+		partition.chunk.Reset();
+	}
+
+	BufferManager &buffer_manager;
+	vector<LogicalType> types;
+	vector<Partition> partitions;
+	vector<shared_ptr<BlockHandle>> blocks;
+	//! The block that is currently written to
+	unique_ptr<BufferHandle> write_handle;
+	idx_t write_offset;
+};
+
 class PhysicalHashJoinState : public PhysicalOperatorState {
 public:
 	PhysicalHashJoinState(PhysicalOperator &op, PhysicalOperator *left, PhysicalOperator *right,
@@ -160,6 +454,12 @@ public:
 	DataChunk join_keys;
 	ExpressionExecutor probe_executor;
 	unique_ptr<JoinHashTable::ScanStructure> scan_structure;
+	//! The probe side of this thread, only used if the HT is partitioned
+	unique_ptr<ProbeSpill> probe_spill;
+	//! The partition that is currently probed
+	idx_t partition_idx = 0;
+	//! The position of the next spilled chunk within the current partition
+	idx_t spill_position = 0;
 };
 
 unique_ptr<PhysicalOperatorState> PhysicalHashJoin::GetOperatorState() {
@@ -222,6 +522,10 @@ void PhysicalHashJoin::GetChunkInternal(ExecutionContext &context, DataChunk &ch
 void PhysicalHashJoin::ProbeHashTable(ExecutionContext &context, DataChunk &chunk, PhysicalOperatorState *state_) {
 	auto state = reinterpret_cast<PhysicalHashJoinState *>(state_);
 	auto &sink = (HashJoinGlobalState &)*sink_state;
+	if (!sink.partitions.empty()) {
+		ProbePartitions(context, chunk, state_);
+		return;
+	}
 
 	if (state->child_chunk.size() > 0 && state->scan_structure) {
 		// still have elements remaining from the previous probe (i.e. we got
@@ -253,4 +557,117 @@ void PhysicalHashJoin::ProbeHashTable(ExecutionContext &context, DataChunk &chun
 	} while (chunk.size() == 0);
 }
 
+//! Pins a partition of the HT, constructing its pointer table if no other thread is probing it
+static void PinPartition(HashJoinGlobalState &sink, idx_t partition_idx) {
+	lock_guard<mutex> partition_guard(sink.partition_lock);
+	if (sink.partition_users[partition_idx]++ == 0) {
+		sink.partitions[partition_idx]->Finalize();
+	}
+}
+
+//! Unpins a partition of the HT, releasing its pointer table if no other thread is probing it
+static void UnpinPartition(HashJoinGlobalState &sink, idx_t partition_idx) {
+	lock_guard<mutex> partition_guard(sink.partition_lock);
+	D_ASSERT(sink.partition_users[partition_idx] > 0);
+	if (--sink.partition_users[partition_idx] == 0) {
+		sink.partitions[partition_idx]->Unpin();
+	}
+}
+
+//! Moves the state to the next partition that has probe rows (if any), and pins it
+static void NextPartition(HashJoinGlobalState &sink, PhysicalHashJoinState &state) {
+	auto &spill = *state.probe_spill;
+	while (state.partition_idx < sink.partitions.size() && !spill.HasRows(state.partition_idx)) {
+		state.partition_idx++;
+	}
+	state.spill_position = 0;
+	if (state.partition_idx < sink.partitions.size()) {
+		PinPartition(sink, state.partition_idx);
+	}
+}
+
+void PhysicalHashJoin::PartitionProbeSide(ExecutionContext &context, PhysicalOperatorState *state_) {
+	auto state = reinterpret_cast<PhysicalHashJoinState *>(state_);
+	auto &sink = (HashJoinGlobalState &)*sink_state;
+	auto &spill = *state->probe_spill;
+
+	Vector hashes(LogicalType::HASH);
+	SelectionVector sel(STANDARD_VECTOR_SIZE);
+	vector<idx_t> partition_counts(sink.partitions.size());
+	vector<idx_t> partition_offsets(sink.partitions.size());
+	while (true) {
+		children[0]->GetChunk(context, state->child_chunk, state->child_state.get());
+		if (state->child_chunk.size() == 0) {
+			break;
+		}
+		idx_t count = state->child_chunk.size();
+		state->probe_executor.Execute(state->child_chunk, state->join_keys);
+		// rows with NULL keys never find a match, they can be assigned to any partition
+		sink.hash_table->Hash(state->join_keys, FlatVector::IncrementalSelectionVector, count, hashes);
+		hashes.Normalify(count);
+		auto hash_data = FlatVector::GetData<hash_t>(hashes);
+		// compute a selection vector that groups the rows by partition
+		std::fill(partition_counts.begin(), partition_counts.end(), 0);
+		for (idx_t i = 0; i < count; i++) {
+			partition_counts[JoinHashTable::RadixPartition(hash_data[i], sink.radix_bits)]++;
+		}
+		idx_t offset = 0;
+		for (idx_t partition_idx = 0; partition_idx < partition_counts.size(); partition_idx++) {
+			partition_offsets[partition_idx] = offset;
+			offset += partition_counts[partition_idx];
+		}
+		for (idx_t i = 0; i < count; i++) {
+			sel.set_index(partition_offsets[JoinHashTable::RadixPartition(hash_data[i], sink.radix_bits)]++, i);
+		}
+		offset = 0;
+		for (idx_t partition_idx = 0; partition_idx < partition_counts.size(); partition_idx++) {
+			if (partition_counts[partition_idx] > 0) {
+				SelectionVector partition_sel(sel.data() + offset);
+				spill.Append(state->child_chunk, partition_sel, partition_counts[partition_idx], partition_idx);
+			}
+			offset += partition_counts[partition_idx];
+		}
+	}
+	spill.Finalize();
+}
+
+void PhysicalHashJoin::ProbePartitions(ExecutionContext &context, DataChunk &chunk, PhysicalOperatorState *state_) {
+	auto state = reinterpret_cast<PhysicalHashJoinState *>(state_);
+	auto &sink = (HashJoinGlobalState &)*sink_state;
+	if (!state->probe_spill) {
+		// first partition the entire probe side of this thread, then join it partition by partition
+		state->probe_spill = make_unique<ProbeSpill>(BufferManager::GetBufferManager(context.client),
+		                                             children[0]->GetTypes(), sink.partitions.size());
+		PartitionProbeSide(context, state_);
+		state->partition_idx = 0;
+		NextPartition(sink, *state);
+	}
+	while (state->partition_idx < sink.partitions.size()) {
+		auto &hash_table = *sink.partitions[state->partition_idx];
+		if (state->child_chunk.size() > 0 && state->scan_structure) {
+			// still have elements remaining from the previous probe
+			state->scan_structure->Next(state->join_keys, state->child_chunk, chunk);
+			if (chunk.size() > 0) {
+				return;
+			}
+			state->scan_structure = nullptr;
+		}
+		if (!state->probe_spill->Scan(state->partition_idx, state->spill_position, state->child_chunk)) {
+			// finished probing this partition: move on to the next one
+			UnpinPartition(sink, state->partition_idx);
+			state->partition_idx++;
+			NextPartition(sink, *state);
+			continue;
+		}
+		if (hash_table.size() == 0 && (join_type == JoinType::INNER || join_type == JoinType::SEMI)) {
+			// empty partition with INNER or SEMI join means empty result for the rows of this partition
+			continue;
+		}
+		// resolve the join keys for the spilled chunk and probe the partition
+		state->probe_executor.Execute(state->child_chunk, state->join_keys);
+		state->scan_structure = hash_table.Probe(state->join_keys);
+	}
+	state->child_chunk.Reset();
+}
+
 } // namespace duckdb
@@ -0,0 +1,637 @@
+#include "duckdb/execution/operator/join/physical_iejoin.hpp"
+
+#include "duckdb/common/types/chunk_collection.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+
+#include <cstring>
+
+namespace duckdb {
+
+PhysicalIEJoin::PhysicalIEJoin(LogicalOperator &op, unique_ptr<PhysicalOperator> left,
+                               unique_ptr<PhysicalOperator> right, vector<JoinCondition> cond, JoinType join_type)
+    : PhysicalComparisonJoin(op, PhysicalOperatorType::IE_JOIN, move(cond), join_type) {
+	D_ASSERT(CanUseIEJoin(conditions, join_type));
+	for (idx_t i = 0; i < conditions.size(); i++) {
+		auto &cond = conditions[i];
+		D_ASSERT(cond.left->return_type == cond.right->return_type);
+		join_key_types.push_back(cond.left->return_type);
+		// the build-side rows that satisfy the first condition sort after the probe-side key, the rows that satisfy the
+		// second condition sort before it
+		bool less_than = cond.comparison == ExpressionType::COMPARE_LESSTHAN ||
+		                 cond.comparison == ExpressionType::COMPARE_LESSTHANOREQUALTO;
+		auto order_type = (i == 0) == less_than ? OrderType::ASCENDING : OrderType::DESCENDING;
+		vector<LogicalType> key_types {cond.left->return_type};
+		key_layouts.push_back(make_unique<SortKeyLayout>(key_types, vector<OrderType> {order_type},
+		                                                 vector<OrderByNullType> {OrderByNullType::NULLS_LAST}));
+	}
+	children.push_back(move(left));
+	children.push_back(move(right));
+}
+
+static bool IsStrict(ExpressionType comparison) {
+	return comparison == ExpressionType::COMPARE_LESSTHAN || comparison == ExpressionType::COMPARE_GREATERTHAN;
+}
+
+bool PhysicalIEJoin::CanUseIEJoin(vector<JoinCondition> &conditions, JoinType join_type) {
+	if (join_type != JoinType::INNER || conditions.size() != 2) {
+		return false;
+	}
+	for (auto &cond : conditions) {
+		switch (cond.comparison) {
+		case ExpressionType::COMPARE_LESSTHAN:
+		case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+		case ExpressionType::COMPARE_GREATERTHAN:
+		case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+			break;
+		default:
+			return false;
+		}
+		if (cond.null_values_are_equal || cond.left->return_type != cond.right->return_type) {
+			return false;
+		}
+		// only keys whose order is fully determined by their encoded sort keys
+		switch (cond.left->return_type.InternalType()) {
+		case PhysicalType::INT8:
+		case PhysicalType::INT16:
+		case PhysicalType::INT32:
+		case PhysicalType::INT64:
+		case PhysicalType::INT128:
+		case PhysicalType::UINT8:
+		case PhysicalType::UINT16:
+		case PhysicalType::UINT32:
+		case PhysicalType::UINT64:
+			break;
+		default:
+			return false;
+		}
+	}
+	return true;
+}
+
+//===--------------------------------------------------------------------===//
+// Sink
+//===--------------------------------------------------------------------===//
+//! A sorted run of the build-side rows collected by a single thread
+struct IEJoinRun {
+	//! The entries sorted on the first key
+	unique_ptr<data_t[]> entries_x;
+	//! The entries sorted on the second key
+	unique_ptr<data_t[]> entries_y;
+	//! The amount of entries
+	idx_t count;
+	//! The index of the first row of the run in the global collection
+	idx_t base;
+};
+
+class IEJoinLocalState : public LocalSinkState {
+public:
+	IEJoinLocalState(vector<JoinCondition> &conditions) {
+		vector<LogicalType> condition_types;
+		for (auto &cond : conditions) {
+			rhs_executor.AddExpression(*cond.right);
+			condition_types.push_back(cond.right->return_type);
+		}
+		join_keys.Initialize(condition_types);
+	}
+
+	//! The chunk holding the right condition
+	DataChunk join_keys;
+	//! The executor of the RHS condition
+	ExpressionExecutor rhs_executor;
+	//! The build-side rows collected by this thread
+	ChunkCollection right_chunks;
+	//! The join keys of the build-side rows collected by this thread
+	ChunkCollection right_keys;
+};
+
+class IEJoinGlobalState : public GlobalOperatorState {
+public:
+	IEJoinGlobalState() : count(0) {
+	}
+
+	//! The lock for updating the global state
+	mutex lock;
+	//! The materialized data of the RHS
+	ChunkCollection right_chunks;
+	//! The sorted runs of the threads, these are merged in the Finalize
+	vector<IEJoinRun> runs;
+	//! The entries of all build-side rows sorted on the first key
+	unique_ptr<data_t[]> sorted_x;
+	//! The entries of all build-side rows sorted on the second key
+	unique_ptr<data_t[]> sorted_y;
+	//! The position of every build-side row within sorted_x
+	unique_ptr<idx_t[]> rank_x;
+	//! The amount of build-side rows
+	idx_t count;
+};
+
+unique_ptr<GlobalOperatorState> PhysicalIEJoin::GetGlobalState(ClientContext &context) {
+	return make_unique<IEJoinGlobalState>();
+}
+
+unique_ptr<LocalSinkState> PhysicalIEJoin::GetLocalSinkState(ExecutionContext &context) {
+	return make_unique<IEJoinLocalState>(conditions);
+}
+
+//! Appends the rows of which none of the keys are NULL: rows with a NULL key never satisfy an inequality
+static void AppendNotNull(DataChunk &input, DataChunk &keys, ChunkCollection &input_collection,
+                          ChunkCollection &key_collection) {
+	auto key_data = keys.Orrify();
+	SelectionVector sel(STANDARD_VECTOR_SIZE);
+	idx_t count = 0;
+	for (idx_t i = 0; i < keys.size(); i++) {
+		bool has_null = false;
+		for (idx_t col_idx = 0; col_idx < keys.ColumnCount(); col_idx++) {
+			auto &vdata = key_data[col_idx];
+			if ((*vdata.nullmask)[vdata.sel->get_index(i)]) {
+				has_null = true;
+				break;
+			}
+		}
+		if (!has_null) {
+			sel.set_index(count++, i);
+		}
+	}
+	if (count == keys.size()) {
+		input_collection.Append(input);
+		key_collection.Append(keys);
+		return;
+	}
+	if (count == 0) {
+		return;
+	}
+	auto input_types = input.GetTypes();
+	auto key_types = keys.GetTypes();
+	DataChunk sliced_input, sliced_keys;
+	sliced_input.InitializeEmpty(input_types);
+	sliced_input.Slice(input, sel, count);
+	sliced_keys.InitializeEmpty(key_types);
+	sliced_keys.Slice(keys, sel, count);
+	input_collection.Append(sliced_input);
+	key_collection.Append(sliced_keys);
+}
+
+void PhysicalIEJoin::Sink(ExecutionContext &context, GlobalOperatorState &state, LocalSinkState &lstate_,
+                          DataChunk &input) {
+	auto &lstate = (IEJoinLocalState &)lstate_;
+
+	// resolve the join keys for this chunk
+	lstate.rhs_executor.SetChunk(input);
+
+	lstate.join_keys.Reset();
+	lstate.join_keys.SetCardinality(input);
+	for (idx_t k = 0; k < conditions.size(); k++) {
+		lstate.rhs_executor.ExecuteExpression(k, lstate.join_keys.data[k]);
+	}
+	AppendNotNull(input, lstate.join_keys, lstate.right_chunks, lstate.right_keys);
+}
+
+unique_ptr<data_t[]> PhysicalIEJoin::EncodeKeys(ChunkCollection &keys, idx_t key_idx) {
+	auto &layout = *key_layouts[key_idx];
+	auto entries = unique_ptr<data_t[]>(new data_t[keys.Count() * layout.entry_size]);
+	vector<LogicalType> key_types {join_key_types[key_idx]};
+	DataChunk key_chunk;
+	key_chunk.InitializeEmpty(key_types);
+	idx_t row = 0;
+	for (auto &chunk : keys.Chunks()) {
+		key_chunk.data[0].Reference(chunk->data[key_idx]);
+		key_chunk.SetCardinality(*chunk);
+		auto target = entries.get() + row * layout.entry_size;
+		layout.Encode(key_chunk, target);
+		for (idx_t i = 0; i < chunk->size(); i++) {
+			layout.SetRow(target + i * layout.entry_size, row + i);
+		}
+		row += chunk->size();
+	}
+	return entries;
+}
+
+void PhysicalIEJoin::Combine(ExecutionContext &context, GlobalOperatorState &state, LocalSinkState &lstate_) {
+	auto &gstate = (IEJoinGlobalState &)state;
+	auto &lstate = (IEJoinLocalState &)lstate_;
+	if (lstate.right_chunks.Count() == 0) {
+		return;
+	}
+	// sort the rows of this thread on both keys before they are handed to the global state
+	IEJoinRun run;
+	run.count = lstate.right_chunks.Count();
+	run.entries_x = EncodeKeys(lstate.right_keys, 0);
+	key_layouts[0]->Sort(run.entries_x.get(), run.count, sort_tie_compare_t());
+	run.entries_y = EncodeKeys(lstate.right_keys, 1);
+	key_layouts[1]->Sort(run.entries_y.get(), run.count, sort_tie_compare_t());
+
+	lock_guard<mutex> glock(gstate.lock);
+	run.base = gstate.right_chunks.Count();
+	gstate.right_chunks.Append(lstate.right_chunks);
+	gstate.runs.push_back(move(run));
+}
+
+//===--------------------------------------------------------------------===//
+// Finalize
+//===--------------------------------------------------------------------===//
+struct IEJoinSortedEntries {
+	unique_ptr<data_t[]> entries;
+	idx_t count;
+};
+
+static IEJoinSortedEntries MergeEntries(SortKeyLayout &layout, IEJoinSortedEntries &left, IEJoinSortedEntries &right) {
+	auto entry_size = layout.entry_size;
+	IEJoinSortedEntries result;
+	result.count = left.count + right.count;
+	result.entries = unique_ptr<data_t[]>(new data_t[result.count * entry_size]);
+	auto target = result.entries.get();
+	auto left_ptr = left.entries.get(), left_end = left_ptr + left.count * entry_size;
+	auto right_ptr = right.entries.get(), right_end = right_ptr + right.count * entry_size;
+	while (left_ptr < left_end && right_ptr < right_end) {
+		if (memcmp(right_ptr, left_ptr, layout.key_width) < 0) {
+			memcpy(target, right_ptr, entry_size);
+			right_ptr += entry_size;
+		} else {
+			memcpy(target, left_ptr, entry_size);
+			left_ptr += entry_size;
+		}
+		target += entry_size;
+	}
+	memcpy(target, left_ptr, left_end - left_ptr);
+	target += left_end - left_ptr;
+	memcpy(target, right_ptr, right_end - right_ptr);
+	return result;
+}
+
+//! Merges the sorted runs pairwise until a single sorted run remains
+static unique_ptr<data_t[]> MergeRuns(SortKeyLayout &layout, vector<IEJoinSortedEntries> runs) {
+	D_ASSERT(!runs.empty());
+	while (runs.size() > 1) {
+		vector<IEJoinSortedEntries> merged;
+		for (idx_t i = 0; i + 1 < runs.size(); i += 2) {
+			merged.push_back(MergeEntries(layout, runs[i], runs[i + 1]));
+		}
+		if (runs.size() % 2 == 1) {
+			merged.push_back(move(runs.back()));
+		}
+		runs = move(merged);
+	}
+	return move(runs[0].entries);
+}
+
+void PhysicalIEJoin::Finalize(Pipeline &pipeline, ClientContext &context, unique_ptr<GlobalOperatorState> state) {
+	auto &gstate = (IEJoinGlobalState &)*state;
+	gstate.count = gstate.right_chunks.Count();
+	if (gstate.count > 0) {
+		// the rows of a run reference the local collection of its thread: offset them into the global collection
+		vector<IEJoinSortedEntries> runs_x, runs_y;
+		for (auto &run : gstate.runs) {
+			for (idx_t i = 0; i < run.count; i++) {
+				auto entry_x = run.entries_x.get() + i * key_layouts[0]->entry_size;
+				key_layouts[0]->SetRow(entry_x, key_layouts[0]->GetRow(entry_x) + run.base);
+				auto entry_y = run.entries_y.get() + i * key_layouts[1]->entry_size;
+				key_layouts[1]->SetRow(entry_y, key_layouts[1]->GetRow(entry_y) + run.base);
+			}
+			runs_x.push_back(IEJoinSortedEntries {move(run.entries_x), run.count});
+			runs_y.push_back(IEJoinSortedEntries {move(run.entries_y), run.count});
+		}
+		gstate.runs.clear();
+		gstate.sorted_x = MergeRuns(*key_layouts[0], move(runs_x));
+		gstate.sorted_y = MergeRuns(*key_layouts[1], move(runs_y));
+
+		gstate.rank_x = unique_ptr<idx_t[]>(new idx_t[gstate.count]);
+		for (idx_t i = 0; i < gstate.count; i++) {
+			gstate.rank_x[key_layouts[0]->GetRow(gstate.sorted_x.get() + i * key_layouts[0]->entry_size)] = i;
+		}
+		// the probe threads gather the build-side columns from flat vectors
+		for (auto &chunk : gstate.right_chunks.Chunks()) {
+			chunk->Normalify();
+		}
+	}
+	PhysicalSink::Finalize(pipeline, context, move(state));
+}
+
+//===--------------------------------------------------------------------===//
+// GetChunkInternal
+//===--------------------------------------------------------------------===//
+class PhysicalIEJoinState : public PhysicalOperatorState {
+public:
+	PhysicalIEJoinState(PhysicalOperator &op, PhysicalOperator *left, vector<JoinCondition> &conditions)
+	    : PhysicalOperatorState(op, left), exhausted(false), has_block(false), left_count(0), left_position(0),
+	      right_position(0), scan_position(INVALID_INDEX) {
+		vector<LogicalType> condition_types;
+		for (auto &cond : conditions) {
+			lhs_executor.AddExpression(*cond.left);
+			condition_types.push_back(cond.left->return_type);
+		}
+		join_keys.Initialize(condition_types);
+	}
+
+	//! The executor of the LHS condition
+	ExpressionExecutor lhs_executor;
+	//! The chunk holding the left condition
+	DataChunk join_keys;
+	//! Whether or not the probe side is exhausted
+	bool exhausted;
+	//! Whether or not a block of probe-side rows is being joined
+	bool has_block;
+	//! The buffered block of probe-side rows
+	ChunkCollection left_chunks;
+	//! The join keys of the buffered probe-side rows
+	ChunkCollection left_keys;
+	//! The entries of the buffered probe-side rows sorted on the second key
+	unique_ptr<data_t[]> left_entries;
+	//! For every buffered probe-side row, the position in the build side sorted on the first key from which the
+	//! build-side rows satisfy the first condition
+	unique_ptr<idx_t[]> left_start;
+	//! The amount of buffered probe-side rows
+	idx_t left_count;
+	//! The position of the current probe-side row within left_entries
+	idx_t left_position;
+	//! The amount of build-side rows (in the order of the second key) that have been marked
+	idx_t right_position;
+	//! The position in the bit array from which the current probe-side row continues its scan, or INVALID_INDEX if
+	//! the scan of the current row has not started yet
+	idx_t scan_position;
+	//! The bit array of the marked build-side rows, ordered on the first key
+	vector<uint64_t> bits;
+	//! A bit for every word of the bit array that is set if the word has any bits set
+	vector<uint64_t> summary;
+};
+
+bool PhysicalIEJoin::BufferProbeBlock(ExecutionContext &context, PhysicalOperatorState *state_) {
+	auto state = reinterpret_cast<PhysicalIEJoinState *>(state_);
+	state->left_chunks.Reset();
+	state->left_keys.Reset();
+	while (!state->exhausted && state->left_chunks.Count() < PROBE_BLOCK_SIZE) {
+		children[0]->GetChunk(context, state->child_chunk, state->child_state.get());
+		if (state->child_chunk.size() == 0) {
+			state->exhausted = true;
+			break;
+		}
+		state->lhs_executor.SetChunk(state->child_chunk);
+
+		state->join_keys.Reset();
+		state->join_keys.SetCardinality(state->child_chunk);
+		for (idx_t k = 0; k < conditions.size(); k++) {
+			state->lhs_executor.ExecuteExpression(k, state->join_keys.data[k]);
+		}
+		AppendNotNull(state->child_chunk, state->join_keys, state->left_chunks, state->left_keys);
+	}
+	for (auto &chunk : state->left_chunks.Chunks()) {
+		chunk->Normalify();
+	}
+	return state->left_chunks.Count() > 0;
+}
+
+//! Returns the position of the first sorted entry that follows the key: the first entry with a larger key if strict,
+//! or the first entry with a larger or equal key otherwise
+static idx_t FindPosition(SortKeyLayout &layout, data_ptr_t entries, idx_t count, data_ptr_t key, bool strict) {
+	idx_t lower = 0, upper = count;
+	while (lower < upper) {
+		idx_t middle = lower + (upper - lower) / 2;
+		auto cmp = memcmp(entries + middle * layout.entry_size, key, layout.key_width);
+		if (cmp < 0 || (strict && cmp == 0)) {
+			lower = middle + 1;
+		} else {
+			upper = middle;
+		}
+	}
+	return lower;
+}
+
+void PhysicalIEJoin::InitializeProbeBlock(PhysicalOperatorState *state_) {
+	auto state = reinterpret_cast<PhysicalIEJoinState *>(state_);
+	auto &gstate = (IEJoinGlobalState &)*sink_state;
+	auto &layout_x = *key_layouts[0];
+	state->left_count = state->left_keys.Count();
+
+	// position the probe-side rows within the build side sorted on the first key
+	auto entries_x = EncodeKeys(state->left_keys, 0);
+	state->left_start = unique_ptr<idx_t[]>(new idx_t[state->left_count]);
+	bool strict = IsStrict(conditions[0].comparison);
+	for (idx_t i = 0; i < state->left_count; i++) {
+		auto entry = entries_x.get() + i * layout_x.entry_size;
+		state->left_start[i] = FindPosition(layout_x, gstate.sorted_x.get(), gstate.count, entry, strict);
+	}
+	// the probe-side rows are joined in the order of the second key, so every row only adds the build-side rows that
+	// satisfy its second condition but not that of the rows before it
+	state->left_entries = EncodeKeys(state->left_keys, 1);
+	key_layouts[1]->Sort(state->left_entries.get(), state->left_count, sort_tie_compare_t());
+
+	idx_t word_count = (gstate.count + 63) / 64;
+	state->bits.assign(word_count, 0);
+	state->summary.assign((word_count + 63) / 64, 0);
+	state->left_position = 0;
+	state->right_position = 0;
+	state->scan_position = INVALID_INDEX;
+	state->has_block = true;
+}
+
+static inline idx_t CountTrailingZeros(uint64_t value) {
+	D_ASSERT(value != 0);
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctzll(value);
+#else
+	idx_t count = 0;
+	while (!(value & 1)) {
+		count++;
+		value >>= 1;
+	}
+	return count;
+#endif
+}
+
+//! Returns the position of the first set bit at or after the given position, or count if there is none
+static idx_t NextSetBit(vector<uint64_t> &bits, vector<uint64_t> &summary, idx_t position, idx_t count) {
+	if (position >= count) {
+		return count;
+	}
+	idx_t word_idx = position / 64;
+	auto word = bits[word_idx] & (~uint64_t(0) << (position % 64));
+	if (word != 0) {
+		return word_idx * 64 + CountTrailingZeros(word);
+	}
+	// skip the empty words using the summary
+	word_idx++;
+	idx_t summary_idx = word_idx / 64;
+	if (summary_idx >= summary.size()) {
+		return count;
+	}
+	auto summary_word = summary[summary_idx] & (~uint64_t(0) << (word_idx % 64));
+	while (summary_word == 0) {
+		if (++summary_idx >= summary.size()) {
+			return count;
+		}
+		summary_word = summary[summary_idx];
+	}
+	word_idx = summary_idx * 64 + CountTrailingZeros(summary_word);
+	return word_idx * 64 + CountTrailingZeros(bits[word_idx]);
+}
+
+idx_t PhysicalIEJoin::JoinProbeBlock(PhysicalOperatorState *state_, idx_t left_rows[], idx_t right_rows[]) {
+	auto state = reinterpret_cast<PhysicalIEJoinState *>(state_);
+	auto &gstate = (IEJoinGlobalState &)*sink_state;
+	auto &layout_x = *key_layouts[0];
+	auto &layout_y = *key_layouts[1];
+	bool strict = IsStrict(conditions[1].comparison);
+
+	idx_t result_count = 0;
+	while (state->left_position < state->left_count) {
+		auto left_entry = state->left_entries.get() + state->left_position * layout_y.entry_size;
+		auto left_row = layout_y.GetRow(left_entry);
+		if (state->scan_position == INVALID_INDEX) {
+			// mark the build-side rows that satisfy the second condition for this row
+			while (state->right_position < gstate.count) {
+				auto right_entry = gstate.sorted_y.get() + state->right_position * layout_y.entry_size;
+				auto cmp = memcmp(right_entry, left_entry, layout_y.key_width);
+				if (cmp > 0 || (strict && cmp == 0)) {
+					break;
+				}
+				auto rank = gstate.rank_x[layout_y.GetRow(right_entry)];
+				state->bits[rank / 64] |= uint64_t(1) << (rank % 64);
+				state->summary[rank / 4096] |= uint64_t(1) << ((rank / 64) % 64);
+				state->right_position++;
+			}
+			state->scan_position = state->left_start[left_row];
+		}
+		// the marked rows from the start position also satisfy the first condition
+		while (true) {
+			auto position = NextSetBit(state->bits, state->summary, state->scan_position, gstate.count);
+			if (position >= gstate.count) {
+				break;
+			}
+			if (result_count == STANDARD_VECTOR_SIZE) {
+				// the output is full: continue from here in the next call
+				state->scan_position = position;
+				return result_count;
+			}
+			left_rows[result_count] = left_row;
+			right_rows[result_count] = layout_x.GetRow(gstate.sorted_x.get() + position * layout_x.entry_size);
+			result_count++;
+			state->scan_position = position + 1;
+		}
+		state->left_position++;
+		state->scan_position = INVALID_INDEX;
+	}
+	return result_count;
+}
+
+template <class T>
+static void TemplatedGatherColumn(ChunkCollection &source, idx_t column, const idx_t rows[], idx_t count,
+                                  Vector &result) {
+	auto result_data = FlatVector::GetData<T>(result);
+	auto &result_mask = FlatVector::Nullmask(result);
+	for (idx_t i = 0; i < count; i++) {
+		auto &vector = source.GetChunk(rows[i] / STANDARD_VECTOR_SIZE).data[column];
+		D_ASSERT(vector.vector_type == VectorType::FLAT_VECTOR);
+		auto idx = rows[i] % STANDARD_VECTOR_SIZE;
+		result_data[i] = FlatVector::GetData<T>(vector)[idx];
+		result_mask[i] = FlatVector::Nullmask(vector)[idx];
+	}
+}
+
+static void GatherStringColumn(ChunkCollection &source, idx_t column, const idx_t rows[], idx_t count,
+                               Vector &result) {
+	auto result_data = FlatVector::GetData<string_t>(result);
+	auto &result_mask = FlatVector::Nullmask(result);
+	for (idx_t i = 0; i < count; i++) {
+		auto &vector = source.GetChunk(rows[i] / STANDARD_VECTOR_SIZE).data[column];
+		D_ASSERT(vector.vector_type == VectorType::FLAT_VECTOR);
+		auto idx = rows[i] % STANDARD_VECTOR_SIZE;
+		if (FlatVector::Nullmask(vector)[idx]) {
+			result_mask[i] = true;
+			continue;
+		}
+		result_data[i] = StringVector::AddString(result, FlatVector::GetData<string_t>(vector)[idx]);
+	}
+}
+
+//! Gathers the values of the given rows of a column of the collection into the result vector
+static void GatherColumn(ChunkCollection &source, idx_t column, const idx_t rows[], idx_t count, Vector &result) {
+	switch (result.type.InternalType()) {
+	case PhysicalType::BOOL:
+		TemplatedGatherColumn<bool>(source, column, rows, count, result);
+		break;
+	case PhysicalType::INT8:
+		TemplatedGatherColumn<int8_t>(source, column, rows, count, result);
+		break;
+	case PhysicalType::INT16:
+		TemplatedGatherColumn<int16_t>(source, column, rows, count, result);
+		break;
+	case PhysicalType::INT32:
+		TemplatedGatherColumn<int32_t>(source, column, rows, count, result);
+		break;
+	case PhysicalType::INT64:
+		TemplatedGatherColumn<int64_t>(source, column, rows, count, result);
+		break;
+	case PhysicalType::UINT8:
+		TemplatedGatherColumn<uint8_t>(source, column, rows, count, result);
+		break;
+	case PhysicalType::UINT16:
+		TemplatedGatherColumn<uint16_t>(source, column, rows, count, result);
+		break;
+	case PhysicalType::UINT32:
+		TemplatedGatherColumn<uint32_t>(source, column, rows, count, result);
+		break;
+	case PhysicalType::UINT64:
+		TemplatedGatherColumn<uint64_t>(source, column, rows, count, result);
+		break;
+	case PhysicalType::INT128:
+		TemplatedGatherColumn<hugeint_t>(source, column, rows, count, result);
+		break;
+	case PhysicalType::FLOAT:
+		TemplatedGatherColumn<float>(source, column, rows, count, result);
+		break;
+	case PhysicalType::DOUBLE:
+		TemplatedGatherColumn<double>(source, column, rows, count, result);
+		break;
+	case PhysicalType::INTERVAL:
+		TemplatedGatherColumn<interval_t>(source, column, rows, count, result);
+		break;
+	case PhysicalType::VARCHAR:
+		GatherStringColumn(source, column, rows, count, result);
+		break;
+	default:
+		for (idx_t i = 0; i < count; i++) {
+			result.SetValue(i, source.GetValue(column, rows[i]));
+		}
+		break;
+	}
+}
+
+void PhysicalIEJoin::GetChunkInternal(ExecutionContext &context, DataChunk &chunk, PhysicalOperatorState *state_) {
+	auto state = reinterpret_cast<PhysicalIEJoinState *>(state_);
+	auto &gstate = (IEJoinGlobalState &)*sink_state;
+	if (gstate.count == 0) {
+		// empty build side: the inner join has no result
+		state->finished = true;
+		return;
+	}
+	idx_t left_rows[STANDARD_VECTOR_SIZE], right_rows[STANDARD_VECTOR_SIZE];
+	while (true) {
+		if (!state->has_block) {
+			if (!BufferProbeBlock(context, state)) {
+				state->finished = true;
+				return;
+			}
+			InitializeProbeBlock(state);
+		}
+		auto result_count = JoinProbeBlock(state, left_rows, right_rows);
+		if (result_count == 0) {
+			// all rows of the block have been joined
+			state->has_block = false;
+			continue;
+		}
+		auto left_columns = children[0]->types.size();
+		for (idx_t i = 0; i < left_columns; i++) {
+			GatherColumn(state->left_chunks, i, left_rows, result_count, chunk.data[i]);
+		}
+		for (idx_t i = 0; i < children[1]->types.size(); i++) {
+			GatherColumn(gstate.right_chunks, i, right_rows, result_count, chunk.data[left_columns + i]);
+		}
+		chunk.SetCardinality(result_count);
+		return;
+	}
+}
+
+unique_ptr<PhysicalOperatorState> PhysicalIEJoin::GetOperatorState() {
+	return make_unique<PhysicalIEJoinState>(*this, children[0].get(), conditions);
+}
+
+} // namespace duckdb
@@ -1,84 +1,408 @@
 #include "duckdb/execution/operator/order/physical_order.hpp"
 
 #include "duckdb/common/assert.hpp"
-#include "duckdb/common/value_operations/value_operations.hpp"
-#include "duckdb/common/vector_operations/vector_operations.hpp"
+#include "duckdb/common/types/sort_key.hpp"
 #include "duckdb/execution/expression_executor.hpp"
-#include "duckdb/storage/data_table.hpp"
+#include "duckdb/execution/operator/order/sorted_run.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/parallel/pipeline.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
 
 namespace duckdb {
 
 class PhysicalOrderOperatorState : public PhysicalOperatorState {
 public:
-	PhysicalOrderOperatorState(PhysicalOperator &op, PhysicalOperator *child)
-	    : PhysicalOperatorState(op, child), position(0) {
+	PhysicalOrderOperatorState(PhysicalOperator &op, PhysicalOperator *child) : PhysicalOperatorState(op, child) {
 	}
 
-	idx_t position;
+	//! The reader of the final sorted run
+	unique_ptr<SortedRunReader> reader;
 };
 
 //===--------------------------------------------------------------------===//
 // Sink
 //===--------------------------------------------------------------------===//
+static SortKeyLayout CreateSortKeyLayout(PhysicalOrder &op) {
+	vector<LogicalType> types;
+	vector<OrderType> order_types;
+	vector<OrderByNullType> null_orders;
+	for (auto &order : op.orders) {
+		types.push_back(order.expression->return_type);
+		order_types.push_back(order.type);
+		null_orders.push_back(order.null_order);
+	}
+	return SortKeyLayout(types, move(order_types), move(null_orders));
+}
+
+static SortedRowLayout CreateSortedRowLayout(PhysicalOrder &op, SortKeyLayout &layout) {
+	vector<LogicalType> types;
+	for (auto &order : op.orders) {
+		types.push_back(order.expression->return_type);
+	}
+	return SortedRowLayout(layout, types, op.types);
+}
+
+//! A merge round in progress: every pair of runs is merged into a run, every partition of the merge path of a pair
+//! writes its own blocks
+struct MergeRound {
+	//! The merged runs (or the unpaired run that is carried over to the next round)
+	vector<SortedRun> runs;
+	//! The blocks written by the partitions of every pair
+	vector<vector<vector<SortedBlock>>> partitions;
+};
+
 class OrderByGlobalOperatorState : public GlobalOperatorState {
 public:
-	//! The lock for updating the global aggregate state
+	OrderByGlobalOperatorState(ClientContext &context, PhysicalOrder &op)
+	    : buffer_manager(BufferManager::GetBufferManager(context)), layout(CreateSortKeyLayout(op)),
+	      row_layout(CreateSortedRowLayout(op, layout)) {
+	}
+
+	//! The lock for updating the global order state
 	mutex lock;
-	//! The sorted data
-	ChunkCollection sorted_data;
-	//! The sorted vector
-	unique_ptr<idx_t[]> sorted_vector;
+	BufferManager &buffer_manager;
+	//! The layout of the sort keys
+	SortKeyLayout layout;
+	//! The layout of the rows stored in the sorted runs
+	SortedRowLayout row_layout;
+	//! The nested payload columns sunk by the threads, the rows of the sorted runs reference them
+	vector<unique_ptr<ChunkCollection>> nested_data;
+	//! The sorted runs, a single run remains after the final merge round
+	vector<SortedRun> runs;
+	//! The merge round that is currently executing
+	MergeRound round;
+	//! The amount of tasks of the current merge round that have not finished yet
+	idx_t pending_tasks = 0;
+	//! Whether or not a merge task has failed
+	bool failed = false;
+};
+
+class OrderByLocalState : public LocalSinkState {
+public:
+	//! The executor of the ORDER BY expressions
+	ExpressionExecutor executor;
+	//! The chunk holding the evaluated ORDER BY expressions
+	DataChunk keys_chunk;
+	//! The chunk referencing the nested payload columns of the input
+	DataChunk nested_chunk;
+	//! The amount of memory the unsorted rows of this thread may use before they are sorted into a run
+	idx_t run_budget;
+
+	//! The pinned blocks holding the serialized rows sunk since the last run was written
+	vector<unique_ptr<BufferHandle>> row_blocks;
+	//! The amount of bytes used in the last row block
+	idx_t row_block_offset = 0;
+	//! The sort key entries of the unsorted rows, their row field holds the row block index (upper 32 bits) and the
+	//! offset of the row within the block (lower 32 bits)
+	unique_ptr<data_t[]> entries;
+	//! The amount of entries that fit in the entries buffer
+	idx_t capacity = 0;
+	//! The amount of unsorted rows
+	idx_t count = 0;
+	//! The amount of memory used by the unsorted rows and their entries
+	idx_t memory_usage = 0;
+
+	//! The collection of the nested payload columns of this thread (owned by the global state), if any
+	ChunkCollection *nested_data = nullptr;
+	//! The index of the nested collection in the global state
+	idx_t nested_index = 0;
+
+	data_ptr_t GetRow(idx_t row) {
+		return row_blocks[row >> 32]->Ptr() + (row & 0xFFFFFFFF);
+	}
 };
 
 unique_ptr<GlobalOperatorState> PhysicalOrder::GetGlobalState(ClientContext &context) {
-	return make_unique<OrderByGlobalOperatorState>();
+	return make_unique<OrderByGlobalOperatorState>(context, *this);
+}
+
+unique_ptr<LocalSinkState> PhysicalOrder::GetLocalSinkState(ExecutionContext &context) {
+	auto result = make_unique<OrderByLocalState>();
+	vector<LogicalType> key_types;
+	for (auto &order : orders) {
+		key_types.push_back(order.expression->return_type);
+		result->executor.AddExpression(*order.expression);
+	}
+	result->keys_chunk.Initialize(key_types);
+	// the unsorted rows of all threads together use at most a fraction of the memory limit
+	auto &buffer_manager = BufferManager::GetBufferManager(context.client);
+	idx_t threads = TaskScheduler::GetScheduler(context.client).NumberOfThreads();
+	result->run_budget = buffer_manager.GetMaxMemory() / (RUN_MEMORY_FRACTION * threads);
+	result->run_budget = MaxValue<idx_t>(MinValue<idx_t>(result->run_budget, MAX_RUN_SIZE), Storage::BLOCK_ALLOC_SIZE);
+	return move(result);
+}
+
+//! Sorts the unsorted rows of the thread and writes them to buffer-managed blocks as a new sorted run
+static void SortLocalRows(OrderByGlobalOperatorState &gstate, OrderByLocalState &lstate) {
+	auto &layout = gstate.layout;
+	if (lstate.count == 0) {
+		return;
+	}
+	layout.Sort(lstate.entries.get(), lstate.count, [&](data_ptr_t left, data_ptr_t right) {
+		return gstate.row_layout.Compare(lstate.GetRow(layout.GetRow(left)), lstate.GetRow(layout.GetRow(right)));
+	});
+
+	SortedRunWriter writer(gstate.buffer_manager, layout);
+	auto entry = lstate.entries.get();
+	for (idx_t i = 0; i < lstate.count; i++) {
+		writer.Append(entry, lstate.GetRow(layout.GetRow(entry)));
+		entry += layout.entry_size;
+	}
+	SortedRun run;
+	run.blocks = writer.Finish();
+	run.count = lstate.count;
+
+	// release the unsorted rows
+	lstate.row_blocks.clear();
+	lstate.row_block_offset = 0;
+	lstate.count = 0;
+	lstate.memory_usage = 0;
+
+	lock_guard<mutex> glock(gstate.lock);
+	gstate.runs.push_back(move(run));
 }
 
 void PhysicalOrder::Sink(ExecutionContext &context, GlobalOperatorState &state, LocalSinkState &lstate,
                          DataChunk &input) {
-	// concatenate all the data of the child chunks
 	auto &gstate = (OrderByGlobalOperatorState &)state;
-	lock_guard<mutex> glock(gstate.lock);
-	gstate.sorted_data.Append(input);
+	auto &local_state = (OrderByLocalState &)lstate;
+	auto &layout = gstate.layout;
+	auto &row_layout = gstate.row_layout;
+
+	// compute the ORDER BY expressions and encode their sort keys
+	local_state.keys_chunk.Reset();
+	local_state.executor.Execute(input, local_state.keys_chunk);
+	if (local_state.count + input.size() > local_state.capacity) {
+		// grow the entries buffer
+		auto new_capacity = MaxValue<idx_t>(local_state.capacity * 2, STANDARD_VECTOR_SIZE);
+		auto new_entries = unique_ptr<data_t[]>(new data_t[new_capacity * layout.entry_size]);
+		if (local_state.count > 0) {
+			memcpy(new_entries.get(), local_state.entries.get(), local_state.count * layout.entry_size);
+		}
+		local_state.entries = move(new_entries);
+		local_state.capacity = new_capacity;
+	}
+	auto entries = local_state.entries.get() + local_state.count * layout.entry_size;
+	layout.Encode(local_state.keys_chunk, entries);
+
+	// the nested payload columns are stored in a collection of this thread
+	idx_t first_nested_row = 0;
+	if (!row_layout.nested_columns.empty()) {
+		if (!local_state.nested_data) {
+			lock_guard<mutex> glock(gstate.lock);
+			local_state.nested_index = gstate.nested_data.size();
+			gstate.nested_data.push_back(make_unique<ChunkCollection>());
+			local_state.nested_data = gstate.nested_data.back().get();
+			local_state.nested_chunk.InitializeEmpty(row_layout.nested_types);
+		}
+		for (idx_t nested_idx = 0; nested_idx < row_layout.nested_columns.size(); nested_idx++) {
+			local_state.nested_chunk.data[nested_idx].Reference(input.data[row_layout.nested_columns[nested_idx]]);
+		}
+		local_state.nested_chunk.SetCardinality(input.size());
+		first_nested_row =
+		    local_state.nested_index << SortedRowLayout::NESTED_ROW_BITS | local_state.nested_data->Count();
+		local_state.nested_data->Append(local_state.nested_chunk);
+	}
+
+	// serialize the rows into the row blocks
+	uint32_t sizes[STANDARD_VECTOR_SIZE];
+	data_ptr_t locations[STANDARD_VECTOR_SIZE];
+	row_layout.ComputeSizes(local_state.keys_chunk, input, sizes);
+	for (idx_t i = 0; i < input.size(); i++) {
+		if (local_state.row_blocks.empty() ||
+		    local_state.row_block_offset + sizes[i] > local_state.row_blocks.back()->node->size) {
+			auto alloc_size = MaxValue<idx_t>(Storage::BLOCK_ALLOC_SIZE, sizes[i] + Storage::BLOCK_HEADER_SIZE);
+			local_state.row_blocks.push_back(gstate.buffer_manager.Allocate(alloc_size));
+			local_state.row_block_offset = 0;
+			local_state.memory_usage += alloc_size;
+		}
+		idx_t block_idx = local_state.row_blocks.size() - 1;
+		locations[i] = local_state.row_blocks.back()->Ptr() + local_state.row_block_offset;
+		layout.SetRow(entries + i * layout.entry_size, block_idx << 32 | local_state.row_block_offset);
+		local_state.row_block_offset += sizes[i];
+	}
+	row_layout.Serialize(local_state.keys_chunk, input, sizes, locations, first_nested_row);
+	local_state.count += input.size();
+	local_state.memory_usage += input.size() * layout.entry_size;
+
+	if (local_state.memory_usage >= local_state.run_budget) {
+		// the budget of this thread is exhausted: sort the rows into a run that can be evicted from memory
+		SortLocalRows(gstate, local_state);
+	}
+}
+
+void PhysicalOrder::Combine(ExecutionContext &context, GlobalOperatorState &state, LocalSinkState &lstate) {
+	auto &gstate = (OrderByGlobalOperatorState &)state;
+	auto &local_state = (OrderByLocalState &)lstate;
+	SortLocalRows(gstate, local_state);
 }
 
 //===--------------------------------------------------------------------===//
-// Finalize
+// Merge
 //===--------------------------------------------------------------------===//
-void PhysicalOrder::Finalize(Pipeline &pipeline, ClientContext &context, unique_ptr<GlobalOperatorState> state) {
-	// finalize: perform the actual sorting
-	auto &sink = (OrderByGlobalOperatorState &)*state;
-	ChunkCollection &big_data = sink.sorted_data;
+static int CompareSortedRows(OrderByGlobalOperatorState &state, SortedRunReader &left, SortedRunReader &right) {
+	auto &layout = state.layout;
+	auto result = memcmp(left.Entry(), right.Entry(), layout.key_width);
+	if (result != 0 || layout.exact) {
+		return result;
+	}
+	// equal keys: compare the ORDER BY columns stored in the rows
+	return state.row_layout.Compare(left.Row(), right.Row());
+}
 
-	// compute the sorting columns from the input data
-	ExpressionExecutor executor;
-	vector<LogicalType> sort_types;
-	vector<OrderType> order_types;
-	vector<OrderByNullType> null_order_types;
-	for (idx_t i = 0; i < orders.size(); i++) {
-		auto &expr = orders[i].expression;
-		sort_types.push_back(expr->return_type);
-		order_types.push_back(orders[i].type);
-		null_order_types.push_back(orders[i].null_order);
-		executor.AddExpression(*expr);
+//! Searches the merge path of the left and right run for the given diagonal, i.e. returns how many of the first
+//! "diagonal" rows of the merged run come from the left run. Rows of the left run go first on ties.
+static idx_t MergePathSearch(OrderByGlobalOperatorState &state, SortedRun &left, SortedRun &right, idx_t diagonal) {
+	idx_t lower = diagonal > right.count ? diagonal - right.count : 0;
+	idx_t upper = MinValue<idx_t>(diagonal, left.count);
+	SortedRunReader left_reader(state.buffer_manager, state.layout, left, left.count);
+	SortedRunReader right_reader(state.buffer_manager, state.layout, right, right.count);
+	while (lower < upper) {
+		idx_t middle = lower + (upper - lower) / 2;
+		left_reader.Seek(middle);
+		right_reader.Seek(diagonal - middle - 1);
+		if (CompareSortedRows(state, left_reader, right_reader) <= 0) {
+			lower = middle + 1;
+		} else {
+			upper = middle;
+		}
+	}
+	return lower;
+}
+
+//! Merges the rows [start, end) of the merged run of the left and right run into new blocks. Only the blocks of the
+//! current left, right and result rows are pinned.
+static vector<SortedBlock> MergePartition(OrderByGlobalOperatorState &state, SortedRun &left, SortedRun &right,
+                                          idx_t start, idx_t end) {
+	idx_t left_idx = MergePathSearch(state, left, right, start);
+	SortedRunReader left_reader(state.buffer_manager, state.layout, left, left_idx);
+	SortedRunReader right_reader(state.buffer_manager, state.layout, right, start - left_idx);
+	SortedRunWriter writer(state.buffer_manager, state.layout);
+	for (idx_t result_idx = start; result_idx < end; result_idx++) {
+		if (right_reader.Done() ||
+		    (!left_reader.Done() && CompareSortedRows(state, left_reader, right_reader) <= 0)) {
+			writer.Append(left_reader.Entry(), left_reader.Row());
+			left_reader.Next();
+		} else {
+			writer.Append(right_reader.Entry(), right_reader.Row());
+			right_reader.Next();
+		}
+	}
+	return writer.Finish();
+}
+
+static void ScheduleMergeRound(Pipeline &pipeline, OrderByGlobalOperatorState &state);
+
+//! Concatenates the blocks written by the partitions of the finished merge round into the merged runs
+static void FinishMergeRound(OrderByGlobalOperatorState &state) {
+	auto &round = state.round;
+	for (idx_t pair_idx = 0; pair_idx < round.runs.size(); pair_idx++) {
+		auto &result = round.runs[pair_idx];
+		for (auto &partition : round.partitions[pair_idx]) {
+			for (auto &block : partition) {
+				block.start = result.blocks.empty() ? 0 : result.blocks.back().start + result.blocks.back().count;
+				result.blocks.push_back(move(block));
+			}
+		}
+	}
+	// the blocks of the runs that were merged are released here
+	state.runs = move(round.runs);
+	round = MergeRound();
+}
+
+//! Merges a partition of the merge path of two sorted runs, the partitions of a merge round are merged in parallel
+class PhysicalOrderMergeTask : public Task {
+public:
+	PhysicalOrderMergeTask(Pipeline &parent, OrderByGlobalOperatorState &state, idx_t pair_idx, idx_t partition_idx,
+	                       idx_t start, idx_t end)
+	    : parent(parent), state(state), pair_idx(pair_idx), partition_idx(partition_idx), start(start), end(end) {
 	}
 
-	ChunkCollection sort_collection;
-	for (idx_t i = 0; i < big_data.ChunkCount(); i++) {
-		DataChunk sort_chunk;
-		sort_chunk.Initialize(sort_types);
+	void Execute() override {
+		vector<SortedBlock> blocks;
+		bool failed = false;
+		try {
+			blocks = MergePartition(state, state.runs[pair_idx * 2], state.runs[pair_idx * 2 + 1], start, end);
+		} catch (std::exception &ex) {
+			parent.executor.PushError(ex.what());
+			failed = true;
+		} catch (...) {
+			parent.executor.PushError("Unknown exception in ORDER BY merge!");
+			failed = true;
+		}
 
-		executor.Execute(big_data.GetChunk(i), sort_chunk);
-		sort_collection.Append(sort_chunk);
+		lock_guard<mutex> glock(state.lock);
+		state.round.partitions[pair_idx][partition_idx] = move(blocks);
+		state.failed = state.failed || failed;
+		D_ASSERT(state.pending_tasks > 0);
+		if (--state.pending_tasks == 0 && !state.failed) {
+			// the merge round is finished: schedule the next round (if any) before finishing this task
+			FinishMergeRound(state);
+			if (state.runs.size() > 1) {
+				ScheduleMergeRound(parent, state);
+			}
+		}
+		parent.finished_tasks++;
+		// finish the whole pipeline
+		if (parent.total_tasks == parent.finished_tasks) {
+			parent.Finish();
+		}
 	}
 
-	D_ASSERT(sort_collection.Count() == big_data.Count());
+private:
+	Pipeline &parent;
+	OrderByGlobalOperatorState &state;
+	idx_t pair_idx;
+	idx_t partition_idx;
+	idx_t start;
+	idx_t end;
+};
 
-	// now perform the actual sort
-	sink.sorted_vector = unique_ptr<idx_t[]>(new idx_t[sort_collection.Count()]);
-	sort_collection.Sort(order_types, null_order_types, sink.sorted_vector.get());
+//! Schedules the tasks that merge the sorted runs pairwise, the lock must be held
+static void ScheduleMergeRound(Pipeline &pipeline, OrderByGlobalOperatorState &state) {
+	D_ASSERT(state.runs.size() > 1);
+	auto &round = state.round;
+	vector<unique_ptr<Task>> tasks;
+	round.runs.resize((state.runs.size() + 1) / 2);
+	round.partitions.resize(round.runs.size());
+	for (idx_t pair_idx = 0; pair_idx < round.runs.size(); pair_idx++) {
+		auto &result = round.runs[pair_idx];
+		if (pair_idx * 2 + 1 == state.runs.size()) {
+			// odd amount of runs: the final run is merged in the next round
+			result = move(state.runs[pair_idx * 2]);
+			continue;
+		}
+		result.count = state.runs[pair_idx * 2].count + state.runs[pair_idx * 2 + 1].count;
+		// split the merge path into partitions that are merged independently
+		for (idx_t start = 0; start < result.count; start += PhysicalOrder::MERGE_PARTITION_SIZE) {
+			auto end = MinValue<idx_t>(start + PhysicalOrder::MERGE_PARTITION_SIZE, result.count);
+			auto partition_idx = round.partitions[pair_idx].size();
+			round.partitions[pair_idx].emplace_back();
+			tasks.push_back(
+			    make_unique<PhysicalOrderMergeTask>(pipeline, state, pair_idx, partition_idx, start, end));
+		}
+	}
+	state.pending_tasks = tasks.size();
+	pipeline.total_tasks += tasks.size();
+	auto &scheduler = TaskScheduler::GetScheduler(pipeline.executor.context);
+	for (auto &task : tasks) {
+		scheduler.ScheduleTask(pipeline.token, move(task));
+	}
+}
 
+//===--------------------------------------------------------------------===//
+// Finalize
+//===--------------------------------------------------------------------===//
+void PhysicalOrder::Finalize(Pipeline &pipeline, ClientContext &context, unique_ptr<GlobalOperatorState> state) {
+	auto &sink = (OrderByGlobalOperatorState &)*state;
 	PhysicalSink::Finalize(pipeline, context, move(state));
+
+	// every thread has produced one or more sorted runs: merge the runs in parallel
+	lock_guard<mutex> glock(sink.lock);
+	if (sink.runs.size() > 1) {
+		ScheduleMergeRound(pipeline, sink);
+	}
 }
 
 //===--------------------------------------------------------------------===//
@@ -87,13 +411,31 @@ void PhysicalOrder::Finalize(Pipeline &pipeline, ClientContext &context, unique_
 void PhysicalOrder::GetChunkInternal(ExecutionContext &context, DataChunk &chunk, PhysicalOperatorState *state_) {
 	auto state = reinterpret_cast<PhysicalOrderOperatorState *>(state_);
 	auto &sink = (OrderByGlobalOperatorState &)*this->sink_state;
-	ChunkCollection &big_data = sink.sorted_data;
-	if (state->position >= big_data.Count()) {
+	if (sink.runs.empty()) {
 		return;
 	}
+	D_ASSERT(sink.runs.size() == 1);
+	if (!state->reader) {
+		state->reader = make_unique<SortedRunReader>(sink.buffer_manager, sink.layout, sink.runs[0]);
+	}
+	auto &reader = *state->reader;
 
-	big_data.MaterializeSortedChunk(chunk, sink.sorted_vector.get(), state->position);
-	state->position += STANDARD_VECTOR_SIZE;
+	// deserialize the rows block by block, so that only the block that is read is pinned
+	idx_t count = 0;
+	while (count < STANDARD_VECTOR_SIZE && !reader.Done()) {
+		auto block_count = MinValue<idx_t>(STANDARD_VECTOR_SIZE - count, reader.RemainingInBlock());
+		data_ptr_t rows[STANDARD_VECTOR_SIZE];
+		// the rows are collected without moving the reader to the next block, which would unpin the current block
+		for (idx_t i = 0; i < block_count; i++) {
+			rows[i] = reader.Row();
+			reader.index++;
+		}
+		sink.row_layout.Deserialize(rows, block_count, chunk, count, sink.nested_data);
+		count += block_count;
+		reader.Seek(reader.index);
+	}
+	chunk.SetCardinality(count);
+	chunk.Verify();
 }
 
 unique_ptr<PhysicalOperatorState> PhysicalOrder::GetOperatorState() {
@@ -10,71 +10,328 @@
 namespace duckdb {
 
 //===--------------------------------------------------------------------===//
-// Sink
+// Heap
 //===--------------------------------------------------------------------===//
-class TopNGlobalState : public GlobalOperatorState {
+template <class T>
+static void TemplatedSelectBeforeBoundary(Vector &keys, idx_t count, Vector &boundary, OrderType order_type,
+                                          OrderByNullType null_order, SelectionVector &remaining,
+                                          idx_t &remaining_count, SelectionVector &result, idx_t &result_count) {
+	VectorData kdata;
+	keys.Orrify(count, kdata);
+	auto key_data = (T *)kdata.data;
+	bool boundary_null = FlatVector::IsNull(boundary, 0);
+	auto boundary_value = FlatVector::GetData<T>(boundary)[0];
+
+	idx_t tied_count = 0;
+	for (idx_t i = 0; i < remaining_count; i++) {
+		auto row_idx = remaining.get_index(i);
+		auto key_idx = kdata.sel->get_index(row_idx);
+		bool key_null = (*kdata.nullmask)[key_idx];
+		// compare the key in the same way as ChunkCollection::CompareRows does
+		int cmp;
+		if (key_null && boundary_null) {
+			cmp = 0;
+		} else if (boundary_null) {
+			cmp = null_order == OrderByNullType::NULLS_FIRST ? -1 : 1;
+		} else if (key_null) {
+			cmp = null_order == OrderByNullType::NULLS_FIRST ? 1 : -1;
+		} else if (Equals::Operation<T>(key_data[key_idx], boundary_value)) {
+			cmp = 0;
+		} else {
+			cmp = LessThan::Operation<T>(key_data[key_idx], boundary_value) ? -1 : 1;
+		}
+		if (cmp != 0 && order_type == OrderType::DESCENDING) {
+			cmp = -cmp;
+		}
+		if (cmp < 0) {
+			result.set_index(result_count++, row_idx);
+		} else if (cmp == 0) {
+			remaining.set_index(tied_count++, row_idx);
+		}
+	}
+	remaining_count = tied_count;
+}
+
+//! A bounded heap that holds (at least) the top limit + offset rows of the rows that were added to it. Rows are
+//! appended until the heap holds enough rows to make it worth reducing it to the top rows; after that, incoming rows
+//! are compared against the last of the top rows and only appended if they sort strictly before it.
+class TopNHeap {
 public:
-	mutex lock;
-	ChunkCollection big_data;
-	unique_ptr<idx_t[]> heap;
-	idx_t heap_size;
-};
+	//! The heap is reduced once it holds this many rows more than the top rows, or more than the top rows if that is
+	//! larger
+	static constexpr idx_t MIN_REDUCE_ROWS = 4 * STANDARD_VECTOR_SIZE;
+
+	explicit TopNHeap(PhysicalTopN &op);
+
+	PhysicalTopN &op;
+	//! The amount of top rows that is kept
+	idx_t heap_limit;
+	//! The rows of the heap
+	ChunkCollection payload;
+	//! The sort keys of the rows of the heap
+	ChunkCollection sort_keys;
+	//! Whether or not the heap has been reduced to the top rows, in which case the boundary holds the sort keys of the
+	//! last of them
+	bool has_boundary;
+	DataChunk boundary;
 
-class TopNLocalState : public LocalSinkState {
 public:
-	ChunkCollection big_data;
+	//! Adds the rows of the chunk with the given sort keys to the heap
+	void Append(DataChunk &input, DataChunk &keys);
+	//! Adds the rows of another heap to this heap
+	void Combine(TopNHeap &other);
+	//! Computes the order of the top rows of the heap, returns nullptr if there are no rows after the offset
+	unique_ptr<idx_t[]> ComputeTopN(idx_t &heap_size);
+
+private:
+	//! Selects the rows of the sort keys that sort strictly before the boundary, returns the amount of selected rows
+	idx_t SelectBeforeBoundary(DataChunk &keys, SelectionVector &result);
+	//! Reduces the heap to the top rows and updates the boundary
+	void Reduce();
 };
 
-unique_ptr<LocalSinkState> PhysicalTopN::GetLocalSinkState(ExecutionContext &context) {
-	return make_unique<TopNLocalState>();
+TopNHeap::TopNHeap(PhysicalTopN &op) : op(op), heap_limit(op.limit + op.offset), has_boundary(false) {
+	vector<LogicalType> sort_types;
+	for (auto &order : op.orders) {
+		sort_types.push_back(order.expression->return_type);
+	}
+	boundary.Initialize(sort_types);
 }
 
-unique_ptr<GlobalOperatorState> PhysicalTopN::GetGlobalState(ClientContext &context) {
-	return make_unique<TopNGlobalState>();
+idx_t TopNHeap::SelectBeforeBoundary(DataChunk &keys, SelectionVector &result) {
+	SelectionVector remaining(STANDARD_VECTOR_SIZE);
+	for (idx_t i = 0; i < keys.size(); i++) {
+		remaining.set_index(i, i);
+	}
+	idx_t remaining_count = keys.size();
+	idx_t result_count = 0;
+	for (idx_t col_idx = 0; col_idx < keys.ColumnCount() && remaining_count > 0; col_idx++) {
+		auto &key = keys.data[col_idx];
+		auto &bound = boundary.data[col_idx];
+		auto order_type = op.orders[col_idx].type;
+		auto null_order = op.orders[col_idx].null_order;
+		switch (key.type.InternalType()) {
+		case PhysicalType::BOOL:
+		case PhysicalType::INT8:
+			TemplatedSelectBeforeBoundary<int8_t>(key, keys.size(), bound, order_type, null_order, remaining,
+			                                      remaining_count, result, result_count);
+			break;
+		case PhysicalType::INT16:
+			TemplatedSelectBeforeBoundary<int16_t>(key, keys.size(), bound, order_type, null_order, remaining,
+			                                       remaining_count, result, result_count);
+			break;
+		case PhysicalType::INT32:
+			TemplatedSelectBeforeBoundary<int32_t>(key, keys.size(), bound, order_type, null_order, remaining,
+			                                       remaining_count, result, result_count);
+			break;
+		case PhysicalType::INT64:
+			TemplatedSelectBeforeBoundary<int64_t>(key, keys.size(), bound, order_type, null_order, remaining,
+			                                       remaining_count, result, result_count);
+			break;
+		case PhysicalType::UINT8:
+			TemplatedSelectBeforeBoundary<uint8_t>(key, keys.size(), bound, order_type, null_order, remaining,
+			                                       remaining_count, result, result_count);
+			break;
+		case PhysicalType::UINT16:
+			TemplatedSelectBeforeBoundary<uint16_t>(key, keys.size(), bound, order_type, null_order, remaining,
+			                                        remaining_count, result, result_count);
+			break;
+		case PhysicalType::UINT32:
+			TemplatedSelectBeforeBoundary<uint32_t>(key, keys.size(), bound, order_type, null_order, remaining,
+			                                        remaining_count, result, result_count);
+			break;
+		case PhysicalType::UINT64:
+			TemplatedSelectBeforeBoundary<uint64_t>(key, keys.size(), bound, order_type, null_order, remaining,
+			                                        remaining_count, result, result_count);
+			break;
+		case PhysicalType::INT128:
+			TemplatedSelectBeforeBoundary<hugeint_t>(key, keys.size(), bound, order_type, null_order, remaining,
+			                                         remaining_count, result, result_count);
+			break;
+		case PhysicalType::FLOAT:
+			TemplatedSelectBeforeBoundary<float>(key, keys.size(), bound, order_type, null_order, remaining,
+			                                     remaining_count, result, result_count);
+			break;
+		case PhysicalType::DOUBLE:
+			TemplatedSelectBeforeBoundary<double>(key, keys.size(), bound, order_type, null_order, remaining,
+			                                      remaining_count, result, result_count);
+			break;
+		case PhysicalType::VARCHAR:
+			TemplatedSelectBeforeBoundary<string_t>(key, keys.size(), bound, order_type, null_order, remaining,
+			                                        remaining_count, result, result_count);
+			break;
+		case PhysicalType::INTERVAL:
+			TemplatedSelectBeforeBoundary<interval_t>(key, keys.size(), bound, order_type, null_order, remaining,
+			                                          remaining_count, result, result_count);
+			break;
+		default:
+			throw NotImplementedException("Type for comparison");
+		}
+	}
+	// the rows that are equal to the boundary cannot displace any of the top rows
+	return result_count;
 }
 
-void PhysicalTopN::Sink(ExecutionContext &context, GlobalOperatorState &state, LocalSinkState &lstate,
-                        DataChunk &input) {
-	// append to the local sink state
-	auto &sink = (TopNLocalState &)lstate;
-	sink.big_data.Append(input);
+void TopNHeap::Append(DataChunk &input, DataChunk &keys) {
+	if (heap_limit == 0 || input.size() == 0) {
+		return;
+	}
+	if (!has_boundary) {
+		payload.Append(input);
+		sort_keys.Append(keys);
+	} else {
+		// prune the rows that cannot end up in the top rows before copying them
+		SelectionVector sel(STANDARD_VECTOR_SIZE);
+		idx_t count = SelectBeforeBoundary(keys, sel);
+		if (count == 0) {
+			return;
+		}
+		if (count == input.size()) {
+			payload.Append(input);
+			sort_keys.Append(keys);
+		} else {
+			auto input_types = input.GetTypes();
+			auto key_types = keys.GetTypes();
+			DataChunk sliced_input, sliced_keys;
+			sliced_input.InitializeEmpty(input_types);
+			sliced_input.Slice(input, sel, count);
+			sliced_keys.InitializeEmpty(key_types);
+			sliced_keys.Slice(keys, sel, count);
+			payload.Append(sliced_input);
+			sort_keys.Append(sliced_keys);
+		}
+	}
+	if (payload.Count() > heap_limit && payload.Count() - heap_limit >= MaxValue(heap_limit, MIN_REDUCE_ROWS)) {
+		Reduce();
+	}
 }
 
-unique_ptr<idx_t[]> PhysicalTopN::ComputeTopN(ChunkCollection &big_data, idx_t &heap_size) {
-	// now perform the actual ordering of the data
-	// compute the sorting columns from the input data
-	ExpressionExecutor executor;
-	vector<LogicalType> sort_types;
-	vector<OrderType> order_types;
-	vector<OrderByNullType> null_order_types;
-	for (idx_t i = 0; i < orders.size(); i++) {
-		auto &expr = orders[i].expression;
-		sort_types.push_back(expr->return_type);
-		order_types.push_back(orders[i].type);
-		null_order_types.push_back(orders[i].null_order);
-		executor.AddExpression(*expr);
+void TopNHeap::Combine(TopNHeap &other) {
+	for (idx_t chunk_idx = 0; chunk_idx < other.payload.ChunkCount(); chunk_idx++) {
+		Append(other.payload.GetChunk(chunk_idx), other.sort_keys.GetChunk(chunk_idx));
 	}
+}
 
-	heap_size = (big_data.Count() > offset) ? MinValue<idx_t>(limit + offset, big_data.Count()) : 0;
+unique_ptr<idx_t[]> TopNHeap::ComputeTopN(idx_t &heap_size) {
+	// the top rows are only produced if they are not all skipped by the offset
+	heap_size = (payload.Count() > op.offset) ? MinValue<idx_t>(heap_limit, payload.Count()) : 0;
 	if (heap_size == 0) {
 		return nullptr;
 	}
+	vector<OrderType> order_types;
+	vector<OrderByNullType> null_order_types;
+	for (auto &order : op.orders) {
+		order_types.push_back(order.type);
+		null_order_types.push_back(order.null_order);
+	}
+	auto heap = unique_ptr<idx_t[]>(new idx_t[heap_size]);
+	sort_keys.Heap(order_types, null_order_types, heap.get(), heap_size);
+	return heap;
+}
+
+//! Appends the rows of the source collection in the given order to the target collection
+static void AppendRows(ChunkCollection &source, const idx_t rows[], idx_t count, ChunkCollection &target) {
+	DataChunk chunk;
+	chunk.Initialize(source.Types());
+	SelectionVector sel(STANDARD_VECTOR_SIZE);
+	for (idx_t chunk_begin = 0; chunk_begin < count; chunk_begin += STANDARD_VECTOR_SIZE) {
+		idx_t chunk_end = MinValue<idx_t>(chunk_begin + STANDARD_VECTOR_SIZE, count);
+		idx_t i = chunk_begin;
+		while (i < chunk_end) {
+			// copy the run of rows that are read from the same chunk at once
+			auto source_idx = rows[i] / STANDARD_VECTOR_SIZE;
+			auto run_start = i;
+			idx_t run_count = 0;
+			while (i < chunk_end && rows[i] / STANDARD_VECTOR_SIZE == source_idx) {
+				sel.set_index(run_count++, rows[i] % STANDARD_VECTOR_SIZE);
+				i++;
+			}
+			auto &source_chunk = source.GetChunk(source_idx);
+			for (idx_t col_idx = 0; col_idx < chunk.ColumnCount(); col_idx++) {
+				VectorOperations::Copy(source_chunk.data[col_idx], chunk.data[col_idx], sel, run_count, 0,
+				                       run_start - chunk_begin);
+			}
+		}
+		chunk.SetCardinality(chunk_end - chunk_begin);
+		target.Append(chunk);
+		chunk.Reset();
+	}
+}
+
+void TopNHeap::Reduce() {
+	idx_t heap_size;
+	auto heap = ComputeTopN(heap_size);
+	D_ASSERT(heap && heap_size == heap_limit);
 
-	ChunkCollection heap_collection;
-	for (idx_t i = 0; i < big_data.ChunkCount(); i++) {
-		DataChunk heap_chunk;
-		heap_chunk.Initialize(sort_types);
+	ChunkCollection new_payload, new_sort_keys;
+	AppendRows(payload, heap.get(), heap_size, new_payload);
+	AppendRows(sort_keys, heap.get(), heap_size, new_sort_keys);
+	payload.Reset();
+	payload.Merge(new_payload);
+	sort_keys.Reset();
+	sort_keys.Merge(new_sort_keys);
 
-		executor.Execute(big_data.GetChunk(i), heap_chunk);
-		heap_collection.Append(heap_chunk);
+	// the boundary is the last of the top rows
+	auto &last_chunk = sort_keys.GetChunk(sort_keys.ChunkCount() - 1);
+	SelectionVector last_sel(STANDARD_VECTOR_SIZE);
+	last_sel.set_index(0, last_chunk.size() - 1);
+	boundary.Reset();
+	for (idx_t col_idx = 0; col_idx < boundary.ColumnCount(); col_idx++) {
+		VectorOperations::Copy(last_chunk.data[col_idx], boundary.data[col_idx], last_sel, 1, 0, 0);
+	}
+	boundary.SetCardinality(1);
+	has_boundary = true;
+}
+
+//===--------------------------------------------------------------------===//
+// Sink
+//===--------------------------------------------------------------------===//
+class TopNGlobalState : public GlobalOperatorState {
+public:
+	explicit TopNGlobalState(PhysicalTopN &op) : heap(op), heap_size(0) {
 	}
 
-	D_ASSERT(heap_collection.Count() == big_data.Count());
+	mutex lock;
+	//! The heap into which the heaps of the threads are merged
+	TopNHeap heap;
+	//! The order of the top rows of the heap
+	unique_ptr<idx_t[]> top_rows;
+	idx_t heap_size;
+};
 
-	// create and use the heap
-	auto heap = unique_ptr<idx_t[]>(new idx_t[heap_size]);
-	heap_collection.Heap(order_types, null_order_types, heap.get(), heap_size);
-	return heap;
+class TopNLocalState : public LocalSinkState {
+public:
+	explicit TopNLocalState(PhysicalTopN &op) : heap(op) {
+		vector<LogicalType> sort_types;
+		for (auto &order : op.orders) {
+			sort_types.push_back(order.expression->return_type);
+			executor.AddExpression(*order.expression);
+		}
+		sort_chunk.Initialize(sort_types);
+	}
+
+	//! The bounded heap of the rows that were sunk by this thread
+	TopNHeap heap;
+	//! Computes the sort keys of the input chunks
+	ExpressionExecutor executor;
+	DataChunk sort_chunk;
+};
+
+unique_ptr<LocalSinkState> PhysicalTopN::GetLocalSinkState(ExecutionContext &context) {
+	return make_unique<TopNLocalState>(*this);
+}
+
+unique_ptr<GlobalOperatorState> PhysicalTopN::GetGlobalState(ClientContext &context) {
+	return make_unique<TopNGlobalState>(*this);
+}
+
+void PhysicalTopN::Sink(ExecutionContext &context, GlobalOperatorState &state, LocalSinkState &lstate,
+                        DataChunk &input) {
+	// add the input to the heap of this thread
+	auto &sink = (TopNLocalState &)lstate;
+	sink.sort_chunk.Reset();
+	sink.executor.Execute(input, sink.sort_chunk);
+	sink.heap.Append(input, sink.sort_chunk);
 }
 
 //===--------------------------------------------------------------------===//
@@ -84,23 +341,9 @@ void PhysicalTopN::Combine(ExecutionContext &context, GlobalOperatorState &state
 	auto &gstate = (TopNGlobalState &)state;
 	auto &lstate = (TopNLocalState &)lstate_;
 
-	// first construct the top n of the local sink state
-	idx_t local_heap_size;
-	auto local_heap = ComputeTopN(lstate.big_data, local_heap_size);
-	if (!local_heap) {
-		return;
-	}
-
-	// now scan the local top N and add it to the global heap
+	// merge the rows of the local heap into the global heap
 	lock_guard<mutex> glock(gstate.lock);
-	idx_t position = 0;
-	DataChunk chunk;
-	chunk.Initialize(types);
-	while (position < local_heap_size) {
-		position = lstate.big_data.MaterializeHeapChunk(chunk, local_heap.get(), position, local_heap_size);
-		gstate.big_data.Append(chunk);
-	}
-	gstate.heap_size += local_heap_size;
+	gstate.heap.Combine(lstate.heap);
 }
 
 //===--------------------------------------------------------------------===//
@@ -109,7 +352,7 @@ void PhysicalTopN::Combine(ExecutionContext &context, GlobalOperatorState &state
 void PhysicalTopN::Finalize(Pipeline &pipeline, ClientContext &context, unique_ptr<GlobalOperatorState> state) {
 	auto &gstate = (TopNGlobalState &)*state;
 	// global finalize: compute the final top N
-	gstate.heap = ComputeTopN(gstate.big_data, gstate.heap_size);
+	gstate.top_rows = gstate.heap.ComputeTopN(gstate.heap_size);
 
 	PhysicalSink::Finalize(pipeline, context, move(state));
 }
@@ -136,7 +379,8 @@ void PhysicalTopN::GetChunkInternal(ExecutionContext &context, DataChunk &chunk,
 		state.position = offset;
 	}
 
-	state.position = gstate.big_data.MaterializeHeapChunk(chunk, gstate.heap.get(), state.position, gstate.heap_size);
+	state.position =
+	    gstate.heap.payload.MaterializeHeapChunk(chunk, gstate.top_rows.get(), state.position, gstate.heap_size);
 }
 
 unique_ptr<PhysicalOperatorState> PhysicalTopN::GetOperatorState() {
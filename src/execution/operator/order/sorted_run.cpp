@@ -0,0 +1,454 @@
+#include "duckdb/execution/operator/order/sorted_run.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/operator/comparison_operators.hpp"
+#include "duckdb/storage/buffer/buffer_handle.hpp"
+
+namespace duckdb {
+
+static bool IsNestedType(PhysicalType type) {
+	return type == PhysicalType::LIST || type == PhysicalType::STRUCT;
+}
+
+SortedRowLayout::SortedRowLayout(SortKeyLayout &key_layout, vector<LogicalType> &order_by_types,
+                                 vector<LogicalType> payload_types_p)
+    : key_offset(key_layout.inexact_column), payload_types(move(payload_types_p)) {
+	for (idx_t col_idx = key_offset; col_idx < order_by_types.size(); col_idx++) {
+		key_types.push_back(order_by_types[col_idx]);
+		order_types.push_back(key_layout.order_types[col_idx]);
+		null_orders.push_back(key_layout.null_orders[col_idx]);
+	}
+	for (idx_t col_idx = 0; col_idx < payload_types.size(); col_idx++) {
+		if (IsNestedType(payload_types[col_idx].InternalType())) {
+			nested_columns.push_back(col_idx);
+			nested_types.push_back(payload_types[col_idx]);
+		}
+	}
+}
+
+//===--------------------------------------------------------------------===//
+// Serialize
+//===--------------------------------------------------------------------===//
+static void ComputeColumnSizes(Vector &vector, idx_t count, uint32_t sizes[]) {
+	auto type = vector.type.InternalType();
+	if (IsNestedType(type)) {
+		// nested columns are referenced instead of serialized
+		return;
+	}
+	if (type != PhysicalType::VARCHAR) {
+		// fixed-size values are stored even if they are NULL
+		for (idx_t i = 0; i < count; i++) {
+			sizes[i] += 1 + GetTypeIdSize(type);
+		}
+		return;
+	}
+	VectorData vdata;
+	vector.Orrify(count, vdata);
+	auto strings = (string_t *)vdata.data;
+	for (idx_t i = 0; i < count; i++) {
+		auto idx = vdata.sel->get_index(i);
+		sizes[i] += 1;
+		if (!(*vdata.nullmask)[idx]) {
+			sizes[i] += sizeof(uint32_t) + strings[idx].GetSize();
+		}
+	}
+}
+
+void SortedRowLayout::ComputeSizes(DataChunk &keys, DataChunk &payload, uint32_t sizes[]) {
+	auto count = payload.size();
+	uint32_t base_size = sizeof(uint32_t) + (nested_columns.empty() ? 0 : sizeof(idx_t));
+	for (idx_t i = 0; i < count; i++) {
+		sizes[i] = base_size;
+	}
+	for (idx_t col_idx = key_offset; col_idx < keys.ColumnCount(); col_idx++) {
+		ComputeColumnSizes(keys.data[col_idx], count, sizes);
+	}
+	for (idx_t col_idx = 0; col_idx < payload.ColumnCount(); col_idx++) {
+		ComputeColumnSizes(payload.data[col_idx], count, sizes);
+	}
+}
+
+template <class T>
+static void TemplatedSerializeColumn(VectorData &vdata, idx_t count, data_ptr_t locations[]) {
+	auto data = (T *)vdata.data;
+	for (idx_t i = 0; i < count; i++) {
+		auto idx = vdata.sel->get_index(i);
+		bool is_null = (*vdata.nullmask)[idx];
+		Store<uint8_t>(is_null ? 0 : 1, locations[i]);
+		Store<T>(is_null ? T() : data[idx], locations[i] + 1);
+		locations[i] += 1 + sizeof(T);
+	}
+}
+
+static void SerializeStringColumn(VectorData &vdata, idx_t count, data_ptr_t locations[]) {
+	auto strings = (string_t *)vdata.data;
+	for (idx_t i = 0; i < count; i++) {
+		auto idx = vdata.sel->get_index(i);
+		if ((*vdata.nullmask)[idx]) {
+			Store<uint8_t>(0, locations[i]);
+			locations[i] += 1;
+			continue;
+		}
+		auto &str = strings[idx];
+		uint32_t size = str.GetSize();
+		Store<uint8_t>(1, locations[i]);
+		Store<uint32_t>(size, locations[i] + 1);
+		memcpy(locations[i] + 1 + sizeof(uint32_t), str.GetDataUnsafe(), size);
+		locations[i] += 1 + sizeof(uint32_t) + size;
+	}
+}
+
+static void SerializeColumn(Vector &vector, idx_t count, data_ptr_t locations[]) {
+	VectorData vdata;
+	vector.Orrify(count, vdata);
+	switch (vector.type.InternalType()) {
+	case PhysicalType::BOOL:
+	case PhysicalType::INT8:
+		TemplatedSerializeColumn<int8_t>(vdata, count, locations);
+		break;
+	case PhysicalType::INT16:
+		TemplatedSerializeColumn<int16_t>(vdata, count, locations);
+		break;
+	case PhysicalType::INT32:
+		TemplatedSerializeColumn<int32_t>(vdata, count, locations);
+		break;
+	case PhysicalType::INT64:
+		TemplatedSerializeColumn<int64_t>(vdata, count, locations);
+		break;
+	case PhysicalType::UINT8:
+		TemplatedSerializeColumn<uint8_t>(vdata, count, locations);
+		break;
+	case PhysicalType::UINT16:
+		TemplatedSerializeColumn<uint16_t>(vdata, count, locations);
+		break;
+	case PhysicalType::UINT32:
+		TemplatedSerializeColumn<uint32_t>(vdata, count, locations);
+		break;
+	case PhysicalType::UINT64:
+		TemplatedSerializeColumn<uint64_t>(vdata, count, locations);
+		break;
+	case PhysicalType::INT128:
+		TemplatedSerializeColumn<hugeint_t>(vdata, count, locations);
+		break;
+	case PhysicalType::FLOAT:
+		TemplatedSerializeColumn<float>(vdata, count, locations);
+		break;
+	case PhysicalType::DOUBLE:
+		TemplatedSerializeColumn<double>(vdata, count, locations);
+		break;
+	case PhysicalType::INTERVAL:
+		TemplatedSerializeColumn<interval_t>(vdata, count, locations);
+		break;
+	case PhysicalType::VARCHAR:
+		SerializeStringColumn(vdata, count, locations);
+		break;
+	case PhysicalType::LIST:
+	case PhysicalType::STRUCT:
+		// nested columns are referenced instead of serialized
+		break;
+	default:
+		throw NotImplementedException("Type is unsupported in ORDER BY");
+	}
+}
+
+void SortedRowLayout::Serialize(DataChunk &keys, DataChunk &payload, uint32_t sizes[], data_ptr_t locations[],
+                                idx_t first_nested_row) {
+	auto count = payload.size();
+	data_ptr_t targets[STANDARD_VECTOR_SIZE];
+	for (idx_t i = 0; i < count; i++) {
+		Store<uint32_t>(sizes[i], locations[i]);
+		targets[i] = locations[i] + sizeof(uint32_t);
+	}
+	for (idx_t col_idx = key_offset; col_idx < keys.ColumnCount(); col_idx++) {
+		SerializeColumn(keys.data[col_idx], count, targets);
+	}
+	for (idx_t col_idx = 0; col_idx < payload.ColumnCount(); col_idx++) {
+		SerializeColumn(payload.data[col_idx], count, targets);
+	}
+	if (!nested_columns.empty()) {
+		for (idx_t i = 0; i < count; i++) {
+			Store<idx_t>(first_nested_row + i, targets[i]);
+			targets[i] += sizeof(idx_t);
+		}
+	}
+#ifdef DEBUG
+	for (idx_t i = 0; i < count; i++) {
+		D_ASSERT(targets[i] == locations[i] + sizes[i]);
+	}
+#endif
+}
+
+//===--------------------------------------------------------------------===//
+// Deserialize
+//===--------------------------------------------------------------------===//
+static void SkipColumn(PhysicalType type, data_ptr_t &row) {
+	if (IsNestedType(type)) {
+		return;
+	}
+	bool is_valid = Load<uint8_t>(row);
+	row++;
+	if (type != PhysicalType::VARCHAR) {
+		row += GetTypeIdSize(type);
+	} else if (is_valid) {
+		row += sizeof(uint32_t) + Load<uint32_t>(row);
+	}
+}
+
+template <class T>
+static void TemplatedDeserializeColumn(data_ptr_t rows[], idx_t count, Vector &result, idx_t result_offset) {
+	auto result_data = FlatVector::GetData<T>(result);
+	auto &nullmask = FlatVector::Nullmask(result);
+	for (idx_t i = 0; i < count; i++) {
+		if (Load<uint8_t>(rows[i])) {
+			result_data[result_offset + i] = Load<T>(rows[i] + 1);
+		} else {
+			nullmask[result_offset + i] = true;
+		}
+		rows[i] += 1 + sizeof(T);
+	}
+}
+
+static void DeserializeStringColumn(data_ptr_t rows[], idx_t count, Vector &result, idx_t result_offset) {
+	auto result_data = FlatVector::GetData<string_t>(result);
+	auto &nullmask = FlatVector::Nullmask(result);
+	for (idx_t i = 0; i < count; i++) {
+		if (!Load<uint8_t>(rows[i])) {
+			nullmask[result_offset + i] = true;
+			rows[i] += 1;
+			continue;
+		}
+		auto size = Load<uint32_t>(rows[i] + 1);
+		auto data = (const char *)rows[i] + 1 + sizeof(uint32_t);
+		result_data[result_offset + i] = StringVector::AddStringOrBlob(result, string_t(data, size));
+		rows[i] += 1 + sizeof(uint32_t) + size;
+	}
+}
+
+static void DeserializeColumn(data_ptr_t rows[], idx_t count, Vector &result, idx_t result_offset) {
+	switch (result.type.InternalType()) {
+	case PhysicalType::BOOL:
+	case PhysicalType::INT8:
+		TemplatedDeserializeColumn<int8_t>(rows, count, result, result_offset);
+		break;
+	case PhysicalType::INT16:
+		TemplatedDeserializeColumn<int16_t>(rows, count, result, result_offset);
+		break;
+	case PhysicalType::INT32:
+		TemplatedDeserializeColumn<int32_t>(rows, count, result, result_offset);
+		break;
+	case PhysicalType::INT64:
+		TemplatedDeserializeColumn<int64_t>(rows, count, result, result_offset);
+		break;
+	case PhysicalType::UINT8:
+		TemplatedDeserializeColumn<uint8_t>(rows, count, result, result_offset);
+		break;
+	case PhysicalType::UINT16:
+		TemplatedDeserializeColumn<uint16_t>(rows, count, result, result_offset);
+		break;
+	case PhysicalType::UINT32:
+		TemplatedDeserializeColumn<uint32_t>(rows, count, result, result_offset);
+		break;
+	case PhysicalType::UINT64:
+		TemplatedDeserializeColumn<uint64_t>(rows, count, result, result_offset);
+		break;
+	case PhysicalType::INT128:
+		TemplatedDeserializeColumn<hugeint_t>(rows, count, result, result_offset);
+		break;
+	case PhysicalType::FLOAT:
+		TemplatedDeserializeColumn<float>(rows, count, result, result_offset);
+		break;
+	case PhysicalType::DOUBLE:
+		TemplatedDeserializeColumn<double>(rows, count, result, result_offset);
+		break;
+	case PhysicalType::INTERVAL:
+		TemplatedDeserializeColumn<interval_t>(rows, count, result, result_offset);
+		break;
+	case PhysicalType::VARCHAR:
+		DeserializeStringColumn(rows, count, result, result_offset);
+		break;
+	default:
+		throw NotImplementedException("Type is unsupported in ORDER BY");
+	}
+}
+
+void SortedRowLayout::Deserialize(data_ptr_t rows[], idx_t count, DataChunk &result, idx_t result_offset,
+                                  vector<unique_ptr<ChunkCollection>> &nested_data) {
+	data_ptr_t sources[STANDARD_VECTOR_SIZE];
+	for (idx_t i = 0; i < count; i++) {
+		sources[i] = rows[i] + sizeof(uint32_t);
+		for (auto &type : key_types) {
+			SkipColumn(type.InternalType(), sources[i]);
+		}
+	}
+	for (idx_t col_idx = 0; col_idx < result.ColumnCount(); col_idx++) {
+		if (!IsNestedType(payload_types[col_idx].InternalType())) {
+			DeserializeColumn(sources, count, result.data[col_idx], result_offset);
+		}
+	}
+	if (nested_columns.empty()) {
+		return;
+	}
+	for (idx_t i = 0; i < count; i++) {
+		auto reference = Load<idx_t>(sources[i]);
+		auto &collection = *nested_data[reference >> NESTED_ROW_BITS];
+		for (idx_t nested_idx = 0; nested_idx < nested_columns.size(); nested_idx++) {
+			result.data[nested_columns[nested_idx]].SetValue(
+			    result_offset + i, collection.GetValue(nested_idx, reference & NESTED_ROW_MASK));
+		}
+	}
+}
+
+//===--------------------------------------------------------------------===//
+// Compare
+//===--------------------------------------------------------------------===//
+template <class T>
+static int TemplatedCompareValues(T left, T right) {
+	if (Equals::Operation(left, right)) {
+		return 0;
+	}
+	return LessThan::Operation(left, right) ? -1 : 1;
+}
+
+static string_t LoadString(data_ptr_t value) {
+	return string_t((const char *)value + sizeof(uint32_t), Load<uint32_t>(value));
+}
+
+static int CompareValues(PhysicalType type, data_ptr_t left, data_ptr_t right) {
+	switch (type) {
+	case PhysicalType::BOOL:
+	case PhysicalType::INT8:
+		return TemplatedCompareValues<int8_t>(Load<int8_t>(left), Load<int8_t>(right));
+	case PhysicalType::INT16:
+		return TemplatedCompareValues<int16_t>(Load<int16_t>(left), Load<int16_t>(right));
+	case PhysicalType::INT32:
+		return TemplatedCompareValues<int32_t>(Load<int32_t>(left), Load<int32_t>(right));
+	case PhysicalType::INT64:
+		return TemplatedCompareValues<int64_t>(Load<int64_t>(left), Load<int64_t>(right));
+	case PhysicalType::UINT8:
+		return TemplatedCompareValues<uint8_t>(Load<uint8_t>(left), Load<uint8_t>(right));
+	case PhysicalType::UINT16:
+		return TemplatedCompareValues<uint16_t>(Load<uint16_t>(left), Load<uint16_t>(right));
+	case PhysicalType::UINT32:
+		return TemplatedCompareValues<uint32_t>(Load<uint32_t>(left), Load<uint32_t>(right));
+	case PhysicalType::UINT64:
+		return TemplatedCompareValues<uint64_t>(Load<uint64_t>(left), Load<uint64_t>(right));
+	case PhysicalType::INT128:
+		return TemplatedCompareValues<hugeint_t>(Load<hugeint_t>(left), Load<hugeint_t>(right));
+	case PhysicalType::FLOAT:
+		return TemplatedCompareValues<float>(Load<float>(left), Load<float>(right));
+	case PhysicalType::DOUBLE:
+		return TemplatedCompareValues<double>(Load<double>(left), Load<double>(right));
+	case PhysicalType::INTERVAL:
+		return TemplatedCompareValues<interval_t>(Load<interval_t>(left), Load<interval_t>(right));
+	case PhysicalType::VARCHAR:
+		return TemplatedCompareValues<string_t>(LoadString(left), LoadString(right));
+	default:
+		throw NotImplementedException("Type for comparison");
+	}
+}
+
+int SortedRowLayout::Compare(data_ptr_t left, data_ptr_t right) {
+	left += sizeof(uint32_t);
+	right += sizeof(uint32_t);
+	for (idx_t col_idx = 0; col_idx < key_types.size(); col_idx++) {
+		auto type = key_types[col_idx].InternalType();
+		bool left_valid = Load<uint8_t>(left);
+		bool right_valid = Load<uint8_t>(right);
+		// NULLs are ordered as in ChunkCollection::CompareRows: DESC reverses the NULL order as well
+		int result;
+		if (!left_valid && !right_valid) {
+			result = 0;
+		} else if (!right_valid) {
+			result = null_orders[col_idx] == OrderByNullType::NULLS_FIRST ? 1 : -1;
+		} else if (!left_valid) {
+			result = null_orders[col_idx] == OrderByNullType::NULLS_FIRST ? -1 : 1;
+		} else {
+			result = CompareValues(type, left + 1, right + 1);
+		}
+		if (result != 0) {
+			return order_types[col_idx] == OrderType::ASCENDING ? result : -result;
+		}
+		SkipColumn(type, left);
+		SkipColumn(type, right);
+	}
+	return 0;
+}
+
+//===--------------------------------------------------------------------===//
+// SortedRunWriter
+//===--------------------------------------------------------------------===//
+SortedRunWriter::SortedRunWriter(BufferManager &buffer_manager, SortKeyLayout &layout)
+    : buffer_manager(buffer_manager), layout(layout), entry_end(0), row_start(0), count(0) {
+}
+
+void SortedRunWriter::NewBlock(idx_t required_space) {
+	auto alloc_size = MaxValue<idx_t>(Storage::BLOCK_ALLOC_SIZE, required_space + Storage::BLOCK_HEADER_SIZE);
+	SortedBlock block;
+	block.block = buffer_manager.RegisterMemory(alloc_size, false);
+	block.count = 0;
+	block.start = count;
+	handle = buffer_manager.Pin(block.block);
+	blocks.push_back(move(block));
+	entry_end = 0;
+	row_start = handle->node->size;
+}
+
+void SortedRunWriter::Append(data_ptr_t entry, data_ptr_t row) {
+	auto row_size = SortedRowLayout::GetSize(row);
+	if (!handle || entry_end + layout.entry_size + row_size > row_start) {
+		NewBlock(layout.entry_size + row_size);
+	}
+	auto target = handle->Ptr();
+	row_start -= row_size;
+	memcpy(target + row_start, row, row_size);
+	memcpy(target + entry_end, entry, layout.key_width);
+	layout.SetRow(target + entry_end, row_start);
+	entry_end += layout.entry_size;
+	blocks.back().count++;
+	count++;
+}
+
+vector<SortedBlock> SortedRunWriter::Finish() {
+	handle.reset();
+	return move(blocks);
+}
+
+//===--------------------------------------------------------------------===//
+// SortedRunReader
+//===--------------------------------------------------------------------===//
+SortedRunReader::SortedRunReader(BufferManager &buffer_manager, SortKeyLayout &layout, SortedRun &run, idx_t index)
+    : index(0), buffer_manager(buffer_manager), layout(layout), run(run), block_idx(INVALID_INDEX) {
+	Seek(index);
+}
+
+void SortedRunReader::Seek(idx_t new_index) {
+	index = new_index;
+	if (index >= run.count) {
+		// past the end of the run: release the pin of the last block
+		block_idx = INVALID_INDEX;
+		handle.reset();
+		return;
+	}
+	if (block_idx != INVALID_INDEX) {
+		auto &block = run.blocks[block_idx];
+		if (index >= block.start && index < block.start + block.count) {
+			// the entry is in the pinned block
+			return;
+		}
+	}
+	// binary search the block of the entry
+	idx_t lower = 0;
+	idx_t upper = run.blocks.size() - 1;
+	while (lower < upper) {
+		idx_t middle = lower + (upper - lower + 1) / 2;
+		if (run.blocks[middle].start <= index) {
+			lower = middle;
+		} else {
+			upper = middle - 1;
+		}
+	}
+	block_idx = lower;
+	handle = buffer_manager.Pin(run.blocks[block_idx].block);
+}
+
+} // namespace duckdb
@@ -4,7 +4,9 @@
 #include "duckdb/common/types/chunk_collection.hpp"
 #include "duckdb/common/vector_operations/vector_operations.hpp"
 #include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/main/client_context.hpp"
 #include "duckdb/storage/data_table.hpp"
+#include "duckdb/storage/table/local_append_storage.hpp"
 
 namespace duckdb {
 
@@ -13,11 +15,15 @@ namespace duckdb {
 //===--------------------------------------------------------------------===//
 class InsertGlobalState : public GlobalOperatorState {
 public:
-	InsertGlobalState() : insert_count(0) {
+	explicit InsertGlobalState(bool parallel) : insert_count(0), parallel(parallel) {
 	}
 
 	std::mutex lock;
 	idx_t insert_count;
+	//! Whether or not the threads append their rows to storages of their own
+	bool parallel;
+	//! The storages of the threads, which are merged into the table in the Finalize
+	vector<unique_ptr<LocalAppendStorage>> storages;
 };
 
 class InsertLocalState : public LocalSinkState {
@@ -29,6 +35,8 @@ public:
 
 	DataChunk insert_chunk;
 	ExpressionExecutor default_executor;
+	//! The rows appended by this thread, if the insert is parallel
+	unique_ptr<LocalAppendStorage> storage;
 };
 
 void PhysicalInsert::Sink(ExecutionContext &context, GlobalOperatorState &state, LocalSinkState &lstate,
@@ -62,13 +70,46 @@ void PhysicalInsert::Sink(ExecutionContext &context, GlobalOperatorState &state,
 		}
 	}
 
+	if (gstate.parallel) {
+		if (!istate.storage) {
+			istate.storage = make_unique<LocalAppendStorage>(*table->storage);
+		}
+		table->storage->LocalAppend(*table, context.client, *istate.storage, istate.insert_chunk);
+		return;
+	}
 	lock_guard<mutex> glock(gstate.lock);
 	table->storage->Append(*table, context.client, istate.insert_chunk);
 	gstate.insert_count += chunk.size();
 }
 
+void PhysicalInsert::Combine(ExecutionContext &context, GlobalOperatorState &state, LocalSinkState &lstate) {
+	auto &gstate = (InsertGlobalState &)state;
+	auto &istate = (InsertLocalState &)lstate;
+	if (!istate.storage) {
+		return;
+	}
+	lock_guard<mutex> glock(gstate.lock);
+	gstate.insert_count += istate.storage->Count();
+	gstate.storages.push_back(move(istate.storage));
+}
+
+void PhysicalInsert::Finalize(Pipeline &pipeline, ClientContext &context, unique_ptr<GlobalOperatorState> state) {
+	auto &gstate = (InsertGlobalState &)*state;
+	// the scans of the source have finished: append the rows of the threads to the table
+	for (auto &storage : gstate.storages) {
+		table->storage->MergeStorage(*table, context, *storage);
+	}
+	gstate.storages.clear();
+	PhysicalSink::Finalize(pipeline, context, move(state));
+}
+
+bool PhysicalInsert::ParallelInsert(ClientContext &context) {
+	// the segments of the threads can only be linked into tables without indexes
+	return !context.preserve_insertion_order && table->storage->info->indexes.empty();
+}
+
 unique_ptr<GlobalOperatorState> PhysicalInsert::GetGlobalState(ClientContext &context) {
-	return make_unique<InsertGlobalState>();
+	return make_unique<InsertGlobalState>(ParallelInsert(context));
 }
 
 unique_ptr<LocalSinkState> PhysicalInsert::GetLocalSinkState(ExecutionContext &context) {
@@ -19,6 +19,11 @@ public:
 	unique_ptr<FunctionOperatorData> operator_data;
 	//! Whether or not the scan has been initialized
 	bool initialized;
+	//! Whether or not the scanned rows are probed against the Bloom filter of the runtime filter
+	bool use_bloom_filter = false;
+	//! The amount of rows that were probed against the Bloom filter, and the amount of rows that passed it
+	idx_t bloom_probed = 0;
+	idx_t bloom_passed = 0;
 };
 
 PhysicalTableScan::PhysicalTableScan(vector<LogicalType> types, TableFunction function_,
@@ -42,6 +47,13 @@ void PhysicalTableScan::GetChunkInternal(ExecutionContext &context, DataChunk &c
 			state.parallel_state = nullptr;
 			auto task_info = task.task_info.find(this);
 			TableFilterCollection filters(table_filters.get());
+			if (runtime_filter && runtime_filter->ready) {
+				// the join has set the runtime filter: skip the segments outside of the range of its keys
+				if (!runtime_filter->zonemap_filters.filters.empty()) {
+					filters.zonemap_filters = &runtime_filter->zonemap_filters;
+				}
+				state.use_bloom_filter = runtime_filter->bloom_filter != nullptr;
+			}
 			if (task_info != task.task_info.end()) {
 				// parallel scan init
 				state.parallel_state = task_info->second;
@@ -58,6 +70,20 @@ void PhysicalTableScan::GetChunkInternal(ExecutionContext &context, DataChunk &c
 		}
 		state.initialized = true;
 	}
+	ScanChunk(context, chunk, state_);
+	while (chunk.size() > 0 && state.use_bloom_filter && !ApplyBloomFilter(chunk, state_)) {
+		// all rows were filtered: scan the next chunk
+		chunk.Reference(state.initial_chunk);
+		ScanChunk(context, chunk, state_);
+	}
+	if (state.parallel_state && function.get_batch_index && chunk.size() > 0) {
+		// let the sink know which morsel the chunk came from
+		context.task.batch_index = function.get_batch_index(context.client, bind_data.get(), state.operator_data.get());
+	}
+}
+
+void PhysicalTableScan::ScanChunk(ExecutionContext &context, DataChunk &chunk, PhysicalOperatorState *state_) {
+	auto &state = (PhysicalTableScanOperatorState &)*state_;
 	if (!state.parallel_state) {
 		// sequential scan
 		function.function(context.client, bind_data.get(), state.operator_data.get(), chunk);
@@ -87,6 +113,27 @@ void PhysicalTableScan::GetChunkInternal(ExecutionContext &context, DataChunk &c
 	}
 }
 
+bool PhysicalTableScan::ApplyBloomFilter(DataChunk &chunk, PhysicalOperatorState *state_) {
+	auto &state = (PhysicalTableScanOperatorState &)*state_;
+	SelectionVector sel(STANDARD_VECTOR_SIZE);
+	idx_t count = runtime_filter->Select(chunk, sel);
+	state.bloom_probed += chunk.size();
+	state.bloom_passed += count;
+	if (state.bloom_probed >= RuntimeJoinFilter::BLOOM_FILTER_SAMPLE_SIZE &&
+	    state.bloom_probed - state.bloom_passed < state.bloom_probed / RuntimeJoinFilter::BLOOM_FILTER_MIN_REMOVED) {
+		// the Bloom filter removes too few rows to pay off: stop probing it
+		state.use_bloom_filter = false;
+	}
+	if (count == chunk.size()) {
+		return true;
+	}
+	if (count == 0) {
+		return false;
+	}
+	chunk.Slice(sel, count);
+	return true;
+}
+
 string PhysicalTableScan::GetName() const {
 	return StringUtil::Upper(function.name);
 }
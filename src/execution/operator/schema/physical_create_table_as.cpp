@@ -3,6 +3,7 @@
 #include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
 #include "duckdb/execution/expression_executor.hpp"
 #include "duckdb/storage/data_table.hpp"
+#include "duckdb/storage/table/local_append_storage.hpp"
 
 namespace duckdb {
 
@@ -22,6 +23,14 @@ public:
 	std::mutex append_lock;
 	TableCatalogEntry *table;
 	int64_t inserted_count;
+	//! The storages of the threads, which are merged into the table in the Finalize
+	vector<unique_ptr<LocalAppendStorage>> storages;
+};
+
+class CreateTableAsLocalState : public LocalSinkState {
+public:
+	//! The rows appended by this thread
+	unique_ptr<LocalAppendStorage> storage;
 };
 
 unique_ptr<GlobalOperatorState> PhysicalCreateTableAs::GetGlobalState(ClientContext &context) {
@@ -31,14 +40,43 @@ unique_ptr<GlobalOperatorState> PhysicalCreateTableAs::GetGlobalState(ClientCont
 	return move(sink);
 }
 
+unique_ptr<LocalSinkState> PhysicalCreateTableAs::GetLocalSinkState(ExecutionContext &context) {
+	return make_unique<CreateTableAsLocalState>();
+}
+
 void PhysicalCreateTableAs::Sink(ExecutionContext &context, GlobalOperatorState &state, LocalSinkState &lstate_,
                                  DataChunk &input) {
 	auto &sink = (CreateTableAsGlobalState &)state;
+	auto &lstate = (CreateTableAsLocalState &)lstate_;
 	if (sink.table) {
-		lock_guard<mutex> client_guard(sink.append_lock);
-		sink.table->storage->Append(*sink.table, context.client, input);
-		sink.inserted_count += input.size();
+		// the new table has no indexes: the threads append to storages of their own
+		if (!lstate.storage) {
+			lstate.storage = make_unique<LocalAppendStorage>(*sink.table->storage);
+		}
+		sink.table->storage->LocalAppend(*sink.table, context.client, *lstate.storage, input);
+	}
+}
+
+void PhysicalCreateTableAs::Combine(ExecutionContext &context, GlobalOperatorState &state, LocalSinkState &lstate_) {
+	auto &sink = (CreateTableAsGlobalState &)state;
+	auto &lstate = (CreateTableAsLocalState &)lstate_;
+	if (!lstate.storage) {
+		return;
+	}
+	lock_guard<mutex> client_guard(sink.append_lock);
+	sink.inserted_count += lstate.storage->Count();
+	sink.storages.push_back(move(lstate.storage));
+}
+
+void PhysicalCreateTableAs::Finalize(Pipeline &pipeline, ClientContext &context,
+                                     unique_ptr<GlobalOperatorState> state) {
+	auto &sink = (CreateTableAsGlobalState &)*state;
+	// append the rows of the threads to the table
+	for (auto &storage : sink.storages) {
+		sink.table->storage->MergeStorage(*sink.table, context, *storage);
 	}
+	sink.storages.clear();
+	PhysicalSink::Finalize(pipeline, context, move(state));
 }
 
 //===--------------------------------------------------------------------===//
@@ -32,9 +32,9 @@ RadixPartitionInfo::RadixPartitionInfo(idx_t _n_partitions_upper_bound)
 
 PartitionableHashTable::PartitionableHashTable(BufferManager &_buffer_manager, RadixPartitionInfo &_partition_info,
                                                vector<LogicalType> _group_types, vector<LogicalType> _payload_types,
-                                               vector<BoundAggregateExpression *> _bindings)
+                                               vector<BoundAggregateExpression *> _bindings, idx_t _max_ht_size)
     : buffer_manager(_buffer_manager), group_types(_group_types), payload_types(_payload_types), bindings(_bindings),
-      is_partitioned(false), partition_info(_partition_info) {
+      is_partitioned(false), partition_info(_partition_info), max_ht_size(_max_ht_size) {
 
 	sel_vectors.resize(partition_info.n_partitions);
 	sel_vector_sizes.resize(partition_info.n_partitions);
@@ -52,10 +52,13 @@ PartitionableHashTable::PartitionableHashTable(BufferManager &_buffer_manager, R
 
 idx_t PartitionableHashTable::ListAddChunk(HashTableList &list, DataChunk &groups, Vector &group_hashes,
                                            DataChunk &payload) {
-	if (list.empty() || list.back()->Size() + groups.size() > list.back()->MaxCapacity()) {
+	if (list.empty() || list.back()->Size() + groups.size() > list.back()->MaxCapacity() ||
+	    list.back()->SizeInBytes() >= max_ht_size) {
 		if (!list.empty()) {
 			// early release first part of ht and prevent adding of more data
 			list.back()->Finalize();
+			// the ht is not touched until it is partitioned or combined: allow its blocks to be evicted
+			list.back()->Unpin();
 		}
 		list.push_back(make_unique<GroupedAggregateHashTable>(buffer_manager, group_types, payload_types, bindings,
 		                                                      HtEntryType::HT_WIDTH_32));
@@ -110,23 +113,32 @@ idx_t PartitionableHashTable::AddChunk(DataChunk &groups, DataChunk &payload, bo
 	return group_count;
 }
 
-void PartitionableHashTable::Partition() {
+idx_t PartitionableHashTable::Partition() {
 	D_ASSERT(!IsPartitioned());
 	D_ASSERT(radix_partitioned_hts.size() == 0);
 	D_ASSERT(partition_info.n_partitions > 1);
 
+	idx_t spilled_bytes = 0;
 	vector<GroupedAggregateHashTable *> partition_hts;
 	for (auto &unpartitioned_ht : unpartitioned_hts) {
+		// only the partitions of the last ht are added to after partitioning, the others can be evicted
+		for (auto &partition_ht : partition_hts) {
+			partition_ht->Finalize();
+			partition_ht->Unpin();
+		}
+		partition_hts.clear();
 		for (idx_t r = 0; r < partition_info.n_partitions; r++) {
 			radix_partitioned_hts[r].push_back(make_unique<GroupedAggregateHashTable>(
 			    buffer_manager, group_types, payload_types, bindings, HtEntryType::HT_WIDTH_32));
 			partition_hts.push_back(radix_partitioned_hts[r].back().get());
 		}
+		spilled_bytes += unpartitioned_ht->Pin();
 		unpartitioned_ht->Partition(partition_hts, partition_info.radix_mask, partition_info.RADIX_SHIFT);
 		unpartitioned_ht.reset();
 	}
 	unpartitioned_hts.clear();
 	is_partitioned = true;
+	return spilled_bytes;
 }
 
 bool PartitionableHashTable::IsPartitioned() {
@@ -150,12 +162,14 @@ void PartitionableHashTable::Finalize() {
 			for (auto &ht : ht_list.second) {
 				D_ASSERT(ht);
 				ht->Finalize();
+				ht->Unpin();
 			}
 		}
 	} else {
 		for (auto &ht : unpartitioned_hts) {
 			D_ASSERT(ht);
 			ht->Finalize();
+			ht->Unpin();
 		}
 	}
 }
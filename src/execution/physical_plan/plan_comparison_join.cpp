@@ -1,5 +1,7 @@
+#include "duckdb/common/operator/subtract.hpp"
 #include "duckdb/execution/operator/join/physical_cross_product.hpp"
 #include "duckdb/execution/operator/join/physical_hash_join.hpp"
+#include "duckdb/execution/operator/join/physical_iejoin.hpp"
 #include "duckdb/execution/operator/join/physical_index_join.hpp"
 #include "duckdb/execution/operator/join/physical_nested_loop_join.hpp"
 #include "duckdb/execution/operator/join/physical_piecewise_merge_join.hpp"
@@ -7,7 +9,9 @@
 #include "duckdb/execution/physical_plan_generator.hpp"
 #include "duckdb/function/table/table_scan.hpp"
 #include "duckdb/main/client_context.hpp"
+#include "duckdb/planner/expression/bound_reference_expression.hpp"
 #include "duckdb/planner/operator/logical_comparison_join.hpp"
+#include "duckdb/storage/statistics/numeric_statistics.hpp"
 #include "duckdb/transaction/transaction.hpp"
 
 namespace duckdb {
@@ -63,6 +67,86 @@ void TransformIndexJoin(ClientContext &context, LogicalComparisonJoin &op, Index
 	}
 }
 
+//! Pushes a runtime filter on the build-side keys of the hash join into the scan of its probe side, if the probe side
+//! is a base table scan of which the equality keys are plain columns
+static void PlanRuntimeFilter(PhysicalHashJoin &join) {
+	if (join.join_type != JoinType::INNER && join.join_type != JoinType::SEMI && join.join_type != JoinType::RIGHT) {
+		// the other joins emit the probe-side rows that do not find a match
+		return;
+	}
+	if (join.children[0]->type != PhysicalOperatorType::TABLE_SCAN) {
+		return;
+	}
+	auto &scan = (PhysicalTableScan &)*join.children[0];
+	if (!scan.function.filter_pushdown || !dynamic_cast<TableScanBindData *>(scan.bind_data.get())) {
+		return;
+	}
+	vector<idx_t> key_columns;
+	for (auto &cond : join.conditions) {
+		if (cond.comparison != ExpressionType::COMPARE_EQUAL) {
+			// the equality conditions are ordered before the other conditions
+			break;
+		}
+		if (cond.left->type != ExpressionType::BOUND_REF) {
+			return;
+		}
+		auto column_index = ((BoundReferenceExpression &)*cond.left).index;
+		if (scan.column_ids[column_index] == COLUMN_IDENTIFIER_ROW_ID) {
+			return;
+		}
+		key_columns.push_back(column_index);
+	}
+	D_ASSERT(!key_columns.empty());
+	join.runtime_filter = make_shared<RuntimeJoinFilter>(move(key_columns));
+	scan.runtime_filter = join.runtime_filter;
+}
+
+//! Uses the statistics of the build-side key to check whether the HT of a join on a single integer key can be a perfect
+//! hash table, which is indexed on the key instead of on its hash. Whether or not the keys are unique is only known
+//! when the HT is finalized.
+static void PlanPerfectHashJoin(LogicalComparisonJoin &op, PhysicalHashJoin &join) {
+	if (join.conditions.size() != 1 || op.join_stats.size() != 1 || !op.join_stats[0]) {
+		return;
+	}
+	auto &condition = join.conditions[0];
+	if (condition.null_values_are_equal) {
+		return;
+	}
+	auto &nstats = (NumericStatistics &)*op.join_stats[0];
+	if (nstats.min.is_null || nstats.max.is_null) {
+		return;
+	}
+	int64_t min, range;
+	switch (condition.right->return_type.InternalType()) {
+	case PhysicalType::INT8:
+		min = nstats.min.GetValueUnsafe<int8_t>();
+		range = int64_t(nstats.max.GetValueUnsafe<int8_t>()) - min;
+		break;
+	case PhysicalType::INT16:
+		min = nstats.min.GetValueUnsafe<int16_t>();
+		range = int64_t(nstats.max.GetValueUnsafe<int16_t>()) - min;
+		break;
+	case PhysicalType::INT32:
+		min = nstats.min.GetValueUnsafe<int32_t>();
+		range = int64_t(nstats.max.GetValueUnsafe<int32_t>()) - min;
+		break;
+	case PhysicalType::INT64:
+		min = nstats.min.GetValueUnsafe<int64_t>();
+		if (!TrySubtractOperator::Operation(nstats.max.GetValueUnsafe<int64_t>(), min, range)) {
+			return;
+		}
+		break;
+	default:
+		// we only support simple integer types for perfect hashing
+		return;
+	}
+	if (range < 0 || idx_t(range) >= PhysicalHashJoin::PERFECT_HASH_MAX_RANGE) {
+		return;
+	}
+	join.perfect_hash_min = min;
+	join.perfect_hash_range = idx_t(range) + 1;
+}
+
 unique_ptr<PhysicalOperator> PhysicalPlanGenerator::CreatePlan(LogicalComparisonJoin &op) {
 	// now visit the children
 	D_ASSERT(op.children.size() == 2);
@@ -113,11 +197,19 @@ unique_ptr<PhysicalOperator> PhysicalPlanGenerator::CreatePlan(LogicalComparison
 			                                      right_index, true);
 		}
 		// equality join: use hash join
-		plan = make_unique<PhysicalHashJoin>(op, move(left), move(right), move(op.conditions), op.join_type,
-		                                     op.left_projection_map, op.right_projection_map, move(op.delim_types));
+		auto hash_join =
+		    make_unique<PhysicalHashJoin>(op, move(left), move(right), move(op.conditions), op.join_type,
+		                                  op.left_projection_map, op.right_projection_map, move(op.delim_types));
+		PlanRuntimeFilter(*hash_join);
+		PlanPerfectHashJoin(op, *hash_join);
+		plan = move(hash_join);
 	} else {
 		D_ASSERT(!has_null_equal_conditions); // don't support this for anything but hash joins for now
-		if (op.conditions.size() == 1 && !has_inequality) {
+		if (rhs_cardinality >= PhysicalIEJoin::MIN_BUILD_CARDINALITY &&
+		    PhysicalIEJoin::CanUseIEJoin(op.conditions, op.join_type)) {
+			// two inequality conditions (e.g. a band join): use the IEJoin
+			plan = make_unique<PhysicalIEJoin>(op, move(left), move(right), move(op.conditions), op.join_type);
+		} else if (op.conditions.size() == 1 && !has_inequality) {
 			// range join: use piecewise merge join
 			plan =
 			    make_unique<PhysicalPiecewiseMergeJoin>(op, move(left), move(right), move(op.conditions), op.join_type);
@@ -0,0 +1,136 @@
+#include "duckdb/execution/runtime_join_filter.hpp"
+
+#include "duckdb/common/vector_operations/vector_operations.hpp"
+
+namespace duckdb {
+
+BloomFilter::BloomFilter(idx_t count) {
+	idx_t word_count = NextPowerOfTwo(MaxValue<idx_t>(count * BITS_PER_KEY / 64, 1));
+	bits = unique_ptr<std::atomic<uint64_t>[]>(new std::atomic<uint64_t>[word_count]);
+	for (idx_t i = 0; i < word_count; i++) {
+		bits[i] = 0;
+	}
+	word_mask = word_count - 1;
+}
+
+idx_t BloomFilter::Lookup(Vector &hashes, idx_t count, SelectionVector &result) {
+	VectorData hdata;
+	hashes.Orrify(count, hdata);
+	auto hash_data = (hash_t *)hdata.data;
+
+	idx_t result_count = 0;
+	for (idx_t i = 0; i < count; i++) {
+		auto hash = Mix(hash_data[hdata.sel->get_index(i)]);
+		auto mask = GetMask(hash);
+		if ((bits[hash & word_mask].load(std::memory_order_relaxed) & mask) == mask) {
+			result.set_index(result_count++, i);
+		}
+	}
+	return result_count;
+}
+
+RuntimeJoinFilter::RuntimeJoinFilter(vector<idx_t> key_columns) : key_columns(move(key_columns)), ready(false) {
+}
+
+bool RuntimeJoinFilter::SupportsMinMax(const LogicalType &type) {
+	switch (type.id()) {
+	case LogicalTypeId::TINYINT:
+	case LogicalTypeId::SMALLINT:
+	case LogicalTypeId::INTEGER:
+	case LogicalTypeId::BIGINT:
+	case LogicalTypeId::HUGEINT:
+	case LogicalTypeId::DATE:
+	case LogicalTypeId::TIME:
+	case LogicalTypeId::TIMESTAMP:
+		return true;
+	default:
+		return false;
+	}
+}
+
+template <class T>
+static void templated_update_min_max(Vector &keys, idx_t count, Value &min, Value &max) {
+	VectorData kdata;
+	keys.Orrify(count, kdata);
+	auto data = (T *)kdata.data;
+
+	bool found = false;
+	T min_value, max_value;
+	for (idx_t i = 0; i < count; i++) {
+		auto idx = kdata.sel->get_index(i);
+		if ((*kdata.nullmask)[idx]) {
+			continue;
+		}
+		if (!found) {
+			min_value = data[idx];
+			max_value = data[idx];
+			found = true;
+		} else if (data[idx] < min_value) {
+			min_value = data[idx];
+		} else if (max_value < data[idx]) {
+			max_value = data[idx];
+		}
+	}
+	if (!found) {
+		return;
+	}
+	if (min.is_null || min_value < min.GetValueUnsafe<T>()) {
+		min = Value(keys.type);
+		min.is_null = false;
+		min.GetValueUnsafe<T>() = min_value;
+	}
+	if (max.is_null || max.GetValueUnsafe<T>() < max_value) {
+		max = Value(keys.type);
+		max.is_null = false;
+		max.GetValueUnsafe<T>() = max_value;
+	}
+}
+
+void RuntimeJoinFilter::UpdateMinMax(Vector &keys, idx_t count, Value &min, Value &max) {
+	D_ASSERT(SupportsMinMax(keys.type));
+	switch (keys.type.InternalType()) {
+	case PhysicalType::INT8:
+		templated_update_min_max<int8_t>(keys, count, min, max);
+		break;
+	case PhysicalType::INT16:
+		templated_update_min_max<int16_t>(keys, count, min, max);
+		break;
+	case PhysicalType::INT32:
+		templated_update_min_max<int32_t>(keys, count, min, max);
+		break;
+	case PhysicalType::INT64:
+		templated_update_min_max<int64_t>(keys, count, min, max);
+		break;
+	case PhysicalType::INT128:
+		templated_update_min_max<hugeint_t>(keys, count, min, max);
+		break;
+	default:
+		throw InternalException("Unsupported type for RuntimeJoinFilter::UpdateMinMax");
+	}
+}
+
+void RuntimeJoinFilter::Reset() {
+	ready = false;
+	zonemap_filters.filters.clear();
+	bloom_filter.reset();
+}
+
+void RuntimeJoinFilter::AddMinMax(idx_t key_idx, Value min, Value max) {
+	auto column_index = key_columns[key_idx];
+	auto &filters = zonemap_filters.filters[column_index];
+	filters.push_back(TableFilter(move(min), ExpressionType::COMPARE_GREATERTHANOREQUALTO, column_index));
+	filters.push_back(TableFilter(move(max), ExpressionType::COMPARE_LESSTHANOREQUALTO, column_index));
+}
+
+idx_t RuntimeJoinFilter::Select(DataChunk &chunk, SelectionVector &sel) {
+	D_ASSERT(ready && bloom_filter);
+	// hash the keys in the same way as the join HT hashes them
+	Vector hashes(LogicalType::HASH);
+	VectorOperations::Hash(chunk.data[key_columns[0]], hashes, chunk.size());
+	for (idx_t i = 1; i < key_columns.size(); i++) {
+		VectorOperations::CombineHash(hashes, chunk.data[key_columns[i]], chunk.size());
+	}
+	return bloom_filter->Lookup(hashes, chunk.size(), sel);
+}
+
+} // namespace duckdb
@@ -7,23 +7,45 @@
 
 namespace duckdb {
 
+WindowSegmentTreeState::WindowSegmentTreeState(WindowSegmentTree &tree)
+    : state(tree.state_size), frame_statep(LogicalType::POINTER), leaf_sel(STANDARD_VECTOR_SIZE),
+      leaf_statep(LogicalType::POINTER), leaf_chunk(0), leaf_count(0), node_sourcep(LogicalType::POINTER),
+      node_targetp(LogicalType::POINTER), node_count(0) {
+	Value ptr_val = Value::POINTER((idx_t)state.data());
+	statep.Reference(ptr_val);
+	statep.Normalify(STANDARD_VECTOR_SIZE);
+
+	frame_states = unique_ptr<data_t[]>(new data_t[STANDARD_VECTOR_SIZE * tree.state_size]);
+	auto frame_pointers = FlatVector::GetData<data_ptr_t>(frame_statep);
+	for (idx_t i = 0; i < STANDARD_VECTOR_SIZE; i++) {
+		frame_pointers[i] = frame_states.get() + i * tree.state_size;
+	}
+
+	if (tree.input_ref && tree.input_ref->ColumnCount() > 0) {
+		inputs.Initialize(tree.input_ref->Types());
+		leaves.InitializeEmpty(tree.input_ref->Types());
+	}
+}
+
 WindowSegmentTree::WindowSegmentTree(AggregateFunction &aggregate, FunctionData *bind_info, LogicalType result_type,
                                      ChunkCollection *input)
-    : aggregate(aggregate), bind_info(bind_info), result_type(result_type), state(aggregate.state_size()),
+    : aggregate(aggregate), bind_info(bind_info), result_type(result_type), state_size(aggregate.state_size()),
       internal_nodes(0), input_ref(input) {
 #if STANDARD_VECTOR_SIZE < 512
 	throw NotImplementedException("Window functions are not supported for vector sizes < 512");
 #endif
-	Value ptr_val = Value::POINTER((idx_t)state.data());
-	statep.Reference(ptr_val);
-	statep.Normalify(STANDARD_VECTOR_SIZE);
-
-	if (input_ref && input_ref->ColumnCount() > 0) {
-		inputs.Initialize(input_ref->Types());
-		if (aggregate.combine) {
-			ConstructTree();
-		}
+	if (!input_ref || input_ref->ColumnCount() == 0 || !aggregate.combine) {
+		return;
+	}
+	// compute space required to store internal nodes of segment tree
+	levels_flat_start.push_back(0);
+	idx_t level_size = input_ref->Count();
+	while (level_size > 1) {
+		level_size = (level_size + (TREE_FANOUT - 1)) / TREE_FANOUT;
+		internal_nodes += level_size;
+		levels_flat_start.push_back(internal_nodes);
 	}
+	levels_flat_native = unique_ptr<data_t[]>(new data_t[internal_nodes * state_size]);
 }
 
 WindowSegmentTree::~WindowSegmentTree() {
@@ -36,7 +58,7 @@ WindowSegmentTree::~WindowSegmentTree() {
 	Vector addresses(LogicalType::POINTER, (data_ptr_t)address_data);
 	idx_t count = 0;
 	for (idx_t i = 0; i < internal_nodes; i++) {
-		address_data[count++] = uint64_t(levels_flat_native.get() + i * state.size());
+		address_data[count++] = uint64_t(levels_flat_native.get() + i * state_size);
 		if (count == STANDARD_VECTOR_SIZE) {
 			aggregate.destructor(addresses, count);
 			count = 0;
@@ -47,33 +69,21 @@ WindowSegmentTree::~WindowSegmentTree() {
 	}
 }
 
-void WindowSegmentTree::AggregateInit() {
-	aggregate.initialize(state.data());
-}
-
-Value WindowSegmentTree::AggegateFinal() {
-	Vector statev(Value::POINTER((idx_t)state.data()));
-	Vector result(result_type);
-	result.vector_type = VectorType::CONSTANT_VECTOR;
-	ConstantVector::SetNull(result, false);
-	aggregate.finalize(statev, bind_info, result, 1);
-
-	if (aggregate.destructor) {
-		aggregate.destructor(statev, 1);
-	}
-	return result.GetValue(0);
+void WindowSegmentTree::AggregateInit(WindowSegmentTreeState &lstate) {
+	aggregate.initialize(lstate.state.data());
 }
 
-void WindowSegmentTree::WindowSegmentValue(idx_t l_idx, idx_t begin, idx_t end) {
+void WindowSegmentTree::WindowSegmentValue(WindowSegmentTreeState &lstate, idx_t l_idx, idx_t begin, idx_t end) {
 	D_ASSERT(begin <= end);
 	if (begin == end) {
 		return;
 	}
+	auto &inputs = lstate.inputs;
 	inputs.Reset();
 	inputs.SetCardinality(end - begin);
 
 	Vector s;
-	s.Slice(statep, 0);
+	s.Slice(lstate.statep, 0);
 	idx_t start_in_vector = begin % STANDARD_VECTOR_SIZE;
 	if (l_idx == 0) {
 		const auto input_count = input_ref->ColumnCount();
@@ -101,95 +111,166 @@ void WindowSegmentTree::WindowSegmentValue(idx_t l_idx, idx_t begin, idx_t end)
 	} else {
 		D_ASSERT(end - begin <= STANDARD_VECTOR_SIZE);
 		// find out where the states begin
-		data_ptr_t begin_ptr = levels_flat_native.get() + state.size() * (begin + levels_flat_start[l_idx - 1]);
+		data_ptr_t begin_ptr = levels_flat_native.get() + state_size * (begin + levels_flat_start[l_idx - 1]);
 		// set up a vector of pointers that point towards the set of states
 		Vector v(LogicalType::POINTER);
 		auto pdata = FlatVector::GetData<data_ptr_t>(v);
 		for (idx_t i = 0; i < inputs.size(); i++) {
-			pdata[i] = begin_ptr + i * state.size();
+			pdata[i] = begin_ptr + i * state_size;
 		}
 		v.Verify(inputs.size());
 		aggregate.combine(v, s, inputs.size());
 	}
 }
 
-void WindowSegmentTree::ConstructTree() {
-	D_ASSERT(input_ref);
-	D_ASSERT(inputs.ColumnCount() > 0);
+void WindowSegmentTree::ConstructLevel(WindowSegmentTreeState &lstate, idx_t level, idx_t begin, idx_t end) {
+	D_ASSERT(level + 1 < levels_flat_start.size());
+	D_ASSERT(begin % TREE_FANOUT == 0);
+	// level 0 is data itself
+	idx_t level_size = level == 0 ? input_ref->Count() : levels_flat_start[level] - levels_flat_start[level - 1];
+	D_ASSERT(end <= level_size);
+	for (idx_t pos = begin; pos < end; pos += TREE_FANOUT) {
+		// compute the aggregate for this entry in the segment tree
+		AggregateInit(lstate);
+		WindowSegmentValue(lstate, level, pos, MinValue<idx_t>(level_size, pos + TREE_FANOUT));
 
-	// compute space required to store internal nodes of segment tree
-	internal_nodes = 0;
-	idx_t level_nodes = input_ref->Count();
-	do {
-		level_nodes = (level_nodes + (TREE_FANOUT - 1)) / TREE_FANOUT;
-		internal_nodes += level_nodes;
-	} while (level_nodes > 1);
-	levels_flat_native = unique_ptr<data_t[]>(new data_t[internal_nodes * state.size()]);
-	levels_flat_start.push_back(0);
+		auto node_idx = levels_flat_start[level] + pos / TREE_FANOUT;
+		memcpy(levels_flat_native.get() + node_idx * state_size, lstate.state.data(), state_size);
+	}
+}
 
-	idx_t levels_flat_offset = 0;
-	idx_t level_current = 0;
-	// level 0 is data itself
-	idx_t level_size;
-	// iterate over the levels of the segment tree
-	while ((level_size = (level_current == 0 ? input_ref->Count()
-	                                         : levels_flat_offset - levels_flat_start[level_current - 1])) > 1) {
-		for (idx_t pos = 0; pos < level_size; pos += TREE_FANOUT) {
-			// compute the aggregate for this entry in the segment tree
-			AggregateInit();
-			WindowSegmentValue(level_current, pos, MinValue<idx_t>(level_size, pos + TREE_FANOUT));
+void WindowSegmentTree::Construct(WindowSegmentTreeState &lstate) {
+	if (!HasInternalNodes()) {
+		return;
+	}
+	ConstructFirstLevel(lstate, 0, input_ref->Count());
+	ConstructUpperLevels(lstate);
+}
 
-			memcpy(levels_flat_native.get() + (levels_flat_offset * state.size()), state.data(), state.size());
+void WindowSegmentTree::ConstructFirstLevel(WindowSegmentTreeState &lstate, idx_t begin, idx_t end) {
+	D_ASSERT(HasInternalNodes());
+	ConstructLevel(lstate, 0, begin, end);
+}
 
-			levels_flat_offset++;
-		}
+void WindowSegmentTree::ConstructUpperLevels(WindowSegmentTreeState &lstate) {
+	D_ASSERT(HasInternalNodes());
+	// iterate over the levels of the segment tree
+	for (idx_t level = 1; level + 1 < levels_flat_start.size(); level++) {
+		ConstructLevel(lstate, level, 0, levels_flat_start[level] - levels_flat_start[level - 1]);
+	}
+}
 
-		levels_flat_start.push_back(levels_flat_offset);
-		level_current++;
+void WindowSegmentTree::FlushLeaves(WindowSegmentTreeState &lstate) {
+	if (lstate.leaf_count == 0) {
+		return;
 	}
+	auto &chunk = input_ref->GetChunk(lstate.leaf_chunk);
+	lstate.leaves.Slice(chunk, lstate.leaf_sel, lstate.leaf_count);
+	aggregate.update(&lstate.leaves.data[0], bind_info, lstate.leaves.ColumnCount(), lstate.leaf_statep,
+	                 lstate.leaf_count);
+	lstate.leaf_count = 0;
 }
 
-Value WindowSegmentTree::Compute(idx_t begin, idx_t end) {
-	D_ASSERT(input_ref);
+void WindowSegmentTree::FlushNodes(WindowSegmentTreeState &lstate) {
+	if (lstate.node_count == 0) {
+		return;
+	}
+	aggregate.combine(lstate.node_sourcep, lstate.node_targetp, lstate.node_count);
+	lstate.node_count = 0;
+}
 
-	// No arguments, so just count
-	if (inputs.ColumnCount() == 0) {
-		return Value::Numeric(result_type, end - begin);
+void WindowSegmentTree::AddFrameSegment(WindowSegmentTreeState &lstate, idx_t l_idx, idx_t begin, idx_t end,
+                                        data_ptr_t frame_state) {
+	if (l_idx == 0) {
+		// gather the input rows, which are aggregated into the frame states in batches per input chunk
+		auto leaf_states = FlatVector::GetData<data_ptr_t>(lstate.leaf_statep);
+		for (idx_t row_idx = begin; row_idx < end; row_idx++) {
+			auto chunk_idx = row_idx / STANDARD_VECTOR_SIZE;
+			bool other_chunk = lstate.leaf_count > 0 && chunk_idx != lstate.leaf_chunk;
+			if (lstate.leaf_count == STANDARD_VECTOR_SIZE || other_chunk) {
+				FlushLeaves(lstate);
+			}
+			lstate.leaf_chunk = chunk_idx;
+			lstate.leaf_sel.set_index(lstate.leaf_count, row_idx % STANDARD_VECTOR_SIZE);
+			leaf_states[lstate.leaf_count++] = frame_state;
+		}
+		return;
+	}
+	// gather the nodes of the level, which are combined into the frame states in batches
+	auto sources = FlatVector::GetData<data_ptr_t>(lstate.node_sourcep);
+	auto targets = FlatVector::GetData<data_ptr_t>(lstate.node_targetp);
+	data_ptr_t begin_ptr = levels_flat_native.get() + state_size * (begin + levels_flat_start[l_idx - 1]);
+	for (idx_t i = 0; i < end - begin; i++) {
+		if (lstate.node_count == STANDARD_VECTOR_SIZE) {
+			FlushNodes(lstate);
+		}
+		sources[lstate.node_count] = begin_ptr + i * state_size;
+		targets[lstate.node_count++] = frame_state;
 	}
+}
 
-	AggregateInit();
+void WindowSegmentTree::Evaluate(WindowSegmentTreeState &lstate, const idx_t begins[], const idx_t ends[],
+                                 Vector &result, idx_t count) {
+	D_ASSERT(input_ref);
+	D_ASSERT(result.vector_type == VectorType::FLAT_VECTOR);
 
-	// Aggregate everything at once if we can't combine states
-	if (!aggregate.combine) {
-		WindowSegmentValue(0, begin, end);
-		if (end - begin >= STANDARD_VECTOR_SIZE) {
-			throw InternalException(
-			    "Cannot compute window aggregation: bounds are too large for non-combinable aggregate");
+	// No arguments, so just count
+	if (lstate.inputs.ColumnCount() == 0) {
+		if (result_type.InternalType() != PhysicalType::INT64) {
+			for (idx_t i = 0; i < count; i++) {
+				result.SetValue(i, Value::Numeric(result_type, ends[i] - begins[i]));
+			}
+			return;
+		}
+		auto result_data = FlatVector::GetData<int64_t>(result);
+		for (idx_t i = 0; i < count; i++) {
+			result_data[i] = ends[i] - begins[i];
 		}
-		return AggegateFinal();
+		return;
 	}
 
-	for (idx_t l_idx = 0; l_idx < levels_flat_start.size() + 1; l_idx++) {
-		idx_t parent_begin = begin / TREE_FANOUT;
-		idx_t parent_end = end / TREE_FANOUT;
-		if (parent_begin == parent_end) {
-			WindowSegmentValue(l_idx, begin, end);
-			return AggegateFinal();
+	auto frame_states = FlatVector::GetData<data_ptr_t>(lstate.frame_statep);
+	for (idx_t i = 0; i < count; i++) {
+		aggregate.initialize(frame_states[i]);
+	}
+	for (idx_t i = 0; i < count; i++) {
+		idx_t begin = begins[i];
+		idx_t end = ends[i];
+		if (begin >= end) {
+			continue;
 		}
-		idx_t group_begin = parent_begin * TREE_FANOUT;
-		if (begin != group_begin) {
-			WindowSegmentValue(l_idx, begin, group_begin + TREE_FANOUT);
-			parent_begin++;
+		// Aggregate everything at once if we can't combine states
+		if (!aggregate.combine) {
+			AddFrameSegment(lstate, 0, begin, end, frame_states[i]);
+			continue;
 		}
-		idx_t group_end = parent_end * TREE_FANOUT;
-		if (end != group_end) {
-			WindowSegmentValue(l_idx, group_end, end);
+		for (idx_t l_idx = 0; l_idx < levels_flat_start.size() + 1; l_idx++) {
+			idx_t parent_begin = begin / TREE_FANOUT;
+			idx_t parent_end = end / TREE_FANOUT;
+			if (parent_begin == parent_end) {
+				AddFrameSegment(lstate, l_idx, begin, end, frame_states[i]);
+				break;
+			}
+			idx_t group_begin = parent_begin * TREE_FANOUT;
+			if (begin != group_begin) {
+				AddFrameSegment(lstate, l_idx, begin, group_begin + TREE_FANOUT, frame_states[i]);
+				parent_begin++;
+			}
+			idx_t group_end = parent_end * TREE_FANOUT;
+			if (end != group_end) {
+				AddFrameSegment(lstate, l_idx, group_end, end, frame_states[i]);
+			}
+			begin = parent_begin;
+			end = parent_end;
 		}
-		begin = parent_begin;
-		end = parent_end;
 	}
+	FlushLeaves(lstate);
+	FlushNodes(lstate);
 
-	return AggegateFinal();
+	aggregate.finalize(lstate.frame_statep, bind_info, result, count);
+	if (aggregate.destructor) {
+		aggregate.destructor(lstate.frame_statep, count);
+	}
 }
 
 } // namespace duckdb
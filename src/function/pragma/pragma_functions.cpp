@@ -122,6 +122,14 @@ static void pragma_disable_force_parallelism(ClientContext &context, FunctionPar
 	context.force_parallelism = false;
 }
 
+static void pragma_enable_preserve_insertion_order(ClientContext &context, FunctionParameters parameters) {
+	context.preserve_insertion_order = true;
+}
+
+static void pragma_disable_preserve_insertion_order(ClientContext &context, FunctionParameters parameters) {
+	context.preserve_insertion_order = false;
+}
+
 static void pragma_enable_object_cache(ClientContext &context, FunctionParameters parameters) {
 	DBConfig::GetConfig(context).object_cache_enable = true;
 }
@@ -138,6 +146,14 @@ static void pragma_disable_checkpoint_on_shutdown(ClientContext &context, Functi
 	DBConfig::GetConfig(context).checkpoint_on_shutdown = false;
 }
 
+static void pragma_enable_temporary_compression(ClientContext &context, FunctionParameters parameters) {
+	DBConfig::GetConfig(context).temporary_compression = true;
+}
+
+static void pragma_disable_temporary_compression(ClientContext &context, FunctionParameters parameters) {
+	DBConfig::GetConfig(context).temporary_compression = false;
+}
+
 static void pragma_log_query_path(ClientContext &context, FunctionParameters parameters) {
 	auto str_val = parameters.values[0].ToString();
 	if (str_val.empty()) {
@@ -199,6 +215,19 @@ static void pragma_debug_checkpoint_abort(ClientContext &context, FunctionParame
 	}
 }
 
+static void pragma_force_compression(ClientContext &context, FunctionParameters parameters) {
+	auto compression = CompressionTypeFromString(parameters.values[0].ToString());
+	DBConfig::GetConfig(context).force_compression = compression;
+}
+
+static void pragma_read_ahead_depth(ClientContext &context, FunctionParameters parameters) {
+	auto depth = parameters.values[0].GetValue<int64_t>();
+	if (depth < 0) {
+		throw ParserException("Read-ahead depth out of range: should be a non-negative amount of blocks");
+	}
+	DBConfig::GetConfig(context).read_ahead_depth = depth;
+}
+
 void PragmaFunctions::RegisterFunction(BuiltinFunctions &set) {
 	register_enable_profiling(set);
 
@@ -228,6 +257,11 @@ void PragmaFunctions::RegisterFunction(BuiltinFunctions &set) {
 	set.AddFunction(PragmaFunction::PragmaStatement("force_parallelism", pragma_enable_force_parallelism));
 	set.AddFunction(PragmaFunction::PragmaStatement("disable_force_parallelism", pragma_disable_force_parallelism));
 
+	set.AddFunction(
+	    PragmaFunction::PragmaStatement("preserve_insertion_order", pragma_enable_preserve_insertion_order));
+	set.AddFunction(
+	    PragmaFunction::PragmaStatement("disable_preserve_insertion_order", pragma_disable_preserve_insertion_order));
+
 	set.AddFunction(PragmaFunction::PragmaStatement("enable_object_cache", pragma_enable_object_cache));
 	set.AddFunction(PragmaFunction::PragmaStatement("disable_object_cache", pragma_disable_object_cache));
 
@@ -245,6 +279,11 @@ void PragmaFunctions::RegisterFunction(BuiltinFunctions &set) {
 	set.AddFunction(
 	    PragmaFunction::PragmaStatement("disable_checkpoint_on_shutdown", pragma_disable_checkpoint_on_shutdown));
 
+	set.AddFunction(
+	    PragmaFunction::PragmaStatement("enable_temporary_compression", pragma_enable_temporary_compression));
+	set.AddFunction(
+	    PragmaFunction::PragmaStatement("disable_temporary_compression", pragma_disable_temporary_compression));
+
 	set.AddFunction(
 	    PragmaFunction::PragmaAssignment("perfect_ht_threshold", pragma_perfect_ht_threshold, LogicalType::INTEGER));
 
@@ -255,6 +294,11 @@ void PragmaFunctions::RegisterFunction(BuiltinFunctions &set) {
 
 	set.AddFunction(PragmaFunction::PragmaAssignment("debug_checkpoint_abort", pragma_debug_checkpoint_abort,
 	                                                 LogicalType::VARCHAR));
+
+	set.AddFunction(
+	    PragmaFunction::PragmaAssignment("force_compression", pragma_force_compression, LogicalType::VARCHAR));
+
+	set.AddFunction(PragmaFunction::PragmaAssignment("read_ahead_depth", pragma_read_ahead_depth, LogicalType::BIGINT));
 }
 
 idx_t ParseMemoryLimit(string arg) {
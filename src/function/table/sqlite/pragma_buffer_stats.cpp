@@ -0,0 +1,56 @@
+#include "duckdb/function/table/sqlite_functions.hpp"
+
+#include "duckdb/storage/buffer_manager.hpp"
+
+namespace duckdb {
+
+struct PragmaBufferStatsData : public FunctionOperatorData {
+	PragmaBufferStatsData() : finished(false) {
+	}
+
+	bool finished;
+};
+
+static unique_ptr<FunctionData> pragma_buffer_stats_bind(ClientContext &context, vector<Value> &inputs,
+                                                         unordered_map<string, Value> &named_parameters,
+                                                         vector<LogicalType> &return_types, vector<string> &names) {
+	names.push_back("hits");
+	return_types.push_back(LogicalType::BIGINT);
+
+	names.push_back("misses");
+	return_types.push_back(LogicalType::BIGINT);
+
+	names.push_back("evictions");
+	return_types.push_back(LogicalType::BIGINT);
+
+	return nullptr;
+}
+
+unique_ptr<FunctionOperatorData> pragma_buffer_stats_init(ClientContext &context, const FunctionData *bind_data,
+                                                          vector<column_t> &column_ids,
+                                                          TableFilterCollection *filters) {
+	return make_unique<PragmaBufferStatsData>();
+}
+
+void pragma_buffer_stats(ClientContext &context, const FunctionData *bind_data, FunctionOperatorData *operator_state,
+                         DataChunk &output) {
+	auto &data = (PragmaBufferStatsData &)*operator_state;
+	if (data.finished) {
+		return;
+	}
+	auto stats = BufferManager::GetBufferManager(context).GetStatistics();
+
+	output.SetCardinality(1);
+	output.data[0].SetValue(0, Value::BIGINT(stats.hits));
+	output.data[1].SetValue(0, Value::BIGINT(stats.misses));
+	output.data[2].SetValue(0, Value::BIGINT(stats.evictions));
+
+	data.finished = true;
+}
+
+void PragmaBufferStats::RegisterFunction(BuiltinFunctions &set) {
+	set.AddFunction(TableFunction("pragma_buffer_stats", {}, pragma_buffer_stats, pragma_buffer_stats_bind,
+	                              pragma_buffer_stats_init));
+}
+
+} // namespace duckdb
@@ -15,6 +15,7 @@ void BuiltinFunctions::RegisterSQLiteFunctions() {
 	PragmaTableInfo::RegisterFunction(*this);
 	SQLiteMaster::RegisterFunction(*this);
 	PragmaDatabaseSize::RegisterFunction(*this);
+	PragmaBufferStats::RegisterFunction(*this);
 	PragmaDatabaseList::RegisterFunction(*this);
 
 	// CreateViewInfo info;
@@ -36,6 +36,7 @@ static unique_ptr<FunctionOperatorData> table_scan_init(ClientContext &context,
 	auto &bind_data = (const TableScanBindData &)*bind_data_;
 	result->column_ids = column_ids;
 	result->scan_state.table_filters = filters->table_filters;
+	result->scan_state.zonemap_filters = filters->zonemap_filters;
 	bind_data.table->storage->InitializeScan(transaction, result->scan_state, result->column_ids,
 	                                         filters->table_filters);
 	return move(result);
@@ -58,6 +59,7 @@ static unique_ptr<FunctionOperatorData> table_scan_parallel_init(ClientContext &
 	auto result = make_unique<TableScanOperatorData>();
 	result->column_ids = column_ids;
 	result->scan_state.table_filters = filters->table_filters;
+	result->scan_state.zonemap_filters = filters->zonemap_filters;
 	if (!table_scan_parallel_state_next(context, bind_data_, result.get(), state)) {
 		return nullptr;
 	}
@@ -100,6 +102,12 @@ bool table_scan_parallel_state_next(ClientContext &context, const FunctionData *
 	                                                  state.column_ids);
 }
 
+idx_t table_scan_get_batch_index(ClientContext &context, const FunctionData *bind_data_,
+                                 FunctionOperatorData *operator_state) {
+	auto &state = (TableScanOperatorData &)*operator_state;
+	return state.scan_state.batch_index;
+}
+
 void table_scan_dependency(unordered_set<CatalogEntry *> &entries, const FunctionData *bind_data_) {
 	auto &bind_data = (const TableScanBindData &)*bind_data_;
 	entries.insert(bind_data.table);
@@ -301,6 +309,7 @@ void table_scan_pushdown_complex_filter(ClientContext &context, LogicalGet &get,
 				get.function.max_threads = nullptr;
 				get.function.init_parallel_state = nullptr;
 				get.function.parallel_state_next = nullptr;
+				get.function.get_batch_index = nullptr;
 				get.function.filter_pushdown = false;
 			} else {
 				bind_data.result_ids.clear();
@@ -328,6 +337,7 @@ TableFunction TableScanFunction::GetFunction() {
 	scan_function.init_parallel_state = table_scan_init_parallel_state;
 	scan_function.parallel_init = table_scan_parallel_init;
 	scan_function.parallel_state_next = table_scan_parallel_state_next;
+	scan_function.get_batch_index = table_scan_get_batch_index;
 	scan_function.projection_pushdown = true;
 	scan_function.filter_pushdown = true;
 	return scan_function;
@@ -0,0 +1,34 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// duckdb/common/enums/compression_type.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/constants.hpp"
+
+namespace duckdb {
+
+//===--------------------------------------------------------------------===//
+// Compression Types
+//===--------------------------------------------------------------------===//
+enum class CompressionType : uint8_t {
+	COMPRESSION_AUTO = 0,         // automatically choose the compression at checkpoint time
+	COMPRESSION_UNCOMPRESSED = 1, // no compression
+	COMPRESSION_RLE = 2,          // run-length encoding
+	COMPRESSION_BITPACKING = 3,   // bit-packing of non-negative values
+	COMPRESSION_FOR = 4,          // frame-of-reference: bit-packing of the difference with the minimum value
+	COMPRESSION_DICTIONARY = 5,   // dictionary encoding of strings
+	COMPRESSION_FSST = 6,         // symbol table (FSST) encoding of strings
+	COMPRESSION_CHIMP = 7         // XOR-based encoding of floating point values (Chimp)
+};
+
+//! Convert compression type to string
+string CompressionTypeToString(CompressionType type);
+//! Convert a string to a compression type, throws an exception if the string is not a valid compression type
+CompressionType CompressionTypeFromString(const string &str);
+
+} // namespace duckdb
@@ -42,9 +42,19 @@ public:
 
 	void Clear();
 
+	//! Store the checksum of the contents in front of the buffer, after which the AllocSize() bytes at InternalBuffer()
+	//! can be written out by the caller (e.g. in compressed form)
+	void StoreChecksum();
+	//! Verify the checksum after the AllocSize() bytes at InternalBuffer() were read in by the caller, throws an
+	//! exception if the checksum does not match
+	void VerifyChecksum();
+
 	uint64_t AllocSize() {
 		return internal_size;
 	}
+	data_ptr_t InternalBuffer() {
+		return internal_buffer;
+	}
 
 private:
 	//! The pointer to the internal buffer that will be read or written, including the buffer header
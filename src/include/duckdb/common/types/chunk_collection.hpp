@@ -101,6 +101,11 @@ public:
 	}
 
 	void Sort(vector<OrderType> &desc, vector<OrderByNullType> &null_order, idx_t result[]);
+	//! Compares the row at index left of the left collection with the row at index right of the right collection,
+	//! returns a negative number, zero or a positive number if the left row sorts before, equal to or after the right
+	//! row
+	static int CompareRows(ChunkCollection &left_collection, ChunkCollection &right_collection, idx_t left,
+	                       idx_t right, vector<OrderType> &desc, vector<OrderByNullType> &null_order);
 	//! Reorders the rows in the collection according to the given indices. NB: order is changed!
 	void Reorder(idx_t order[]);
 
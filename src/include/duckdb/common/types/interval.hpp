@@ -48,6 +48,10 @@ public:
 	//! Returns the difference between two timestamps
 	static interval_t GetDifference(timestamp_t timestamp_1, timestamp_t timestamp_2);
 
+	//! Normalizes the interval into months, days and micros, such that the days and micros do not overflow into the
+	//! months and the micros do not overflow into the days. Intervals are ordered by their normalized entries.
+	static void Normalize(interval_t input, int64_t &months, int64_t &days, int64_t &micros);
+
 	//! Comparison operators
 	static bool Equals(interval_t left, interval_t right);
 	static bool GreaterThan(interval_t left, interval_t right);
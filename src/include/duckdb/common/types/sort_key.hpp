@@ -0,0 +1,80 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// duckdb/common/types/sort_key.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/enums/order_type.hpp"
+#include "duckdb/common/types/data_chunk.hpp"
+
+#include <functional>
+
+namespace duckdb {
+
+//! Compares two sort key entries with equal keys on the ORDER BY columns of the rows they reference, returns a value
+//! smaller than, equal to or larger than zero
+typedef std::function<int(data_ptr_t left_entry, data_ptr_t right_entry)> sort_tie_compare_t;
+
+//! The SortKeyLayout encodes the ORDER BY columns of a row into a fixed-width binary key, such that comparing two keys
+//! with memcmp gives the same result as comparing the ORDER BY columns of the rows. Every column is encoded as a byte
+//! that determines the NULL order, followed by the value in big-endian order with its sign bit flipped. The bytes of
+//! descending columns are inverted. A key entry is followed by a field that references the row it was encoded from.
+/*!
+    Strings are encoded as a fixed-size prefix, two keys with an equal prefix do not necessarily belong to equal rows.
+    Encoding stops after the first string column (or before the first column that cannot be encoded): rows with equal
+    keys then have to be compared on their ORDER BY columns to determine their order.
+*/
+class SortKeyLayout {
+public:
+	//! The amount of bytes of a string that are encoded in the key
+	static constexpr idx_t STRING_PREFIX_SIZE = 12;
+	//! Buckets of the radix sort with at most this many entries are sorted with a comparison sort instead
+	static constexpr idx_t RADIX_SORT_THRESHOLD = 64;
+
+	SortKeyLayout(vector<LogicalType> &types, vector<OrderType> order_types, vector<OrderByNullType> null_orders);
+
+	//! The order types of the ORDER BY columns
+	vector<OrderType> order_types;
+	//! The NULL orders of the ORDER BY columns
+	vector<OrderByNullType> null_orders;
+	//! The offsets of the encoded columns within the key
+	vector<idx_t> column_offsets;
+	//! The width of the key
+	idx_t key_width;
+	//! The width of an entry, i.e. the key followed by the row index
+	idx_t entry_size;
+	//! Whether or not the keys fully determine the order of the rows. If not, rows with equal keys have to be compared
+	//! on their ORDER BY columns.
+	bool exact;
+	//! The index of the first ORDER BY column whose values are not fully determined by the keys, i.e. rows with equal
+	//! keys only have to be compared on this column and the columns after it
+	idx_t inexact_column;
+
+public:
+	//! Encodes the keys of the rows of the chunk into consecutive entries, the row fields of the entries are not set
+	void Encode(DataChunk &keys, data_ptr_t entries);
+	//! Sorts the entries with an MSD radix sort on the keys. If the keys are not exact, entries with equal keys are
+	//! ordered with the given comparison function.
+	void Sort(data_ptr_t entries, idx_t count, const sort_tie_compare_t &compare_ties);
+
+	//! Returns the row reference stored in an entry
+	idx_t GetRow(data_ptr_t entry) {
+		return Load<idx_t>(entry + key_width);
+	}
+	//! Sets the row reference stored in an entry
+	void SetRow(data_ptr_t entry, idx_t row) {
+		Store<idx_t>(row, entry + key_width);
+	}
+
+private:
+	void RadixSort(data_ptr_t entries, data_ptr_t temp, idx_t count, idx_t offset,
+	               const sort_tie_compare_t &compare_ties);
+	void ComparisonSort(data_ptr_t entries, data_ptr_t temp, idx_t count, idx_t offset,
+	                    const sort_tie_compare_t &compare_ties);
+};
+
+} // namespace duckdb
@@ -88,6 +88,9 @@ public:
 	void Slice(const SelectionVector &sel, idx_t count);
 	//! Slice the vector, keeping the result around in a cache or potentially using the cache instead of slicing
 	void Slice(const SelectionVector &sel, idx_t count, SelCache &cache);
+	//! Turns the vector into a dictionary vector that selects entries from the specified dictionary (a
+	//! VectorChildBuffer). Unlike Slice, the dictionary can be shared between many vectors.
+	void Dictionary(buffer_ptr<VectorBuffer> dictionary, const SelectionVector &sel);
 
 	//! Creates the data of this vector with the specified type. Any data that
 	//! is currently in the vector is destroyed.
@@ -150,6 +153,9 @@ public:
 
 public:
 	Vector data;
+	//! The amount of entries in the child vector if it is a dictionary that is shared between vectors (e.g. the
+	//! dictionary of a compressed segment), or 0 if the amount of entries is unknown
+	idx_t dictionary_size = 0;
 };
 
 struct ConstantVector {
@@ -187,6 +193,17 @@ struct DictionaryVector {
 		D_ASSERT(vector.vector_type == VectorType::DICTIONARY_VECTOR);
 		return ((VectorChildBuffer &)*vector.auxiliary).data;
 	}
+	//! Returns the buffer holding the child of the dictionary vector, this buffer is shared by all vectors that
+	//! reference the same dictionary
+	static inline const buffer_ptr<VectorBuffer> &ChildBuffer(const Vector &vector) {
+		D_ASSERT(vector.vector_type == VectorType::DICTIONARY_VECTOR);
+		return vector.auxiliary;
+	}
+	//! Returns the amount of entries in the dictionary, or 0 if the amount of entries is unknown
+	static inline idx_t DictionarySize(const Vector &vector) {
+		D_ASSERT(vector.vector_type == VectorType::DICTIONARY_VECTOR);
+		return ((VectorChildBuffer &)*vector.auxiliary).dictionary_size;
+	}
 };
 
 struct FlatVector {
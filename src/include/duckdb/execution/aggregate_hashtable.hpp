@@ -71,7 +71,7 @@ public:
 
 	//! Scan the HT starting from the scan_position until the result and group
 	//! chunks are filled. scan_position will be updated by this function.
-	//! Returns the amount of elements found.
+	//! Returns the amount of elements found. Different threads can scan a HT at the same time.
 	idx_t Scan(idx_t &scan_position, DataChunk &result);
 
 	//! Fetch the aggregates for specific groups from the HT and place them in the result
@@ -99,6 +99,14 @@ public:
 	void Partition(vector<GroupedAggregateHashTable *> &partition_hts, hash_t mask, idx_t shift);
 
 	void Finalize();
+	//! Unpins the payload blocks of a finalized HT, so they can be evicted to the temporary directory while the HT is
+	//! not used. The HT has to be pinned again before it is combined, partitioned or scanned.
+	void Unpin();
+	//! Pins the payload blocks of the HT, returns the amount of bytes that had to be read back from the temporary
+	//! directory
+	idx_t Pin();
+	//! Returns the amount of memory the payload blocks and the pointer table of the HT use
+	idx_t SizeInBytes();
 
 	//! The stringheap of the AggregateHashTable
 	StringHeap string_heap;
@@ -120,8 +128,11 @@ private:
 	//! The amount of entries stored in the HT currently
 	idx_t entries;
 	//! The data of the HT
+	vector<shared_ptr<BlockHandle>> payload_blocks;
+	//! The pins of the payload blocks, empty if the HT is unpinned
 	vector<unique_ptr<BufferHandle>> payload_hds;
 	vector<data_ptr_t> payload_hds_ptrs;
+	bool is_pinned;
 
 	//! The hashes of the HT
 	unique_ptr<BufferHandle> hashes_hdl;
@@ -134,7 +145,7 @@ private:
 	//! Bitmask for getting relevant bits from the hashes to determine the position
 	hash_t bitmask;
 
-	//! Pointer vector for Scan()
+	//! Pointer vector for AddChunk()
 	Vector addresses;
 
 	vector<unique_ptr<GroupedAggregateHashTable>> distinct_hashes;
@@ -169,6 +180,10 @@ private:
 	template <class T>
 	idx_t FindOrCreateGroupsInternal(DataChunk &groups, Vector &group_hashes, Vector &addresses,
 	                                 SelectionVector &new_groups);
+	//! Find or create the groups of a single dictionary-encoded group column, looking up every used dictionary entry
+	//! only once
+	idx_t FindOrCreateDictionaryGroups(DataChunk &groups, Vector &group_hashes, Vector &addresses,
+	                                   SelectionVector &new_groups);
 
 	template <class FUNC = std::function<void(idx_t, idx_t, data_ptr_t)>>
 	void PayloadApply(FUNC fun);
@@ -20,6 +20,7 @@ class ClientContext;
 class DataChunk;
 class PhysicalOperator;
 class PhysicalOperatorState;
+class PhysicalResultCollector;
 class ThreadContext;
 class Task;
 
@@ -36,7 +37,9 @@ public:
 	ClientContext &context;
 
 public:
-	void Initialize(PhysicalOperator *physical_plan);
+	//! Executes the pipelines of the plan. If a collector is given and the root pipeline of the plan can be executed in
+	//! parallel, the result of the plan is materialized into the collector. Otherwise it is fetched with FetchChunk().
+	void Initialize(PhysicalOperator *physical_plan, PhysicalResultCollector *collector = nullptr);
 	void BuildPipelines(PhysicalOperator *op, Pipeline *parent);
 
 	void Reset();
@@ -13,8 +13,13 @@
 #include "duckdb/planner/bound_tokens.hpp"
 #include "duckdb/planner/expression.hpp"
 
+#include <functional>
+
 namespace duckdb {
 
+//! Evaluates an expression on the entries of a dictionary, with the dictionary taking the place of the input
+typedef std::function<void(Vector &entries, idx_t entry_count, Vector &result)> dictionary_function_t;
+
 //! ExpressionExecutor is responsible for executing a set of expressions and storing the result in a data chunk
 class ExpressionExecutor {
 public:
@@ -50,6 +55,16 @@ public:
 	//! Evaluate a scalar expression and fold it into a single value
 	static Value EvaluateScalar(Expression &expr);
 
+	//! Evaluate an expression on the entries of the dictionary of its only non-foldable input, instead of on every row
+	//! of that input. This is possible if the input is a dictionary vector over a dictionary of known size. The result
+	//! is a dictionary vector over the evaluated entries; the evaluated entries are cached in the state for as long as
+	//! the same dictionary is used. Returns false if the input does not qualify.
+	static bool ExecuteOnDictionary(ExpressionState &state, Vector &input, idx_t count, Vector &result,
+	                                const dictionary_function_t &function);
+	//! Generate the selection vectors from the result of a boolean expression
+	static idx_t SelectBooleans(Vector &booleans, const SelectionVector *sel, idx_t count, SelectionVector *true_sel,
+	                            SelectionVector *false_sel);
+
 	//! Initialize the state of a given expression
 	static unique_ptr<ExpressionState> InitializeState(Expression &expr, ExpressionExecutorState &state);
 
@@ -28,6 +28,16 @@ struct ExpressionState {
 	vector<LogicalType> types;
 	DataChunk intermediate_chunk;
 
+	//! The index of the only child that is not foldable, or INVALID_INDEX if there is no such child. If this child
+	//! produces a dictionary vector, the expression can be evaluated on the entries of the dictionary instead.
+	idx_t dictionary_child = INVALID_INDEX;
+	//! The amount of children that are not foldable
+	idx_t non_foldable_children = 0;
+	//! The dictionary the expression was last evaluated on
+	buffer_ptr<VectorBuffer> dictionary;
+	//! The result of evaluating the expression on the entries of that dictionary
+	buffer_ptr<VectorBuffer> dictionary_result;
+
 public:
 	void AddChild(Expression *expr);
 	void Finalize();
@@ -24,6 +24,10 @@
 #include "duckdb/execution/index/art/node256.hpp"
 
 namespace duckdb {
+class BlockHandle;
+class DatabaseInstance;
+class MetaBlockWriter;
+
 struct IteratorEntry {
 	IteratorEntry() {
 	}
@@ -73,6 +77,8 @@ public:
 	bool is_little_endian;
 	//! Whether or not the ART is an index built to enforce a UNIQUE constraint
 	bool is_unique;
+	//! The database the nodes of the tree are loaded from, only set if the index was loaded from storage
+	DatabaseInstance *db;
 
 public:
 	//! Initialize a scan on the index with the given expression and column ids
@@ -102,8 +108,18 @@ public:
 	//! Search Equal used for Joins that do not need to fetch data
 	void SearchEqualJoinNoFetch(Value &equal_value, idx_t &result_size);
 
+	//! Serialize the nodes of the tree with the writer, returns a pointer to the root node. The blocks that contain
+	//! nodes of the tree are added to "blocks".
+	BlockPointer Serialize(MetaBlockWriter &writer, vector<block_id_t> &blocks);
+	//! Initialize the tree from the nodes that were serialized at the given root pointer. The nodes are not loaded
+	//! until they are first accessed.
+	void LoadFromStorage(DatabaseInstance &db, BlockPointer root, const vector<block_id_t> &blocks);
+
 private:
 	DataChunk expression_result;
+	//! The handles of the blocks the nodes of the tree are loaded from, they keep the blocks registered in the buffer
+	//! manager until the tree has been fully loaded
+	vector<shared_ptr<BlockHandle>> block_handles;
 
 private:
 	//! Insert a row id into a leaf node
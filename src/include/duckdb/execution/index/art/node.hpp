@@ -10,11 +10,13 @@
 
 #include "duckdb/execution/index/art/art_key.hpp"
 #include "duckdb/common/common.hpp"
+#include "duckdb/storage/block.hpp"
 
 namespace duckdb {
-enum class NodeType : uint8_t { N4 = 0, N16 = 1, N48 = 2, N256 = 3, NLeaf = 4 };
+enum class NodeType : uint8_t { N4 = 0, N16 = 1, N48 = 2, N256 = 3, NLeaf = 4, NSwizzled = 5 };
 
 class ART;
+class MetaBlockWriter;
 
 class Node {
 public:
@@ -62,9 +64,26 @@ public:
 	//! Erase entry from node
 	static void Erase(ART &art, unique_ptr<Node> &node, idx_t pos);
 
+	//! Serialize the node and all of its children, returns a pointer to the serialized node
+	BlockPointer Serialize(ART &art, MetaBlockWriter &writer);
+	//! Deserialize the node stored at the given pointer, the children of the node are not loaded
+	static unique_ptr<Node> Deserialize(ART &art, BlockPointer pointer);
+	//! Load the node from storage if it has not been loaded yet
+	static void Unswizzle(unique_ptr<Node> &node);
+
 protected:
 	//! Copies the prefix from the source to the destination node
 	static void CopyPrefix(ART &art, Node *src, Node *dst);
 };
 
+//! A node that is stored on disk and has not been loaded yet. Swizzled nodes are replaced by the actual node when they
+//! are first accessed through Node::GetChild.
+class SwizzledNode : public Node {
+public:
+	SwizzledNode(ART &art, BlockPointer pointer);
+
+	ART &art;
+	BlockPointer pointer;
+};
+
 } // namespace duckdb
@@ -18,6 +18,7 @@
 namespace duckdb {
 class BufferManager;
 class BufferHandle;
+class BloomFilter;
 
 struct JoinHTScanState {
 	JoinHTScanState() : position(0), block_position(0) {
@@ -117,19 +118,48 @@ private:
 
 	idx_t AppendToBlock(HTDataBlock &block, BufferHandle &handle, vector<BlockAppendEntry> &append_entries,
 	                    idx_t remaining);
-
-	void Hash(DataChunk &keys, const SelectionVector &sel, idx_t count, Vector &hashes);
+	//! Allocates space for the given amount of entries in the blocks of the HT, the blocks are pinned in handles
+	void AllocateEntries(idx_t entry_count, vector<unique_ptr<BufferHandle>> &handles, data_ptr_t key_locations[]);
+	//! Returns the capacity of the pointer table constructed in Finalize
+	idx_t PointerTableCapacity();
 
 public:
 	JoinHashTable(BufferManager &buffer_manager, vector<JoinCondition> &conditions, vector<LogicalType> build_types,
 	              JoinType type);
 	~JoinHashTable();
 
-	//! Add the given data to the HT
+	//! Add the given data to the HT. Build is not thread-safe: every thread builds its own HT, which is merged into the
+	//! global HT with Merge.
 	void Build(DataChunk &keys, DataChunk &input);
+	//! Moves the data blocks and the strings of another HT into this HT
+	void Merge(JoinHashTable &other);
 	//! Finalize the build of the HT, constructing the actual hash table and making the HT ready for probing. Finalize
 	//! must be called before any call to Probe, and after Finalize is called Build should no longer be ever called.
 	void Finalize();
+	//! Allocates the pointer table and pins all data blocks, this is the first step of a (parallel) finalize
+	void InitializePointerTable();
+	//! Inserts the entries of the data blocks [block_idx_start, block_idx_end) into the pointer table. If parallel is
+	//! true, different ranges of blocks can be inserted concurrently.
+	void Finalize(idx_t block_idx_start, idx_t block_idx_end, bool parallel);
+	//! Tries to finalize the HT as a perfect hash table, of which the pointer table is indexed on (key - min_key)
+	//! instead of on the hash. This is only possible for a single integer equality condition. Returns false, without
+	//! finalizing the HT, if a key falls outside of [min_key, min_key + capacity) or occurs more than once.
+	bool FinalizePerfectHash(int64_t min_key, idx_t capacity);
+	//! Radix partitions the entries of this HT over the given empty HTs on the upper radix_bits of their hashes. The
+	//! strings remain in the string heap of this HT, which must outlive the partitions.
+	void Partition(vector<unique_ptr<JoinHashTable>> &partitions, idx_t radix_bits);
+	//! Releases the pointer table and unpins the blocks of a finalized partition. A partition can be finalized again
+	//! after it was unpinned, so only the partitions that are probed have to be kept in memory.
+	void Unpin();
+	//! Returns the amount of memory the finalized HT requires
+	idx_t SizeInBytes();
+	//! Hash the keys of the given selection
+	void Hash(DataChunk &keys, const SelectionVector &sel, idx_t count, Vector &hashes);
+	//! Returns the radix partition of a hash
+	static idx_t RadixPartition(hash_t hash, idx_t radix_bits) {
+		D_ASSERT(radix_bits > 0 && radix_bits < sizeof(hash_t) * 8);
+		return hash >> (sizeof(hash_t) * 8 - radix_bits);
+	}
 	//! Probe the HT with the given input chunk, resulting in the given result
 	unique_ptr<ScanStructure> Probe(DataChunk &keys);
 	//! Scan the HT to construct the final full outer join result after
@@ -138,6 +168,10 @@ public:
 	idx_t size() {
 		return count;
 	}
+	//! The amount of data blocks of the HT
+	idx_t BlockCount() {
+		return blocks.size();
+	}
 
 	//! The stringheap of the JoinHashTable
 	StringHeap string_heap;
@@ -163,6 +197,8 @@ public:
 	idx_t tuple_size;
 	//! Next pointer offset in tuple
 	idx_t pointer_offset;
+	//! The offset of the hash in a tuple
+	idx_t hash_offset;
 	//! The join type of the HT
 	JoinType join_type;
 	//! Whether or not the HT has been finalized
@@ -171,8 +207,17 @@ public:
 	bool has_null;
 	//! Bitmask for getting relevant bits from the hashes to determine the position
 	uint64_t bitmask;
+	//! Whether or not the pointer table is indexed on the key instead of on the hash. The keys of a perfect HT are
+	//! unique, so the entry a key points to always matches it.
+	bool perfect_hash;
+	//! The key stored in the first slot of the pointer table of a perfect HT
+	int64_t perfect_hash_min;
+	//! The amount of slots of the pointer table of a perfect HT
+	idx_t perfect_hash_capacity;
 	//! The amount of entries stored per block
 	idx_t block_capacity;
+	//! If set, the hashes of the entries are inserted into this Bloom filter when the HT is finalized or partitioned
+	BloomFilter *bloom_filter;
 
 	struct {
 		std::mutex mj_lock;
@@ -195,9 +240,14 @@ private:
 	//! Apply a bitmask to the hashes
 	void ApplyBitmask(Vector &hashes, idx_t count);
 	void ApplyBitmask(Vector &hashes, const SelectionVector &sel, idx_t count, Vector &pointers);
-	//! Insert the given set of locations into the HT with the given set of
-	//! hashes. Caller should hold lock in parallel HT.
-	void InsertHashes(Vector &hashes, idx_t count, data_ptr_t key_locations[]);
+	//! Insert the given set of locations into the HT with the given set of hashes. If parallel is true, the pointers
+	//! are swapped in with an atomic compare-and-swap.
+	void InsertHashes(Vector &hashes, idx_t count, data_ptr_t key_locations[], bool parallel);
+
+	//! Points the pointers of the selected keys to their entries in the pointer table of a perfect HT, returns the
+	//! amount of keys that have an entry. The selection of these keys is written to result.
+	idx_t ProbePerfectHash(VectorData &key_data, const SelectionVector &sel, idx_t count, Vector &pointers,
+	                       SelectionVector &result);
 
 	idx_t PrepareKeys(DataChunk &keys, unique_ptr<VectorData[]> &key_data, const SelectionVector *&current_sel,
 	                  SelectionVector &sel, bool build_side);
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "duckdb/execution/physical_sink.hpp"
+#include "duckdb/parallel/parallel_state.hpp"
 #include "duckdb/storage/data_table.hpp"
 
 namespace duckdb {
@@ -26,6 +27,15 @@ public:
 	                      vector<unique_ptr<Expression>> groups,
 	                      PhysicalOperatorType type = PhysicalOperatorType::HASH_GROUP_BY);
 
+	//! The amount of radix partitions per thread. Using more partitions than threads keeps the partitions that are
+	//! combined at the same time small enough to fit in memory, while the others remain evicted.
+	static constexpr idx_t PARTITIONS_PER_THREAD = 4;
+	//! The minimum size of a thread-local HT before it is unpinned
+	static constexpr idx_t MIN_HT_SIZE = 4 * Storage::BLOCK_ALLOC_SIZE;
+	//! The amount of groups of a finalized HT that are scanned by a single thread at a time in a parallel scan, this
+	//! has to be a multiple of STANDARD_VECTOR_SIZE
+	static constexpr idx_t MORSEL_SIZE = 64 * STANDARD_VECTOR_SIZE;
+
 	//! The groups
 	vector<unique_ptr<Expression>> groups;
 	//! The aggregates that have to be computed
@@ -65,6 +75,12 @@ public:
 
 	string ParamsToString() const override;
 
+	//! The amount of morsels the finalized HTs are split into for a parallel scan, 0 if they cannot be scanned in
+	//! parallel
+	idx_t MorselCount();
+	//! Returns the state of a parallel scan of the finalized HTs
+	unique_ptr<ParallelState> GetParallelState();
+
 private:
 	//! how many groups can we have in the operator before we switch to radix partitioning
 	idx_t radix_limit;
@@ -35,6 +35,17 @@ public:
 public:
 	//! The projection list of the WINDOW statement (may contain aggregates)
 	vector<unique_ptr<Expression>> select_list;
+
+	//! The amount of tasks per thread that the window expressions are computed in: the sunk rows are hash partitioned
+	//! on the PARTITION BY keys into this many partitions per thread, and a single large partition is split into this
+	//! many ranges of rows per thread
+	static constexpr idx_t TASKS_PER_THREAD = 4;
+	//! The minimum amount of rows of a single partition that a task evaluates
+	static constexpr idx_t MIN_TASK_ROWS = 16 * STANDARD_VECTOR_SIZE;
+
+private:
+	//! Returns the amount of bits of the hash of the PARTITION BY keys on which the sunk rows are partitioned
+	idx_t GetRadixBits(ClientContext &context);
 };
 
 } // namespace duckdb
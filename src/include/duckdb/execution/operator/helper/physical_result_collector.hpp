@@ -0,0 +1,44 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// duckdb/execution/operator/helper/physical_result_collector.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/execution/physical_sink.hpp"
+#include "duckdb/common/types/chunk_collection.hpp"
+
+namespace duckdb {
+
+//! PhysicalResultCollector materializes the result of a plan, so that the pipeline that produces the result can be
+//! executed by multiple threads. The collector is not part of the plan: it only references its root.
+class PhysicalResultCollector : public PhysicalSink {
+public:
+	PhysicalResultCollector(PhysicalOperator *plan, bool preserve_order)
+	    : PhysicalSink(PhysicalOperatorType::RESULT_COLLECTOR, plan->types), plan(plan),
+	      preserve_order(preserve_order) {
+	}
+
+	//! The root of the plan of which the result is collected
+	PhysicalOperator *plan;
+	//! Whether or not the rows are collected in the order in which a single thread would produce them. If not, the
+	//! threads append their rows in any order.
+	bool preserve_order;
+
+public:
+	unique_ptr<GlobalOperatorState> GetGlobalState(ClientContext &context) override;
+	unique_ptr<LocalSinkState> GetLocalSinkState(ExecutionContext &context) override;
+	void Sink(ExecutionContext &context, GlobalOperatorState &state, LocalSinkState &lstate, DataChunk &input) override;
+	void Combine(ExecutionContext &context, GlobalOperatorState &state, LocalSinkState &lstate) override;
+	void Finalize(Pipeline &pipeline, ClientContext &context, unique_ptr<GlobalOperatorState> gstate) override;
+
+	void GetChunkInternal(ExecutionContext &context, DataChunk &chunk, PhysicalOperatorState *state) override;
+
+	//! Returns the collected rows, can only be called after the pipeline has finished
+	ChunkCollection &GetResult();
+};
+
+} // namespace duckdb
@@ -12,6 +12,7 @@
 #include "duckdb/execution/join_hashtable.hpp"
 #include "duckdb/execution/operator/join/physical_comparison_join.hpp"
 #include "duckdb/execution/physical_operator.hpp"
+#include "duckdb/execution/runtime_join_filter.hpp"
 #include "duckdb/planner/operator/logical_join.hpp"
 
 namespace duckdb {
@@ -25,6 +26,15 @@ public:
 	PhysicalHashJoin(LogicalOperator &op, unique_ptr<PhysicalOperator> left, unique_ptr<PhysicalOperator> right,
 	                 vector<JoinCondition> cond, JoinType join_type);
 
+	//! The minimum amount of HT blocks for which the pointer table is constructed by a separate finalize task
+	static constexpr idx_t FINALIZE_TASK_BLOCKS = 4;
+	//! The HT is radix partitioned if it requires more than 1/HT_MEMORY_FRACTION of the memory limit
+	static constexpr idx_t HT_MEMORY_FRACTION = 2;
+	//! The maximum amount of radix bits used to partition a HT that does not fit in memory
+	static constexpr idx_t MAX_RADIX_BITS = 6;
+	//! The maximum range of the build-side key for which a perfect hash table is constructed
+	static constexpr idx_t PERFECT_HASH_MAX_RANGE = idx_t(1) << 24;
+
 	vector<idx_t> right_projection_map;
 	//! The types of the keys
 	vector<LogicalType> condition_types;
@@ -32,19 +42,39 @@ public:
 	vector<LogicalType> build_types;
 	//! Duplicate eliminated types; only used for delim_joins (i.e. correlated subqueries)
 	vector<LogicalType> delim_types;
+	//! The filters derived from the build side that are pushed into the table scan of the probe side (optional)
+	shared_ptr<RuntimeJoinFilter> runtime_filter;
+	//! The minimum of the build-side key and the size of its range according to the statistics. If the range is not 0,
+	//! the HT is finalized as a perfect hash table, unless the keys turn out not to be unique.
+	int64_t perfect_hash_min;
+	idx_t perfect_hash_range;
 
 public:
 	unique_ptr<GlobalOperatorState> GetGlobalState(ClientContext &context) override;
 
 	unique_ptr<LocalSinkState> GetLocalSinkState(ExecutionContext &context) override;
 	void Sink(ExecutionContext &context, GlobalOperatorState &state, LocalSinkState &lstate, DataChunk &input) override;
+	void Combine(ExecutionContext &context, GlobalOperatorState &gstate, LocalSinkState &lstate) override;
 	void Finalize(Pipeline &pipeline, ClientContext &context, unique_ptr<GlobalOperatorState> gstate) override;
 
 	void GetChunkInternal(ExecutionContext &context, DataChunk &chunk, PhysicalOperatorState *state) override;
 	unique_ptr<PhysicalOperatorState> GetOperatorState() override;
 
 private:
+	//! Whether or not this is a correlated MARK join that keeps track of the counts of the correlated columns
+	bool IsCorrelatedMarkJoin() {
+		return join_type == JoinType::MARK && delim_types.size() > 0 && delim_types.size() + 1 == conditions.size();
+	}
+	//! Whether or not the HT can be radix partitioned when it does not fit in memory
+	bool CanPartition();
+	void BuildHashTable(GlobalOperatorState &state, LocalSinkState &lstate, DataChunk &payload);
+	//! Sets the runtime filter from the keys of the build side, before the pointer table of the HT is constructed
+	void SetRuntimeFilter(GlobalOperatorState &state);
 	void ProbeHashTable(ExecutionContext &context, DataChunk &chunk, PhysicalOperatorState *state_);
+	//! Radix partitions the entire probe side of the thread
+	void PartitionProbeSide(ExecutionContext &context, PhysicalOperatorState *state_);
+	//! Probes the partitions of a partitioned HT one at a time with the partitioned probe side
+	void ProbePartitions(ExecutionContext &context, DataChunk &chunk, PhysicalOperatorState *state_);
 };
 
 } // namespace duckdb
@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// duckdb/execution/operator/join/physical_iejoin.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/types/sort_key.hpp"
+#include "duckdb/execution/operator/join/physical_comparison_join.hpp"
+
+namespace duckdb {
+
+//! PhysicalIEJoin represents an inner join on two inequality conditions (e.g. a band join), using the IEJoin algorithm
+//! of Khayyat et al. The build side is sorted on both keys. A probe-side row then marks the build-side rows that
+//! satisfy its second condition in a bit array that is ordered on the first key, and scans the bits of the rows that
+//! satisfy its first condition.
+class PhysicalIEJoin : public PhysicalComparisonJoin {
+public:
+	PhysicalIEJoin(LogicalOperator &op, unique_ptr<PhysicalOperator> left, unique_ptr<PhysicalOperator> right,
+	               vector<JoinCondition> cond, JoinType join_type);
+
+	//! The minimum estimated amount of build-side rows for which an IEJoin is planned: smaller build sides are joined
+	//! about as fast by the nested loop join, which does not have to sort them
+	static constexpr idx_t MIN_BUILD_CARDINALITY = STANDARD_VECTOR_SIZE;
+	//! The maximum amount of probe-side rows that a thread joins with the build side at a time
+	static constexpr idx_t PROBE_BLOCK_SIZE = 64 * STANDARD_VECTOR_SIZE;
+
+	//! The types of the join keys
+	vector<LogicalType> join_key_types;
+	//! The layouts of the sort keys of the conditions. The keys are ordered such that the build-side rows that satisfy
+	//! the first condition for a probe-side row follow the position of the probe-side key, and the build-side rows
+	//! that satisfy the second condition precede it.
+	vector<unique_ptr<SortKeyLayout>> key_layouts;
+
+public:
+	//! Whether or not a join with the given conditions can be executed as an IEJoin
+	static bool CanUseIEJoin(vector<JoinCondition> &conditions, JoinType join_type);
+
+	unique_ptr<GlobalOperatorState> GetGlobalState(ClientContext &context) override;
+	unique_ptr<LocalSinkState> GetLocalSinkState(ExecutionContext &context) override;
+	void Sink(ExecutionContext &context, GlobalOperatorState &state, LocalSinkState &lstate, DataChunk &input) override;
+	void Combine(ExecutionContext &context, GlobalOperatorState &gstate, LocalSinkState &lstate) override;
+	void Finalize(Pipeline &pipeline, ClientContext &context, unique_ptr<GlobalOperatorState> gstate) override;
+
+	void GetChunkInternal(ExecutionContext &context, DataChunk &chunk, PhysicalOperatorState *state) override;
+	unique_ptr<PhysicalOperatorState> GetOperatorState() override;
+
+private:
+	//! Encodes the sort keys of one of the conditions for all rows of the collection into consecutive entries
+	unique_ptr<data_t[]> EncodeKeys(ChunkCollection &keys, idx_t key_idx);
+	//! Buffers the next block of probe-side rows, returns false if the probe side is exhausted
+	bool BufferProbeBlock(ExecutionContext &context, PhysicalOperatorState *state);
+	//! Sorts the buffered probe-side rows and positions them within the sorted build side
+	void InitializeProbeBlock(PhysicalOperatorState *state);
+	//! Finds the next matches of the buffered probe-side rows, returns the amount of matches that were found
+	idx_t JoinProbeBlock(PhysicalOperatorState *state, idx_t left_rows[], idx_t right_rows[]);
+};
+
+} // namespace duckdb
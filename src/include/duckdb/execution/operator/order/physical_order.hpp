@@ -14,9 +14,20 @@
 
 namespace duckdb {
 
-//! Represents a physical ordering of the data. Note that this will not change
-//! the data but only add a selection vector.
+//! Represents a physical ordering of the data. The ORDER BY columns are encoded into binary sort keys (see
+//! SortKeyLayout), every thread radix sorts the keys of the data it sinks into sorted runs, the runs are then merged
+//! pairwise in parallel. The runs are stored in buffer-managed blocks (see SortedRun), so an ORDER BY on more data
+//! than fits in memory spills to the temporary directory.
 class PhysicalOrder : public PhysicalSink {
+public:
+	//! The amount of rows of the merge path of two runs that is merged by a single task
+	static constexpr idx_t MERGE_PARTITION_SIZE = 131072;
+	//! The unsorted rows of all threads together use at most 1/RUN_MEMORY_FRACTION of the memory limit, a thread
+	//! sorts its rows into a run when its share is exhausted
+	static constexpr idx_t RUN_MEMORY_FRACTION = 4;
+	//! The maximum amount of memory used by the unsorted rows of a single thread
+	static constexpr idx_t MAX_RUN_SIZE = 64 * 1024 * 1024;
+
 public:
 	PhysicalOrder(vector<LogicalType> types, vector<BoundOrderByNode> orders)
 	    : PhysicalSink(PhysicalOperatorType::ORDER_BY, move(types)), orders(move(orders)) {
@@ -26,8 +37,10 @@ public:
 
 public:
 	void Sink(ExecutionContext &context, GlobalOperatorState &state, LocalSinkState &lstate, DataChunk &input) override;
+	void Combine(ExecutionContext &context, GlobalOperatorState &gstate, LocalSinkState &lstate) override;
 	void Finalize(Pipeline &pipeline, ClientContext &context, unique_ptr<GlobalOperatorState> state) override;
 	unique_ptr<GlobalOperatorState> GetGlobalState(ClientContext &context) override;
+	unique_ptr<LocalSinkState> GetLocalSinkState(ExecutionContext &context) override;
 
 	void GetChunkInternal(ExecutionContext &context, DataChunk &chunk, PhysicalOperatorState *state) override;
 	unique_ptr<PhysicalOperatorState> GetOperatorState() override;
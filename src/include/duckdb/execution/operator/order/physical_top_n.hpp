@@ -37,9 +37,6 @@ public:
 	unique_ptr<PhysicalOperatorState> GetOperatorState() override;
 
 	string ParamsToString() const override;
-
-private:
-	unique_ptr<idx_t[]> ComputeTopN(ChunkCollection &big_data, idx_t &heap_size);
 };
 
 } // namespace duckdb
@@ -0,0 +1,152 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// duckdb/execution/operator/order/sorted_run.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/types/chunk_collection.hpp"
+#include "duckdb/common/types/sort_key.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+
+namespace duckdb {
+
+//! The SortedRowLayout serializes the rows sunk into an ORDER BY into a self-contained binary format, so that they can
+//! be stored in buffer-managed blocks that are written to the temporary directory when memory runs out.
+/*!
+    A row starts with its size (as uint32_t), followed by the ORDER BY columns that are not fully determined by the
+    sort key (see SortKeyLayout::inexact_column) and the payload columns. Every column starts with a validity byte.
+    Fixed-size values follow the validity byte, strings are stored as their length (as uint32_t) followed by their
+    data if they are not NULL. Nested payload columns are not serialized: they remain in a ChunkCollection of the
+    thread that sunk them, and the row ends with a reference to the row in that collection.
+*/
+class SortedRowLayout {
+public:
+	//! A reference to a nested row: the upper bits store the index of the nested collection, the lower bits store the
+	//! index of the row within the collection
+	static constexpr idx_t NESTED_ROW_BITS = 48;
+	static constexpr idx_t NESTED_ROW_MASK = (idx_t(1) << NESTED_ROW_BITS) - 1;
+
+	SortedRowLayout(SortKeyLayout &key_layout, vector<LogicalType> &order_by_types, vector<LogicalType> payload_types);
+
+	//! The index of the first ORDER BY column that is stored in the rows
+	idx_t key_offset;
+	//! The types of the ORDER BY columns that are stored in the rows
+	vector<LogicalType> key_types;
+	//! The order types of the ORDER BY columns that are stored in the rows
+	vector<OrderType> order_types;
+	//! The NULL orders of the ORDER BY columns that are stored in the rows
+	vector<OrderByNullType> null_orders;
+	//! The types of the payload columns
+	vector<LogicalType> payload_types;
+	//! The indices of the payload columns that have a nested type
+	vector<idx_t> nested_columns;
+	//! The types of the nested payload columns
+	vector<LogicalType> nested_types;
+
+public:
+	//! Computes the sizes of the serialized rows of the chunk
+	void ComputeSizes(DataChunk &keys, DataChunk &payload, uint32_t sizes[]);
+	//! Serializes the rows of the chunk to the given locations. The nested payload columns of the rows are referenced
+	//! starting from first_nested_row.
+	void Serialize(DataChunk &keys, DataChunk &payload, uint32_t sizes[], data_ptr_t locations[],
+	               idx_t first_nested_row);
+	//! Deserializes the payload columns of the rows into the result, starting at the given offset
+	void Deserialize(data_ptr_t rows[], idx_t count, DataChunk &result, idx_t result_offset,
+	                 vector<unique_ptr<ChunkCollection>> &nested_data);
+	//! Compares two rows on the ORDER BY columns stored in them
+	int Compare(data_ptr_t left, data_ptr_t right);
+
+	//! Returns the size of a serialized row
+	static uint32_t GetSize(data_ptr_t row) {
+		return Load<uint32_t>(row);
+	}
+};
+
+//! A buffer-managed block of a sorted run. The sort key entries are stored at the start of the block, the rows are
+//! stored at the end of the block. The row field of an entry holds the offset of its row within the block.
+struct SortedBlock {
+	shared_ptr<BlockHandle> block;
+	//! The amount of entries in the block
+	idx_t count;
+	//! The index of the first entry of the block within its run
+	idx_t start;
+};
+
+//! A run of rows sorted on their sort keys
+struct SortedRun {
+	vector<SortedBlock> blocks;
+	idx_t count = 0;
+};
+
+//! Appends sort key entries and the rows they reference to new blocks, only the block that is written is pinned
+class SortedRunWriter {
+public:
+	SortedRunWriter(BufferManager &buffer_manager, SortKeyLayout &layout);
+
+	//! Appends a sort key entry and the row it references
+	void Append(data_ptr_t entry, data_ptr_t row);
+	//! Unpins the last block and returns the blocks that were written
+	vector<SortedBlock> Finish();
+
+private:
+	//! Allocate a new block that has space for at least the given amount of bytes
+	void NewBlock(idx_t required_space);
+
+	BufferManager &buffer_manager;
+	SortKeyLayout &layout;
+	vector<SortedBlock> blocks;
+	unique_ptr<BufferHandle> handle;
+	//! The end of the entries in the current block
+	idx_t entry_end;
+	//! The start of the rows in the current block
+	idx_t row_start;
+	//! The amount of entries appended
+	idx_t count;
+};
+
+//! Reads the entries of a sorted run, only the block of the current entry is pinned
+class SortedRunReader {
+public:
+	SortedRunReader(BufferManager &buffer_manager, SortKeyLayout &layout, SortedRun &run, idx_t index = 0);
+
+	//! The index of the current entry within the run
+	idx_t index;
+
+public:
+	//! Moves the reader to the entry with the given index
+	void Seek(idx_t index);
+	//! Moves the reader to the next entry
+	void Next() {
+		Seek(index + 1);
+	}
+	bool Done() {
+		return index >= run.count;
+	}
+	//! Returns the amount of entries remaining in the current block
+	idx_t RemainingInBlock() {
+		auto &block = run.blocks[block_idx];
+		return block.start + block.count - index;
+	}
+	//! Returns the current entry
+	data_ptr_t Entry() {
+		return handle->Ptr() + (index - run.blocks[block_idx].start) * layout.entry_size;
+	}
+	//! Returns the row referenced by the current entry
+	data_ptr_t Row() {
+		return handle->Ptr() + layout.GetRow(Entry());
+	}
+
+private:
+	BufferManager &buffer_manager;
+	SortKeyLayout &layout;
+	SortedRun &run;
+	//! The block of the current entry, INVALID_INDEX if no block is pinned
+	idx_t block_idx;
+	unique_ptr<BufferHandle> handle;
+};
+
+} // namespace duckdb
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "duckdb/execution/physical_operator.hpp"
+#include "duckdb/execution/runtime_join_filter.hpp"
 #include "duckdb/storage/data_table.hpp"
 #include "duckdb/function/table_function.hpp"
 #include "duckdb/planner/table_filter.hpp"
@@ -31,6 +32,8 @@ public:
 	vector<string> names;
 	//! The table filters
 	unique_ptr<TableFilterSet> table_filters;
+	//! The filters pushed into the scan at runtime by the hash join that probes the scanned rows (optional)
+	shared_ptr<RuntimeJoinFilter> runtime_filter;
 
 public:
 	string GetName() const override;
@@ -38,6 +41,11 @@ public:
 
 	void GetChunkInternal(ExecutionContext &context, DataChunk &chunk, PhysicalOperatorState *state) override;
 	unique_ptr<PhysicalOperatorState> GetOperatorState() override;
+
+private:
+	void ScanChunk(ExecutionContext &context, DataChunk &chunk, PhysicalOperatorState *state);
+	//! Removes the rows of the chunk that fail the Bloom filter of the runtime filter, returns false if no rows remain
+	bool ApplyBloomFilter(DataChunk &chunk, PhysicalOperatorState *state);
 };
 
 } // namespace duckdb
@@ -26,15 +26,18 @@ class PartitionableHashTable {
 public:
 	PartitionableHashTable(BufferManager &_buffer_manager, RadixPartitionInfo &_partition_info,
 	                       vector<LogicalType> _group_types, vector<LogicalType> _payload_types,
-	                       vector<BoundAggregateExpression *> _bindings);
+	                       vector<BoundAggregateExpression *> _bindings, idx_t _max_ht_size);
 
 	idx_t AddChunk(DataChunk &groups, DataChunk &payload, bool do_partition);
-	void Partition();
+	//! Partitions the unpartitioned HTs, returns the amount of bytes that had to be read back from the temporary
+	//! directory
+	idx_t Partition();
 	bool IsPartitioned();
 
 	HashTableList GetPartition(idx_t partition);
 	HashTableList GetUnpartitioned();
 
+	//! Finalizes and unpins all HTs, so their blocks can be evicted until they are combined
 	void Finalize();
 
 private:
@@ -45,6 +48,8 @@ private:
 
 	bool is_partitioned;
 	RadixPartitionInfo &partition_info;
+	//! The size after which no more groups are added to a HT: a new HT is started and the full one is unpinned
+	idx_t max_ht_size;
 	vector<SelectionVector> sel_vectors;
 	vector<idx_t> sel_vector_sizes;
 	DataChunk group_subset, payload_subset;
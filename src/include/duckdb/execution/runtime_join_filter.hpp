@@ -0,0 +1,98 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// duckdb/execution/runtime_join_filter.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/common.hpp"
+#include "duckdb/common/types/data_chunk.hpp"
+#include "duckdb/planner/table_filter.hpp"
+
+#include <atomic>
+
+namespace duckdb {
+
+//! A blocked Bloom filter on the hashes of the keys of a join. All bits of a hash are set in the same 64-bit word, so
+//! that a lookup only touches a single cache line. Hashes can be inserted concurrently.
+class BloomFilter {
+public:
+	//! The amount of bits reserved per inserted hash
+	static constexpr idx_t BITS_PER_KEY = 16;
+
+	explicit BloomFilter(idx_t count);
+
+public:
+	//! Inserts a hash into the filter, this is thread-safe
+	void Insert(hash_t hash) {
+		hash = Mix(hash);
+		bits[hash & word_mask].fetch_or(GetMask(hash), std::memory_order_relaxed);
+	}
+	//! Selects the rows of which the hash may have been inserted into the filter, returns the amount of selected rows
+	idx_t Lookup(Vector &hashes, idx_t count, SelectionVector &result);
+
+private:
+	//! The hashes of integers are not uniform in their lower bits: mix them before they are used
+	static hash_t Mix(hash_t hash) {
+		hash ^= hash >> 33;
+		hash *= UINT64_C(0xff51afd7ed558ccd);
+		hash ^= hash >> 33;
+		return hash;
+	}
+	//! The bits of the word that are set for a (mixed) hash
+	static uint64_t GetMask(hash_t hash) {
+		return (uint64_t(1) << ((hash >> 32) & 63)) | (uint64_t(1) << ((hash >> 38) & 63)) |
+		       (uint64_t(1) << ((hash >> 44) & 63));
+	}
+
+	unique_ptr<std::atomic<uint64_t>[]> bits;
+	//! The mask that selects the word of a (mixed) hash
+	idx_t word_mask;
+};
+
+//! A RuntimeJoinFilter holds the filters that a hash join derives from the keys of its build side, which are pushed
+//! into the table scan of its probe side. The scan skips the segments that cannot match using the min/max filters on
+//! their zonemaps, and removes the rows that fail the Bloom filter before they reach the probe.
+class RuntimeJoinFilter {
+public:
+	//! The minimum amount of build-side rows for which a Bloom filter is constructed, smaller HTs are probed about as
+	//! fast as the Bloom filter
+	static constexpr idx_t MIN_BLOOM_FILTER_COUNT = 4096;
+	//! The maximum amount of build-side rows for which a Bloom filter is constructed
+	static constexpr idx_t MAX_BLOOM_FILTER_COUNT = idx_t(1) << 24;
+	//! The amount of rows a scan probes the Bloom filter with before it decides whether to keep using it
+	static constexpr idx_t BLOOM_FILTER_SAMPLE_SIZE = 16 * STANDARD_VECTOR_SIZE;
+	//! The scan only keeps using the Bloom filter if it removes at least 1/BLOOM_FILTER_MIN_REMOVED of the sample
+	static constexpr idx_t BLOOM_FILTER_MIN_REMOVED = 4;
+
+	explicit RuntimeJoinFilter(vector<idx_t> key_columns);
+
+	//! The columns of the scan that hold the keys of the equality conditions of the join, in the order of the
+	//! conditions
+	vector<idx_t> key_columns;
+	//! Whether or not the filters have been set by the join; the scan ignores the filters if they are not set
+	bool ready;
+	//! The min/max filters on the key columns of the scan. These are only checked against the zonemaps: filtering the
+	//! rows themselves on the key range rarely removes more than the Bloom filter does.
+	TableFilterSet zonemap_filters;
+	//! The Bloom filter on the hashes of the keys, or nullptr if the build side was too large for a Bloom filter
+	unique_ptr<BloomFilter> bloom_filter;
+
+public:
+	//! Whether or not min/max filters can be derived for keys of the given type
+	static bool SupportsMinMax(const LogicalType &type);
+	//! Updates the minimum and maximum with the non-NULL keys
+	static void UpdateMinMax(Vector &keys, idx_t count, Value &min, Value &max);
+
+	//! Clears the filters, so they are not used until the join sets them again
+	void Reset();
+	//! Adds a min/max filter on the key column with the given index
+	void AddMinMax(idx_t key_idx, Value min, Value max);
+	//! Selects the rows of the scanned chunk that pass the Bloom filter, returns the amount of selected rows
+	idx_t Select(DataChunk &chunk, SelectionVector &sel);
+};
+
+} // namespace duckdb
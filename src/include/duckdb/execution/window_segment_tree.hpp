@@ -14,19 +14,74 @@
 
 namespace duckdb {
 
+class WindowSegmentTree;
+
+//! The intermediate state that is used to aggregate the segments of a WindowSegmentTree. The tree itself is only read
+//! after it has been constructed, so threads can compute windows concurrently, each with their own state.
+class WindowSegmentTreeState {
+public:
+	explicit WindowSegmentTreeState(WindowSegmentTree &tree);
+
+	//! Data pointer that contains a single state, used for intermediate window segment aggregation
+	vector<data_t> state;
+	//! Input data chunk, used for intermediate window segment aggregation
+	DataChunk inputs;
+	//! A vector of pointers to "state", used for intermediate window segment aggregation
+	Vector statep;
+
+	//! The states of the frames of a batch of rows
+	unique_ptr<data_t[]> frame_states;
+	//! A vector of pointers to the frame states
+	Vector frame_statep;
+	//! The input rows that are aggregated into the frame states, all gathered from the same input chunk
+	DataChunk leaves;
+	SelectionVector leaf_sel;
+	Vector leaf_statep;
+	idx_t leaf_chunk;
+	idx_t leaf_count;
+	//! The nodes of the tree that are combined into the frame states
+	Vector node_sourcep;
+	Vector node_targetp;
+	idx_t node_count;
+};
+
 class WindowSegmentTree {
+	friend class WindowSegmentTreeState;
+
 public:
 	WindowSegmentTree(AggregateFunction &aggregate, FunctionData *bind_info, LogicalType result_type,
 	                  ChunkCollection *input);
 	~WindowSegmentTree();
 
-	Value Compute(idx_t start, idx_t end);
+	//! Whether or not the tree has internal nodes that have to be constructed before windows can be computed
+	bool HasInternalNodes() {
+		return internal_nodes > 0;
+	}
+	//! Constructs the whole tree
+	void Construct(WindowSegmentTreeState &lstate);
+	//! Constructs the nodes of the first level that aggregate the input rows [begin, end), begin has to be a multiple
+	//! of TREE_FANOUT. The first level is the bulk of the tree: disjoint ranges can be constructed concurrently.
+	void ConstructFirstLevel(WindowSegmentTreeState &lstate, idx_t begin, idx_t end);
+	//! Constructs the remaining levels of the tree after the whole first level has been constructed
+	void ConstructUpperLevels(WindowSegmentTreeState &lstate);
+
+	//! Computes the aggregate over the frames [begins[i], ends[i]) of a batch of count rows into the result vector
+	void Evaluate(WindowSegmentTreeState &lstate, const idx_t begins[], const idx_t ends[], Vector &result,
+	              idx_t count);
+
+	// TREE_FANOUT needs to cleanly divide STANDARD_VECTOR_SIZE
+	static constexpr idx_t TREE_FANOUT = 64;
 
 private:
-	void ConstructTree();
-	void WindowSegmentValue(idx_t l_idx, idx_t begin, idx_t end);
-	void AggregateInit();
-	Value AggegateFinal();
+	void ConstructLevel(WindowSegmentTreeState &lstate, idx_t level, idx_t begin, idx_t end);
+	void WindowSegmentValue(WindowSegmentTreeState &lstate, idx_t l_idx, idx_t begin, idx_t end);
+	void AggregateInit(WindowSegmentTreeState &lstate);
+	//! Adds the input rows or the nodes [begin, end) of a level of the tree to the frame state of a row
+	void AddFrameSegment(WindowSegmentTreeState &lstate, idx_t l_idx, idx_t begin, idx_t end, data_ptr_t frame_state);
+	//! Aggregates the gathered input rows into their frame states
+	void FlushLeaves(WindowSegmentTreeState &lstate);
+	//! Combines the gathered nodes into their frame states
+	void FlushNodes(WindowSegmentTreeState &lstate);
 
 	//! The aggregate that the window function is computed over
 	AggregateFunction aggregate;
@@ -34,13 +89,8 @@ private:
 	FunctionData *bind_info;
 	//! The result type of the window function
 	LogicalType result_type;
-
-	//! Data pointer that contains a single state, used for intermediate window segment aggregation
-	vector<data_t> state;
-	//! Input data chunk, used for intermediate window segment aggregation
-	DataChunk inputs;
-	//! A vector of pointers to "state", used for intermediate window segment aggregation
-	Vector statep;
+	//! The size of a single aggregate state
+	idx_t state_size;
 
 	//! The actual window segment tree: an array of aggregate states that represent all the intermediate nodes
 	unique_ptr<data_t[]> levels_flat_native;
@@ -52,9 +102,6 @@ private:
 
 	//! The (sorted) input chunk collection on which the tree is built
 	ChunkCollection *input_ref;
-
-	// TREE_FANOUT needs to cleanly divide STANDARD_VECTOR_SIZE
-	static constexpr idx_t TREE_FANOUT = 64;
 };
 
 } // namespace duckdb
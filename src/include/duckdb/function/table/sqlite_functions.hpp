@@ -40,4 +40,8 @@ struct PragmaDatabaseSize {
 	static void RegisterFunction(BuiltinFunctions &set);
 };
 
+struct PragmaBufferStats {
+	static void RegisterFunction(BuiltinFunctions &set);
+};
+
 } // namespace duckdb
@@ -27,7 +27,10 @@ struct FunctionOperatorData {
 
 struct TableFilterCollection {
 	TableFilterSet *table_filters;
-	TableFilterCollection(TableFilterSet *table_filters) : table_filters(table_filters) {
+	//! Filters that are only used to skip segments using their zonemaps, the rows themselves are not filtered
+	TableFilterSet *zonemap_filters;
+	TableFilterCollection(TableFilterSet *table_filters, TableFilterSet *zonemap_filters = nullptr)
+	    : table_filters(table_filters), zonemap_filters(zonemap_filters) {
 	}
 };
 
@@ -53,6 +56,8 @@ typedef unique_ptr<FunctionOperatorData> (*table_function_init_parallel_t)(Clien
                                                                            TableFilterCollection *filters);
 typedef bool (*table_function_parallel_state_next_t)(ClientContext &context, const FunctionData *bind_data,
                                                      FunctionOperatorData *state, ParallelState *parallel_state);
+typedef idx_t (*table_function_get_batch_index_t)(ClientContext &context, const FunctionData *bind_data,
+                                                  FunctionOperatorData *state);
 typedef void (*table_function_dependency_t)(unordered_set<CatalogEntry *> &dependencies, const FunctionData *bind_data);
 typedef unique_ptr<NodeStatistics> (*table_function_cardinality_t)(ClientContext &context,
                                                                    const FunctionData *bind_data);
@@ -133,6 +138,9 @@ public:
 	table_function_init_parallel_t parallel_init;
 	//! (Optional) return the next chunk to process in the parallel scan, or return nullptr if there is none
 	table_function_parallel_state_next_t parallel_state_next;
+	//! (Optional) return the sequence number of the part of the parallel scan that is currently scanned, the parts are
+	//! numbered in the order of the sequential scan
+	table_function_get_batch_index_t get_batch_index = nullptr;
 
 	//! Whether or not the table function supports projection pushdown. If not supported a projection will be added
 	//! that filters out unused columns.
@@ -64,6 +64,8 @@ public:
 	bool enable_optimizer = true;
 	//! Force parallelism of small tables, used for testing
 	bool force_parallelism = false;
+	//! Whether or not a materialized result that is collected in parallel is in the order of a sequential execution
+	bool preserve_insertion_order = true;
 	//! Force index join independent of table cardinality, used for testing
 	bool force_index_join = false;
 	//! Maximum bits allowed for using a perfect hash table (i.e. the perfect HT can hold up to 2^perfect_ht_threshold
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "duckdb/common/common.hpp"
+#include "duckdb/common/enums/compression_type.hpp"
 #include "duckdb/common/enums/order_type.hpp"
 #include "duckdb/common/file_system.hpp"
 #include "duckdb/common/winapi.hpp"
@@ -61,6 +62,13 @@ public:
 	bool checkpoint_on_shutdown = true;
 	//! Debug flag that decides when a checkpoing should be aborted. Only used for testing purposes.
 	CheckpointAbort checkpoint_abort = CheckpointAbort::NO_ABORT;
+	//! Force a specific compression method to be used when checkpointing (if available)
+	CompressionType force_compression = CompressionType::COMPRESSION_AUTO;
+	//! The amount of blocks of every scanned column that are loaded ahead of a sequential table scan (0 disables
+	//! read-ahead)
+	idx_t read_ahead_depth = 4;
+	//! Whether or not buffers that are evicted to the temporary directory are compressed
+	bool temporary_compression = false;
 
 public:
 	DUCKDB_API static DBConfig &GetConfig(ClientContext &context);
@@ -17,6 +17,7 @@
 #include "duckdb/common/winapi.hpp"
 #include "duckdb/execution/physical_operator.hpp"
 
+#include <atomic>
 #include <stack>
 #include <unordered_map>
 
@@ -64,6 +65,8 @@ public:
 		OperatorTimingInformation info;
 		vector<unique_ptr<TreeNode>> children;
 		idx_t depth = 0;
+		//! The amount of bytes the operator had to read back from the temporary directory
+		std::atomic<idx_t> spilled_bytes {0};
 	};
 
 private:
@@ -92,6 +95,8 @@ public:
 
 	//! Adds the timings gathered by an OperatorProfiler to this query profiler
 	DUCKDB_API void Flush(OperatorProfiler &profiler);
+	//! Adds to the amount of bytes an operator had to read back from the temporary directory, this is thread-safe
+	DUCKDB_API void AddSpilledBytes(PhysicalOperator *op, idx_t bytes);
 
 	DUCKDB_API void StartPhase(string phase);
 	DUCKDB_API void EndPhase();
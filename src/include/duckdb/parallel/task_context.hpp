@@ -23,6 +23,9 @@ public:
 
 	//! Per-operator task info
 	unordered_map<PhysicalOperator *, ParallelState *> task_info;
+	//! The sequence number of the morsel that the parallel source of the pipeline last handed out to this task, sinks
+	//! can use it to restore the order of the source
+	idx_t batch_index = 0;
 };
 
 } // namespace duckdb
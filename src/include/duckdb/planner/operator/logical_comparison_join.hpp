@@ -12,6 +12,7 @@
 #include "duckdb/common/unordered_set.hpp"
 #include "duckdb/planner/joinside.hpp"
 #include "duckdb/planner/operator/logical_join.hpp"
+#include "duckdb/storage/statistics/base_statistics.hpp"
 
 namespace duckdb {
 
@@ -25,6 +26,8 @@ public:
 	vector<JoinCondition> conditions;
 	//! Used for duplicate-eliminated joins
 	vector<LogicalType> delim_types;
+	//! The statistics of the right-hand side of each of the conditions (optional)
+	vector<unique_ptr<BaseStatistics>> join_stats;
 
 public:
 	string ParamsToString() const override;
@@ -21,4 +21,10 @@ public:
 	block_id_t id;
 };
 
+//! A pointer to a location within a (meta) block on disk
+struct BlockPointer {
+	block_id_t block_id;
+	uint32_t offset;
+};
+
 } // namespace duckdb
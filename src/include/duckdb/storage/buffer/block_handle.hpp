@@ -12,16 +12,24 @@
 #include "duckdb/common/mutex.hpp"
 #include "duckdb/storage/storage_info.hpp"
 
+#include <list>
+
 namespace duckdb {
+class BlockHandle;
 class BufferHandle;
 class BufferManager;
 class DatabaseInstance;
 class FileBuffer;
 
 enum class BlockState : uint8_t { BLOCK_UNLOADED = 0, BLOCK_LOADED = 1 };
+//! The eviction list a block is in: blocks that were used once since they were loaded are on probation, blocks that
+//! were used more often are protected and only evicted when few blocks are on probation
+enum class EvictionList : uint8_t { NONE = 0, PROBATION = 1, PROTECTED = 2 };
+
+typedef std::list<weak_ptr<BlockHandle>> eviction_list_t;
 
 class BlockHandle {
-	friend struct BufferEvictionNode;
+	friend struct EvictionQueue;
 	friend class BufferHandle;
 	friend class BufferManager;
 
@@ -37,6 +45,11 @@ public:
 	block_id_t BlockId() {
 		return block_id;
 	}
+	//! Whether or not the block is currently loaded in memory
+	bool IsLoaded() {
+		lock_guard<mutex> guard(lock);
+		return state == BlockState::BLOCK_LOADED;
+	}
 
 private:
 	static unique_ptr<BufferHandle> Load(shared_ptr<BlockHandle> &handle);
@@ -53,8 +66,12 @@ private:
 	block_id_t block_id;
 	//! Pointer to loaded data (if any)
 	unique_ptr<FileBuffer> buffer;
-	//! Internal eviction timestamp
-	idx_t eviction_timestamp;
+	//! The amount of times the block was pinned since it was loaded
+	idx_t access_count;
+	//! The eviction list the block is in, protected by the lock of the eviction shard of the block
+	EvictionList eviction_list;
+	//! The position of the block in its eviction list
+	eviction_list_t::iterator eviction_position;
 	//! Whether or not the buffer can be destroyed (only used for temporary buffers)
 	bool can_destroy;
 	//! The memory usage of the block
@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// duckdb/storage/buffer/temporary_file_manager.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/common.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/storage/buffer/managed_buffer.hpp"
+
+namespace duckdb {
+class DatabaseInstance;
+
+//! The TemporaryFileManager stores the buffers that are evicted from memory in the temporary directory. Buffers of
+//! BLOCK_ALLOC_SIZE are stored in fixed-size slots of a single shared temporary file, freed slots are reused for the
+//! next evicted buffers. Buffers of any other size are stored in a file of their own.
+class TemporaryFileManager {
+public:
+	TemporaryFileManager(DatabaseInstance &db, string temp_directory);
+	~TemporaryFileManager();
+
+	//! Write the buffer to the temporary storage, optionally compressing it
+	void WriteTemporaryBuffer(ManagedBuffer &buffer, bool compress);
+	//! Read the buffer with the given id back from the temporary storage, and free the space it occupied
+	unique_ptr<FileBuffer> ReadTemporaryBuffer(block_id_t id);
+	//! Free the space occupied by the buffer with the given id (if it was written to the temporary storage)
+	void DeleteTemporaryBuffer(block_id_t id);
+
+private:
+	struct TemporaryBufferIndex {
+		//! The slot in the shared temporary file, or INVALID_INDEX if the buffer is stored in a file of its own
+		idx_t slot;
+		//! The amount of bytes stored, equal to the allocation size of the buffer if it is not compressed
+		idx_t stored_size;
+		//! The allocation size of the buffer
+		idx_t alloc_size;
+	};
+
+	//! Returns the path of the file used to store a buffer that does not fit a slot
+	string GetTemporaryPath(block_id_t id);
+	//! Reserve a free slot in the shared temporary file, the lock must be held
+	idx_t AllocateSlot();
+	//! Free a slot of the shared temporary file, truncating the file if the slot was the last slot in use. The lock
+	//! must be held
+	void FreeSlot(idx_t slot);
+	//! Remove the buffer from the temporary storage, the lock must be held
+	void RemoveBuffer(block_id_t id, TemporaryBufferIndex &index);
+
+private:
+	DatabaseInstance &db;
+	//! The directory in which the temporary files are stored
+	string temp_directory;
+	//! Lock protecting the slots and the buffer index, the file I/O itself is performed without holding the lock
+	mutex lock;
+	//! The shared temporary file, created when the first buffer is written to it
+	unique_ptr<FileHandle> handle;
+	//! Bitmap of the slots of the shared temporary file that are in use
+	vector<uint64_t> used_slots;
+	//! The amount of slots the shared temporary file currently spans
+	idx_t slot_count;
+	//! The buffers that are currently stored in the temporary storage
+	unordered_map<block_id_t, TemporaryBufferIndex> buffers;
+};
+
+} // namespace duckdb
@@ -15,6 +15,7 @@
 #include "duckdb/common/file_system.hpp"
 #include "duckdb/common/unordered_map.hpp"
 #include "duckdb/storage/buffer/block_handle.hpp"
+#include "duckdb/storage/buffer/temporary_file_manager.hpp"
 
 #include <atomic>
 #include <mutex>
@@ -22,6 +23,16 @@
 namespace duckdb {
 class DatabaseInstance;
 struct EvictionQueue;
+struct ReadAheadQueue;
+
+struct BufferManagerStatistics {
+	//! The amount of pins of blocks that were already loaded in memory
+	idx_t hits = 0;
+	//! The amount of pins that had to load the block
+	idx_t misses = 0;
+	//! The amount of blocks that were evicted from memory
+	idx_t evictions = 0;
+};
 
 //! The buffer manager is in charge of handling memory management for the database. It hands out memory buffers that can
 //! be used by the database internally.
@@ -48,6 +59,9 @@ public:
 
 	unique_ptr<BufferHandle> Pin(shared_ptr<BlockHandle> &handle);
 	void Unpin(shared_ptr<BlockHandle> &handle);
+	//! Schedule an asynchronous load of the given on-disk block, so a later Pin of the block does not have to wait for
+	//! the read. Read-ahead is best-effort: requests are dropped if the loads fall too far behind.
+	void ReadAhead(shared_ptr<BlockHandle> &handle);
 
 	void UnregisterBlock(block_id_t block_id, bool can_destroy);
 
@@ -64,21 +78,29 @@ public:
 	idx_t GetMaxMemory() {
 		return maximum_memory;
 	}
+	//! Returns the hit, miss and eviction counters of the buffer manager
+	BufferManagerStatistics GetStatistics();
 
 private:
+	//! Pin the block, count_access signifies whether or not the pin counts as a use of the block for the statistics and
+	//! the replacement policy
+	unique_ptr<BufferHandle> PinInternal(shared_ptr<BlockHandle> &handle, bool count_access);
 	//! Evict blocks until the currently used memory + extra_memory fit, returns false if this was not possible
 	//! (i.e. not enough blocks could be evicted)
 	bool EvictBlocks(idx_t extra_memory, idx_t memory_limit);
+	//! Remove the block from the eviction list it is in (if any)
+	void RemoveFromEvictionList(BlockHandle &handle);
 
 	//! Write a temporary buffer to disk
 	void WriteTemporaryBuffer(ManagedBuffer &buffer);
 	//! Read a temporary buffer from disk
 	unique_ptr<FileBuffer> ReadTemporaryBuffer(block_id_t id);
-	//! Get the path of the temporary buffer
-	string GetTemporaryPath(block_id_t id);
-
+	//! Remove a temporary buffer from disk (if it was written to disk)
 	void DeleteTemporaryFile(block_id_t id);
 
+	//! Load the blocks that are scheduled for read-ahead until the buffer manager is destroyed
+	void ExecuteReadAhead();
+
 private:
 	//! The database instance
 	DatabaseInstance &db;
@@ -88,13 +110,17 @@ private:
 	std::atomic<idx_t> maximum_memory;
 	//! The directory name where temporary files are stored
 	string temp_directory;
+	//! The temporary storage of evicted buffers, only set if a temporary directory is specified
+	unique_ptr<TemporaryFileManager> temporary_files;
 	//! The lock for the set of blocks
 	std::mutex manager_lock;
 	//! A mapping of block id -> BlockPointer
 	unordered_map<block_id_t, weak_ptr<BlockHandle>> blocks;
-	//! Eviction queue
+	//! The sharded replacement policy that decides which blocks are evicted
 	unique_ptr<EvictionQueue> queue;
-	//! The temporary id used for managed buffers
-	block_id_t temporary_id;
+	//! The temporary id used for managed buffers, memory is registered by multiple threads concurrently
+	std::atomic<block_id_t> temporary_id;
+	//! The blocks scheduled for read-ahead and the background thread loading them
+	unique_ptr<ReadAheadQueue> read_ahead;
 };
 } // namespace duckdb
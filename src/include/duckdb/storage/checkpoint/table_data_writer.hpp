@@ -9,6 +9,7 @@
 #pragma once
 
 #include "duckdb/storage/checkpoint_manager.hpp"
+#include "duckdb/common/enums/compression_type.hpp"
 
 namespace duckdb {
 class ColumnData;
@@ -16,6 +17,8 @@ class UncompressedSegment;
 class MorselInfo;
 class BaseStatistics;
 class SegmentStatistics;
+class CompressedSegmentWriter;
+class CompressedStringSegmentWriter;
 
 //! The table data writer is responsible for writing the data of a table to the block manager
 class TableDataWriter {
@@ -25,9 +28,14 @@ public:
 	TableDataWriter(DatabaseInstance &db, TableCatalogEntry &table, MetaBlockWriter &meta_writer);
 	~TableDataWriter();
 
+	//! Set up the writers of the columns, after which the columns can be checkpointed
+	void InitializeColumns();
+	//! Write the data of a column to disk, every column has its own state so different columns of the table can be
+	//! checkpointed concurrently
+	void CheckpointColumn(ColumnData &col_data, idx_t col_idx);
+	//! Write the data pointers and the deletes of the checkpointed columns to the meta data
 	void WriteTableData();
 
-	void CheckpointColumn(ColumnData &col_data, idx_t col_idx);
 	void CheckpointDeletes(MorselInfo *info);
 
 private:
@@ -35,6 +43,16 @@ private:
 
 	void CreateSegment(idx_t col_idx);
 	void FlushSegment(SegmentTree &new_tree, idx_t col_idx);
+	//! Compress the vectors of the current uncompressed segment using the specified compression
+	void CompressSegment(SegmentTree &new_tree, idx_t col_idx, CompressionType compression);
+	//! Move the overflow strings of the current string segment from memory to disk
+	void WriteOverflowStrings(idx_t col_idx);
+	//! Compress the strings of the current string segment using the specified compression
+	void CompressStringSegment(SegmentTree &new_tree, idx_t col_idx, CompressionType compression);
+	//! Write the pending compressed segment of the column (if any) to disk
+	void FlushCompressedSegment(SegmentTree &new_tree, idx_t col_idx);
+	void AddDataPointer(SegmentTree &new_tree, idx_t col_idx, block_id_t block_id, idx_t tuple_count,
+	                    CompressionType compression, unique_ptr<BaseStatistics> statistics);
 
 	void WriteDataPointers();
 	void VerifyDataPointers();
@@ -45,6 +63,10 @@ private:
 	MetaBlockWriter &meta_writer;
 
 	vector<unique_ptr<UncompressedSegment>> segments;
+	//! The compressed segments that are currently being written to
+	vector<unique_ptr<CompressedSegmentWriter>> compressed_segments;
+	//! The compressed string segments that are currently being written to
+	vector<unique_ptr<CompressedStringSegmentWriter>> compressed_string_segments;
 	vector<unique_ptr<SegmentStatistics>> stats;
 	vector<unique_ptr<BaseStatistics>> column_stats;
 
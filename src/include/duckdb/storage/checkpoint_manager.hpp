@@ -21,12 +21,14 @@ class MetaBlockReader;
 class SchemaCatalogEntry;
 class SequenceCatalogEntry;
 class TableCatalogEntry;
+class TableDataWriter;
 class ViewCatalogEntry;
 
 //! CheckpointManager is responsible for checkpointing the database
 class CheckpointManager {
 public:
 	CheckpointManager(DatabaseInstance &db);
+	~CheckpointManager();
 
 	//! Checkpoint the current state of the WAL and flush it to the main storage. This should be called BEFORE any
 	//! connction is available because right now the checkpointing cannot be done online. (TODO)
@@ -42,6 +44,10 @@ public:
 	unique_ptr<MetaBlockWriter> tabledata_writer;
 
 private:
+	//! Write the column data of all tables to disk, one task per column is scheduled on the task scheduler. The
+	//! writers are kept until the meta data of the tables is written
+	void CheckpointTableData(vector<SchemaCatalogEntry *> &schemas);
+
 	void WriteSchema(SchemaCatalogEntry &schema);
 	void WriteTable(TableCatalogEntry &table);
 	void WriteView(ViewCatalogEntry &table);
@@ -53,6 +59,10 @@ private:
 	void ReadView(ClientContext &context, MetaBlockReader &reader);
 	void ReadSequence(ClientContext &context, MetaBlockReader &reader);
 	void ReadMacro(ClientContext &context, MetaBlockReader &reader);
+
+private:
+	//! The writers of the tables whose column data has been written
+	unordered_map<TableCatalogEntry *, unique_ptr<TableDataWriter>> table_writers;
 };
 
 } // namespace duckdb
@@ -67,6 +67,10 @@ public:
 	//! Update the specified row identifiers
 	void Update(Transaction &transaction, Vector &updates, Vector &row_ids, idx_t count);
 
+	//! Schedule asynchronous loads of the blocks of the "depth" segments starting at the given segment, skipping the
+	//! segments before read_ahead_row. read_ahead_row is moved to the end of the last segment that was considered.
+	void ReadAhead(ColumnSegment *segment, idx_t depth, idx_t &read_ahead_row);
+
 	//! Fetch the vector from the column data that belongs to this specific row
 	void Fetch(ColumnScanState &state, row_t row_id, Vector &result);
 	//! Fetch a specific row id and append it to the vector
@@ -75,6 +79,8 @@ public:
 private:
 	//! Append a transient segment
 	void AppendTransientSegment(idx_t start_row);
+	//! Initialize the scan of the current segment of the scan state, and read ahead the blocks of the next segments
+	void InitializeSegmentScan(ColumnScanState &state);
 };
 
 } // namespace duckdb
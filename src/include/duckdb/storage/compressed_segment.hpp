@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// duckdb/storage/compressed_segment.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/storage/numeric_segment.hpp"
+#include "duckdb/storage/compression/compression_function.hpp"
+
+namespace duckdb {
+class BaseStatistics;
+
+//! A compressed segment is a numeric segment that is backed by an on-disk block holding compressed vectors. Vectors
+//! are decompressed directly into the result vectors during scans. Before the segment can be modified (i.e. updated
+//! or appended to), it is decompressed into an in-memory buffer with the regular uncompressed layout.
+//! The compressed block has the following layout:
+//! [uint32_t vector_offsets[MAX_VECTOR_COUNT]]
+//! and for every vector: [uint8_t has_null][nullmask_t nullmask (only if has_null)][compressed data]
+class CompressedSegment : public NumericSegment {
+public:
+	CompressedSegment(DatabaseInstance &db, PhysicalType type, idx_t row_start, block_id_t block_id,
+	                  CompressionType compression, idx_t tuple_count);
+
+	//! The compression function used to compress the vectors of this segment
+	CompressionFunction function;
+
+	//! The maximum amount of vectors that are stored in a single compressed segment
+	static constexpr idx_t MAX_VECTOR_COUNT = 128;
+	//! The size of the header of a compressed block
+	static constexpr idx_t HEADER_SIZE = MAX_VECTOR_COUNT * sizeof(uint32_t);
+
+public:
+	//! Fetch a single value and append it to the vector
+	void FetchRow(ColumnFetchState &state, Transaction &transaction, row_t row_id, Vector &result,
+	              idx_t result_idx) override;
+
+	//! Decompress the segment into an in-memory buffer
+	void ToTemporary() override;
+
+protected:
+	void Select(ColumnScanState &state, Vector &result, SelectionVector &sel, idx_t &approved_tuple_count,
+	            vector<TableFilter> &tableFilter) override;
+	void FetchBaseData(ColumnScanState &state, idx_t vector_index, Vector &result) override;
+	void FilterFetchBaseData(ColumnScanState &state, Vector &result, SelectionVector &sel,
+	                         idx_t &approved_tuple_count) override;
+
+private:
+	//! Whether or not the pinned buffer holds the compressed data (i.e. the segment has not been decompressed yet)
+	bool IsCompressed(BufferHandle &handle);
+	//! Decompress the vector at the specified index into the target nullmask and data
+	void DecompressVector(data_ptr_t block_data, idx_t vector_index, nullmask_t &nullmask, data_ptr_t target);
+};
+
+//! The CompressedSegmentWriter compresses the vectors of uncompressed segments into a compressed block
+class CompressedSegmentWriter {
+public:
+	CompressedSegmentWriter(DatabaseInstance &db, LogicalType type, CompressionFunction function);
+
+	//! The database
+	DatabaseInstance &db;
+	//! The compression function used to compress the vectors
+	CompressionFunction function;
+	//! The amount of vectors written to the compressed block
+	idx_t vector_count;
+	//! The amount of tuples written to the compressed block
+	idx_t tuple_count;
+	//! The statistics of the compressed segment
+	unique_ptr<BaseStatistics> statistics;
+
+public:
+	//! Compress a vector with the uncompressed layout (i.e. a nullmask followed by the values) into the block. Returns
+	//! false if the vector does not fit in the block anymore.
+	bool Append(data_ptr_t vector_data, idx_t count);
+	//! Write the compressed block to disk
+	void Flush(block_id_t block_id);
+
+	//! Choose the best compression for the vectors in the given uncompressed segment, based on the statistics and the
+	//! data of the segment. Returns COMPRESSION_UNCOMPRESSED if compressing the segment is not beneficial.
+	static CompressionType ChooseCompression(DatabaseInstance &db, NumericSegment &segment, SegmentStatistics &stats);
+
+private:
+	//! The buffer holding the compressed block
+	unique_ptr<BufferHandle> handle;
+	//! The current offset in the compressed block
+	idx_t offset;
+};
+
+} // namespace duckdb
@@ -0,0 +1,117 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// duckdb/storage/compressed_string_segment.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/storage/string_segment.hpp"
+#include "duckdb/storage/compressed_segment.hpp"
+#include "duckdb/storage/compression/string_compression_function.hpp"
+
+namespace duckdb {
+class BaseStatistics;
+
+//! A compressed string segment is a string segment that is backed by an on-disk block holding compressed vectors of
+//! strings. Vectors are decoded lazily into the result vectors during scans. Before the segment can be modified, it is
+//! decompressed into an in-memory buffer with the regular string segment layout.
+//! The compressed block has the following layout:
+//! [uint32_t vector_offsets[MAX_VECTOR_COUNT]][uint32_t header_offset][uint32_t total_string_size]
+//! for every vector: [uint8_t has_null][nullmask_t nullmask (only if has_null)][compressed data]
+//! followed by the header of the compression function (e.g. the dictionary or the symbol table)
+class CompressedStringSegment : public StringSegment {
+public:
+	CompressedStringSegment(DatabaseInstance &db, idx_t row_start, block_id_t block_id, CompressionType compression,
+	                        idx_t tuple_count);
+
+	//! The compression function used to compress the vectors of this segment
+	StringCompressionFunction function;
+
+	//! The maximum amount of vectors that are stored in a single compressed segment
+	static constexpr idx_t MAX_VECTOR_COUNT = CompressedSegment::MAX_VECTOR_COUNT;
+	//! The offset of the header offset within the block
+	static constexpr idx_t HEADER_OFFSET_POSITION = MAX_VECTOR_COUNT * sizeof(uint32_t);
+	//! The offset of the total string size within the block
+	static constexpr idx_t STRING_SIZE_POSITION = HEADER_OFFSET_POSITION + sizeof(uint32_t);
+	//! The size of the header of a compressed block
+	static constexpr idx_t HEADER_SIZE = STRING_SIZE_POSITION + sizeof(uint32_t);
+
+public:
+	//! Fetch a single value and append it to the vector
+	void FetchRow(ColumnFetchState &state, Transaction &transaction, row_t row_id, Vector &result,
+	              idx_t result_idx) override;
+
+	void InitializeScan(ColumnScanState &state) override;
+
+	//! Decompress the segment into an in-memory buffer
+	void ToTemporary() override;
+
+protected:
+	void Select(ColumnScanState &state, Vector &result, SelectionVector &sel, idx_t &approved_tuple_count,
+	            vector<TableFilter> &tableFilter) override;
+	void FetchBaseData(ColumnScanState &state, idx_t vector_index, Vector &result) override;
+	void ScanBaseData(ColumnScanState &state, idx_t vector_index, Vector &result) override;
+	void FilterFetchBaseData(ColumnScanState &state, Vector &result, SelectionVector &sel,
+	                         idx_t &approved_tuple_count) override;
+
+private:
+	//! Whether or not the pinned buffer holds the compressed data (i.e. the segment has not been decompressed yet)
+	bool IsCompressed(BufferHandle &handle);
+	//! Returns the pinned primary buffer of the scan, switching to the decompressed buffer if the segment was
+	//! decompressed after the scan was initialized
+	BufferHandle &GetPrimaryHandle(ColumnScanState &state);
+	//! Decompress the vector at the specified index into the result vector
+	void DecompressVector(data_ptr_t block_data, idx_t vector_index, idx_t count, Vector &result);
+	//! Emit the vector at the specified index as a dictionary vector that references the decoded dictionary of the
+	//! segment. Returns false if the compression function has no dictionary, or if the dictionary is too large.
+	bool ScanDictionaryVector(ColumnScanState &state, data_ptr_t block_data, idx_t vector_index, idx_t count,
+	                          Vector &result);
+};
+
+//! The CompressedStringSegmentWriter compresses the vectors of string segments into a compressed block
+class CompressedStringSegmentWriter {
+public:
+	CompressedStringSegmentWriter(DatabaseInstance &db, LogicalType type, StringCompressionFunction function,
+	                              vector<string_t> &sample);
+
+	//! The database
+	DatabaseInstance &db;
+	//! The compression function used to compress the vectors
+	StringCompressionFunction function;
+	//! The amount of vectors written to the compressed block
+	idx_t vector_count;
+	//! The amount of tuples written to the compressed block
+	idx_t tuple_count;
+	//! The statistics of the compressed segment
+	unique_ptr<BaseStatistics> statistics;
+
+public:
+	//! Compress a (flat) vector of strings into the block. Returns false if the vector does not fit in the block
+	//! anymore.
+	bool Append(Vector &strings, idx_t count);
+	//! Returns the total size of the compressed block, including the header
+	idx_t GetCompressedSize();
+	//! Write the compressed block to disk
+	void Flush(block_id_t block_id);
+
+	//! Read all the strings of the segment
+	static vector<string_t> GetStrings(StringSegment &segment, ColumnScanState &state, Vector &intermediate);
+	//! Choose the best compression for the strings in the given segment, based on the statistics and the data of the
+	//! segment. Returns COMPRESSION_UNCOMPRESSED if compressing the segment is not beneficial.
+	static CompressionType ChooseCompression(DatabaseInstance &db, StringSegment &segment, SegmentStatistics &stats);
+
+private:
+	//! The compression state holding the dictionary or symbol table
+	unique_ptr<StringCompressionState> state;
+	//! The buffer holding the compressed block
+	unique_ptr<BufferHandle> handle;
+	//! The current offset in the compressed block
+	idx_t offset;
+	//! The total size of the (uncompressed) strings written to the block
+	idx_t total_string_size;
+};
+
+} // namespace duckdb
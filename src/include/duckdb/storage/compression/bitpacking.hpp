@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// duckdb/storage/compression/bitpacking.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/common.hpp"
+#include "duckdb/common/helper.hpp"
+
+namespace duckdb {
+
+//! Primitives to pack unsigned integers into a buffer using a fixed amount of bits per value. Values are read and
+//! written through (unaligned) 64-bit words, hence the packed buffer is padded with an extra word.
+struct BitpackingPrimitives {
+	//! The maximum width that can be unpacked with a single 64-bit load
+	static constexpr uint8_t MAXIMUM_WIDTH = 56;
+
+	//! Returns the minimum amount of bits required to represent the value
+	static inline uint8_t MinimumBitWidth(uint64_t value) {
+		uint8_t width = 0;
+		while (value) {
+			width++;
+			value >>= 1;
+		}
+		return width;
+	}
+
+	//! Returns the amount of bytes required to pack "count" values of "width" bits
+	static inline idx_t GetRequiredSize(idx_t count, uint8_t width) {
+		if (width == 0) {
+			return 0;
+		}
+		return (count * width + 7) / 8 + sizeof(uint64_t);
+	}
+
+	//! Pack a value at the specified index, the target buffer must be zero-initialized
+	static inline void PackValue(data_ptr_t target, idx_t index, uint8_t width, uint64_t value) {
+		D_ASSERT(width <= MAXIMUM_WIDTH);
+		idx_t bit_position = index * width;
+		auto ptr = target + bit_position / 8;
+		auto word = Load<uint64_t>(ptr);
+		word |= value << (bit_position % 8);
+		Store<uint64_t>(word, ptr);
+	}
+
+	//! Unpack the value at the specified index
+	static inline uint64_t UnpackValue(const_data_ptr_t source, idx_t index, uint8_t width) {
+		D_ASSERT(width <= MAXIMUM_WIDTH);
+		if (width == 0) {
+			return 0;
+		}
+		idx_t bit_position = index * width;
+		auto word = Load<uint64_t>(source + bit_position / 8);
+		return (word >> (bit_position % 8)) & ((uint64_t(1) << width) - 1);
+	}
+};
+
+} // namespace duckdb
@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// duckdb/storage/compression/compression_function.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/common.hpp"
+#include "duckdb/common/enums/compression_type.hpp"
+#include "duckdb/common/types/vector.hpp"
+
+namespace duckdb {
+class BaseStatistics;
+
+//! Returns whether or not the compression function can be used for a segment with the given statistics
+typedef bool (*compression_applicable_t)(BaseStatistics &stats);
+//! Returns the amount of bytes required to store the (at most STANDARD_VECTOR_SIZE) values in compressed form, or
+//! INVALID_INDEX if the values cannot be compressed using this compression function
+typedef idx_t (*compression_analyze_t)(data_ptr_t source, nullmask_t &nullmask, idx_t count);
+//! Compress the values into the target buffer, returns the amount of bytes written
+typedef idx_t (*compression_compress_t)(data_ptr_t source, nullmask_t &nullmask, idx_t count, data_ptr_t target);
+//! Decompress a vector of values directly into the (uncompressed) target array
+typedef void (*compression_decompress_t)(data_ptr_t source, idx_t count, data_ptr_t target);
+//! Decompress the single value at the specified row into the target
+typedef void (*compression_fetch_row_t)(data_ptr_t source, idx_t count, idx_t row_idx, data_ptr_t target);
+
+//! A CompressionFunction is a set of functions that (de)compress vectors of a specific physical type. Compression is
+//! performed on a per-vector basis, which allows the vectors of a compressed segment to be decompressed independently.
+class CompressionFunction {
+public:
+	CompressionFunction(CompressionType type, PhysicalType data_type, compression_applicable_t applicable,
+	                    compression_analyze_t analyze, compression_compress_t compress,
+	                    compression_decompress_t decompress, compression_fetch_row_t fetch_row)
+	    : type(type), data_type(data_type), applicable(applicable), analyze(analyze), compress(compress),
+	      decompress(decompress), fetch_row(fetch_row) {
+	}
+
+	//! The compression type
+	CompressionType type;
+	//! The physical type this function compresses
+	PhysicalType data_type;
+
+	compression_applicable_t applicable;
+	compression_analyze_t analyze;
+	compression_compress_t compress;
+	compression_decompress_t decompress;
+	compression_fetch_row_t fetch_row;
+
+public:
+	//! Returns the set of compression functions that are available for the specified physical type
+	static vector<CompressionFunction> GetCompressionFunctions(PhysicalType data_type);
+	//! Returns the compression function of the given compression type for the specified physical type
+	static CompressionFunction GetCompressionFunction(CompressionType type, PhysicalType data_type);
+	//! Whether or not any compression function exists for the specified physical type
+	static bool TypeIsSupported(PhysicalType data_type);
+};
+
+struct RLEFun {
+	static CompressionFunction GetFunction(PhysicalType data_type);
+	static bool TypeIsSupported(PhysicalType data_type);
+};
+
+struct BitpackingFun {
+	static CompressionFunction GetFunction(PhysicalType data_type);
+	static bool TypeIsSupported(PhysicalType data_type);
+};
+
+struct FORFun {
+	static CompressionFunction GetFunction(PhysicalType data_type);
+	static bool TypeIsSupported(PhysicalType data_type);
+};
+
+struct ChimpFun {
+	static CompressionFunction GetFunction(PhysicalType data_type);
+	static bool TypeIsSupported(PhysicalType data_type);
+};
+
+} // namespace duckdb
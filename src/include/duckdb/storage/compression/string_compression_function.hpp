@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// duckdb/storage/compression/string_compression_function.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/common.hpp"
+#include "duckdb/common/enums/compression_type.hpp"
+#include "duckdb/common/types/vector.hpp"
+
+namespace duckdb {
+
+//! The StringCompressionState holds the segment-wide state (e.g. the dictionary or the symbol table) that is used to
+//! compress the vectors of a single compressed string segment
+class StringCompressionState {
+public:
+	virtual ~StringCompressionState() {
+	}
+
+public:
+	//! Compress the (non-null) strings of a vector into the target buffer. Returns the amount of bytes written, or
+	//! INVALID_INDEX if the compressed vector together with the growth of the segment header does not fit in the
+	//! remaining space. If the vector does not fit the state is left unchanged.
+	virtual idx_t Compress(string_t *strings, nullmask_t &nullmask, idx_t count, data_ptr_t target,
+	                       idx_t remaining_space) = 0;
+	//! Returns the size of the segment header
+	virtual idx_t GetHeaderSize() = 0;
+	//! Write the segment header to the target buffer
+	virtual void WriteHeader(data_ptr_t target) = 0;
+};
+
+//! Initialize the compression state for a segment, using a sample of the strings that will be compressed
+typedef unique_ptr<StringCompressionState> (*string_compression_init_t)(vector<string_t> &sample);
+//! Decompress a vector of strings into the result vector. The strings either point directly into the block or are
+//! decompressed into the string heap of the result vector.
+typedef void (*string_decompress_t)(data_ptr_t header, data_ptr_t source, nullmask_t &nullmask, idx_t count,
+                                    Vector &result);
+//! Decompress the single string at the specified row and place it in the result vector
+typedef void (*string_fetch_row_t)(data_ptr_t header, data_ptr_t source, idx_t count, idx_t row_idx, Vector &result,
+                                   idx_t result_idx);
+//! Returns the amount of entries in the dictionary of the segment
+typedef idx_t (*string_dictionary_size_t)(data_ptr_t header);
+//! Decompress all entries of the dictionary of the segment into the result vector
+typedef void (*string_decompress_dictionary_t)(data_ptr_t header, Vector &result);
+//! Decompress the dictionary indices of a vector of strings into the selection vector. The indices of null values are
+//! unspecified.
+typedef void (*string_decompress_indices_t)(data_ptr_t source, idx_t count, SelectionVector &result);
+
+//! A StringCompressionFunction is a set of functions that (de)compress vectors of strings. Unlike the numeric
+//! compression functions, string compression uses state that is shared between all vectors of a segment and is stored
+//! in a segment header.
+class StringCompressionFunction {
+public:
+	StringCompressionFunction(CompressionType type, string_compression_init_t init, string_decompress_t decompress,
+	                          string_fetch_row_t fetch_row, string_dictionary_size_t dictionary_size = nullptr,
+	                          string_decompress_dictionary_t decompress_dictionary = nullptr,
+	                          string_decompress_indices_t decompress_indices = nullptr)
+	    : type(type), init(init), decompress(decompress), fetch_row(fetch_row), dictionary_size(dictionary_size),
+	      decompress_dictionary(decompress_dictionary), decompress_indices(decompress_indices) {
+	}
+
+	//! The compression type
+	CompressionType type;
+
+	string_compression_init_t init;
+	string_decompress_t decompress;
+	string_fetch_row_t fetch_row;
+
+	//! (Optional) Dictionary functions: if the compressed vectors are indices into a segment-wide dictionary, scans
+	//! can emit dictionary vectors that reference the decoded dictionary instead of decompressing every string
+	string_dictionary_size_t dictionary_size;
+	string_decompress_dictionary_t decompress_dictionary;
+	string_decompress_indices_t decompress_indices;
+
+public:
+	//! Returns the set of available string compression functions
+	static vector<StringCompressionFunction> GetCompressionFunctions();
+	//! Returns the string compression function of the given compression type
+	static StringCompressionFunction GetCompressionFunction(CompressionType type);
+};
+
+struct DictionaryFun {
+	static StringCompressionFunction GetFunction();
+};
+
+struct FSSTFun {
+	static StringCompressionFunction GetFunction();
+};
+
+} // namespace duckdb
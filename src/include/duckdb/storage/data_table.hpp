@@ -26,6 +26,7 @@ namespace duckdb {
 class ClientContext;
 class ColumnDefinition;
 class DataTable;
+class LocalAppendStorage;
 class StorageManager;
 class TableCatalogEntry;
 class Transaction;
@@ -54,6 +55,10 @@ struct DataTableInfo {
 struct ParallelTableScanState {
 	idx_t current_row;
 	bool transaction_local_data;
+	//! The sequence number of the next morsel
+	idx_t batch_index;
+	//! For every scanned column, the row up to which its blocks have been scheduled for read-ahead
+	vector<idx_t> read_ahead_rows;
 };
 
 //! DataTable represents a physical table on disk
@@ -100,6 +105,12 @@ public:
 
 	//! Append a DataChunk to the table. Throws an exception if the columns don't match the tables' columns.
 	void Append(TableCatalogEntry &table, ClientContext &context, DataChunk &chunk);
+	//! Append a DataChunk to the local append storage of a thread. Throws an exception if the columns don't match the
+	//! tables' columns or if the chunk violates a constraint of the table.
+	void LocalAppend(TableCatalogEntry &table, ClientContext &context, LocalAppendStorage &storage, DataChunk &chunk);
+	//! Append the rows of a local append storage to the table, linking its segments into the table. Can only be used
+	//! for tables without indexes.
+	void MergeStorage(TableCatalogEntry &table, ClientContext &context, LocalAppendStorage &storage);
 	//! Delete the entries with the specified row identifier from the table
 	void Delete(TableCatalogEntry &table, ClientContext &context, Vector &row_ids, idx_t count);
 	//! Update the entries with the specified row identifier from the table
@@ -140,8 +151,9 @@ public:
 
 	unique_ptr<BaseStatistics> GetStatistics(ClientContext &context, column_t column_id);
 
-	//! Checkpoint the table to the specified table data writer
-	void Checkpoint(TableDataWriter &writer);
+	//! Checkpoint a column of the table to the specified table data writer, different columns can be checkpointed
+	//! concurrently
+	void Checkpoint(TableDataWriter &writer, idx_t column_index);
 	void CheckpointDeletes(TableDataWriter &writer);
 	void CommitDropTable();
 	void CommitDropColumn(idx_t index);
@@ -152,9 +164,17 @@ private:
 	//! Verify constraints with a chunk from the Update containing only the specified column_ids
 	void VerifyUpdateConstraints(TableCatalogEntry &table, DataChunk &chunk, vector<column_t> &column_ids);
 
+	//! Append the versions of append_count rows inserted by the transaction at the end of the table
+	void AppendVersions(Transaction &transaction, idx_t append_count);
+
 	void InitializeScanWithOffset(TableScanState &state, const vector<column_t> &column_ids,
 	                              TableFilterSet *table_filters, idx_t start_row, idx_t end_row);
-	bool CheckZonemap(TableScanState &state, TableFilterSet *table_filters, idx_t &current_row);
+	//! Schedule asynchronous loads of the blocks of the scanned columns, starting at the current row of the parallel
+	//! scan and going read_ahead_depth segments deep
+	void ReadAhead(ClientContext &context, ParallelTableScanState &state, const vector<column_t> &column_ids);
+	//! Checks the current segments of the filtered columns against both the table filters and the zonemap filters of
+	//! the scan, skipping the segment and returning false if no row of it can satisfy them
+	bool CheckZonemap(TableScanState &state, idx_t &current_row);
 	bool ScanBaseTable(Transaction &transaction, DataChunk &result, TableScanState &state,
 	                   const vector<column_t> &column_ids, idx_t &current_row, idx_t max_row);
 	bool ScanCreateIndex(CreateIndexScanState &state, const vector<column_t> &column_ids, DataChunk &result,
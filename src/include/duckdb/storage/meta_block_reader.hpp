@@ -20,7 +20,7 @@ class DatabaseInstance;
 //! This struct is responsible for reading meta data from disk
 class MetaBlockReader : public Deserializer {
 public:
-	MetaBlockReader(DatabaseInstance &db, block_id_t block);
+	MetaBlockReader(DatabaseInstance &db, block_id_t block, bool free_blocks_on_read = true);
 	~MetaBlockReader();
 
 	DatabaseInstance &db;
@@ -28,6 +28,8 @@ public:
 	unique_ptr<BufferHandle> handle;
 	idx_t offset;
 	block_id_t next_block;
+	//! Whether or not the blocks that are read are marked as modified, so they are reclaimed at the next checkpoint
+	bool free_blocks_on_read;
 
 public:
 	//! Read content of size read_size into the buffer
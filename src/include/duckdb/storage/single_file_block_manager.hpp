@@ -12,6 +12,7 @@
 #include "duckdb/storage/block_manager.hpp"
 #include "duckdb/storage/block.hpp"
 #include "duckdb/common/file_system.hpp"
+#include "duckdb/common/mutex.hpp"
 #include "duckdb/common/unordered_set.hpp"
 #include "duckdb/common/set.hpp"
 #include "duckdb/common/vector.hpp"
@@ -38,7 +39,7 @@ public:
 	void MarkBlockAsModified(block_id_t block_id) override;
 	//! Return the meta block id
 	block_id_t GetMetaBlock() override;
-	//! Read the content of the block from disk
+	//! Read the content of the block from disk, reads are positional and can be issued concurrently
 	void Read(Block &block) override;
 	//! Write the given block to disk
 	void Write(FileBuffer &block, block_id_t block_id) override;
@@ -69,6 +70,9 @@ private:
 	unique_ptr<FileHandle> handle;
 	//! The buffer used to read/write to the headers
 	FileBuffer header_buffer;
+	//! Lock protecting the free list, the modified blocks and the maximum block id, blocks are allocated concurrently
+	//! while checkpointing
+	mutex block_lock;
 	//! The list of free blocks that can be written to currently
 	set<block_id_t> free_list;
 	//! The list of blocks that will be added to the free list
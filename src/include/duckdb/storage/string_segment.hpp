@@ -33,8 +33,8 @@ struct string_location_t {
 	}
 	string_location_t() {
 	}
-	bool IsValid() {
-		return offset < Storage::BLOCK_SIZE && (block_id == INVALID_BLOCK || block_id >= MAXIMUM_BLOCK);
+	bool IsValid(idx_t segment_size) {
+		return idx_t(offset) < segment_size && (block_id == INVALID_BLOCK || block_id >= MAXIMUM_BLOCK);
 	}
 	block_id_t block_id;
 	int32_t offset;
@@ -63,6 +63,8 @@ public:
 	unique_ptr<OverflowStringWriter> overflow_writer;
 	//! Map of block id to string block
 	unordered_map<block_id_t, StringBlock *> overflow_blocks;
+	//! The size of the buffer holding the segment, the dictionary grows backwards from the end of the buffer
+	idx_t segment_size;
 
 public:
 	void InitializeScan(ColumnScanState &state) override;
@@ -95,7 +97,7 @@ protected:
 	void FilterFetchBaseData(ColumnScanState &state, Vector &result, SelectionVector &sel,
 	                         idx_t &approved_tuple_count) override;
 
-private:
+protected:
 	void AppendData(BufferHandle &handle, SegmentStatistics &stats, data_ptr_t target, data_ptr_t end,
 	                idx_t target_offset, Vector &source, idx_t offset, idx_t count);
 
@@ -202,7 +204,7 @@ private:
 	void SetDictionaryOffset(BufferHandle &handle, idx_t offset);
 	idx_t GetDictionaryOffset(BufferHandle &handle);
 
-private:
+public:
 	//! The max string size that is allowed within a block. Strings bigger than this will be labeled as a BIG STRING and
 	//! offloaded to the overflow blocks.
 	static constexpr uint16_t STRING_BLOCK_LIMIT = 4096;
@@ -0,0 +1,54 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB
+//
+// duckdb/storage/table/local_append_storage.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/types/data_chunk.hpp"
+#include "duckdb/storage/table/append_state.hpp"
+
+namespace duckdb {
+class DataTable;
+class TransientSegment;
+
+//! The LocalAppendStorage holds the rows that a single thread of a bulk append writes to column segments of its own.
+//! The segments are linked into the table by DataTable::MergeStorage, so that the rows are not copied under the append
+//! lock of the table. The segments only hold complete vectors: the first vector of rows is kept apart to fill up the
+//! last vector of the table, and the rows that do not fill up a vector are appended to the transaction-local storage.
+class LocalAppendStorage {
+public:
+	explicit LocalAppendStorage(DataTable &table);
+	~LocalAppendStorage();
+
+	DataTable &table;
+	//! The first vector of appended rows
+	DataChunk head;
+	//! The appended rows that do not fill up a vector of the segments yet
+	DataChunk tail;
+	//! The segments of every column. The rows of the segments start at 0 until they are linked into the table.
+	vector<vector<unique_ptr<TransientSegment>>> segments;
+	//! The append states of the last segment of every column
+	unique_ptr<ColumnAppendState[]> states;
+	//! The amount of rows held by the segments
+	idx_t segment_count;
+
+public:
+	//! Appends a chunk of which the constraints have been verified
+	void Append(DataChunk &chunk);
+	//! Returns the total amount of appended rows
+	idx_t Count() {
+		return head.size() + segment_count + tail.size();
+	}
+
+private:
+	//! Copies (a part of) the chunk into the target, returns the amount of copied rows
+	static idx_t CopyRows(DataChunk &source, idx_t offset, DataChunk &target);
+	//! Appends a complete vector of rows to the segments
+	void AppendToSegments(DataChunk &chunk);
+};
+
+} // namespace duckdb
@@ -11,6 +11,7 @@
 #include "duckdb/storage/table/column_segment.hpp"
 #include "duckdb/storage/block.hpp"
 #include "duckdb/storage/uncompressed_segment.hpp"
+#include "duckdb/common/enums/compression_type.hpp"
 
 namespace duckdb {
 class DatabaseInstance;
@@ -18,7 +19,7 @@ class DatabaseInstance;
 class PersistentSegment : public ColumnSegment {
 public:
 	PersistentSegment(DatabaseInstance &db, block_id_t id, idx_t offset, LogicalType type, idx_t start, idx_t count,
-	                  unique_ptr<BaseStatistics> statistics);
+	                  CompressionType compression, unique_ptr<BaseStatistics> statistics);
 
 	//! The storage manager
 	DatabaseInstance &db;
@@ -26,12 +27,17 @@ public:
 	block_id_t block_id;
 	//! The offset into the block
 	idx_t offset;
+	//! The compression used to store the segment
+	CompressionType compression;
 	//! The uncompressed segment that the data of the persistent segment is loaded into
 	unique_ptr<UncompressedSegment> data;
 
 public:
 	bool HasChanges();
 
+	//! Schedule an asynchronous load of the block of this segment
+	void ReadAhead();
+
 	void InitializeScan(ColumnScanState &state) override;
 	//! Scan one vector from this persistent segment
 	void Scan(Transaction &transaction, ColumnScanState &state, idx_t vector_index, Vector &result) override;
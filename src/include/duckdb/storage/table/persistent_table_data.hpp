@@ -10,12 +10,21 @@
 
 #include "duckdb/common/constants.hpp"
 #include "duckdb/common/vector.hpp"
+#include "duckdb/storage/block.hpp"
 #include "duckdb/storage/table/segment_tree.hpp"
 
 namespace duckdb {
 class BaseStatistics;
 class PersistentSegment;
 
+//! The location of an index that was persisted at a checkpoint
+struct PersistentIndexData {
+	//! Pointer to the root node of the index
+	BlockPointer root;
+	//! The blocks that (partially) hold the nodes of the index
+	vector<block_id_t> blocks;
+};
+
 class PersistentTableData {
 public:
 	PersistentTableData(idx_t column_count);
@@ -24,6 +33,8 @@ public:
 	vector<unique_ptr<BaseStatistics>> column_stats;
 	vector<vector<unique_ptr<PersistentSegment>>> table_data;
 	shared_ptr<SegmentTree> versions;
+	//! The persisted indexes of the UNIQUE and PRIMARY KEY constraints of the table
+	vector<PersistentIndexData> indexes;
 };
 
 } // namespace duckdb
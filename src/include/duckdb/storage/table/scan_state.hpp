@@ -43,6 +43,15 @@ struct ColumnScanState {
 	bool initialized = false;
 	//! If this segment has already been checked for skipping puorposes
 	bool segment_checked = false;
+	//! The decoded dictionary of a dictionary compressed segment, shared by the dictionary vectors emitted by the scan
+	buffer_ptr<VectorBuffer> dictionary;
+	//! For every entry of the dictionary, whether or not it passes the table filters of the scan
+	unique_ptr<bool[]> dictionary_filter;
+	//! The amount of segments ahead of the current segment whose blocks are loaded asynchronously (0 disables
+	//! read-ahead)
+	idx_t read_ahead_depth = 0;
+	//! The row up to which the blocks of the column have been scheduled for read-ahead
+	idx_t read_ahead_row = 0;
 
 public:
 	//! Move on to the next vector in the scan
@@ -80,8 +89,12 @@ public:
 	idx_t column_count;
 	TableFilterSet *table_filters = nullptr;
 	unique_ptr<AdaptiveFilter> adaptive_filter;
+	//! Filters that are only used to skip segments using their zonemaps (optional)
+	TableFilterSet *zonemap_filters = nullptr;
 	LocalScanState local_state;
 	MorselInfo *version_info;
+	//! The sequence number of the morsel of a parallel scan
+	idx_t batch_index = 0;
 
 	//! Move to the next vector
 	void NextVector();
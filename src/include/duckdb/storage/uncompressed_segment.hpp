@@ -77,6 +77,9 @@ public:
 	//! full.
 	virtual idx_t Append(SegmentStatistics &stats, Vector &data, idx_t offset, idx_t count) = 0;
 
+	//! Revert the appends of the rows starting at start_row
+	void RevertAppend(idx_t start_row);
+
 	//! Update a set of row identifiers to the specified set of updated values
 	void Update(ColumnData &data, SegmentStatistics &stats, Transaction &transaction, Vector &update, row_t *ids,
 	            idx_t count, row_t offset);
@@ -112,6 +115,11 @@ protected:
 	                                 idx_t &approved_tuple_count) = 0;
 	//! Fetch base table data
 	virtual void FetchBaseData(ColumnScanState &state, idx_t vector_index, Vector &result) = 0;
+	//! Fetch base table data for a regular scan of a vector without updates. Unlike FetchBaseData, the result is not
+	//! necessarily a flat vector.
+	virtual void ScanBaseData(ColumnScanState &state, idx_t vector_index, Vector &result) {
+		FetchBaseData(state, vector_index, result);
+	}
 	//! Fetch update data from an UpdateInfo version
 	virtual void FetchUpdateData(ColumnScanState &state, transaction_t start_time, transaction_t transaction_id,
 	                             UpdateInfo *version, Vector &result) = 0;
@@ -4,6 +4,7 @@
 #include "duckdb/common/serializer/buffered_deserializer.hpp"
 #include "duckdb/common/serializer/buffered_serializer.hpp"
 #include "duckdb/execution/physical_plan_generator.hpp"
+#include "duckdb/execution/operator/helper/physical_result_collector.hpp"
 #include "duckdb/main/database.hpp"
 #include "duckdb/main/materialized_query_result.hpp"
 #include "duckdb/main/query_result.hpp"
@@ -200,21 +201,31 @@ unique_ptr<QueryResult> ClientContext::ExecutePreparedStatement(ClientContextLoc
 
 	bool create_stream_result = statement.allow_stream_result && allow_stream_result;
 
-	// store the physical plan in the context for calls to Fetch()
-	executor.Initialize(statement.plan.get());
+	if (create_stream_result) {
+		// store the physical plan in the context for calls to Fetch()
+		executor.Initialize(statement.plan.get());
 
-	auto types = executor.GetTypes();
+		auto types = executor.GetTypes();
 
-	D_ASSERT(types == statement.types);
+		D_ASSERT(types == statement.types);
 
-	if (create_stream_result) {
 		// successfully compiled SELECT clause and it is the last statement
 		// return a StreamQueryResult so the client can call Fetch() on it and stream the result
 		return make_unique<StreamQueryResult>(statement.statement_type, shared_from_this(), statement.types,
 		                                      statement.names, move(statement_p));
 	}
-	// create a materialized result by continuously fetching
+	// collect the result of the plan in parallel, if possible
+	PhysicalResultCollector collector(statement.plan.get(), preserve_insertion_order);
+	executor.Initialize(statement.plan.get(), &collector);
+
+	D_ASSERT(executor.GetTypes() == statement.types);
+
 	auto result = make_unique<MaterializedQueryResult>(statement.statement_type, statement.types, statement.names);
+	if (collector.sink_state) {
+		result->collection.Merge(collector.GetResult());
+		return move(result);
+	}
+	// create a materialized result by continuously fetching
 	while (true) {
 		auto chunk = FetchInternal(lock);
 		if (chunk->size() == 0) {
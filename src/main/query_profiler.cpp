@@ -58,6 +58,7 @@ bool QueryProfiler::OperatorRequiresProfiling(PhysicalOperatorType op_type) {
 	case PhysicalOperatorType::HASH_JOIN:
 	case PhysicalOperatorType::CROSS_PRODUCT:
 	case PhysicalOperatorType::PIECEWISE_MERGE_JOIN:
+	case PhysicalOperatorType::IE_JOIN:
 	case PhysicalOperatorType::DELIM_JOIN:
 	case PhysicalOperatorType::UNION:
 	case PhysicalOperatorType::RECURSIVE_CTE:
@@ -220,13 +221,27 @@ void QueryProfiler::Flush(OperatorProfiler &profiler) {
 
 	for (auto &node : profiler.timings) {
 		auto entry = tree_map.find(node.first);
-		D_ASSERT(entry != tree_map.end());
+		if (entry == tree_map.end()) {
+			// the operator is not part of the plan, e.g. the result collector
+			continue;
+		}
 
 		entry->second->info.time += node.second.time;
 		entry->second->info.elements += node.second.elements;
 	}
 }
 
+void QueryProfiler::AddSpilledBytes(PhysicalOperator *op, idx_t bytes) {
+	if (!enabled || !running || bytes == 0) {
+		return;
+	}
+	auto entry = tree_map.find(op);
+	if (entry == tree_map.end()) {
+		return;
+	}
+	entry->second->spilled_bytes += bytes;
+}
+
 static string DrawPadded(string str, idx_t width) {
 	if (str.size() > width) {
 		return str.substr(0, width);
@@ -334,6 +349,7 @@ static void ToJSONRecursive(QueryProfiler::TreeNode &node, std::ostream &ss, int
 	ss << string(depth * 3, ' ') << "\"name\": \"" + node.name + "\",\n";
 	ss << string(depth * 3, ' ') << "\"timing\":" + StringUtil::Format("%.2f", node.info.time) + ",\n";
 	ss << string(depth * 3, ' ') << "\"cardinality\":" + to_string(node.info.elements) + ",\n";
+	ss << string(depth * 3, ' ') << "\"spilled_bytes\":" + to_string(node.spilled_bytes.load()) + ",\n";
 	ss << string(depth * 3, ' ') << "\"extra_info\": \"" + StringUtil::Replace(node.extra_info, "\n", "\\n") + "\",\n";
 	ss << string(depth * 3, ' ') << "\"children\": [";
 	if (node.children.size() == 0) {
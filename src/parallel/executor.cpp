@@ -1,6 +1,7 @@
 #include "duckdb/execution/executor.hpp"
 
 #include "duckdb/execution/operator/helper/physical_execute.hpp"
+#include "duckdb/execution/operator/helper/physical_result_collector.hpp"
 #include "duckdb/execution/operator/join/physical_delim_join.hpp"
 #include "duckdb/execution/operator/scan/physical_chunk_scan.hpp"
 #include "duckdb/execution/operator/set/physical_recursive_cte.hpp"
@@ -21,7 +22,7 @@ Executor::Executor(ClientContext &context) : context(context) {
 Executor::~Executor() {
 }
 
-void Executor::Initialize(PhysicalOperator *plan) {
+void Executor::Initialize(PhysicalOperator *plan, PhysicalResultCollector *collector) {
 	Reset();
 
 	physical_plan = plan;
@@ -31,7 +32,12 @@ void Executor::Initialize(PhysicalOperator *plan) {
 	auto &scheduler = TaskScheduler::GetScheduler(context);
 	this->producer = scheduler.CreateProducer();
 
-	BuildPipelines(physical_plan, nullptr);
+	if (collector) {
+		// the result is materialized by the pipeline of the collector, if it can be executed in parallel
+		BuildPipelines(collector, nullptr);
+	} else {
+		BuildPipelines(physical_plan, nullptr);
+	}
 
 	this->total_pipelines = pipelines.size();
 
@@ -99,6 +105,7 @@ void Executor::BuildPipelines(PhysicalOperator *op, Pipeline *parent) {
 		case PhysicalOperatorType::BLOCKWISE_NL_JOIN:
 		case PhysicalOperatorType::HASH_JOIN:
 		case PhysicalOperatorType::PIECEWISE_MERGE_JOIN:
+		case PhysicalOperatorType::IE_JOIN:
 		case PhysicalOperatorType::CROSS_PRODUCT:
 			// regular join, create a pipeline with RHS source that sinks into this pipeline
 			pipeline->child = op->children[1].get();
@@ -111,6 +118,10 @@ void Executor::BuildPipelines(PhysicalOperator *op, Pipeline *parent) {
 			pipeline->child = op->children[0].get();
 			break;
 		}
+		case PhysicalOperatorType::RESULT_COLLECTOR:
+			// result collector: the root of the plan is the source
+			pipeline->child = ((PhysicalResultCollector &)*op).plan;
+			break;
 		default:
 			throw InternalException("Unimplemented sink type!");
 		}
@@ -11,6 +11,9 @@
 #include "duckdb/execution/operator/aggregate/physical_simple_aggregate.hpp"
 #include "duckdb/execution/operator/scan/physical_table_scan.hpp"
 #include "duckdb/execution/operator/aggregate/physical_hash_aggregate.hpp"
+#include "duckdb/execution/operator/helper/physical_execute.hpp"
+#include "duckdb/execution/operator/helper/physical_result_collector.hpp"
+#include "duckdb/execution/operator/persistent/physical_insert.hpp"
 
 namespace duckdb {
 
@@ -100,10 +103,14 @@ bool Pipeline::ScheduleOperator(PhysicalOperator *op) {
 	case PhysicalOperatorType::FILTER:
 	case PhysicalOperatorType::PROJECTION:
 	case PhysicalOperatorType::HASH_JOIN:
+	case PhysicalOperatorType::IE_JOIN:
 	case PhysicalOperatorType::CROSS_PRODUCT:
 	case PhysicalOperatorType::STREAMING_SAMPLE:
-		// filter, projection or hash probe: continue in children
+		// filter, projection or join probe: continue in children
 		return ScheduleOperator(op->children[0].get());
+	case PhysicalOperatorType::EXECUTE:
+		// prepared statement: continue in the plan
+		return ScheduleOperator(((PhysicalExecute &)*op).plan);
 	case PhysicalOperatorType::TABLE_SCAN: {
 		// we reached a scan: split it up into parts and schedule the parts
 		auto &scheduler = TaskScheduler::GetScheduler(executor.context);
@@ -134,8 +141,27 @@ bool Pipeline::ScheduleOperator(PhysicalOperator *op) {
 		return true;
 	}
 	case PhysicalOperatorType::HASH_GROUP_BY: {
-		// FIXME: parallelize scan of GROUP_BY HT
-		return false;
+		// the aggregate has been finalized by the pipeline we depend on: split the scan of its HTs into morsels
+		auto &scheduler = TaskScheduler::GetScheduler(executor.context);
+		auto &hash_aggr = (PhysicalHashAggregate &)*op;
+		idx_t max_threads = hash_aggr.MorselCount();
+		if (max_threads > executor.context.db->NumberOfThreads()) {
+			max_threads = executor.context.db->NumberOfThreads();
+		}
+		if (max_threads <= 1) {
+			// too few groups to parallelize
+			return false;
+		}
+		this->parallel_state = hash_aggr.GetParallelState();
+		this->parallel_node = op;
+
+		// launch a task for every thread
+		this->total_tasks = max_threads;
+		for (idx_t i = 0; i < max_threads; i++) {
+			auto task = make_unique<PipelineTask>(this);
+			scheduler.ScheduleTask(*executor.producer, move(task));
+		}
+		return true;
 	}
 	default:
 		// unknown operator: skip parallel task scheduling
@@ -143,6 +169,25 @@ bool Pipeline::ScheduleOperator(PhysicalOperator *op) {
 	}
 }
 
+//! Whether or not the operators on top of the parallel source emit the rows of a morsel before the rows of the next
+//! morsel, so that the sink can restore the order of the source from the morsel sequence numbers
+static bool PreservesMorselOrder(PhysicalOperator *op) {
+	switch (op->type) {
+	case PhysicalOperatorType::FILTER:
+	case PhysicalOperatorType::PROJECTION:
+		return PreservesMorselOrder(op->children[0].get());
+	case PhysicalOperatorType::EXECUTE:
+		return PreservesMorselOrder(((PhysicalExecute &)*op).plan);
+	case PhysicalOperatorType::TABLE_SCAN:
+		return ((PhysicalTableScan &)*op).function.get_batch_index != nullptr;
+	case PhysicalOperatorType::HASH_GROUP_BY:
+		return true;
+	default:
+		// e.g. the hash probe and unnest combine the rows of multiple input chunks in one output chunk
+		return false;
+	}
+}
+
 void Pipeline::ClearParents() {
 	for (auto &parent : parents) {
 		parent->dependencies.erase(this);
@@ -203,8 +248,21 @@ void Pipeline::Schedule() {
 		}
 		break;
 	}
+	case PhysicalOperatorType::INSERT: {
+		auto &insert = (PhysicalInsert &)*sink;
+		if (!insert.ParallelInsert(executor.context)) {
+			// the rows have to be inserted in order: switch to sequential mode
+			break;
+		}
+		if (ScheduleOperator(sink->children[0].get())) {
+			// all parallel tasks have been scheduled: return
+			return;
+		}
+		break;
+	}
 	case PhysicalOperatorType::CROSS_PRODUCT:
-	case PhysicalOperatorType::HASH_JOIN: {
+	case PhysicalOperatorType::HASH_JOIN:
+	case PhysicalOperatorType::IE_JOIN: {
 		// schedule build side of the join
 		if (ScheduleOperator(sink->children[1].get())) {
 			// all parallel tasks have been scheduled: return
@@ -220,6 +278,17 @@ void Pipeline::Schedule() {
 		}
 		break;
 	}
+	case PhysicalOperatorType::RESULT_COLLECTOR: {
+		auto &collector = (PhysicalResultCollector &)*sink;
+		if ((!collector.preserve_order || PreservesMorselOrder(child)) && ScheduleOperator(child)) {
+			// all parallel tasks have been scheduled: return
+			return;
+		}
+		// the result cannot be collected in parallel: the client thread fetches it from the plan instead, so that
+		// statements such as PRAGMA threads are not executed by a worker thread
+		Finish();
+		return;
+	}
 	default:
 		break;
 	}
@@ -0,0 +1,190 @@
+#include "duckdb/storage/buffer/temporary_file_manager.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/to_string.hpp"
+#include "duckdb/main/database.hpp"
+#include "miniz.hpp"
+
+namespace duckdb {
+
+using namespace duckdb_miniz;
+
+//! The name of the shared temporary file in the temporary directory
+static constexpr const char *TEMPORARY_STORAGE_FILE = "duckdb_temp_storage.tmp";
+
+TemporaryFileManager::TemporaryFileManager(DatabaseInstance &db, string temp_directory_p)
+    : db(db), temp_directory(move(temp_directory_p)), slot_count(0) {
+}
+
+TemporaryFileManager::~TemporaryFileManager() {
+	if (handle) {
+		handle.reset();
+		auto &fs = FileSystem::GetFileSystem(db);
+		auto path = fs.JoinPath(temp_directory, TEMPORARY_STORAGE_FILE);
+		if (fs.FileExists(path)) {
+			fs.RemoveFile(path);
+		}
+	}
+}
+
+string TemporaryFileManager::GetTemporaryPath(block_id_t id) {
+	auto &fs = FileSystem::GetFileSystem(db);
+	return fs.JoinPath(temp_directory, to_string(id) + ".block");
+}
+
+idx_t TemporaryFileManager::AllocateSlot() {
+	// find the first free slot
+	idx_t word_idx;
+	for (word_idx = 0; word_idx < used_slots.size(); word_idx++) {
+		if (used_slots[word_idx] != ~uint64_t(0)) {
+			break;
+		}
+	}
+	if (word_idx == used_slots.size()) {
+		used_slots.push_back(0);
+	}
+	idx_t bit_idx = 0;
+	while (used_slots[word_idx] & (uint64_t(1) << bit_idx)) {
+		bit_idx++;
+	}
+	used_slots[word_idx] |= uint64_t(1) << bit_idx;
+	auto slot = word_idx * 64 + bit_idx;
+	slot_count = MaxValue<idx_t>(slot_count, slot + 1);
+	return slot;
+}
+
+void TemporaryFileManager::FreeSlot(idx_t slot) {
+	used_slots[slot / 64] &= ~(uint64_t(1) << (slot % 64));
+	if (slot + 1 < slot_count) {
+		return;
+	}
+	// the last slot of the file was freed: shrink the file to the last slot that is still in use
+	while (slot_count > 0 && !(used_slots[(slot_count - 1) / 64] & (uint64_t(1) << ((slot_count - 1) % 64)))) {
+		slot_count--;
+	}
+	used_slots.resize((slot_count + 63) / 64);
+	auto &fs = FileSystem::GetFileSystem(db);
+	fs.Truncate(*handle, slot_count * Storage::BLOCK_ALLOC_SIZE);
+}
+
+void TemporaryFileManager::RemoveBuffer(block_id_t id, TemporaryBufferIndex &index) {
+	if (index.slot != INVALID_INDEX) {
+		FreeSlot(index.slot);
+	} else {
+		auto &fs = FileSystem::GetFileSystem(db);
+		auto path = GetTemporaryPath(id);
+		if (fs.FileExists(path)) {
+			fs.RemoveFile(path);
+		}
+	}
+	buffers.erase(id);
+}
+
+void TemporaryFileManager::WriteTemporaryBuffer(ManagedBuffer &buffer, bool compress) {
+	D_ASSERT(buffer.size + Storage::BLOCK_HEADER_SIZE >= Storage::BLOCK_ALLOC_SIZE);
+	// the checksum is verified when the buffer is read back
+	buffer.StoreChecksum();
+	data_ptr_t data = buffer.InternalBuffer();
+	idx_t data_size = buffer.AllocSize();
+	unique_ptr<data_t[]> compressed_data;
+	if (compress) {
+		mz_ulong compressed_size = mz_compressBound(data_size);
+		compressed_data = unique_ptr<data_t[]>(new data_t[compressed_size]);
+		auto ret = mz_compress2(compressed_data.get(), &compressed_size, data, data_size, MZ_BEST_SPEED);
+		if (ret == MZ_OK && compressed_size < data_size) {
+			data = compressed_data.get();
+			data_size = compressed_size;
+		}
+	}
+
+	TemporaryBufferIndex index;
+	index.alloc_size = buffer.AllocSize();
+	index.stored_size = data_size;
+	auto &fs = FileSystem::GetFileSystem(db);
+	{
+		lock_guard<mutex> temp_lock(lock);
+		D_ASSERT(buffers.find(buffer.id) == buffers.end());
+		if (index.alloc_size == Storage::BLOCK_ALLOC_SIZE) {
+			if (!handle) {
+				auto path = fs.JoinPath(temp_directory, TEMPORARY_STORAGE_FILE);
+				handle = fs.OpenFile(path, FileFlags::FILE_FLAGS_WRITE | FileFlags::FILE_FLAGS_FILE_CREATE_NEW);
+			}
+			index.slot = AllocateSlot();
+		} else {
+			index.slot = INVALID_INDEX;
+		}
+		buffers[buffer.id] = index;
+	}
+	try {
+		if (index.slot != INVALID_INDEX) {
+			// the slot is reserved for this buffer: write it without holding the lock
+			handle->Write(data, data_size, index.slot * Storage::BLOCK_ALLOC_SIZE);
+		} else {
+			auto path = GetTemporaryPath(buffer.id);
+			auto file = fs.OpenFile(path, FileFlags::FILE_FLAGS_WRITE | FileFlags::FILE_FLAGS_FILE_CREATE_NEW);
+			file->Write(data, data_size, 0);
+		}
+	} catch (...) {
+		lock_guard<mutex> temp_lock(lock);
+		RemoveBuffer(buffer.id, index);
+		throw;
+	}
+}
+
+unique_ptr<FileBuffer> TemporaryFileManager::ReadTemporaryBuffer(block_id_t id) {
+	TemporaryBufferIndex index;
+	{
+		lock_guard<mutex> temp_lock(lock);
+		auto entry = buffers.find(id);
+		if (entry == buffers.end()) {
+			throw InternalException("Temporary buffer %lld was not written to the temporary storage", id);
+		}
+		index = entry->second;
+	}
+	// read the stored data
+	unique_ptr<FileHandle> file;
+	FileHandle *source = handle.get();
+	idx_t location = 0;
+	if (index.slot != INVALID_INDEX) {
+		location = index.slot * Storage::BLOCK_ALLOC_SIZE;
+	} else {
+		auto &fs = FileSystem::GetFileSystem(db);
+		auto path = GetTemporaryPath(id);
+		file = fs.OpenFile(path, FileFlags::FILE_FLAGS_READ);
+		source = file.get();
+	}
+	auto buffer = make_unique<ManagedBuffer>(db, index.alloc_size, false, id);
+	D_ASSERT(buffer->AllocSize() == index.alloc_size);
+	if (index.stored_size == index.alloc_size) {
+		source->Read(buffer->InternalBuffer(), index.alloc_size, location);
+	} else {
+		auto compressed_data = unique_ptr<data_t[]>(new data_t[index.stored_size]);
+		source->Read(compressed_data.get(), index.stored_size, location);
+		mz_ulong decompressed_size = index.alloc_size;
+		auto ret =
+		    mz_uncompress(buffer->InternalBuffer(), &decompressed_size, compressed_data.get(), index.stored_size);
+		if (ret != MZ_OK || decompressed_size != index.alloc_size) {
+			throw IOException("Failed to decompress temporary buffer %lld", id);
+		}
+	}
+	buffer->VerifyChecksum();
+	// the buffer is back in memory: the space it occupied can be reused
+	{
+		lock_guard<mutex> temp_lock(lock);
+		RemoveBuffer(id, index);
+	}
+	return move(buffer);
+}
+
+void TemporaryFileManager::DeleteTemporaryBuffer(block_id_t id) {
+	lock_guard<mutex> temp_lock(lock);
+	auto entry = buffers.find(id);
+	if (entry == buffers.end()) {
+		// the buffer was never written to (or was already read back from) the temporary storage
+		return;
+	}
+	auto index = entry->second;
+	RemoveBuffer(id, index);
+}
+
+} // namespace duckdb
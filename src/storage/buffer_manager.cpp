@@ -3,7 +3,13 @@
 #include "duckdb/storage/storage_manager.hpp"
 
 #include "duckdb/common/exception.hpp"
-#include "concurrentqueue.h"
+#include "duckdb/main/config.hpp"
+
+#ifndef DUCKDB_NO_THREADS
+#include "duckdb/common/thread.hpp"
+#include <condition_variable>
+#include <queue>
+#endif
 
 namespace duckdb {
 
@@ -11,7 +17,8 @@ BlockHandle::BlockHandle(DatabaseInstance &db, block_id_t block_id_p) : db(db) {
 	block_id = block_id_p;
 	readers = 0;
 	buffer = nullptr;
-	eviction_timestamp = 0;
+	access_count = 0;
+	eviction_list = EvictionList::NONE;
 	state = BlockState::BLOCK_UNLOADED;
 	can_destroy = false;
 	memory_usage = Storage::BLOCK_ALLOC_SIZE;
@@ -24,7 +31,8 @@ BlockHandle::BlockHandle(DatabaseInstance &db, block_id_t block_id_p, unique_ptr
 	block_id = block_id_p;
 	readers = 0;
 	buffer = move(buffer_p);
-	eviction_timestamp = 0;
+	access_count = 0;
+	eviction_list = EvictionList::NONE;
 	state = BlockState::BLOCK_LOADED;
 	can_destroy = can_destroy_p;
 	memory_usage = alloc_size;
@@ -32,6 +40,7 @@ BlockHandle::BlockHandle(DatabaseInstance &db, block_id_t block_id_p, unique_ptr
 
 BlockHandle::~BlockHandle() {
 	auto &buffer_manager = BufferManager::GetBufferManager(db);
+	buffer_manager.RemoveFromEvictionList(*this);
 	// no references remain to this block: erase
 	if (state == BlockState::BLOCK_LOADED) {
 		// the block is still loaded in memory: erase it
@@ -47,25 +56,23 @@ unique_ptr<BufferHandle> BlockHandle::Load(shared_ptr<BlockHandle> &handle) {
 		D_ASSERT(handle->buffer);
 		return make_unique<BufferHandle>(handle, handle->buffer.get());
 	}
-	handle->state = BlockState::BLOCK_LOADED;
-
 	auto &buffer_manager = BufferManager::GetBufferManager(handle->db);
 	auto &block_manager = BlockManager::GetBlockManager(handle->db);
 	if (handle->block_id < MAXIMUM_BLOCK) {
-		// FIXME: currently we still require a lock for reading blocks from disk
-		// this is mainly down to the block manager only having a single pointer into the file
-		// this is relatively easy to fix later on
-		lock_guard<mutex> buffer_lock(buffer_manager.manager_lock);
+		// the caller holds the lock of this block: reads of different blocks run in parallel
 		auto block = make_unique<Block>(handle->block_id);
 		block_manager.Read(*block);
 		handle->buffer = move(block);
 	} else {
 		if (handle->can_destroy) {
+			handle->state = BlockState::BLOCK_LOADED;
 			return nullptr;
 		} else {
 			handle->buffer = buffer_manager.ReadTemporaryBuffer(handle->block_id);
 		}
 	}
+	// only mark the block as loaded once the read succeeded
+	handle->state = BlockState::BLOCK_LOADED;
 	return make_unique<BufferHandle>(handle, handle->buffer.get());
 }
 
@@ -85,6 +92,9 @@ void BlockHandle::Unload() {
 	}
 	buffer.reset();
 	buffer_manager.current_memory -= memory_usage;
+	access_count = 0;
+	// unloaded blocks are never in an eviction list
+	buffer_manager.RemoveFromEvictionList(*this);
 }
 
 bool BlockHandle::CanUnload() {
@@ -106,40 +116,158 @@ bool BlockHandle::CanUnload() {
 	return true;
 }
 
-struct BufferEvictionNode {
-	BufferEvictionNode(weak_ptr<BlockHandle> handle_p, idx_t timestamp_p)
-	    : handle(move(handle_p)), timestamp(timestamp_p) {
-		D_ASSERT(!handle.expired());
+//! A shard of the eviction lists. Every block belongs to the shard given by its block id, so threads pinning and
+//! unpinning different blocks mostly use different locks.
+struct EvictionShard {
+	mutex lock;
+	//! The blocks that were used once since they were loaded, in FIFO order
+	eviction_list_t probation;
+	//! The blocks that were used more than once since they were loaded, in LRU order
+	eviction_list_t protected_blocks;
+	//! The amount of pins of blocks that were already loaded
+	std::atomic<idx_t> hits;
+	//! The amount of pins that had to load the block
+	std::atomic<idx_t> misses;
+	//! The amount of blocks that were evicted
+	std::atomic<idx_t> evictions;
+
+	EvictionShard() : hits(0), misses(0), evictions(0) {
 	}
 
-	weak_ptr<BlockHandle> handle;
-	idx_t timestamp;
+	eviction_list_t &GetList(EvictionList list) {
+		D_ASSERT(list != EvictionList::NONE);
+		return list == EvictionList::PROBATION ? probation : protected_blocks;
+	}
+};
 
-	bool CanUnload(BlockHandle &handle) {
-		if (timestamp != handle.eviction_timestamp) {
-			// handle was used in between
-			return false;
+//! The replacement policy of the buffer manager, a simplified 2Q: blocks that were only used once since they were
+//! loaded (e.g. by a large scan) are on probation and are evicted first, blocks that were used more often are
+//! protected and are only evicted when few blocks are left on probation.
+struct EvictionQueue {
+	static constexpr idx_t SHARD_COUNT = 16;
+	//! Protected blocks are evicted once less than 1 / PROBATION_RATIO of the blocks in the lists are on probation
+	static constexpr idx_t PROBATION_RATIO = 4;
+
+	EvictionShard shards[SHARD_COUNT];
+	//! The shard to start looking for the next block to evict, eviction cycles through the shards
+	std::atomic<idx_t> next_shard;
+	//! The total amount of blocks on probation and protected over all shards
+	std::atomic<idx_t> probation_count;
+	std::atomic<idx_t> protected_count;
+
+	EvictionQueue() : next_shard(0), probation_count(0), protected_count(0) {
+	}
+
+	EvictionShard &GetShard(BlockHandle &handle) {
+		return shards[idx_t(handle.BlockId()) % SHARD_COUNT];
+	}
+
+	//! Add the unpinned block to the back of the eviction list that matches how often it was used, the caller holds
+	//! the lock of the block
+	void Insert(shared_ptr<BlockHandle> &handle) {
+		auto target = handle->access_count > 1 ? EvictionList::PROTECTED : EvictionList::PROBATION;
+		auto &shard = GetShard(*handle);
+		lock_guard<mutex> shard_lock(shard.lock);
+		RemoveInternal(shard, *handle);
+		auto &list = shard.GetList(target);
+		handle->eviction_list = target;
+		handle->eviction_position = list.insert(list.end(), weak_ptr<BlockHandle>(handle));
+		GetCount(target)++;
+	}
+
+	//! Remove the block from the eviction list it is in (if any)
+	void Remove(BlockHandle &handle) {
+		auto &shard = GetShard(handle);
+		lock_guard<mutex> shard_lock(shard.lock);
+		RemoveInternal(shard, handle);
+	}
+
+	//! Remove the next block to evict from the eviction lists, returns nullptr if the lists are empty
+	shared_ptr<BlockHandle> PopCandidate() {
+		idx_t probation = probation_count;
+		bool prefer_probation = probation * PROBATION_RATIO > probation + protected_count;
+		auto first = prefer_probation ? EvictionList::PROBATION : EvictionList::PROTECTED;
+		auto second = prefer_probation ? EvictionList::PROTECTED : EvictionList::PROBATION;
+		auto start = next_shard++;
+		for (auto list : {first, second}) {
+			for (idx_t i = 0; i < SHARD_COUNT; i++) {
+				auto handle = PopCandidate(shards[(start + i) % SHARD_COUNT], list);
+				if (handle) {
+					return handle;
+				}
+			}
 		}
-		return handle.CanUnload();
+		return nullptr;
 	}
-};
 
-typedef moodycamel::ConcurrentQueue<unique_ptr<BufferEvictionNode>> eviction_queue_t;
+private:
+	std::atomic<idx_t> &GetCount(EvictionList list) {
+		return list == EvictionList::PROBATION ? probation_count : protected_count;
+	}
 
-struct EvictionQueue {
-	eviction_queue_t q;
+	void RemoveInternal(EvictionShard &shard, BlockHandle &handle) {
+		if (handle.eviction_list != EvictionList::NONE) {
+			shard.GetList(handle.eviction_list).erase(handle.eviction_position);
+			GetCount(handle.eviction_list)--;
+			handle.eviction_list = EvictionList::NONE;
+		}
+	}
+
+	shared_ptr<BlockHandle> PopCandidate(EvictionShard &shard, EvictionList list_type) {
+		lock_guard<mutex> shard_lock(shard.lock);
+		auto &list = shard.GetList(list_type);
+		for (auto &entry : list) {
+			auto handle = entry.lock();
+			if (!handle) {
+				// the block is being destroyed, its destructor removes it from the list
+				continue;
+			}
+			RemoveInternal(shard, *handle);
+			return handle;
+		}
+		return nullptr;
+	}
+};
+
+struct ReadAheadQueue {
+#ifndef DUCKDB_NO_THREADS
+	//! The maximum amount of outstanding read-ahead requests, further requests are dropped
+	static constexpr idx_t MAXIMUM_QUEUE_SIZE = 1024;
+
+	mutex lock;
+	std::condition_variable blocks_available;
+	//! The blocks that are scheduled to be loaded
+	std::queue<weak_ptr<BlockHandle>> blocks;
+	//! The background thread that loads the blocks, launched on the first read-ahead request
+	unique_ptr<thread> loader;
+	//! Set when the buffer manager is destroyed to stop the loader thread
+	bool finished = false;
+#endif
 };
 
 BufferManager::BufferManager(DatabaseInstance &db, string tmp, idx_t maximum_memory)
     : db(db), current_memory(0), maximum_memory(maximum_memory), temp_directory(move(tmp)),
-      queue(make_unique<EvictionQueue>()), temporary_id(MAXIMUM_BLOCK) {
+      queue(make_unique<EvictionQueue>()), temporary_id(MAXIMUM_BLOCK), read_ahead(make_unique<ReadAheadQueue>()) {
 	auto &fs = FileSystem::GetFileSystem(db);
 	if (!temp_directory.empty()) {
 		fs.CreateDirectory(temp_directory);
+		temporary_files = make_unique<TemporaryFileManager>(db, temp_directory);
 	}
 }
 
 BufferManager::~BufferManager() {
+#ifndef DUCKDB_NO_THREADS
+	// stop the read-ahead thread before anything it uses is destroyed
+	{
+		lock_guard<mutex> queue_lock(read_ahead->lock);
+		read_ahead->finished = true;
+	}
+	read_ahead->blocks_available.notify_all();
+	if (read_ahead->loader) {
+		read_ahead->loader->join();
+	}
+#endif
+	temporary_files.reset();
 	auto &fs = FileSystem::GetFileSystem(db);
 	if (!temp_directory.empty()) {
 		fs.RemoveDirectory(temp_directory);
@@ -186,22 +314,43 @@ unique_ptr<BufferHandle> BufferManager::Allocate(idx_t alloc_size) {
 }
 
 unique_ptr<BufferHandle> BufferManager::Pin(shared_ptr<BlockHandle> &handle) {
+	return PinInternal(handle, true);
+}
+
+unique_ptr<BufferHandle> BufferManager::PinInternal(shared_ptr<BlockHandle> &handle, bool count_access) {
+	auto &shard = queue->GetShard(*handle);
 	// lock the block
 	lock_guard<mutex> lock(handle->lock);
+	if (count_access) {
+		handle->access_count++;
+	}
 	// check if the block is already loaded
 	if (handle->state == BlockState::BLOCK_LOADED) {
 		// the block is loaded, increment the reader count and return a pointer to the handle
+		if (count_access) {
+			shard.hits++;
+		}
 		handle->readers++;
 		return handle->Load(handle);
 	}
+	if (count_access) {
+		shard.misses++;
+	}
 	// evict blocks until we have space for the current block
 	if (!EvictBlocks(handle->memory_usage, maximum_memory)) {
 		throw OutOfRangeException("Not enough memory to complete operation: failed to pin block");
 	}
 	// now we can actually load the current block
 	D_ASSERT(handle->readers == 0);
-	handle->readers = 1;
-	return handle->Load(handle);
+	try {
+		auto result = handle->Load(handle);
+		handle->readers = 1;
+		return result;
+	} catch (...) {
+		// the read failed: release the memory reserved for the block again
+		current_memory -= handle->memory_usage;
+		throw;
+	}
 }
 
 void BufferManager::Unpin(shared_ptr<BlockHandle> &handle) {
@@ -209,43 +358,98 @@ void BufferManager::Unpin(shared_ptr<BlockHandle> &handle) {
 	D_ASSERT(handle->readers > 0);
 	handle->readers--;
 	if (handle->readers == 0) {
-		handle->eviction_timestamp++;
-		queue->q.enqueue(make_unique<BufferEvictionNode>(weak_ptr<BlockHandle>(handle), handle->eviction_timestamp));
-		// FIXME: do some house-keeping to prevent the queue from being flooded with many old blocks
+		queue->Insert(handle);
 	}
 }
 
+void BufferManager::ReadAhead(shared_ptr<BlockHandle> &handle) {
+#ifndef DUCKDB_NO_THREADS
+	D_ASSERT(handle->block_id < MAXIMUM_BLOCK);
+	{
+		lock_guard<mutex> queue_lock(read_ahead->lock);
+		if (read_ahead->blocks.size() >= ReadAheadQueue::MAXIMUM_QUEUE_SIZE) {
+			return;
+		}
+		read_ahead->blocks.push(weak_ptr<BlockHandle>(handle));
+		if (!read_ahead->loader) {
+			read_ahead->loader = make_unique<thread>(&BufferManager::ExecuteReadAhead, this);
+		}
+	}
+	read_ahead->blocks_available.notify_one();
+#endif
+}
+
+void BufferManager::ExecuteReadAhead() {
+#ifndef DUCKDB_NO_THREADS
+	while (true) {
+		shared_ptr<BlockHandle> handle;
+		{
+			std::unique_lock<mutex> queue_lock(read_ahead->lock);
+			read_ahead->blocks_available.wait(
+			    queue_lock, [&]() { return read_ahead->finished || !read_ahead->blocks.empty(); });
+			if (read_ahead->finished) {
+				return;
+			}
+			handle = read_ahead->blocks.front().lock();
+			read_ahead->blocks.pop();
+		}
+		if (!handle) {
+			// the block was destroyed in the mean time
+			continue;
+		}
+		{
+			lock_guard<mutex> block_lock(handle->lock);
+			if (handle->state == BlockState::BLOCK_LOADED) {
+				// the block was already loaded by a scan
+				continue;
+			}
+		}
+		try {
+			// load the block by pinning it, unpinning it again leaves it loaded in the buffer pool
+			// the load does not count as a use of the block, so the block is evicted like the other scanned blocks
+			PinInternal(handle, false);
+		} catch (...) {
+			// the block could not be loaded (e.g. there is not enough memory), the scan will load it when it gets there
+		}
+	}
+#endif
+}
+
+void BufferManager::RemoveFromEvictionList(BlockHandle &handle) {
+	queue->Remove(handle);
+}
+
 bool BufferManager::EvictBlocks(idx_t extra_memory, idx_t memory_limit) {
-	unique_ptr<BufferEvictionNode> node;
 	current_memory += extra_memory;
 	while (current_memory > memory_limit) {
-		// get a block to unpin from the queue
-		if (!queue->q.try_dequeue(node)) {
+		// get the next block to evict
+		auto handle = queue->PopCandidate();
+		if (!handle) {
 			current_memory -= extra_memory;
 			return false;
 		}
-		// get a reference to the underlying block pointer
-		auto handle = node->handle.lock();
-		if (!handle) {
-			continue;
-		}
-		if (!node->CanUnload(*handle)) {
-			// early out: we already know that we cannot unload this node
-			continue;
-		}
-		// we might be able to free this block: grab the mutex and check if we can free it
 		lock_guard<mutex> lock(handle->lock);
-		if (!node->CanUnload(*handle)) {
-			// something changed in the mean-time, bail out
+		if (!handle->CanUnload()) {
+			// the block is pinned (or already unloaded): it is added to an eviction list again when it is unpinned
 			continue;
 		}
-		// hooray, we can unload the block
 		// release the memory and mark the block as unloaded
 		handle->Unload();
+		queue->GetShard(*handle).evictions++;
 	}
 	return true;
 }
 
+BufferManagerStatistics BufferManager::GetStatistics() {
+	BufferManagerStatistics result;
+	for (auto &shard : queue->shards) {
+		result.hits += shard.hits;
+		result.misses += shard.misses;
+		result.evictions += shard.evictions;
+	}
+	return result;
+}
+
 void BufferManager::UnregisterBlock(block_id_t block_id, bool can_destroy) {
 	if (block_id >= MAXIMUM_BLOCK) {
 		// in-memory buffer: destroy the buffer
@@ -280,21 +484,10 @@ void BufferManager::SetLimit(idx_t limit) {
 	}
 }
 
-string BufferManager::GetTemporaryPath(block_id_t id) {
-	auto &fs = FileSystem::GetFileSystem(db);
-	return fs.JoinPath(temp_directory, to_string(id) + ".block");
-}
-
 void BufferManager::WriteTemporaryBuffer(ManagedBuffer &buffer) {
 	D_ASSERT(!temp_directory.empty());
-	D_ASSERT(buffer.size + Storage::BLOCK_HEADER_SIZE >= Storage::BLOCK_ALLOC_SIZE);
-	// get the path to write to
-	auto path = GetTemporaryPath(buffer.id);
-	// create the file and write the size followed by the buffer contents
-	auto &fs = FileSystem::GetFileSystem(db);
-	auto handle = fs.OpenFile(path, FileFlags::FILE_FLAGS_WRITE | FileFlags::FILE_FLAGS_FILE_CREATE);
-	handle->Write(&buffer.size, sizeof(idx_t), 0);
-	buffer.Write(*handle, sizeof(idx_t));
+	D_ASSERT(temporary_files);
+	temporary_files->WriteTemporaryBuffer(buffer, DBConfig::GetConfig(db).temporary_compression);
 }
 
 unique_ptr<FileBuffer> BufferManager::ReadTemporaryBuffer(block_id_t id) {
@@ -302,25 +495,14 @@ unique_ptr<FileBuffer> BufferManager::ReadTemporaryBuffer(block_id_t id) {
 		throw Exception("Out-of-memory: cannot read buffer because no temporary directory is specified!\nTo enable "
 		                "temporary buffer eviction set a temporary directory in the configuration");
 	}
-	idx_t alloc_size;
-	// open the temporary file and read the size
-	auto path = GetTemporaryPath(id);
-	auto &fs = FileSystem::GetFileSystem(db);
-	auto handle = fs.OpenFile(path, FileFlags::FILE_FLAGS_READ);
-	handle->Read(&alloc_size, sizeof(idx_t), 0);
-
-	// now allocate a buffer of this size and read the data into that buffer
-	auto buffer = make_unique<ManagedBuffer>(db, alloc_size + Storage::BLOCK_HEADER_SIZE, false, id);
-	buffer->Read(*handle, sizeof(idx_t));
-	return move(buffer);
+	return temporary_files->ReadTemporaryBuffer(id);
 }
 
 void BufferManager::DeleteTemporaryFile(block_id_t id) {
-	auto &fs = FileSystem::GetFileSystem(db);
-	auto path = GetTemporaryPath(id);
-	if (fs.FileExists(path)) {
-		fs.RemoveFile(path);
+	if (!temporary_files) {
+		return;
 	}
+	temporary_files->DeleteTemporaryBuffer(id);
 }
 
 } // namespace duckdb
@@ -7,11 +7,14 @@
 #include "duckdb/common/serializer/buffered_serializer.hpp"
 
 #include "duckdb/storage/numeric_segment.hpp"
+#include "duckdb/storage/compressed_segment.hpp"
+#include "duckdb/storage/compressed_string_segment.hpp"
 #include "duckdb/storage/string_segment.hpp"
 #include "duckdb/storage/table/column_segment.hpp"
 #include "duckdb/storage/table/persistent_segment.hpp"
 #include "duckdb/storage/table/transient_segment.hpp"
 #include "duckdb/storage/column_data.hpp"
+#include "duckdb/storage/statistics/string_statistics.hpp"
 #include "duckdb/storage/table/morsel_info.hpp"
 
 namespace duckdb {
@@ -47,9 +50,11 @@ TableDataWriter::TableDataWriter(DatabaseInstance &db, TableCatalogEntry &table,
 TableDataWriter::~TableDataWriter() {
 }
 
-void TableDataWriter::WriteTableData() {
+void TableDataWriter::InitializeColumns() {
 	// allocate the initial segments
 	segments.resize(table.columns.size());
+	compressed_segments.resize(table.columns.size());
+	compressed_string_segments.resize(table.columns.size());
 	data_pointers.resize(table.columns.size());
 	stats.reserve(table.columns.size());
 	column_stats.reserve(table.columns.size());
@@ -59,10 +64,10 @@ void TableDataWriter::WriteTableData() {
 		column_stats.push_back(BaseStatistics::CreateEmpty(table.columns[i].type));
 		CreateSegment(i);
 	}
+}
 
-	// now start scanning the table and append the data to the uncompressed segments
-	table.storage->Checkpoint(*this);
-
+void TableDataWriter::WriteTableData() {
+	// the data of the columns has been written: write the data pointers to the meta data
 	VerifyDataPointers();
 	WriteDataPointers();
 
@@ -73,9 +78,8 @@ void TableDataWriter::WriteTableData() {
 void TableDataWriter::CreateSegment(idx_t col_idx) {
 	auto type_id = table.columns[col_idx].type.InternalType();
 	if (type_id == PhysicalType::VARCHAR) {
-		auto string_segment = make_unique<StringSegment>(db, 0);
-		string_segment->overflow_writer = make_unique<WriteOverflowStringsToDisk>(db);
-		segments[col_idx] = move(string_segment);
+		// overflow strings are kept in memory until we know whether or not the segment is compressed
+		segments[col_idx] = make_unique<StringSegment>(db, 0);
 	} else {
 		segments[col_idx] = make_unique<NumericSegment>(db, type_id, 0);
 	}
@@ -106,10 +110,12 @@ void TableDataWriter::CheckpointColumn(ColumnData &col_data, idx_t col_idx) {
 					FlushSegment(new_tree, col_idx);
 					CreateSegment(col_idx);
 				}
+				FlushCompressedSegment(new_tree, col_idx);
 
 				// set up the data pointer directly using the data from the persistent segment
 				pointer.block_id = persistent.block_id;
 				pointer.offset = 0;
+				pointer.compression = persistent.compression;
 				pointer.row_start = segment->start;
 				pointer.tuple_count = persistent.count;
 				pointer.statistics = persistent.stats.statistics->Copy();
@@ -142,6 +148,7 @@ void TableDataWriter::CheckpointColumn(ColumnData &col_data, idx_t col_idx) {
 	}
 	// flush the final segment
 	FlushSegment(new_tree, col_idx);
+	FlushCompressedSegment(new_tree, col_idx);
 	// replace the old tree with the new one
 	col_data.data.Replace(new_tree);
 }
@@ -198,6 +205,29 @@ void TableDataWriter::FlushSegment(SegmentTree &new_tree, idx_t col_idx) {
 	if (tuple_count == 0) {
 		return;
 	}
+	auto &type = table.columns[col_idx].type;
+	// check if it is worth compressing the segment
+	if (type.InternalType() == PhysicalType::VARCHAR) {
+		auto compression = CompressedStringSegmentWriter::ChooseCompression(db, (StringSegment &)*segments[col_idx],
+		                                                                    *stats[col_idx]);
+		if (compression != CompressionType::COMPRESSION_UNCOMPRESSED) {
+			CompressStringSegment(new_tree, col_idx, compression);
+			return;
+		}
+	} else {
+		auto compression =
+		    CompressedSegmentWriter::ChooseCompression(db, (NumericSegment &)*segments[col_idx], *stats[col_idx]);
+		if (compression != CompressionType::COMPRESSION_UNCOMPRESSED) {
+			CompressSegment(new_tree, col_idx, compression);
+			return;
+		}
+	}
+	// the segment is written uncompressed: first flush any pending compressed segment
+	FlushCompressedSegment(new_tree, col_idx);
+	if (type.InternalType() == PhysicalType::VARCHAR &&
+	    ((StringStatistics &)*stats[col_idx]->statistics).has_overflow_strings) {
+		WriteOverflowStrings(col_idx);
+	}
 
 	// get the buffer of the segment and pin it
 	auto &buffer_manager = BufferManager::GetBufferManager(db);
@@ -208,6 +238,144 @@ void TableDataWriter::FlushSegment(SegmentTree &new_tree, idx_t col_idx) {
 	// get a free block id to write to
 	auto block_id = block_manager.GetFreeBlockId();
 
+	// construct the data pointer and the persistent segment that points to this block
+	AddDataPointer(new_tree, col_idx, block_id, tuple_count, CompressionType::COMPRESSION_UNCOMPRESSED,
+	               stats[col_idx]->statistics->Copy());
+	// write the block to disk
+	block_manager.Write(*handle->node, block_id);
+
+	column_stats[col_idx]->Merge(*stats[col_idx]->statistics);
+	stats[col_idx] = make_unique<SegmentStatistics>(type, GetTypeIdSize(type.InternalType()));
+	handle.reset();
+	segments[col_idx] = nullptr;
+}
+
+void TableDataWriter::WriteOverflowStrings(idx_t col_idx) {
+	auto &type = table.columns[col_idx].type;
+	auto &segment = (StringSegment &)*segments[col_idx];
+	// re-append the strings to a segment that writes its overflow strings to disk
+	// as the strings are identical the new segment has exactly the same layout as the current segment
+	auto string_segment = make_unique<StringSegment>(db, 0);
+	string_segment->overflow_writer = make_unique<WriteOverflowStringsToDisk>(db);
+	SegmentStatistics string_stats(type, GetTypeIdSize(type.InternalType()));
+
+	ColumnScanState state;
+	Vector intermediate(type);
+	for (idx_t vector_index = 0; vector_index * STANDARD_VECTOR_SIZE < segment.tuple_count; vector_index++) {
+		auto count = segment.GetVectorCount(vector_index);
+		segment.Fetch(state, vector_index, intermediate);
+		if (string_segment->Append(string_stats, intermediate, 0, count) != count) {
+			throw InternalException("Failed to write overflow strings of string segment");
+		}
+	}
+	segments[col_idx] = move(string_segment);
+}
+
+void TableDataWriter::CompressSegment(SegmentTree &new_tree, idx_t col_idx, CompressionType compression) {
+	auto &type = table.columns[col_idx].type;
+	auto &segment = (NumericSegment &)*segments[col_idx];
+	if (compressed_segments[col_idx] && compressed_segments[col_idx]->function.type != compression) {
+		// the pending compressed segment uses a different compression: flush it
+		FlushCompressedSegment(new_tree, col_idx);
+	}
+
+	auto &buffer_manager = BufferManager::GetBufferManager(db);
+	auto handle = buffer_manager.Pin(segment.block);
+	bool merged_stats = false;
+	for (idx_t vector_index = 0; vector_index * STANDARD_VECTOR_SIZE < segment.tuple_count;) {
+		if (!compressed_segments[col_idx]) {
+			compressed_segments[col_idx] = make_unique<CompressedSegmentWriter>(
+			    db, type, CompressionFunction::GetCompressionFunction(compression, type.InternalType()));
+			merged_stats = false;
+		}
+		auto &writer = *compressed_segments[col_idx];
+		if (!merged_stats) {
+			// the statistics of the compressed segment contain the statistics of every segment that is written to it
+			writer.statistics->Merge(*stats[col_idx]->statistics);
+			merged_stats = true;
+		}
+		auto vector_data = handle->node->buffer + vector_index * segment.vector_size;
+		if (!writer.Append(vector_data, segment.GetVectorCount(vector_index))) {
+			// the compressed segment is full: flush it and retry with a new compressed segment
+			D_ASSERT(writer.vector_count > 0);
+			FlushCompressedSegment(new_tree, col_idx);
+			continue;
+		}
+		vector_index++;
+	}
+
+	column_stats[col_idx]->Merge(*stats[col_idx]->statistics);
+	stats[col_idx] = make_unique<SegmentStatistics>(type, GetTypeIdSize(type.InternalType()));
+	handle.reset();
+	segments[col_idx] = nullptr;
+}
+
+void TableDataWriter::CompressStringSegment(SegmentTree &new_tree, idx_t col_idx, CompressionType compression) {
+	auto &type = table.columns[col_idx].type;
+	auto &segment = (StringSegment &)*segments[col_idx];
+	if (compressed_string_segments[col_idx] && compressed_string_segments[col_idx]->function.type != compression) {
+		// the pending compressed segment uses a different compression: flush it
+		FlushCompressedSegment(new_tree, col_idx);
+	}
+
+	// the strings that are fetched from the segment point into the pinned buffer of the segment
+	ColumnScanState state;
+	Vector intermediate(type);
+	bool merged_stats = false;
+	for (idx_t vector_index = 0; vector_index * STANDARD_VECTOR_SIZE < segment.tuple_count;) {
+		if (!compressed_string_segments[col_idx]) {
+			// the dictionary or symbol table of a new compressed segment is built from the strings of this segment
+			auto sample = CompressedStringSegmentWriter::GetStrings(segment, state, intermediate);
+			compressed_string_segments[col_idx] = make_unique<CompressedStringSegmentWriter>(
+			    db, type, StringCompressionFunction::GetCompressionFunction(compression), sample);
+			merged_stats = false;
+		}
+		auto &writer = *compressed_string_segments[col_idx];
+		if (!merged_stats) {
+			writer.statistics->Merge(*stats[col_idx]->statistics);
+			// all strings are stored in the compressed segment itself
+			((StringStatistics &)*writer.statistics).has_overflow_strings = false;
+			merged_stats = true;
+		}
+		segment.Fetch(state, vector_index, intermediate);
+		if (!writer.Append(intermediate, segment.GetVectorCount(vector_index))) {
+			// the compressed segment is full: flush it and retry with a new compressed segment
+			D_ASSERT(writer.vector_count > 0);
+			FlushCompressedSegment(new_tree, col_idx);
+			continue;
+		}
+		vector_index++;
+	}
+
+	column_stats[col_idx]->Merge(*stats[col_idx]->statistics);
+	stats[col_idx] = make_unique<SegmentStatistics>(type, GetTypeIdSize(type.InternalType()));
+	segments[col_idx] = nullptr;
+}
+
+void TableDataWriter::FlushCompressedSegment(SegmentTree &new_tree, idx_t col_idx) {
+	auto &block_manager = BlockManager::GetBlockManager(db);
+	if (compressed_segments[col_idx]) {
+		auto &writer = *compressed_segments[col_idx];
+		auto block_id = block_manager.GetFreeBlockId();
+
+		AddDataPointer(new_tree, col_idx, block_id, writer.tuple_count, writer.function.type,
+		               writer.statistics->Copy());
+		writer.Flush(block_id);
+		compressed_segments[col_idx].reset();
+	}
+	if (compressed_string_segments[col_idx]) {
+		auto &writer = *compressed_string_segments[col_idx];
+		auto block_id = block_manager.GetFreeBlockId();
+
+		AddDataPointer(new_tree, col_idx, block_id, writer.tuple_count, writer.function.type,
+		               writer.statistics->Copy());
+		writer.Flush(block_id);
+		compressed_string_segments[col_idx].reset();
+	}
+}
+
+void TableDataWriter::AddDataPointer(SegmentTree &new_tree, idx_t col_idx, block_id_t block_id, idx_t tuple_count,
+                                     CompressionType compression, unique_ptr<BaseStatistics> statistics) {
 	// construct the data pointer
 	uint32_t offset_in_block = 0;
 
@@ -220,23 +388,16 @@ void TableDataWriter::FlushSegment(SegmentTree &new_tree, idx_t col_idx) {
 		data_pointer.row_start = last_pointer.row_start + last_pointer.tuple_count;
 	}
 	data_pointer.tuple_count = tuple_count;
-	data_pointer.statistics = stats[col_idx]->statistics->Copy();
+	data_pointer.compression = compression;
+	data_pointer.statistics = statistics->Copy();
 
 	// construct a persistent segment that points to this block, and append it to the new segment tree
-	auto persistent_segment = make_unique<PersistentSegment>(db, block_id, offset_in_block, table.columns[col_idx].type,
-	                                                         data_pointer.row_start, data_pointer.tuple_count,
-	                                                         stats[col_idx]->statistics->Copy());
+	auto persistent_segment =
+	    make_unique<PersistentSegment>(db, block_id, offset_in_block, table.columns[col_idx].type,
+	                                   data_pointer.row_start, data_pointer.tuple_count, compression, move(statistics));
 	new_tree.AppendSegment(move(persistent_segment));
 
 	data_pointers[col_idx].push_back(move(data_pointer));
-	// write the block to disk
-	block_manager.Write(*handle->node, block_id);
-
-	column_stats[col_idx]->Merge(*stats[col_idx]->statistics);
-	stats[col_idx] = make_unique<SegmentStatistics>(table.columns[col_idx].type,
-	                                                GetTypeIdSize(table.columns[col_idx].type.InternalType()));
-	handle.reset();
-	segments[col_idx] = nullptr;
 }
 
 void TableDataWriter::VerifyDataPointers() {
@@ -279,6 +440,7 @@ void TableDataWriter::WriteDataPointers() {
 			meta_writer.Write<idx_t>(data_pointer.tuple_count);
 			meta_writer.Write<block_id_t>(data_pointer.block_id);
 			meta_writer.Write<uint32_t>(data_pointer.offset);
+			meta_writer.Write<uint8_t>((uint8_t)data_pointer.compression);
 			data_pointer.statistics->Serialize(meta_writer);
 		}
 	}
@@ -28,13 +28,19 @@
 
 #include "duckdb/storage/checkpoint/table_data_writer.hpp"
 #include "duckdb/storage/checkpoint/table_data_reader.hpp"
+#include "duckdb/storage/table/persistent_table_data.hpp"
+#include "duckdb/execution/index/art/art.hpp"
 #include "duckdb/main/config.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
 
 namespace duckdb {
 
 CheckpointManager::CheckpointManager(DatabaseInstance &db) : db(db) {
 }
 
+CheckpointManager::~CheckpointManager() {
+}
+
 void CheckpointManager::CreateCheckpoint() {
 	auto &config = DBConfig::GetConfig(db);
 	auto &storage_manager = StorageManager::GetStorageManager(db);
@@ -58,7 +64,9 @@ void CheckpointManager::CreateCheckpoint() {
 	// we scan the set of committed schemas
 	auto &catalog = Catalog::GetCatalog(db);
 	catalog.schemas->Scan([&](CatalogEntry *entry) { schemas.push_back((SchemaCatalogEntry *)entry); });
-	// write the actual data into the database
+	// write the data of the tables in parallel
+	CheckpointTableData(schemas);
+	// write the meta data and the data pointers into the database
 	// write the amount of schemas
 	metadata_writer->Write<uint32_t>(schemas.size());
 	for (auto &schema : schemas) {
@@ -102,6 +110,81 @@ void CheckpointManager::CreateCheckpoint() {
 	}
 }
 
+struct CheckpointTaskState {
+	CheckpointTaskState() : finished_tasks(0) {
+	}
+
+	//! The amount of tasks that have finished
+	std::atomic<idx_t> finished_tasks;
+	//! Lock protecting the exceptions
+	mutex lock;
+	//! The exceptions that occurred while executing the tasks
+	vector<string> exceptions;
+};
+
+class CheckpointColumnTask : public Task {
+public:
+	CheckpointColumnTask(CheckpointTaskState &state, TableCatalogEntry &table, TableDataWriter &writer,
+	                     idx_t column_index)
+	    : state(state), table(table), writer(writer), column_index(column_index) {
+	}
+
+	void Execute() override {
+		try {
+			table.storage->Checkpoint(writer, column_index);
+		} catch (std::exception &ex) {
+			lock_guard<mutex> error_lock(state.lock);
+			state.exceptions.push_back(ex.what());
+		} catch (...) {
+			lock_guard<mutex> error_lock(state.lock);
+			state.exceptions.push_back("Unknown exception while checkpointing!");
+		}
+		state.finished_tasks++;
+	}
+
+private:
+	CheckpointTaskState &state;
+	TableCatalogEntry &table;
+	TableDataWriter &writer;
+	idx_t column_index;
+};
+
+void CheckpointManager::CheckpointTableData(vector<SchemaCatalogEntry *> &schemas) {
+	vector<TableCatalogEntry *> tables;
+	for (auto &schema : schemas) {
+		schema->Scan(CatalogType::TABLE_ENTRY, [&](CatalogEntry *entry) {
+			if (entry->type == CatalogType::TABLE_ENTRY) {
+				tables.push_back((TableCatalogEntry *)entry);
+			}
+		});
+	}
+	// every column has its own segments and writers: schedule one task per column
+	auto &scheduler = db.GetScheduler();
+	auto producer = scheduler.CreateProducer();
+	CheckpointTaskState state;
+	idx_t total_tasks = 0;
+	for (auto &table : tables) {
+		auto writer = make_unique<TableDataWriter>(db, *table, *tabledata_writer);
+		writer->InitializeColumns();
+		for (idx_t i = 0; i < table->columns.size(); i++) {
+			scheduler.ScheduleTask(*producer, make_unique<CheckpointColumnTask>(state, *table, *writer, i));
+			total_tasks++;
+		}
+		table_writers[table] = move(writer);
+	}
+	// execute tasks from this producer until all columns are written
+	while (state.finished_tasks < total_tasks) {
+		unique_ptr<Task> task;
+		while (scheduler.GetTaskFromProducer(*producer, task)) {
+			task->Execute();
+			task.reset();
+		}
+	}
+	if (!state.exceptions.empty()) {
+		throw Exception(state.exceptions[0]);
+	}
+}
+
 void CheckpointManager::LoadFromStorage() {
 	auto &block_manager = BlockManager::GetBlockManager(db);
 	block_id_t meta_block = block_manager.GetMetaBlock();
@@ -255,9 +338,33 @@ void CheckpointManager::WriteTable(TableCatalogEntry &table) {
 	metadata_writer->Write<block_id_t>(tabledata_writer->block->id);
 	//! and the offset to where the info starts
 	metadata_writer->Write<uint64_t>(tabledata_writer->offset);
-	// now we need to write the table data
-	TableDataWriter writer(db, table, *tabledata_writer);
-	writer.WriteTableData();
+	// the column data has already been written: write the data pointers of the table
+	auto entry = table_writers.find(&table);
+	D_ASSERT(entry != table_writers.end());
+	entry->second->WriteTableData();
+	// finally write the indexes of the UNIQUE and PRIMARY KEY constraints
+	// the nodes are written to the table data, the pointers to the root nodes are written to the meta data
+	auto &indexes = table.storage->info->indexes;
+	idx_t index_count = 0;
+	for (auto &constraint : table.bound_constraints) {
+		if (constraint->type == ConstraintType::UNIQUE) {
+			index_count++;
+		}
+	}
+	D_ASSERT(index_count <= indexes.size());
+	metadata_writer->Write<uint32_t>(index_count);
+	for (idx_t i = 0; i < index_count; i++) {
+		D_ASSERT(indexes[i]->type == IndexType::ART);
+		auto &art = (ART &)*indexes[i];
+		vector<block_id_t> blocks;
+		auto root = art.Serialize(*tabledata_writer, blocks);
+		metadata_writer->Write<block_id_t>(root.block_id);
+		metadata_writer->Write<uint32_t>(root.offset);
+		metadata_writer->Write<uint32_t>(blocks.size());
+		for (auto &block_id : blocks) {
+			metadata_writer->Write<block_id_t>(block_id);
+		}
+	}
 }
 
 void CheckpointManager::ReadTable(ClientContext &context, MetaBlockReader &reader) {
@@ -275,6 +382,23 @@ void CheckpointManager::ReadTable(ClientContext &context, MetaBlockReader &reade
 	TableDataReader data_reader(db, table_data_reader, *bound_info);
 	data_reader.ReadTableData();
 
+	// read the pointers to the indexes of the table, the nodes of the indexes are loaded lazily
+	auto &block_manager = BlockManager::GetBlockManager(db);
+	auto index_count = reader.Read<uint32_t>();
+	for (idx_t i = 0; i < index_count; i++) {
+		PersistentIndexData index;
+		index.root.block_id = reader.Read<block_id_t>();
+		index.root.offset = reader.Read<uint32_t>();
+		auto block_count = reader.Read<uint32_t>();
+		for (idx_t j = 0; j < block_count; j++) {
+			auto index_block = reader.Read<block_id_t>();
+			// the index is rewritten at the next checkpoint: its blocks can be reclaimed afterwards
+			block_manager.MarkBlockAsModified(index_block);
+			index.blocks.push_back(index_block);
+		}
+		bound_info->data->indexes.push_back(move(index));
+	}
+
 	// finally create the table in the catalog
 	auto &catalog = Catalog::GetCatalog(db);
 	catalog.CreateTable(context, bound_info.get());
@@ -5,6 +5,7 @@
 #include "duckdb/storage/storage_manager.hpp"
 #include "duckdb/storage/data_pointer.hpp"
 #include "duckdb/storage/checkpoint/table_data_writer.hpp"
+#include "duckdb/main/config.hpp"
 
 namespace duckdb {
 
@@ -24,6 +25,8 @@ void ColumnData::InitializeScan(ColumnScanState &state) {
 	state.current = (ColumnSegment *)data.GetRootSegment();
 	state.vector_index = 0;
 	state.initialized = false;
+	state.read_ahead_depth = DBConfig::GetConfig(db).read_ahead_depth;
+	state.read_ahead_row = 0;
 }
 
 void ColumnData::InitializeScanWithOffset(ColumnScanState &state, idx_t vector_idx) {
@@ -33,10 +36,28 @@ void ColumnData::InitializeScanWithOffset(ColumnScanState &state, idx_t vector_i
 	state.initialized = false;
 }
 
+void ColumnData::InitializeSegmentScan(ColumnScanState &state) {
+	if (state.read_ahead_depth > 0) {
+		// load the blocks of the upcoming segments while this segment is being scanned
+		ReadAhead((ColumnSegment *)state.current->next.get(), state.read_ahead_depth, state.read_ahead_row);
+	}
+	state.current->InitializeScan(state);
+	state.initialized = true;
+}
+
+void ColumnData::ReadAhead(ColumnSegment *segment, idx_t depth, idx_t &read_ahead_row) {
+	for (idx_t i = 0; i < depth && segment; i++) {
+		if (segment->start >= read_ahead_row && segment->segment_type == ColumnSegmentType::PERSISTENT) {
+			((PersistentSegment &)*segment).ReadAhead();
+		}
+		read_ahead_row = MaxValue<idx_t>(read_ahead_row, segment->start + segment->count);
+		segment = (ColumnSegment *)segment->next.get();
+	}
+}
+
 void ColumnData::Scan(Transaction &transaction, ColumnScanState &state, Vector &result) {
 	if (!state.initialized) {
-		state.current->InitializeScan(state);
-		state.initialized = true;
+		InitializeSegmentScan(state);
 	}
 	// perform a scan of this segment
 	state.current->Scan(transaction, state, state.vector_index, result);
@@ -47,8 +68,7 @@ void ColumnData::Scan(Transaction &transaction, ColumnScanState &state, Vector &
 void ColumnData::FilterScan(Transaction &transaction, ColumnScanState &state, Vector &result, SelectionVector &sel,
                             idx_t &approved_tuple_count) {
 	if (!state.initialized) {
-		state.current->InitializeScan(state);
-		state.initialized = true;
+		InitializeSegmentScan(state);
 	}
 	// perform a scan of this segment
 	state.current->FilterScan(transaction, state, result, sel, approved_tuple_count);
@@ -59,8 +79,7 @@ void ColumnData::FilterScan(Transaction &transaction, ColumnScanState &state, Ve
 void ColumnData::Select(Transaction &transaction, ColumnScanState &state, Vector &result, SelectionVector &sel,
                         idx_t &approved_tuple_count, vector<TableFilter> &tableFilter) {
 	if (!state.initialized) {
-		state.current->InitializeScan(state);
-		state.initialized = true;
+		InitializeSegmentScan(state);
 	}
 	// perform a scan of this segment
 	state.current->Select(transaction, state, result, sel, approved_tuple_count, tableFilter);
@@ -107,7 +126,14 @@ void ColumnData::InitializeAppend(ColumnAppendState &state) {
 		AppendTransientSegment(persistent_rows);
 	}
 	auto segment = (ColumnSegment *)data.GetLastSegment();
-	if (segment->segment_type == ColumnSegmentType::PERSISTENT) {
+	if (segment->segment_type == ColumnSegmentType::PERSISTENT &&
+	    ((PersistentSegment &)*segment).compression != CompressionType::COMPRESSION_UNCOMPRESSED &&
+	    segment->count % STANDARD_VECTOR_SIZE == 0) {
+		// compressed segment that ends on a vector boundary: instead of decompressing the segment, leave it untouched
+		// and start a new transient segment after it
+		AppendTransientSegment(segment->start + segment->count);
+		state.current = (TransientSegment *)data.GetLastSegment();
+	} else if (segment->segment_type == ColumnSegmentType::PERSISTENT) {
 		// cannot append to persistent segment, convert the last segment into a transient segment
 		auto transient = make_unique<TransientSegment>((PersistentSegment &)*segment);
 		state.current = (TransientSegment *)transient.get();
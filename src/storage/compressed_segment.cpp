@@ -0,0 +1,255 @@
+#include "duckdb/storage/compressed_segment.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+#include "duckdb/storage/statistics/base_statistics.hpp"
+#include "duckdb/common/types/vector.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/main/config.hpp"
+#include "duckdb/planner/table_filter.hpp"
+
+namespace duckdb {
+
+CompressedSegment::CompressedSegment(DatabaseInstance &db, PhysicalType type, idx_t row_start, block_id_t block_id,
+                                     CompressionType compression, idx_t tuple_count)
+    : NumericSegment(db, type, row_start, block_id),
+      function(CompressionFunction::GetCompressionFunction(compression, type)) {
+	D_ASSERT(block_id != INVALID_BLOCK);
+	this->tuple_count = tuple_count;
+	this->max_vector_count = tuple_count / STANDARD_VECTOR_SIZE + (tuple_count % STANDARD_VECTOR_SIZE == 0 ? 0 : 1);
+	D_ASSERT(max_vector_count <= MAX_VECTOR_COUNT);
+}
+
+bool CompressedSegment::IsCompressed(BufferHandle &handle) {
+	// the compressed data lives in the on-disk block; once the segment is converted to a temporary in-memory buffer
+	// the data has been decompressed
+	return handle.handle->BlockId() < MAXIMUM_BLOCK;
+}
+
+void CompressedSegment::DecompressVector(data_ptr_t block_data, idx_t vector_index, nullmask_t &nullmask,
+                                         data_ptr_t target) {
+	D_ASSERT(vector_index < max_vector_count);
+	auto vector_data = block_data + Load<uint32_t>(block_data + vector_index * sizeof(uint32_t));
+	auto has_null = Load<uint8_t>(vector_data);
+	vector_data += sizeof(uint8_t);
+	if (has_null) {
+		memcpy(&nullmask, vector_data, sizeof(nullmask_t));
+		vector_data += sizeof(nullmask_t);
+	} else {
+		nullmask.reset();
+	}
+	function.decompress(vector_data, GetVectorCount(vector_index), target);
+}
+
+//===--------------------------------------------------------------------===//
+// Scan
+//===--------------------------------------------------------------------===//
+void CompressedSegment::FetchBaseData(ColumnScanState &state, idx_t vector_index, Vector &result) {
+	if (!IsCompressed(*state.primary_handle)) {
+		NumericSegment::FetchBaseData(state, vector_index, result);
+		return;
+	}
+	D_ASSERT(vector_index < max_vector_count);
+	D_ASSERT(vector_index * STANDARD_VECTOR_SIZE <= tuple_count);
+
+	result.vector_type = VectorType::FLAT_VECTOR;
+	DecompressVector(state.primary_handle->node->buffer, vector_index, FlatVector::Nullmask(result),
+	                 FlatVector::GetData(result));
+}
+
+void CompressedSegment::FilterFetchBaseData(ColumnScanState &state, Vector &result, SelectionVector &sel,
+                                            idx_t &approved_tuple_count) {
+	if (!IsCompressed(*state.primary_handle)) {
+		NumericSegment::FilterFetchBaseData(state, result, sel, approved_tuple_count);
+		return;
+	}
+	// decompress the full vector and slice the result with the selection vector
+	FetchBaseData(state, state.vector_index, result);
+	result.Slice(sel, approved_tuple_count);
+}
+
+void CompressedSegment::Select(ColumnScanState &state, Vector &result, SelectionVector &sel,
+                               idx_t &approved_tuple_count, vector<TableFilter> &tableFilter) {
+	auto &buffer_manager = BufferManager::GetBufferManager(db);
+	auto handle = buffer_manager.Pin(block);
+	if (!IsCompressed(*handle)) {
+		handle.reset();
+		NumericSegment::Select(state, result, sel, approved_tuple_count, tableFilter);
+		return;
+	}
+	// decompress the vector and then execute the filters on the decompressed data
+	result.vector_type = VectorType::FLAT_VECTOR;
+	auto &nullmask = FlatVector::Nullmask(result);
+	DecompressVector(handle->node->buffer, state.vector_index, nullmask, FlatVector::GetData(result));
+	for (auto &filter : tableFilter) {
+		filterSelection(sel, result, filter, approved_tuple_count, nullmask);
+	}
+}
+
+//===--------------------------------------------------------------------===//
+// Fetch
+//===--------------------------------------------------------------------===//
+void CompressedSegment::FetchRow(ColumnFetchState &state, Transaction &transaction, row_t row_id, Vector &result,
+                                 idx_t result_idx) {
+	{
+		auto read_lock = lock.GetSharedLock();
+		auto &buffer_manager = BufferManager::GetBufferManager(db);
+		auto handle = buffer_manager.Pin(block);
+		if (IsCompressed(*handle)) {
+			// the segment has not been modified: there are no versions, decompress the value directly
+			idx_t vector_index = row_id / STANDARD_VECTOR_SIZE;
+			idx_t id_in_vector = row_id - vector_index * STANDARD_VECTOR_SIZE;
+			D_ASSERT(vector_index < max_vector_count);
+
+			auto data = handle->node->buffer;
+			auto vector_data = data + Load<uint32_t>(data + vector_index * sizeof(uint32_t));
+			auto has_null = Load<uint8_t>(vector_data);
+			vector_data += sizeof(uint8_t);
+			bool is_null = false;
+			if (has_null) {
+				nullmask_t nullmask;
+				memcpy(&nullmask, vector_data, sizeof(nullmask_t));
+				is_null = nullmask[id_in_vector];
+				vector_data += sizeof(nullmask_t);
+			}
+			FlatVector::SetNull(result, result_idx, is_null);
+			function.fetch_row(vector_data, GetVectorCount(vector_index), id_in_vector,
+			                   FlatVector::GetData(result) + result_idx * type_size);
+			return;
+		}
+	}
+	NumericSegment::FetchRow(state, transaction, row_id, result, result_idx);
+}
+
+//===--------------------------------------------------------------------===//
+// ToTemporary
+//===--------------------------------------------------------------------===//
+void CompressedSegment::ToTemporary() {
+	auto write_lock = lock.GetExclusiveLock();
+	if (block->BlockId() >= MAXIMUM_BLOCK) {
+		// conversion has already been performed by a different thread
+		return;
+	}
+	auto &block_manager = BlockManager::GetBlockManager(db);
+	block_manager.MarkBlockAsModified(block->BlockId());
+
+	// pin the compressed block
+	auto &buffer_manager = BufferManager::GetBufferManager(db);
+	auto current = buffer_manager.Pin(block);
+
+	// allocate an in-memory buffer that fits all vectors of this segment in uncompressed form
+	auto alloc_size =
+	    MaxValue<idx_t>(Storage::BLOCK_ALLOC_SIZE, max_vector_count * vector_size + Storage::BLOCK_HEADER_SIZE);
+	auto new_block = buffer_manager.RegisterMemory(alloc_size, false);
+	auto handle = buffer_manager.Pin(new_block);
+	// now decompress the vectors and switch to using the new block
+	for (idx_t vector_index = 0; vector_index < max_vector_count; vector_index++) {
+		auto target = handle->node->buffer + vector_index * vector_size;
+		DecompressVector(current->node->buffer, vector_index, *((nullmask_t *)target), target + sizeof(nullmask_t));
+	}
+	this->block = move(new_block);
+}
+
+//===--------------------------------------------------------------------===//
+// Compressed Segment Writer
+//===--------------------------------------------------------------------===//
+static idx_t GetVectorHeaderSize(nullmask_t &nullmask) {
+	return sizeof(uint8_t) + (nullmask.any() ? sizeof(nullmask_t) : 0);
+}
+
+CompressedSegmentWriter::CompressedSegmentWriter(DatabaseInstance &db, LogicalType type, CompressionFunction function)
+    : db(db), function(move(function)), vector_count(0), tuple_count(0) {
+	statistics = BaseStatistics::CreateEmpty(type);
+
+	auto &buffer_manager = BufferManager::GetBufferManager(db);
+	handle = buffer_manager.Allocate(Storage::BLOCK_ALLOC_SIZE);
+	memset(handle->node->buffer, 0, Storage::BLOCK_SIZE);
+	offset = CompressedSegment::HEADER_SIZE;
+}
+
+bool CompressedSegmentWriter::Append(data_ptr_t vector_data, idx_t count) {
+	if (vector_count >= CompressedSegment::MAX_VECTOR_COUNT) {
+		return false;
+	}
+	auto &nullmask = *((nullmask_t *)vector_data);
+	auto source = vector_data + sizeof(nullmask_t);
+	auto compressed_size = function.analyze(source, nullmask, count);
+	D_ASSERT(compressed_size != INVALID_INDEX);
+	if (offset + GetVectorHeaderSize(nullmask) + compressed_size > Storage::BLOCK_SIZE) {
+		// the vector does not fit in this block anymore
+		return false;
+	}
+	auto data = handle->node->buffer;
+	// write the offset of the vector into the header
+	Store<uint32_t>(offset, data + vector_count * sizeof(uint32_t));
+	// write the nullmask (if any)
+	bool has_null = nullmask.any();
+	Store<uint8_t>(has_null, data + offset);
+	offset += sizeof(uint8_t);
+	if (has_null) {
+		memcpy(data + offset, &nullmask, sizeof(nullmask_t));
+		offset += sizeof(nullmask_t);
+	}
+	// finally compress the data
+	auto written = function.compress(source, nullmask, count, data + offset);
+	D_ASSERT(written == compressed_size);
+	offset += written;
+
+	vector_count++;
+	tuple_count += count;
+	return true;
+}
+
+void CompressedSegmentWriter::Flush(block_id_t block_id) {
+	D_ASSERT(vector_count > 0);
+	auto &block_manager = BlockManager::GetBlockManager(db);
+	block_manager.Write(*handle->node, block_id);
+	handle.reset();
+}
+
+CompressionType CompressedSegmentWriter::ChooseCompression(DatabaseInstance &db, NumericSegment &segment,
+                                                           SegmentStatistics &stats) {
+	auto forced_compression = DBConfig::GetConfig(db).force_compression;
+	if (forced_compression == CompressionType::COMPRESSION_UNCOMPRESSED ||
+	    !CompressionFunction::TypeIsSupported(segment.type)) {
+		return CompressionType::COMPRESSION_UNCOMPRESSED;
+	}
+	auto &buffer_manager = BufferManager::GetBufferManager(db);
+	auto handle = buffer_manager.Pin(segment.block);
+
+	idx_t vector_count = segment.tuple_count / STANDARD_VECTOR_SIZE +
+	                     (segment.tuple_count % STANDARD_VECTOR_SIZE == 0 ? 0 : 1);
+	// compression has to beat the size of the uncompressed segment
+	idx_t best_size = vector_count * segment.vector_size;
+	auto best_compression = CompressionType::COMPRESSION_UNCOMPRESSED;
+	for (auto &function : CompressionFunction::GetCompressionFunctions(segment.type)) {
+		if (forced_compression != CompressionType::COMPRESSION_AUTO && function.type != forced_compression) {
+			continue;
+		}
+		// use the statistics of the segment to prune compression functions that are not applicable
+		if (!function.applicable(*stats.statistics)) {
+			continue;
+		}
+		// analyze the vectors to figure out the compressed size
+		idx_t compressed_size = 0;
+		for (idx_t vector_index = 0; vector_index < vector_count; vector_index++) {
+			auto vector_data = handle->node->buffer + vector_index * segment.vector_size;
+			auto &nullmask = *((nullmask_t *)vector_data);
+			auto size = function.analyze(vector_data + sizeof(nullmask_t), nullmask,
+			                             segment.GetVectorCount(vector_index));
+			if (size == INVALID_INDEX) {
+				compressed_size = INVALID_INDEX;
+				break;
+			}
+			compressed_size += GetVectorHeaderSize(nullmask) + size;
+		}
+		if (compressed_size == INVALID_INDEX) {
+			continue;
+		}
+		if (compressed_size < best_size || function.type == forced_compression) {
+			best_size = compressed_size;
+			best_compression = function.type;
+		}
+	}
+	return best_compression;
+}
+
+} // namespace duckdb
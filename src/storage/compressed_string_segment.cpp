@@ -0,0 +1,430 @@
+#include "duckdb/storage/compressed_string_segment.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
+#include "duckdb/storage/statistics/string_statistics.hpp"
+#include "duckdb/common/types/vector.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/main/config.hpp"
+#include "duckdb/planner/table_filter.hpp"
+
+namespace duckdb {
+
+CompressedStringSegment::CompressedStringSegment(DatabaseInstance &db, idx_t row_start, block_id_t block_id,
+                                                 CompressionType compression, idx_t tuple_count)
+    : StringSegment(db, row_start, block_id), function(StringCompressionFunction::GetCompressionFunction(compression)) {
+	D_ASSERT(block_id != INVALID_BLOCK);
+	this->tuple_count = tuple_count;
+	this->max_vector_count = tuple_count / STANDARD_VECTOR_SIZE + (tuple_count % STANDARD_VECTOR_SIZE == 0 ? 0 : 1);
+	D_ASSERT(max_vector_count <= MAX_VECTOR_COUNT);
+}
+
+bool CompressedStringSegment::IsCompressed(BufferHandle &handle) {
+	// the compressed data lives in the on-disk block; once the segment is converted to a temporary in-memory buffer
+	// the data has been decompressed
+	return handle.handle->BlockId() < MAXIMUM_BLOCK;
+}
+
+void CompressedStringSegment::DecompressVector(data_ptr_t block_data, idx_t vector_index, idx_t count,
+                                               Vector &result) {
+	D_ASSERT(vector_index < max_vector_count);
+	auto header = block_data + Load<uint32_t>(block_data + HEADER_OFFSET_POSITION);
+	auto vector_data = block_data + Load<uint32_t>(block_data + vector_index * sizeof(uint32_t));
+	auto has_null = Load<uint8_t>(vector_data);
+	vector_data += sizeof(uint8_t);
+
+	if (result.vector_type != VectorType::FLAT_VECTOR) {
+		// the vector might reference a shared dictionary: give it its own buffer before writing into it
+		result.Initialize();
+	}
+	auto &nullmask = FlatVector::Nullmask(result);
+	if (has_null) {
+		memcpy(&nullmask, vector_data, sizeof(nullmask_t));
+		vector_data += sizeof(nullmask_t);
+	} else {
+		nullmask.reset();
+	}
+	function.decompress(header, vector_data, nullmask, count, result);
+}
+
+//===--------------------------------------------------------------------===//
+// Scan
+//===--------------------------------------------------------------------===//
+void CompressedStringSegment::InitializeScan(ColumnScanState &state) {
+	StringSegment::InitializeScan(state);
+	state.dictionary.reset();
+	state.dictionary_filter.reset();
+}
+
+BufferHandle &CompressedStringSegment::GetPrimaryHandle(ColumnScanState &state) {
+	if (state.primary_handle->handle.get() != block.get()) {
+		// the segment was decompressed after the scan was initialized: switch to the decompressed buffer, as the
+		// string locations of any updates refer to the decompressed buffer
+		auto &buffer_manager = BufferManager::GetBufferManager(db);
+		state.primary_handle = buffer_manager.Pin(block);
+	}
+	return *state.primary_handle;
+}
+
+void CompressedStringSegment::FetchBaseData(ColumnScanState &state, idx_t vector_index, Vector &result) {
+	auto &handle = GetPrimaryHandle(state);
+	if (!IsCompressed(handle)) {
+		StringSegment::FetchBaseData(state, vector_index, result);
+		return;
+	}
+	D_ASSERT(vector_index < max_vector_count);
+	D_ASSERT(vector_index * STANDARD_VECTOR_SIZE <= tuple_count);
+	DecompressVector(handle.node->buffer, vector_index, GetVectorCount(vector_index), result);
+}
+
+bool CompressedStringSegment::ScanDictionaryVector(ColumnScanState &state, data_ptr_t block_data, idx_t vector_index,
+                                                   idx_t count, Vector &result) {
+	D_ASSERT(vector_index < max_vector_count);
+	if (!function.dictionary_size) {
+		return false;
+	}
+	auto header = block_data + Load<uint32_t>(block_data + HEADER_OFFSET_POSITION);
+	auto entry_count = function.dictionary_size(header);
+	// the dictionary holds an additional entry that is referenced by null values
+	if (entry_count + 1 > STANDARD_VECTOR_SIZE) {
+		return false;
+	}
+	if (!state.dictionary) {
+		// decode the dictionary once, it is shared by all vectors of the segment
+		auto dictionary = make_buffer<VectorChildBuffer>();
+		auto &entries = dictionary->data;
+		entries.Initialize(result.type);
+		function.decompress_dictionary(header, entries);
+		FlatVector::GetData<string_t>(entries)[entry_count] = string_t(nullptr, 0);
+		FlatVector::SetNull(entries, entry_count, true);
+		// the strings point into the block: keep it pinned for as long as the dictionary is in use
+		auto &buffer_manager = BufferManager::GetBufferManager(db);
+		StringVector::AddHandle(entries, buffer_manager.Pin(block));
+		dictionary->dictionary_size = entry_count + 1;
+		state.dictionary = move(dictionary);
+	}
+	auto vector_data = block_data + Load<uint32_t>(block_data + vector_index * sizeof(uint32_t));
+	auto has_null = Load<uint8_t>(vector_data);
+	vector_data += sizeof(uint8_t);
+	nullmask_t nullmask;
+	if (has_null) {
+		memcpy(&nullmask, vector_data, sizeof(nullmask_t));
+		vector_data += sizeof(nullmask_t);
+	}
+	SelectionVector sel(STANDARD_VECTOR_SIZE);
+	function.decompress_indices(vector_data, count, sel);
+	if (has_null) {
+		for (idx_t i = 0; i < count; i++) {
+			if (nullmask[i]) {
+				sel.set_index(i, entry_count);
+			}
+		}
+	}
+	result.Dictionary(state.dictionary, sel);
+	return true;
+}
+
+void CompressedStringSegment::ScanBaseData(ColumnScanState &state, idx_t vector_index, Vector &result) {
+	auto &handle = GetPrimaryHandle(state);
+	if (IsCompressed(handle) &&
+	    ScanDictionaryVector(state, handle.node->buffer, vector_index, GetVectorCount(vector_index), result)) {
+		return;
+	}
+	FetchBaseData(state, vector_index, result);
+}
+
+void CompressedStringSegment::FilterFetchBaseData(ColumnScanState &state, Vector &result, SelectionVector &sel,
+                                                  idx_t &approved_tuple_count) {
+	if (!IsCompressed(GetPrimaryHandle(state))) {
+		StringSegment::FilterFetchBaseData(state, result, sel, approved_tuple_count);
+		return;
+	}
+	// fetch the full vector and slice the result with the selection vector
+	ScanBaseData(state, state.vector_index, result);
+	result.Slice(sel, approved_tuple_count);
+}
+
+void CompressedStringSegment::Select(ColumnScanState &state, Vector &result, SelectionVector &sel,
+                                     idx_t &approved_tuple_count, vector<TableFilter> &tableFilter) {
+	auto &handle = GetPrimaryHandle(state);
+	if (!IsCompressed(handle)) {
+		StringSegment::Select(state, result, sel, approved_tuple_count, tableFilter);
+		return;
+	}
+	auto vector_count = GetVectorCount(state.vector_index);
+	if (ScanDictionaryVector(state, handle.node->buffer, state.vector_index, vector_count, result)) {
+		// execute the filters once for every entry of the dictionary
+		auto &entries = DictionaryVector::Child(result);
+		if (!state.dictionary_filter) {
+			auto entry_count = DictionaryVector::DictionarySize(result);
+			SelectionVector entry_sel;
+			entry_sel.Initialize(FlatVector::IncrementalSelectionVector);
+			idx_t match_count = entry_count;
+			for (auto &filter : tableFilter) {
+				filterSelection(entry_sel, entries, filter, match_count, FlatVector::Nullmask(entries));
+			}
+			state.dictionary_filter = unique_ptr<bool[]>(new bool[entry_count]);
+			memset(state.dictionary_filter.get(), 0, sizeof(bool) * entry_count);
+			for (idx_t i = 0; i < match_count; i++) {
+				state.dictionary_filter[entry_sel.get_index(i)] = true;
+			}
+		}
+		// now select the rows that reference a matching entry
+		auto &dictionary_sel = DictionaryVector::SelVector(result);
+		SelectionVector new_sel(approved_tuple_count);
+		idx_t result_count = 0;
+		for (idx_t i = 0; i < approved_tuple_count; i++) {
+			auto idx = sel.get_index(i);
+			if (state.dictionary_filter[dictionary_sel.get_index(idx)]) {
+				new_sel.set_index(result_count++, idx);
+			}
+		}
+		sel.Initialize(new_sel);
+		approved_tuple_count = result_count;
+		return;
+	}
+	// decompress the vector and then execute the filters on the decompressed strings
+	DecompressVector(handle.node->buffer, state.vector_index, vector_count, result);
+	auto &nullmask = FlatVector::Nullmask(result);
+	for (auto &filter : tableFilter) {
+		filterSelection(sel, result, filter, approved_tuple_count, nullmask);
+	}
+}
+
+//===--------------------------------------------------------------------===//
+// Fetch
+//===--------------------------------------------------------------------===//
+void CompressedStringSegment::FetchRow(ColumnFetchState &state, Transaction &transaction, row_t row_id,
+                                       Vector &result, idx_t result_idx) {
+	{
+		auto read_lock = lock.GetSharedLock();
+		auto primary_id = block->BlockId();
+		if (primary_id < MAXIMUM_BLOCK) {
+			// the segment has not been modified: there are no versions, decompress the string directly
+			// the handle is kept pinned in the fetch state, as the string might point into the block
+			data_ptr_t data;
+			auto entry = state.handles.find(primary_id);
+			if (entry == state.handles.end()) {
+				auto &buffer_manager = BufferManager::GetBufferManager(db);
+				auto handle = buffer_manager.Pin(block);
+				data = handle->node->buffer;
+				state.handles[primary_id] = move(handle);
+			} else {
+				data = entry->second->node->buffer;
+			}
+			idx_t vector_index = row_id / STANDARD_VECTOR_SIZE;
+			idx_t id_in_vector = row_id - vector_index * STANDARD_VECTOR_SIZE;
+			D_ASSERT(vector_index < max_vector_count);
+
+			auto header = data + Load<uint32_t>(data + HEADER_OFFSET_POSITION);
+			auto vector_data = data + Load<uint32_t>(data + vector_index * sizeof(uint32_t));
+			auto has_null = Load<uint8_t>(vector_data);
+			vector_data += sizeof(uint8_t);
+			bool is_null = false;
+			if (has_null) {
+				nullmask_t nullmask;
+				memcpy(&nullmask, vector_data, sizeof(nullmask_t));
+				is_null = nullmask[id_in_vector];
+				vector_data += sizeof(nullmask_t);
+			}
+			FlatVector::SetNull(result, result_idx, is_null);
+			if (!is_null) {
+				function.fetch_row(header, vector_data, GetVectorCount(vector_index), id_in_vector, result,
+				                   result_idx);
+			}
+			return;
+		}
+	}
+	StringSegment::FetchRow(state, transaction, row_id, result, result_idx);
+}
+
+//===--------------------------------------------------------------------===//
+// ToTemporary
+//===--------------------------------------------------------------------===//
+void CompressedStringSegment::ToTemporary() {
+	auto write_lock = lock.GetExclusiveLock();
+	if (block->BlockId() >= MAXIMUM_BLOCK) {
+		// conversion has already been performed by a different thread
+		return;
+	}
+	auto &block_manager = BlockManager::GetBlockManager(db);
+	block_manager.MarkBlockAsModified(block->BlockId());
+
+	// pin the compressed block
+	auto &buffer_manager = BufferManager::GetBufferManager(db);
+	auto current = buffer_manager.Pin(block);
+	auto total_string_size = Load<uint32_t>(current->node->buffer + STRING_SIZE_POSITION);
+
+	// allocate an in-memory buffer that fits all strings of this segment in the regular string segment layout
+	// we reserve room for a big string marker for every string of a vector, so no strings are written to overflow
+	// blocks while the strings are appended
+	idx_t required_size = max_vector_count * vector_size + total_string_size + tuple_count * sizeof(uint16_t) +
+	                      STANDARD_VECTOR_SIZE * BIG_STRING_MARKER_SIZE + sizeof(idx_t);
+	auto alloc_size = MaxValue<idx_t>(Storage::BLOCK_ALLOC_SIZE, required_size + Storage::BLOCK_HEADER_SIZE);
+	auto new_block = buffer_manager.RegisterMemory(alloc_size, false);
+	auto handle = buffer_manager.Pin(new_block);
+	this->segment_size = alloc_size - Storage::BLOCK_HEADER_SIZE;
+	SetDictionaryOffset(*handle, sizeof(idx_t));
+
+	// now decompress the vectors and append them to the new buffer
+	idx_t vector_count = max_vector_count;
+	idx_t total_count = tuple_count;
+	max_vector_count = 0;
+	tuple_count = 0;
+	SegmentStatistics stats(LogicalType::VARCHAR, GetTypeIdSize(PhysicalType::VARCHAR));
+	Vector intermediate(LogicalType::VARCHAR);
+	for (idx_t vector_index = 0; vector_index < vector_count; vector_index++) {
+		idx_t count = MinValue<idx_t>(STANDARD_VECTOR_SIZE, total_count - vector_index * STANDARD_VECTOR_SIZE);
+		ExpandStringSegment(handle->node->buffer);
+		DecompressVector(current->node->buffer, vector_index, count, intermediate);
+		AppendData(*handle, stats, handle->node->buffer + vector_index * vector_size,
+		           handle->node->buffer + segment_size, 0, intermediate, 0, count);
+		tuple_count += count;
+	}
+	D_ASSERT(!((StringStatistics &)*stats.statistics).has_overflow_strings);
+	this->block = move(new_block);
+}
+
+//===--------------------------------------------------------------------===//
+// Compressed String Segment Writer
+//===--------------------------------------------------------------------===//
+static idx_t GetStringVectorHeaderSize(nullmask_t &nullmask) {
+	return sizeof(uint8_t) + (nullmask.any() ? sizeof(nullmask_t) : 0);
+}
+
+CompressedStringSegmentWriter::CompressedStringSegmentWriter(DatabaseInstance &db, LogicalType type,
+                                                             StringCompressionFunction function,
+                                                             vector<string_t> &sample)
+    : db(db), function(move(function)), vector_count(0), tuple_count(0), total_string_size(0) {
+	statistics = BaseStatistics::CreateEmpty(type);
+	state = this->function.init(sample);
+
+	auto &buffer_manager = BufferManager::GetBufferManager(db);
+	handle = buffer_manager.Allocate(Storage::BLOCK_ALLOC_SIZE);
+	memset(handle->node->buffer, 0, Storage::BLOCK_SIZE);
+	offset = CompressedStringSegment::HEADER_SIZE;
+}
+
+bool CompressedStringSegmentWriter::Append(Vector &strings, idx_t count) {
+	D_ASSERT(strings.vector_type == VectorType::FLAT_VECTOR);
+	if (vector_count >= CompressedStringSegment::MAX_VECTOR_COUNT || tuple_count % STANDARD_VECTOR_SIZE != 0) {
+		return false;
+	}
+	auto &nullmask = FlatVector::Nullmask(strings);
+	auto source = FlatVector::GetData<string_t>(strings);
+	auto vector_header_size = GetStringVectorHeaderSize(nullmask);
+	if (offset + vector_header_size >= Storage::BLOCK_SIZE) {
+		return false;
+	}
+	auto data = handle->node->buffer;
+	// first compress the data, this fails if the vector does not fit in the block anymore
+	auto compressed_size = state->Compress(source, nullmask, count, data + offset + vector_header_size,
+	                                       Storage::BLOCK_SIZE - offset - vector_header_size);
+	if (compressed_size == INVALID_INDEX) {
+		return false;
+	}
+	// write the offset of the vector into the header
+	Store<uint32_t>(offset, data + vector_count * sizeof(uint32_t));
+	// write the nullmask (if any)
+	bool has_null = nullmask.any();
+	Store<uint8_t>(has_null, data + offset);
+	offset += sizeof(uint8_t);
+	if (has_null) {
+		memcpy(data + offset, &nullmask, sizeof(nullmask_t));
+		offset += sizeof(nullmask_t);
+	}
+	offset += compressed_size;
+	D_ASSERT(offset + state->GetHeaderSize() <= Storage::BLOCK_SIZE);
+
+	for (idx_t i = 0; i < count; i++) {
+		if (!nullmask[i]) {
+			total_string_size += source[i].GetSize();
+		}
+	}
+	vector_count++;
+	tuple_count += count;
+	return true;
+}
+
+idx_t CompressedStringSegmentWriter::GetCompressedSize() {
+	return offset + state->GetHeaderSize();
+}
+
+void CompressedStringSegmentWriter::Flush(block_id_t block_id) {
+	D_ASSERT(vector_count > 0);
+	auto data = handle->node->buffer;
+	// write the header of the compression function after the vectors
+	Store<uint32_t>(offset, data + CompressedStringSegment::HEADER_OFFSET_POSITION);
+	Store<uint32_t>(total_string_size, data + CompressedStringSegment::STRING_SIZE_POSITION);
+	state->WriteHeader(data + offset);
+
+	auto &block_manager = BlockManager::GetBlockManager(db);
+	block_manager.Write(*handle->node, block_id);
+	handle.reset();
+}
+
+vector<string_t> CompressedStringSegmentWriter::GetStrings(StringSegment &segment, ColumnScanState &state,
+                                                          Vector &intermediate) {
+	vector<string_t> result;
+	for (idx_t vector_index = 0; vector_index * STANDARD_VECTOR_SIZE < segment.tuple_count; vector_index++) {
+		segment.Fetch(state, vector_index, intermediate);
+		auto &nullmask = FlatVector::Nullmask(intermediate);
+		auto strings = FlatVector::GetData<string_t>(intermediate);
+		for (idx_t i = 0; i < segment.GetVectorCount(vector_index); i++) {
+			if (!nullmask[i]) {
+				result.push_back(strings[i]);
+			}
+		}
+	}
+	return result;
+}
+
+CompressionType CompressedStringSegmentWriter::ChooseCompression(DatabaseInstance &db, StringSegment &segment,
+                                                                 SegmentStatistics &stats) {
+	auto forced_compression = DBConfig::GetConfig(db).force_compression;
+	if (forced_compression == CompressionType::COMPRESSION_UNCOMPRESSED) {
+		return CompressionType::COMPRESSION_UNCOMPRESSED;
+	}
+	// big strings are not compressed
+	auto &string_stats = (StringStatistics &)*stats.statistics;
+	if (string_stats.max_string_length >= StringSegment::STRING_BLOCK_LIMIT) {
+		return CompressionType::COMPRESSION_UNCOMPRESSED;
+	}
+	// the strings point into the (pinned) buffers of the segment
+	ColumnScanState state;
+	Vector intermediate(stats.type);
+	auto sample = GetStrings(segment, state, intermediate);
+
+	// compression has to beat the size of the uncompressed segment
+	idx_t vector_count = segment.tuple_count / STANDARD_VECTOR_SIZE +
+	                     (segment.tuple_count % STANDARD_VECTOR_SIZE == 0 ? 0 : 1);
+	idx_t best_size = vector_count * segment.vector_size;
+	for (auto &str : sample) {
+		best_size += sizeof(uint16_t) + str.GetSize();
+	}
+	auto best_compression = CompressionType::COMPRESSION_UNCOMPRESSED;
+	for (auto &function : StringCompressionFunction::GetCompressionFunctions()) {
+		if (forced_compression != CompressionType::COMPRESSION_AUTO && function.type != forced_compression) {
+			continue;
+		}
+		// compress the segment into a scratch block to figure out the compressed size
+		CompressedStringSegmentWriter writer(db, stats.type, function, sample);
+		bool fits = true;
+		for (idx_t vector_index = 0; vector_index * STANDARD_VECTOR_SIZE < segment.tuple_count; vector_index++) {
+			segment.Fetch(state, vector_index, intermediate);
+			if (!writer.Append(intermediate, segment.GetVectorCount(vector_index))) {
+				fits = false;
+				break;
+			}
+		}
+		if (!fits) {
+			continue;
+		}
+		auto compressed_size = writer.GetCompressedSize();
+		if (compressed_size < best_size || function.type == forced_compression) {
+			best_size = compressed_size;
+			best_compression = function.type;
+		}
+	}
+	return best_compression;
+}
+
+} // namespace duckdb
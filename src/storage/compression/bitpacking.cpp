@@ -0,0 +1,286 @@
+#include "duckdb/storage/compression/compression_function.hpp"
+#include "duckdb/storage/compression/bitpacking.hpp"
+#include "duckdb/storage/statistics/numeric_statistics.hpp"
+#include "duckdb/common/exception.hpp"
+
+#include <type_traits>
+
+namespace duckdb {
+
+//! Reads the min/max of the numeric statistics as the physical type T
+template <class T>
+static void GetStatisticsRange(BaseStatistics &stats, T &min, T &max) {
+	auto &nstats = (NumericStatistics &)stats;
+	min = Load<T>((const_data_ptr_t)&nstats.min.value_);
+	max = Load<T>((const_data_ptr_t)&nstats.max.value_);
+}
+
+//===--------------------------------------------------------------------===//
+// Bitpacking
+//===--------------------------------------------------------------------===//
+// A bit-packed vector has the following layout:
+// [uint8_t width][packed values]
+// Bit-packing can only be used for non-negative values, NULL values are stored as 0
+template <class T>
+struct BitpackingCompression {
+	typedef typename std::make_unsigned<T>::type UT;
+
+	static uint8_t GetWidth(T *data, nullmask_t &nullmask, idx_t count, bool &valid) {
+		UT max = 0;
+		bool has_null = nullmask.any();
+		for (idx_t i = 0; i < count; i++) {
+			if (has_null && nullmask[i]) {
+				continue;
+			}
+			if (data[i] < 0) {
+				valid = false;
+				return 0;
+			}
+			if (UT(data[i]) > max) {
+				max = UT(data[i]);
+			}
+		}
+		auto width = BitpackingPrimitives::MinimumBitWidth(max);
+		valid = width <= BitpackingPrimitives::MAXIMUM_WIDTH;
+		return width;
+	}
+
+	static bool Applicable(BaseStatistics &stats) {
+		T min, max;
+		GetStatisticsRange<T>(stats, min, max);
+		if (max < min) {
+			// empty statistics: only NULL values
+			return true;
+		}
+		return min >= 0 && BitpackingPrimitives::MinimumBitWidth(UT(max)) <= BitpackingPrimitives::MAXIMUM_WIDTH;
+	}
+
+	static idx_t Analyze(data_ptr_t source, nullmask_t &nullmask, idx_t count) {
+		bool valid;
+		auto width = GetWidth((T *)source, nullmask, count, valid);
+		if (!valid) {
+			return INVALID_INDEX;
+		}
+		return sizeof(uint8_t) + BitpackingPrimitives::GetRequiredSize(count, width);
+	}
+
+	static idx_t Compress(data_ptr_t source, nullmask_t &nullmask, idx_t count, data_ptr_t target) {
+		auto data = (T *)source;
+		bool valid;
+		auto width = GetWidth(data, nullmask, count, valid);
+		D_ASSERT(valid);
+		Store<uint8_t>(width, target);
+		auto packed = target + sizeof(uint8_t);
+		auto packed_size = BitpackingPrimitives::GetRequiredSize(count, width);
+		memset(packed, 0, packed_size);
+		if (width > 0) {
+			bool has_null = nullmask.any();
+			for (idx_t i = 0; i < count; i++) {
+				if (has_null && nullmask[i]) {
+					continue;
+				}
+				BitpackingPrimitives::PackValue(packed, i, width, UT(data[i]));
+			}
+		}
+		return sizeof(uint8_t) + packed_size;
+	}
+
+	static void Decompress(data_ptr_t source, idx_t count, data_ptr_t target) {
+		auto width = Load<uint8_t>(source);
+		auto packed = source + sizeof(uint8_t);
+		auto result = (T *)target;
+		for (idx_t i = 0; i < count; i++) {
+			result[i] = T(BitpackingPrimitives::UnpackValue(packed, i, width));
+		}
+	}
+
+	static void FetchRow(data_ptr_t source, idx_t count, idx_t row_idx, data_ptr_t target) {
+		auto width = Load<uint8_t>(source);
+		auto packed = source + sizeof(uint8_t);
+		Store<T>(T(BitpackingPrimitives::UnpackValue(packed, row_idx, width)), target);
+	}
+};
+
+//===--------------------------------------------------------------------===//
+// Frame of Reference
+//===--------------------------------------------------------------------===//
+// A frame-of-reference vector has the following layout:
+// [T reference][uint8_t width][packed values]
+// Every value is stored as the (unsigned) difference with the reference, which is the minimum value of the vector
+template <class T>
+struct FORCompression {
+	typedef typename std::make_unsigned<T>::type UT;
+
+	static uint8_t GetFrame(T *data, nullmask_t &nullmask, idx_t count, T &reference, bool &valid) {
+		bool has_value = false;
+		T min = T(), max = T();
+		bool has_null = nullmask.any();
+		for (idx_t i = 0; i < count; i++) {
+			if (has_null && nullmask[i]) {
+				continue;
+			}
+			if (!has_value) {
+				min = max = data[i];
+				has_value = true;
+			} else if (data[i] < min) {
+				min = data[i];
+			} else if (data[i] > max) {
+				max = data[i];
+			}
+		}
+		reference = min;
+		auto width = BitpackingPrimitives::MinimumBitWidth(UT(UT(max) - UT(min)));
+		valid = width <= BitpackingPrimitives::MAXIMUM_WIDTH;
+		return width;
+	}
+
+	static bool Applicable(BaseStatistics &stats) {
+		T min, max;
+		GetStatisticsRange<T>(stats, min, max);
+		if (max < min) {
+			// empty statistics: only NULL values
+			return true;
+		}
+		return BitpackingPrimitives::MinimumBitWidth(UT(UT(max) - UT(min))) <= BitpackingPrimitives::MAXIMUM_WIDTH;
+	}
+
+	static idx_t Analyze(data_ptr_t source, nullmask_t &nullmask, idx_t count) {
+		T reference;
+		bool valid;
+		auto width = GetFrame((T *)source, nullmask, count, reference, valid);
+		if (!valid) {
+			return INVALID_INDEX;
+		}
+		return sizeof(T) + sizeof(uint8_t) + BitpackingPrimitives::GetRequiredSize(count, width);
+	}
+
+	static idx_t Compress(data_ptr_t source, nullmask_t &nullmask, idx_t count, data_ptr_t target) {
+		auto data = (T *)source;
+		T reference;
+		bool valid;
+		auto width = GetFrame(data, nullmask, count, reference, valid);
+		D_ASSERT(valid);
+		Store<T>(reference, target);
+		Store<uint8_t>(width, target + sizeof(T));
+		auto packed = target + sizeof(T) + sizeof(uint8_t);
+		auto packed_size = BitpackingPrimitives::GetRequiredSize(count, width);
+		memset(packed, 0, packed_size);
+		if (width > 0) {
+			bool has_null = nullmask.any();
+			for (idx_t i = 0; i < count; i++) {
+				if (has_null && nullmask[i]) {
+					continue;
+				}
+				BitpackingPrimitives::PackValue(packed, i, width, UT(UT(data[i]) - UT(reference)));
+			}
+		}
+		return sizeof(T) + sizeof(uint8_t) + packed_size;
+	}
+
+	static void Decompress(data_ptr_t source, idx_t count, data_ptr_t target) {
+		auto reference = UT(Load<T>(source));
+		auto width = Load<uint8_t>(source + sizeof(T));
+		auto packed = source + sizeof(T) + sizeof(uint8_t);
+		auto result = (T *)target;
+		for (idx_t i = 0; i < count; i++) {
+			result[i] = T(UT(reference + BitpackingPrimitives::UnpackValue(packed, i, width)));
+		}
+	}
+
+	static void FetchRow(data_ptr_t source, idx_t count, idx_t row_idx, data_ptr_t target) {
+		auto reference = UT(Load<T>(source));
+		auto width = Load<uint8_t>(source + sizeof(T));
+		auto packed = source + sizeof(T) + sizeof(uint8_t);
+		Store<T>(T(UT(reference + BitpackingPrimitives::UnpackValue(packed, row_idx, width))), target);
+	}
+};
+
+template <class T>
+static CompressionFunction GetBitpackingFunction(PhysicalType data_type) {
+	return CompressionFunction(CompressionType::COMPRESSION_BITPACKING, data_type,
+	                           BitpackingCompression<T>::Applicable, BitpackingCompression<T>::Analyze,
+	                           BitpackingCompression<T>::Compress, BitpackingCompression<T>::Decompress,
+	                           BitpackingCompression<T>::FetchRow);
+}
+
+template <class T>
+static CompressionFunction GetFORFunction(PhysicalType data_type) {
+	return CompressionFunction(CompressionType::COMPRESSION_FOR, data_type, FORCompression<T>::Applicable,
+	                           FORCompression<T>::Analyze, FORCompression<T>::Compress, FORCompression<T>::Decompress,
+	                           FORCompression<T>::FetchRow);
+}
+
+static bool BitpackingTypeIsSupported(PhysicalType data_type) {
+	switch (data_type) {
+	case PhysicalType::BOOL:
+	case PhysicalType::INT8:
+	case PhysicalType::INT16:
+	case PhysicalType::INT32:
+	case PhysicalType::INT64:
+	case PhysicalType::UINT8:
+	case PhysicalType::UINT16:
+	case PhysicalType::UINT32:
+	case PhysicalType::UINT64:
+		return true;
+	default:
+		return false;
+	}
+}
+
+CompressionFunction BitpackingFun::GetFunction(PhysicalType data_type) {
+	switch (data_type) {
+	case PhysicalType::BOOL:
+	case PhysicalType::INT8:
+		return GetBitpackingFunction<int8_t>(data_type);
+	case PhysicalType::INT16:
+		return GetBitpackingFunction<int16_t>(data_type);
+	case PhysicalType::INT32:
+		return GetBitpackingFunction<int32_t>(data_type);
+	case PhysicalType::INT64:
+		return GetBitpackingFunction<int64_t>(data_type);
+	case PhysicalType::UINT8:
+		return GetBitpackingFunction<uint8_t>(data_type);
+	case PhysicalType::UINT16:
+		return GetBitpackingFunction<uint16_t>(data_type);
+	case PhysicalType::UINT32:
+		return GetBitpackingFunction<uint32_t>(data_type);
+	case PhysicalType::UINT64:
+		return GetBitpackingFunction<uint64_t>(data_type);
+	default:
+		throw InternalException("Unsupported type for bit-packing");
+	}
+}
+
+bool BitpackingFun::TypeIsSupported(PhysicalType data_type) {
+	return BitpackingTypeIsSupported(data_type);
+}
+
+CompressionFunction FORFun::GetFunction(PhysicalType data_type) {
+	switch (data_type) {
+	case PhysicalType::BOOL:
+	case PhysicalType::INT8:
+		return GetFORFunction<int8_t>(data_type);
+	case PhysicalType::INT16:
+		return GetFORFunction<int16_t>(data_type);
+	case PhysicalType::INT32:
+		return GetFORFunction<int32_t>(data_type);
+	case PhysicalType::INT64:
+		return GetFORFunction<int64_t>(data_type);
+	case PhysicalType::UINT8:
+		return GetFORFunction<uint8_t>(data_type);
+	case PhysicalType::UINT16:
+		return GetFORFunction<uint16_t>(data_type);
+	case PhysicalType::UINT32:
+		return GetFORFunction<uint32_t>(data_type);
+	case PhysicalType::UINT64:
+		return GetFORFunction<uint64_t>(data_type);
+	default:
+		throw InternalException("Unsupported type for frame-of-reference");
+	}
+}
+
+bool FORFun::TypeIsSupported(PhysicalType data_type) {
+	return BitpackingTypeIsSupported(data_type);
+}
+
+} // namespace duckdb
@@ -0,0 +1,301 @@
+#include "duckdb/storage/compression/compression_function.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/helper.hpp"
+
+namespace duckdb {
+
+//===--------------------------------------------------------------------===//
+// Chimp
+//===--------------------------------------------------------------------===//
+// Chimp compresses floating point values by XOR-ing every value with the previous value, and only storing the
+// meaningful bits of the XOR result. A Chimp compressed vector has the following layout:
+// [uint32_t/uint64_t first_value][uint8_t flags[(count + 3) / 4]][bitstream][uint64_t padding]
+// Every value (except the first) has a 2-bit flag that describes how it is stored in the bitstream:
+// 00: the value is identical to the previous value, nothing is stored
+// 01: the XOR has many trailing zeros: [3-bit leading zeros][6-bit significant bit count][significant bits]
+// 10: the XOR has the same (rounded) leading zeros as the previous value: [XOR without the leading zeros]
+// 11: [3-bit leading zeros][XOR without the leading zeros]
+// The flags are stored separately from the bitstream, so that they can be unpacked for the whole vector at once
+// before the values are decoded. NULL values are stored as the previous value so that they only cost the flag.
+
+//! The leading zero counts that can be represented in the 3-bit leading zero field
+static const uint8_t CHIMP_LEADING_REPRESENTATION[] = {0, 8, 12, 16, 18, 20, 22, 24};
+
+//! Returns the index in CHIMP_LEADING_REPRESENTATION of the largest representable value <= leading_zeros
+static inline uint8_t ChimpRoundLeadingZeros(idx_t leading_zeros) {
+	uint8_t code = 0;
+	while (code + 1 < 8 && CHIMP_LEADING_REPRESENTATION[code + 1] <= leading_zeros) {
+		code++;
+	}
+	return code;
+}
+
+template <class U>
+static inline idx_t ChimpCountLeadingZeros(U value) {
+	D_ASSERT(value != 0);
+	idx_t count = 0;
+	U mask = U(1) << (sizeof(U) * 8 - 1);
+	while (!(value & mask)) {
+		count++;
+		mask >>= 1;
+	}
+	return count;
+}
+
+template <class U>
+static inline idx_t ChimpCountTrailingZeros(U value) {
+	D_ASSERT(value != 0);
+	idx_t count = 0;
+	while (!(value & 1)) {
+		count++;
+		value >>= 1;
+	}
+	return count;
+}
+
+//! Writes values of at most 32 bits into the bitstream (least significant bit first)
+struct ChimpBitWriter {
+	explicit ChimpBitWriter(data_ptr_t target) : target(target), buffer(0), bit_count(0), offset(0) {
+	}
+
+	data_ptr_t target;
+	uint64_t buffer;
+	idx_t bit_count;
+	idx_t offset;
+
+	inline void WriteBits(uint64_t value, idx_t width) {
+		D_ASSERT(width <= 32);
+		buffer |= value << bit_count;
+		bit_count += width;
+		if (bit_count >= 32) {
+			Store<uint32_t>(uint32_t(buffer), target + offset);
+			offset += sizeof(uint32_t);
+			buffer >>= 32;
+			bit_count -= 32;
+		}
+	}
+
+	//! Flush the remaining bits, returns the total amount of bytes written
+	idx_t Flush() {
+		while (bit_count > 0) {
+			target[offset++] = uint8_t(buffer);
+			buffer >>= 8;
+			bit_count = bit_count > 8 ? bit_count - 8 : 0;
+		}
+		return offset;
+	}
+};
+
+//! Computes the size of the bitstream without writing anything
+struct ChimpBitCounter {
+	ChimpBitCounter() : bit_count(0) {
+	}
+
+	idx_t bit_count;
+
+	inline void WriteBits(uint64_t value, idx_t width) {
+		bit_count += width;
+	}
+
+	idx_t Flush() {
+		return (bit_count + 7) / 8;
+	}
+};
+
+//! Reads values from the bitstream, the bitstream must be padded with an extra 64-bit word
+struct ChimpBitReader {
+	explicit ChimpBitReader(const_data_ptr_t source) : source(source), position(0) {
+	}
+
+	const_data_ptr_t source;
+	idx_t position;
+
+	inline uint64_t ReadBits(idx_t width) {
+		D_ASSERT(width > 0 && width <= 64);
+		auto ptr = source + position / 8;
+		auto shift = position % 8;
+		position += width;
+		auto word = Load<uint64_t>(ptr) >> shift;
+		if (shift + width > 64) {
+			// the value is spread over nine bytes
+			word |= uint64_t(ptr[8]) << (64 - shift);
+		}
+		return width == 64 ? word : word & ((uint64_t(1) << width) - 1);
+	}
+};
+
+template <class U>
+struct ChimpCompression {
+	//! The amount of bits in a value
+	static constexpr idx_t BIT_WIDTH = sizeof(U) * 8;
+	//! The minimum amount of trailing zeros for which only the significant bits are stored
+	static constexpr idx_t TRAILING_ZERO_THRESHOLD = 6;
+
+	static constexpr uint8_t FLAG_IDENTICAL = 0;
+	static constexpr uint8_t FLAG_TRAILING_ZEROS = 1;
+	static constexpr uint8_t FLAG_SAME_LEADING_ZEROS = 2;
+	static constexpr uint8_t FLAG_NEW_LEADING_ZEROS = 3;
+
+	static idx_t GetFlagSize(idx_t count) {
+		return (count + 3) / 4;
+	}
+
+	template <class WRITER>
+	static inline void WriteValue(WRITER &writer, U value, idx_t width) {
+		if (width > 32) {
+			writer.WriteBits(value & 0xFFFFFFFF, 32);
+			writer.WriteBits(uint64_t(value) >> 32, width - 32);
+		} else {
+			writer.WriteBits(value, width);
+		}
+	}
+
+	//! Encode the values into the flags and the bitstream, returns the size of the bitstream in bytes
+	template <class WRITER>
+	static idx_t Encode(U *data, nullmask_t &nullmask, idx_t count, data_ptr_t flags, WRITER &writer) {
+		bool has_null = nullmask.any();
+		U previous = has_null && nullmask[0] ? 0 : data[0];
+		// the stored (rounded) leading zeros, BIT_WIDTH + 1 means there are no stored leading zeros
+		idx_t stored_leading_zeros = BIT_WIDTH + 1;
+		for (idx_t i = 1; i < count; i++) {
+			U value = has_null && nullmask[i] ? previous : data[i];
+			U xor_result = value ^ previous;
+			previous = value;
+
+			uint8_t flag;
+			if (xor_result == 0) {
+				flag = FLAG_IDENTICAL;
+				stored_leading_zeros = BIT_WIDTH + 1;
+			} else {
+				auto leading_code = ChimpRoundLeadingZeros(ChimpCountLeadingZeros<U>(xor_result));
+				idx_t leading_zeros = CHIMP_LEADING_REPRESENTATION[leading_code];
+				idx_t trailing_zeros = ChimpCountTrailingZeros<U>(xor_result);
+				if (trailing_zeros > TRAILING_ZERO_THRESHOLD) {
+					flag = FLAG_TRAILING_ZEROS;
+					idx_t significant_bits = BIT_WIDTH - leading_zeros - trailing_zeros;
+					writer.WriteBits(leading_code | (significant_bits << 3), 9);
+					WriteValue(writer, xor_result >> trailing_zeros, significant_bits);
+					stored_leading_zeros = BIT_WIDTH + 1;
+				} else if (leading_zeros == stored_leading_zeros) {
+					flag = FLAG_SAME_LEADING_ZEROS;
+					WriteValue(writer, xor_result, BIT_WIDTH - leading_zeros);
+				} else {
+					flag = FLAG_NEW_LEADING_ZEROS;
+					stored_leading_zeros = leading_zeros;
+					writer.WriteBits(leading_code, 3);
+					WriteValue(writer, xor_result, BIT_WIDTH - leading_zeros);
+				}
+			}
+			if (flags) {
+				flags[i / 4] |= flag << ((i % 4) * 2);
+			}
+		}
+		return writer.Flush();
+	}
+
+	//! Decode the first "count" values of a compressed vector holding "total_count" values into the result
+	static void Decode(data_ptr_t source, idx_t total_count, idx_t count, U *result) {
+		D_ASSERT(count <= total_count && count <= STANDARD_VECTOR_SIZE);
+		if (count == 0) {
+			return;
+		}
+		auto flag_data = source + sizeof(U);
+		ChimpBitReader reader(flag_data + GetFlagSize(total_count));
+
+		// unpack the flags of the whole vector in one go
+		uint8_t flags[STANDARD_VECTOR_SIZE];
+		for (idx_t i = 0; i < count; i++) {
+			flags[i] = (flag_data[i / 4] >> ((i % 4) * 2)) & 3;
+		}
+		// now decode the values
+		U previous = Load<U>(source);
+		result[0] = previous;
+		idx_t stored_leading_zeros = 0;
+		for (idx_t i = 1; i < count; i++) {
+			switch (flags[i]) {
+			case FLAG_IDENTICAL:
+				break;
+			case FLAG_TRAILING_ZEROS: {
+				auto header = reader.ReadBits(9);
+				idx_t leading_zeros = CHIMP_LEADING_REPRESENTATION[header & 7];
+				idx_t significant_bits = header >> 3;
+				idx_t trailing_zeros = BIT_WIDTH - leading_zeros - significant_bits;
+				previous ^= U(reader.ReadBits(significant_bits)) << trailing_zeros;
+				break;
+			}
+			case FLAG_SAME_LEADING_ZEROS:
+				previous ^= U(reader.ReadBits(BIT_WIDTH - stored_leading_zeros));
+				break;
+			default:
+				stored_leading_zeros = CHIMP_LEADING_REPRESENTATION[reader.ReadBits(3)];
+				previous ^= U(reader.ReadBits(BIT_WIDTH - stored_leading_zeros));
+				break;
+			}
+			result[i] = previous;
+		}
+	}
+
+	static bool Applicable(BaseStatistics &stats) {
+		return true;
+	}
+
+	static idx_t Analyze(data_ptr_t source, nullmask_t &nullmask, idx_t count) {
+		ChimpBitCounter counter;
+		auto stream_size = Encode<ChimpBitCounter>((U *)source, nullmask, count, nullptr, counter);
+		return sizeof(U) + GetFlagSize(count) + stream_size + sizeof(uint64_t);
+	}
+
+	static idx_t Compress(data_ptr_t source, nullmask_t &nullmask, idx_t count, data_ptr_t target) {
+		auto data = (U *)source;
+		Store<U>(nullmask.any() && nullmask[0] ? 0 : data[0], target);
+		auto flags = target + sizeof(U);
+		auto flag_size = GetFlagSize(count);
+		memset(flags, 0, flag_size);
+		ChimpBitWriter writer(flags + flag_size);
+		auto stream_size = Encode<ChimpBitWriter>(data, nullmask, count, flags, writer);
+		// zero-initialize the padding
+		Store<uint64_t>(0, flags + flag_size + stream_size);
+		return sizeof(U) + flag_size + stream_size + sizeof(uint64_t);
+	}
+
+	static void Decompress(data_ptr_t source, idx_t count, data_ptr_t target) {
+		Decode(source, count, count, (U *)target);
+	}
+
+	static void FetchRow(data_ptr_t source, idx_t count, idx_t row_idx, data_ptr_t target) {
+		D_ASSERT(row_idx < count);
+		U values[STANDARD_VECTOR_SIZE];
+		Decode(source, count, row_idx + 1, values);
+		Store<U>(values[row_idx], target);
+	}
+};
+
+template <class U>
+static CompressionFunction GetChimpFunction(PhysicalType data_type) {
+	return CompressionFunction(CompressionType::COMPRESSION_CHIMP, data_type, ChimpCompression<U>::Applicable,
+	                           ChimpCompression<U>::Analyze, ChimpCompression<U>::Compress,
+	                           ChimpCompression<U>::Decompress, ChimpCompression<U>::FetchRow);
+}
+
+CompressionFunction ChimpFun::GetFunction(PhysicalType data_type) {
+	switch (data_type) {
+	case PhysicalType::FLOAT:
+		return GetChimpFunction<uint32_t>(data_type);
+	case PhysicalType::DOUBLE:
+		return GetChimpFunction<uint64_t>(data_type);
+	default:
+		throw InternalException("Unsupported type for Chimp");
+	}
+}
+
+bool ChimpFun::TypeIsSupported(PhysicalType data_type) {
+	switch (data_type) {
+	case PhysicalType::FLOAT:
+	case PhysicalType::DOUBLE:
+		return true;
+	default:
+		return false;
+	}
+}
+
+} // namespace duckdb
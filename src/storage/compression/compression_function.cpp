@@ -0,0 +1,43 @@
+#include "duckdb/storage/compression/compression_function.hpp"
+#include "duckdb/common/exception.hpp"
+
+namespace duckdb {
+
+vector<CompressionFunction> CompressionFunction::GetCompressionFunctions(PhysicalType data_type) {
+	vector<CompressionFunction> result;
+	if (RLEFun::TypeIsSupported(data_type)) {
+		result.push_back(RLEFun::GetFunction(data_type));
+	}
+	if (BitpackingFun::TypeIsSupported(data_type)) {
+		result.push_back(BitpackingFun::GetFunction(data_type));
+	}
+	if (FORFun::TypeIsSupported(data_type)) {
+		result.push_back(FORFun::GetFunction(data_type));
+	}
+	if (ChimpFun::TypeIsSupported(data_type)) {
+		result.push_back(ChimpFun::GetFunction(data_type));
+	}
+	return result;
+}
+
+CompressionFunction CompressionFunction::GetCompressionFunction(CompressionType type, PhysicalType data_type) {
+	switch (type) {
+	case CompressionType::COMPRESSION_RLE:
+		return RLEFun::GetFunction(data_type);
+	case CompressionType::COMPRESSION_BITPACKING:
+		return BitpackingFun::GetFunction(data_type);
+	case CompressionType::COMPRESSION_FOR:
+		return FORFun::GetFunction(data_type);
+	case CompressionType::COMPRESSION_CHIMP:
+		return ChimpFun::GetFunction(data_type);
+	default:
+		throw InternalException("Unrecognized compression type \"%s\"", CompressionTypeToString(type));
+	}
+}
+
+bool CompressionFunction::TypeIsSupported(PhysicalType data_type) {
+	return RLEFun::TypeIsSupported(data_type) || BitpackingFun::TypeIsSupported(data_type) ||
+	       FORFun::TypeIsSupported(data_type) || ChimpFun::TypeIsSupported(data_type);
+}
+
+} // namespace duckdb
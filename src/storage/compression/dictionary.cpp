@@ -0,0 +1,144 @@
+#include "duckdb/storage/compression/string_compression_function.hpp"
+#include "duckdb/storage/compression/bitpacking.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/common/pair.hpp"
+
+namespace duckdb {
+
+//===--------------------------------------------------------------------===//
+// Dictionary
+//===--------------------------------------------------------------------===//
+// Dictionary encoding stores every unique string of the segment once in the segment header, the header has the
+// following layout: [uint32_t entry_count][uint32_t offsets[entry_count + 1]][string data]
+// every vector stores the dictionary indices of its strings bitpacked: [uint8_t width][indices]
+// null values are stored as index 0 and are never looked up
+struct DictionaryCompressionState : public StringCompressionState {
+	//! Map of string -> index in the dictionary
+	unordered_map<string, uint32_t> dictionary_map;
+	//! The offsets of the dictionary entries in the string data, the final offset is the end of the string data
+	vector<uint32_t> offsets = {0};
+	//! The string data of the dictionary
+	vector<char> string_data;
+
+public:
+	idx_t Compress(string_t *strings, nullmask_t &nullmask, idx_t count, data_ptr_t target,
+	               idx_t remaining_space) override {
+		uint32_t indices[STANDARD_VECTOR_SIZE];
+		idx_t initial_entries = dictionary_map.size();
+		uint32_t max_index = 0;
+		// look up (or add) the strings in the dictionary
+		for (idx_t i = 0; i < count; i++) {
+			if (nullmask[i]) {
+				indices[i] = 0;
+				continue;
+			}
+			auto str = strings[i].GetString();
+			auto entry = dictionary_map.find(str);
+			if (entry == dictionary_map.end()) {
+				auto index = (uint32_t)dictionary_map.size();
+				string_data.insert(string_data.end(), str.begin(), str.end());
+				offsets.push_back(string_data.size());
+				entry = dictionary_map.insert(make_pair(move(str), index)).first;
+			}
+			indices[i] = entry->second;
+			max_index = MaxValue<uint32_t>(max_index, entry->second);
+		}
+		auto width = BitpackingPrimitives::MinimumBitWidth(max_index);
+		auto compressed_size = sizeof(uint8_t) + BitpackingPrimitives::GetRequiredSize(count, width);
+		if (compressed_size + GetHeaderSize() > remaining_space) {
+			// the vector does not fit: remove the entries that were added for this vector from the dictionary
+			for (idx_t i = initial_entries; i + 1 < offsets.size(); i++) {
+				auto start = offsets[i];
+				auto length = offsets[i + 1] - start;
+				dictionary_map.erase(string(string_data.data() + start, length));
+			}
+			offsets.resize(initial_entries + 1);
+			string_data.resize(offsets.back());
+			return INVALID_INDEX;
+		}
+		// write the indices
+		Store<uint8_t>(width, target);
+		auto packed = target + sizeof(uint8_t);
+		memset(packed, 0, compressed_size - sizeof(uint8_t));
+		for (idx_t i = 0; i < count; i++) {
+			BitpackingPrimitives::PackValue(packed, i, width, indices[i]);
+		}
+		return compressed_size;
+	}
+
+	idx_t GetHeaderSize() override {
+		return sizeof(uint32_t) + offsets.size() * sizeof(uint32_t) + string_data.size();
+	}
+
+	void WriteHeader(data_ptr_t target) override {
+		Store<uint32_t>(offsets.size() - 1, target);
+		target += sizeof(uint32_t);
+		memcpy(target, offsets.data(), offsets.size() * sizeof(uint32_t));
+		target += offsets.size() * sizeof(uint32_t);
+		memcpy(target, string_data.data(), string_data.size());
+	}
+};
+
+static unique_ptr<StringCompressionState> DictionaryInit(vector<string_t> &sample) {
+	return make_unique<DictionaryCompressionState>();
+}
+
+static inline string_t DictionaryLookup(data_ptr_t header, uint32_t index) {
+	auto offsets = header + sizeof(uint32_t);
+	auto entry_count = Load<uint32_t>(header);
+	D_ASSERT(index < entry_count);
+	auto string_data = (const char *)(offsets + (entry_count + 1) * sizeof(uint32_t));
+	auto start = Load<uint32_t>(offsets + index * sizeof(uint32_t));
+	auto end = Load<uint32_t>(offsets + (index + 1) * sizeof(uint32_t));
+	// the string points directly into the dictionary
+	return string_t(string_data + start, end - start);
+}
+
+static void DictionaryDecompress(data_ptr_t header, data_ptr_t source, nullmask_t &nullmask, idx_t count,
+                                 Vector &result) {
+	auto result_data = FlatVector::GetData<string_t>(result);
+	auto width = Load<uint8_t>(source);
+	auto packed = source + sizeof(uint8_t);
+	for (idx_t i = 0; i < count; i++) {
+		if (nullmask[i]) {
+			result_data[i] = string_t(nullptr, 0);
+			continue;
+		}
+		result_data[i] = DictionaryLookup(header, BitpackingPrimitives::UnpackValue(packed, i, width));
+	}
+}
+
+static void DictionaryFetchRow(data_ptr_t header, data_ptr_t source, idx_t count, idx_t row_idx, Vector &result,
+                               idx_t result_idx) {
+	auto width = Load<uint8_t>(source);
+	auto index = BitpackingPrimitives::UnpackValue(source + sizeof(uint8_t), row_idx, width);
+	FlatVector::GetData<string_t>(result)[result_idx] = DictionaryLookup(header, index);
+}
+
+static idx_t DictionaryEntryCount(data_ptr_t header) {
+	return Load<uint32_t>(header);
+}
+
+static void DictionaryDecompressDictionary(data_ptr_t header, Vector &result) {
+	auto result_data = FlatVector::GetData<string_t>(result);
+	auto entry_count = Load<uint32_t>(header);
+	for (idx_t i = 0; i < entry_count; i++) {
+		result_data[i] = DictionaryLookup(header, i);
+	}
+}
+
+static void DictionaryDecompressIndices(data_ptr_t source, idx_t count, SelectionVector &result) {
+	auto width = Load<uint8_t>(source);
+	auto packed = source + sizeof(uint8_t);
+	for (idx_t i = 0; i < count; i++) {
+		result.set_index(i, BitpackingPrimitives::UnpackValue(packed, i, width));
+	}
+}
+
+StringCompressionFunction DictionaryFun::GetFunction() {
+	return StringCompressionFunction(CompressionType::COMPRESSION_DICTIONARY, DictionaryInit, DictionaryDecompress,
+	                                 DictionaryFetchRow, DictionaryEntryCount, DictionaryDecompressDictionary,
+	                                 DictionaryDecompressIndices);
+}
+
+} // namespace duckdb
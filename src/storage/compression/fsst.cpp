@@ -0,0 +1,319 @@
+#include "duckdb/storage/compression/string_compression_function.hpp"
+#include "duckdb/storage/string_segment.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/common/algorithm.hpp"
+#include "duckdb/common/pair.hpp"
+
+namespace duckdb {
+
+//===--------------------------------------------------------------------===//
+// FSST
+//===--------------------------------------------------------------------===//
+// FSST (Fast Static Symbol Table) compression replaces frequently occurring substrings of up to 8 bytes with single
+// byte codes. The symbol table is shared by all vectors of the segment and stored in the segment header:
+// [uint8_t symbol_count][uint8_t lengths[symbol_count]][uint64_t symbols[symbol_count]]
+// every vector stores the end offsets of the encoded strings followed by the encoded strings themselves:
+// [uint32_t end_offsets[count]][encoded data]
+// bytes that are not covered by a symbol are stored as an escape code followed by the literal byte
+struct FSSTSymbol {
+	FSSTSymbol() : value(0), length(0) {
+	}
+	FSSTSymbol(const_data_ptr_t data, idx_t length) : value(0), length(length) {
+		D_ASSERT(length > 0 && length <= sizeof(uint64_t));
+		memcpy(&value, data, length);
+	}
+
+	//! The bytes of the symbol (zero-padded)
+	uint64_t value;
+	//! The length of the symbol in bytes
+	idx_t length;
+
+	const_data_ptr_t GetData() const {
+		return (const_data_ptr_t)&value;
+	}
+};
+
+struct FSSTCompressionState : public StringCompressionState {
+	//! The maximum amount of symbols in the symbol table
+	static constexpr idx_t MAX_SYMBOLS = 255;
+	//! The code that indicates that the next byte is stored as-is
+	static constexpr uint8_t ESCAPE_CODE = 255;
+	//! The amount of bytes of the sample that are used to construct the symbol table
+	static constexpr idx_t SAMPLE_SIZE = 16384;
+	//! The amount of refinement rounds used to construct the symbol table
+	static constexpr idx_t GENERATIONS = 5;
+	//! The amount of codes used during construction: the symbols plus a pseudo-code for every escaped byte
+	static constexpr idx_t CONSTRUCTION_CODES = 512;
+
+	//! The symbol table
+	vector<FSSTSymbol> symbols;
+	//! For every byte, the codes of the symbols that start with that byte ordered by decreasing length
+	vector<uint8_t> candidates[256];
+	//! Buffer used to encode the strings of a vector
+	vector<data_t> encode_buffer;
+
+public:
+	void BuildSymbolTable(vector<string_t> &sample);
+
+	idx_t Compress(string_t *strings, nullmask_t &nullmask, idx_t count, data_ptr_t target,
+	               idx_t remaining_space) override;
+
+	idx_t GetHeaderSize() override {
+		return sizeof(uint8_t) + symbols.size() * (sizeof(uint8_t) + sizeof(uint64_t));
+	}
+
+	void WriteHeader(data_ptr_t target) override {
+		Store<uint8_t>(symbols.size(), target);
+		target += sizeof(uint8_t);
+		for (auto &symbol : symbols) {
+			Store<uint8_t>(symbol.length, target);
+			target++;
+		}
+		for (auto &symbol : symbols) {
+			Store<uint64_t>(symbol.value, target);
+			target += sizeof(uint64_t);
+		}
+	}
+
+private:
+	//! Build the per-byte candidate lists from the current symbol table
+	void BuildCandidates();
+	//! Find the longest symbol that matches the start of the string, returns ESCAPE_CODE if there is none
+	inline uint8_t FindLongestSymbol(const_data_ptr_t str, idx_t remaining, idx_t &length) {
+		for (auto code : candidates[str[0]]) {
+			auto &symbol = symbols[code];
+			if (symbol.length <= remaining && memcmp(symbol.GetData(), str, symbol.length) == 0) {
+				length = symbol.length;
+				return code;
+			}
+		}
+		length = 1;
+		return ESCAPE_CODE;
+	}
+	//! Encode a string into the target buffer, returns the amount of bytes written
+	idx_t EncodeString(const_data_ptr_t str, idx_t length, data_ptr_t target);
+};
+
+void FSSTCompressionState::BuildCandidates() {
+	for (idx_t i = 0; i < 256; i++) {
+		candidates[i].clear();
+	}
+	for (idx_t code = 0; code < symbols.size(); code++) {
+		candidates[symbols[code].GetData()[0]].push_back(code);
+	}
+	for (idx_t i = 0; i < 256; i++) {
+		sort(candidates[i].begin(), candidates[i].end(),
+		     [&](uint8_t a, uint8_t b) { return symbols[a].length > symbols[b].length; });
+	}
+}
+
+void FSSTCompressionState::BuildSymbolTable(vector<string_t> &sample) {
+	// take an evenly spread sample of the strings
+	idx_t total_size = 0;
+	for (auto &str : sample) {
+		total_size += str.GetSize();
+	}
+	idx_t step = MaxValue<idx_t>(1, total_size / SAMPLE_SIZE);
+	vector<string_t> sample_strings;
+	for (idx_t i = 0; i < sample.size(); i += step) {
+		if (sample[i].GetSize() > 0) {
+			sample_strings.push_back(sample[i]);
+		}
+	}
+
+	vector<uint32_t> single_counts(CONSTRUCTION_CODES);
+	vector<uint32_t> pair_counts(CONSTRUCTION_CODES * CONSTRUCTION_CODES);
+	for (idx_t generation = 0; generation < GENERATIONS; generation++) {
+		BuildCandidates();
+		// encode the sample with the current symbol table, counting how often every symbol and every pair of
+		// consecutive symbols occurs. escaped bytes are counted with the pseudo-code 256 + byte
+		fill(single_counts.begin(), single_counts.end(), 0);
+		fill(pair_counts.begin(), pair_counts.end(), 0);
+		for (auto &str : sample_strings) {
+			auto data = (const_data_ptr_t)str.GetDataUnsafe();
+			idx_t size = str.GetSize();
+			idx_t previous_code = INVALID_INDEX;
+			for (idx_t pos = 0; pos < size;) {
+				idx_t length;
+				idx_t code = FindLongestSymbol(data + pos, size - pos, length);
+				if (code == ESCAPE_CODE) {
+					code = 256 + data[pos];
+				}
+				single_counts[code]++;
+				if (previous_code != INVALID_INDEX) {
+					pair_counts[previous_code * CONSTRUCTION_CODES + code]++;
+				}
+				previous_code = code;
+				pos += length;
+			}
+		}
+		// compute the gain (i.e. the amount of bytes covered) of every candidate symbol
+		auto get_symbol = [&](idx_t code) {
+			if (code < 256) {
+				return symbols[code];
+			}
+			data_t byte = code - 256;
+			return FSSTSymbol(&byte, 1);
+		};
+		unordered_map<string, idx_t> gains;
+		for (idx_t code = 0; code < CONSTRUCTION_CODES; code++) {
+			if (single_counts[code] == 0) {
+				continue;
+			}
+			auto symbol = get_symbol(code);
+			gains[string((const char *)symbol.GetData(), symbol.length)] += single_counts[code] * symbol.length;
+		}
+		for (idx_t first = 0; first < CONSTRUCTION_CODES; first++) {
+			if (single_counts[first] == 0) {
+				continue;
+			}
+			auto first_symbol = get_symbol(first);
+			for (idx_t second = 0; second < CONSTRUCTION_CODES; second++) {
+				auto count = pair_counts[first * CONSTRUCTION_CODES + second];
+				if (count == 0) {
+					continue;
+				}
+				auto second_symbol = get_symbol(second);
+				idx_t length = MinValue<idx_t>(first_symbol.length + second_symbol.length, sizeof(uint64_t));
+				data_t combined[2 * sizeof(uint64_t)];
+				memcpy(combined, first_symbol.GetData(), first_symbol.length);
+				memcpy(combined + first_symbol.length, second_symbol.GetData(), second_symbol.length);
+				gains[string((const char *)combined, length)] += count * length;
+			}
+		}
+		// the new symbol table consists of the symbols with the highest gain
+		vector<pair<idx_t, string>> ordered_gains;
+		ordered_gains.reserve(gains.size());
+		for (auto &entry : gains) {
+			ordered_gains.push_back(make_pair(entry.second, entry.first));
+		}
+		auto gain_order = [](const pair<idx_t, string> &a, const pair<idx_t, string> &b) {
+			if (a.first != b.first) {
+				return a.first > b.first;
+			}
+			return a.second < b.second;
+		};
+		sort(ordered_gains.begin(), ordered_gains.end(), gain_order);
+		symbols.clear();
+		for (idx_t i = 0; i < ordered_gains.size() && i < MAX_SYMBOLS; i++) {
+			auto &str = ordered_gains[i].second;
+			symbols.push_back(FSSTSymbol((const_data_ptr_t)str.c_str(), str.size()));
+		}
+	}
+	BuildCandidates();
+}
+
+idx_t FSSTCompressionState::EncodeString(const_data_ptr_t str, idx_t length, data_ptr_t target) {
+	auto start = target;
+	for (idx_t pos = 0; pos < length;) {
+		idx_t symbol_length;
+		auto code = FindLongestSymbol(str + pos, length - pos, symbol_length);
+		*target++ = code;
+		if (code == ESCAPE_CODE) {
+			*target++ = str[pos];
+		}
+		pos += symbol_length;
+	}
+	return target - start;
+}
+
+idx_t FSSTCompressionState::Compress(string_t *strings, nullmask_t &nullmask, idx_t count, data_ptr_t target,
+                                     idx_t remaining_space) {
+	// every byte is encoded in at most two bytes
+	idx_t max_size = count * sizeof(uint32_t);
+	for (idx_t i = 0; i < count; i++) {
+		if (!nullmask[i]) {
+			max_size += 2 * strings[i].GetSize();
+		}
+	}
+	encode_buffer.resize(max_size);
+	auto end_offsets = encode_buffer.data();
+	auto encoded_data = end_offsets + count * sizeof(uint32_t);
+	uint32_t offset = 0;
+	for (idx_t i = 0; i < count; i++) {
+		if (!nullmask[i]) {
+			offset += EncodeString((const_data_ptr_t)strings[i].GetDataUnsafe(), strings[i].GetSize(),
+			                       encoded_data + offset);
+		}
+		Store<uint32_t>(offset, end_offsets + i * sizeof(uint32_t));
+	}
+	idx_t compressed_size = count * sizeof(uint32_t) + offset;
+	if (compressed_size + GetHeaderSize() > remaining_space) {
+		return INVALID_INDEX;
+	}
+	memcpy(target, encode_buffer.data(), compressed_size);
+	return compressed_size;
+}
+
+static unique_ptr<StringCompressionState> FSSTInit(vector<string_t> &sample) {
+	auto state = make_unique<FSSTCompressionState>();
+	state->BuildSymbolTable(sample);
+	return move(state);
+}
+
+//! The decoder state: the symbol table loaded from the segment header
+struct FSSTDecoder {
+	explicit FSSTDecoder(data_ptr_t header) {
+		symbol_count = Load<uint8_t>(header);
+		auto lengths = header + sizeof(uint8_t);
+		auto values = lengths + symbol_count;
+		for (idx_t i = 0; i < symbol_count; i++) {
+			symbol_lengths[i] = lengths[i];
+			symbol_values[i] = Load<uint64_t>(values + i * sizeof(uint64_t));
+		}
+	}
+
+	idx_t symbol_count;
+	uint8_t symbol_lengths[FSSTCompressionState::MAX_SYMBOLS];
+	uint64_t symbol_values[FSSTCompressionState::MAX_SYMBOLS];
+	//! Buffer that strings are decoded into. Symbols are written with a single 8-byte store, hence the padding
+	data_t buffer[StringSegment::STRING_BLOCK_LIMIT + sizeof(uint64_t)];
+
+public:
+	string_t Decode(Vector &result, const_data_ptr_t source, idx_t size) {
+		auto end = source + size;
+		auto target = buffer;
+		while (source < end) {
+			auto code = *source++;
+			if (code != FSSTCompressionState::ESCAPE_CODE) {
+				Store<uint64_t>(symbol_values[code], target);
+				target += symbol_lengths[code];
+			} else {
+				*target++ = *source++;
+			}
+			D_ASSERT(target <= buffer + StringSegment::STRING_BLOCK_LIMIT);
+		}
+		return StringVector::AddStringOrBlob(result, string_t((const char *)buffer, target - buffer));
+	}
+};
+
+static void FSSTDecompress(data_ptr_t header, data_ptr_t source, nullmask_t &nullmask, idx_t count, Vector &result) {
+	FSSTDecoder decoder(header);
+	auto result_data = FlatVector::GetData<string_t>(result);
+	auto encoded_data = source + count * sizeof(uint32_t);
+	uint32_t start = 0;
+	for (idx_t i = 0; i < count; i++) {
+		auto end = Load<uint32_t>(source + i * sizeof(uint32_t));
+		if (nullmask[i]) {
+			result_data[i] = string_t(nullptr, 0);
+		} else {
+			result_data[i] = decoder.Decode(result, encoded_data + start, end - start);
+		}
+		start = end;
+	}
+}
+
+static void FSSTFetchRow(data_ptr_t header, data_ptr_t source, idx_t count, idx_t row_idx, Vector &result,
+                         idx_t result_idx) {
+	FSSTDecoder decoder(header);
+	auto encoded_data = source + count * sizeof(uint32_t);
+	uint32_t start = row_idx == 0 ? 0 : Load<uint32_t>(source + (row_idx - 1) * sizeof(uint32_t));
+	uint32_t end = Load<uint32_t>(source + row_idx * sizeof(uint32_t));
+	FlatVector::GetData<string_t>(result)[result_idx] = decoder.Decode(result, encoded_data + start, end - start);
+}
+
+StringCompressionFunction FSSTFun::GetFunction() {
+	return StringCompressionFunction(CompressionType::COMPRESSION_FSST, FSSTInit, FSSTDecompress, FSSTFetchRow);
+}
+
+} // namespace duckdb
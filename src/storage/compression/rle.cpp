@@ -0,0 +1,154 @@
+#include "duckdb/storage/compression/compression_function.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/helper.hpp"
+
+namespace duckdb {
+
+//===--------------------------------------------------------------------===//
+// RLE
+//===--------------------------------------------------------------------===//
+// An RLE compressed vector has the following layout:
+// [uint16_t run_count][T values[run_count]][uint16_t run_lengths[run_count]]
+// NULL values do not break up runs: they are absorbed into the run they are part of
+template <class T>
+struct RLECompression {
+	typedef uint16_t rle_count_t;
+
+	//! Run the function OP for every run in the vector
+	template <class OP>
+	static idx_t ForEachRun(T *data, nullmask_t &nullmask, idx_t count, OP &&op) {
+		idx_t run_count = 0;
+		bool has_value = false;
+		T last_value = T();
+		rle_count_t run_length = 0;
+		bool has_null = nullmask.any();
+		for (idx_t i = 0; i < count; i++) {
+			if (has_null && nullmask[i]) {
+				run_length++;
+				continue;
+			}
+			if (!has_value) {
+				last_value = data[i];
+				has_value = true;
+				run_length++;
+				continue;
+			}
+			if (data[i] == last_value) {
+				run_length++;
+			} else {
+				op(run_count++, last_value, run_length);
+				last_value = data[i];
+				run_length = 1;
+			}
+		}
+		if (run_length > 0) {
+			op(run_count++, last_value, run_length);
+		}
+		return run_count;
+	}
+
+	static bool Applicable(BaseStatistics &stats) {
+		return true;
+	}
+
+	static idx_t Analyze(data_ptr_t source, nullmask_t &nullmask, idx_t count) {
+		auto run_count = ForEachRun((T *)source, nullmask, count, [](idx_t, T, rle_count_t) {});
+		return sizeof(rle_count_t) + run_count * (sizeof(T) + sizeof(rle_count_t));
+	}
+
+	static idx_t Compress(data_ptr_t source, nullmask_t &nullmask, idx_t count, data_ptr_t target) {
+		// first figure out the amount of runs so we know where the run lengths start
+		auto run_count = ForEachRun((T *)source, nullmask, count, [](idx_t, T, rle_count_t) {});
+		Store<rle_count_t>(run_count, target);
+		auto values = target + sizeof(rle_count_t);
+		auto run_lengths = values + run_count * sizeof(T);
+		ForEachRun((T *)source, nullmask, count, [&](idx_t run_idx, T value, rle_count_t run_length) {
+			Store<T>(value, values + run_idx * sizeof(T));
+			Store<rle_count_t>(run_length, run_lengths + run_idx * sizeof(rle_count_t));
+		});
+		return sizeof(rle_count_t) + run_count * (sizeof(T) + sizeof(rle_count_t));
+	}
+
+	static void Decompress(data_ptr_t source, idx_t count, data_ptr_t target) {
+		auto run_count = Load<rle_count_t>(source);
+		auto values = source + sizeof(rle_count_t);
+		auto run_lengths = values + run_count * sizeof(T);
+		auto result = (T *)target;
+		idx_t result_idx = 0;
+		for (idx_t run_idx = 0; run_idx < run_count; run_idx++) {
+			auto value = Load<T>(values + run_idx * sizeof(T));
+			auto run_length = Load<rle_count_t>(run_lengths + run_idx * sizeof(rle_count_t));
+			D_ASSERT(result_idx + run_length <= count);
+			for (idx_t i = 0; i < run_length; i++) {
+				result[result_idx + i] = value;
+			}
+			result_idx += run_length;
+		}
+		D_ASSERT(result_idx == count);
+	}
+
+	static void FetchRow(data_ptr_t source, idx_t count, idx_t row_idx, data_ptr_t target) {
+		auto run_count = Load<rle_count_t>(source);
+		auto values = source + sizeof(rle_count_t);
+		auto run_lengths = values + run_count * sizeof(T);
+		idx_t run_end = 0;
+		for (idx_t run_idx = 0; run_idx < run_count; run_idx++) {
+			run_end += Load<rle_count_t>(run_lengths + run_idx * sizeof(rle_count_t));
+			if (row_idx < run_end) {
+				Store<T>(Load<T>(values + run_idx * sizeof(T)), target);
+				return;
+			}
+		}
+		throw InternalException("RLE FetchRow: row is out of range of the vector");
+	}
+};
+
+template <class T>
+static CompressionFunction GetRLEFunction(PhysicalType data_type) {
+	return CompressionFunction(CompressionType::COMPRESSION_RLE, data_type, RLECompression<T>::Applicable,
+	                           RLECompression<T>::Analyze, RLECompression<T>::Compress, RLECompression<T>::Decompress,
+	                           RLECompression<T>::FetchRow);
+}
+
+CompressionFunction RLEFun::GetFunction(PhysicalType data_type) {
+	switch (data_type) {
+	case PhysicalType::BOOL:
+	case PhysicalType::INT8:
+		return GetRLEFunction<int8_t>(data_type);
+	case PhysicalType::INT16:
+		return GetRLEFunction<int16_t>(data_type);
+	case PhysicalType::INT32:
+		return GetRLEFunction<int32_t>(data_type);
+	case PhysicalType::INT64:
+		return GetRLEFunction<int64_t>(data_type);
+	case PhysicalType::UINT8:
+		return GetRLEFunction<uint8_t>(data_type);
+	case PhysicalType::UINT16:
+		return GetRLEFunction<uint16_t>(data_type);
+	case PhysicalType::UINT32:
+		return GetRLEFunction<uint32_t>(data_type);
+	case PhysicalType::UINT64:
+		return GetRLEFunction<uint64_t>(data_type);
+	default:
+		throw InternalException("Unsupported type for RLE");
+	}
+}
+
+bool RLEFun::TypeIsSupported(PhysicalType data_type) {
+	switch (data_type) {
+	case PhysicalType::BOOL:
+	case PhysicalType::INT8:
+	case PhysicalType::INT16:
+	case PhysicalType::INT32:
+	case PhysicalType::INT64:
+	case PhysicalType::UINT8:
+	case PhysicalType::UINT16:
+	case PhysicalType::UINT32:
+	case PhysicalType::UINT64:
+		return true;
+	default:
+		return false;
+	}
+}
+
+} // namespace duckdb
@@ -0,0 +1,24 @@
+#include "duckdb/storage/compression/string_compression_function.hpp"
+#include "duckdb/common/exception.hpp"
+
+namespace duckdb {
+
+vector<StringCompressionFunction> StringCompressionFunction::GetCompressionFunctions() {
+	vector<StringCompressionFunction> result;
+	result.push_back(DictionaryFun::GetFunction());
+	result.push_back(FSSTFun::GetFunction());
+	return result;
+}
+
+StringCompressionFunction StringCompressionFunction::GetCompressionFunction(CompressionType type) {
+	switch (type) {
+	case CompressionType::COMPRESSION_DICTIONARY:
+		return DictionaryFun::GetFunction();
+	case CompressionType::COMPRESSION_FSST:
+		return FSSTFun::GetFunction();
+	default:
+		throw InternalException("Unrecognized string compression type \"%s\"", CompressionTypeToString(type));
+	}
+}
+
+} // namespace duckdb
@@ -6,9 +6,11 @@
 #include "duckdb/common/vector_operations/vector_operations.hpp"
 #include "duckdb/execution/expression_executor.hpp"
 #include "duckdb/main/client_context.hpp"
+#include "duckdb/main/config.hpp"
 #include "duckdb/planner/constraints/list.hpp"
 #include "duckdb/planner/table_filter.hpp"
 #include "duckdb/storage/storage_manager.hpp"
+#include "duckdb/storage/table/local_append_storage.hpp"
 #include "duckdb/storage/table/morsel_info.hpp"
 #include "duckdb/storage/table/persistent_table_data.hpp"
 #include "duckdb/storage/table/transient_segment.hpp"
@@ -258,6 +260,8 @@ idx_t DataTable::MaxThreads(ClientContext &context) {
 void DataTable::InitializeParallelScan(ParallelTableScanState &state) {
 	state.current_row = 0;
 	state.transaction_local_data = false;
+	state.batch_index = 0;
+	state.read_ahead_rows.clear();
 }
 
 bool DataTable::NextParallelScan(ClientContext &context, ParallelTableScanState &state, TableScanState &scan_state,
@@ -273,6 +277,9 @@ bool DataTable::NextParallelScan(ClientContext &context, ParallelTableScanState
 
 		// scan a morsel from the persistent rows
 		InitializeScanWithOffset(scan_state, column_ids, scan_state.table_filters, state.current_row, next);
+		scan_state.batch_index = state.batch_index++;
+		// the morsels are handed out in order: read ahead the blocks of this morsel and the morsels following it
+		ReadAhead(context, state, column_ids);
 
 		state.current_row = next;
 		return true;
@@ -283,6 +290,7 @@ bool DataTable::NextParallelScan(ClientContext &context, ParallelTableScanState
 		scan_state.base_row = 0;
 		scan_state.max_row = 0;
 		transaction.storage.InitializeScan(this, scan_state.local_state, scan_state.table_filters);
+		scan_state.batch_index = state.batch_index++;
 		state.transaction_local_data = true;
 		return true;
 	} else {
@@ -291,6 +299,24 @@ bool DataTable::NextParallelScan(ClientContext &context, ParallelTableScanState
 	}
 }
 
+void DataTable::ReadAhead(ClientContext &context, ParallelTableScanState &state, const vector<column_t> &column_ids) {
+	auto read_ahead_depth = DBConfig::GetConfig(context).read_ahead_depth;
+	if (read_ahead_depth == 0) {
+		return;
+	}
+	if (state.read_ahead_rows.empty()) {
+		state.read_ahead_rows.resize(column_ids.size(), 0);
+	}
+	for (idx_t i = 0; i < column_ids.size(); i++) {
+		auto column = column_ids[i];
+		if (column == COLUMN_IDENTIFIER_ROW_ID || state.read_ahead_rows[i] >= total_rows) {
+			continue;
+		}
+		auto segment = (ColumnSegment *)columns[column]->data.GetSegment(state.current_row);
+		columns[column]->ReadAhead(segment, read_ahead_depth, state.read_ahead_rows[i]);
+	}
+}
+
 void DataTable::Scan(Transaction &transaction, DataChunk &result, TableScanState &state, vector<column_t> &column_ids) {
 	// scan the persistent segments
 	while (ScanBaseTable(transaction, result, state, column_ids, state.current_row, state.max_row)) {
@@ -304,37 +330,43 @@ void DataTable::Scan(Transaction &transaction, DataChunk &result, TableScanState
 	transaction.storage.Scan(state.local_state, column_ids, result);
 }
 
-bool DataTable::CheckZonemap(TableScanState &state, TableFilterSet *table_filters, idx_t &current_row) {
-	if (!table_filters) {
-		return true;
-	}
-	for (auto &table_filter : table_filters->filters) {
-		for (auto &predicate_constant : table_filter.second) {
-			bool readSegment = true;
-
-			if (!state.column_scans[predicate_constant.column_index].segment_checked) {
-				state.column_scans[predicate_constant.column_index].segment_checked = true;
-				if (!state.column_scans[predicate_constant.column_index].current) {
-					return true;
-				}
-				readSegment =
-				    state.column_scans[predicate_constant.column_index].current->stats.CheckZonemap(predicate_constant);
+bool DataTable::CheckZonemap(TableScanState &state, idx_t &current_row) {
+	// a column can have both static filters and zonemap filters (e.g. a predicate and a runtime join filter on the same
+	// column): the segment of a column is only marked as checked after it has been checked against both filter sets
+	TableFilterSet *filter_sets[] = {state.table_filters, state.zonemap_filters};
+	for (auto table_filters : filter_sets) {
+		if (!table_filters) {
+			continue;
+		}
+		for (auto &table_filter : table_filters->filters) {
+			auto &column_scan = state.column_scans[table_filter.first];
+			if (column_scan.segment_checked || !column_scan.current) {
+				continue;
 			}
-			if (!readSegment) {
-				//! We can skip this partition
-				idx_t vectorsToSkip =
-				    ceil((double)(state.column_scans[predicate_constant.column_index].current->count +
-				                  state.column_scans[predicate_constant.column_index].current->start - current_row) /
-				         STANDARD_VECTOR_SIZE);
-				for (idx_t i = 0; i < vectorsToSkip; ++i) {
-					state.NextVector();
-					current_row += STANDARD_VECTOR_SIZE;
+			// check the segment against all predicates on the column (e.g. both bounds of a range)
+			for (auto &predicate_constant : table_filter.second) {
+				if (!column_scan.current->stats.CheckZonemap(predicate_constant)) {
+					//! We can skip this partition
+					idx_t vectorsToSkip =
+					    ceil((double)(column_scan.current->count + column_scan.current->start - current_row) /
+					         STANDARD_VECTOR_SIZE);
+					for (idx_t i = 0; i < vectorsToSkip; ++i) {
+						state.NextVector();
+						current_row += STANDARD_VECTOR_SIZE;
+					}
+					return false;
 				}
-				return false;
 			}
 		}
 	}
-
+	for (auto table_filters : filter_sets) {
+		if (!table_filters) {
+			continue;
+		}
+		for (auto &table_filter : table_filters->filters) {
+			state.column_scans[table_filter.first].segment_checked = true;
+		}
+	}
 	return true;
 }
 
@@ -347,7 +379,7 @@ bool DataTable::ScanBaseTable(Transaction &transaction, DataChunk &result, Table
 	auto max_count = MinValue<idx_t>(STANDARD_VECTOR_SIZE, max_row - current_row);
 	idx_t vector_offset = (current_row - state.base_row) / STANDARD_VECTOR_SIZE;
 	//! first check the zonemap if we have to scan this partition
-	if (!CheckZonemap(state, state.table_filters, current_row)) {
+	if (!CheckZonemap(state, current_row)) {
 		return true;
 	}
 	// second, scan the version chunk manager to figure out which tuples to load for this transaction
@@ -561,6 +593,96 @@ void DataTable::Append(TableCatalogEntry &table, ClientContext &context, DataChu
 	transaction.storage.Append(this, chunk);
 }
 
+void DataTable::LocalAppend(TableCatalogEntry &table, ClientContext &context, LocalAppendStorage &storage,
+                            DataChunk &chunk) {
+	if (chunk.size() == 0) {
+		return;
+	}
+	if (chunk.ColumnCount() != table.columns.size()) {
+		throw CatalogException("Mismatch in column count for append");
+	}
+	D_ASSERT(info->indexes.empty());
+
+	chunk.Verify();
+
+	// verify any constraints on the new chunk
+	VerifyAppendConstraints(table, chunk);
+
+	// append to the storage of the thread
+	storage.Append(chunk);
+}
+
+//! Returns the rows [offset, offset + count) of the chunk
+static void SliceRows(DataChunk &source, idx_t offset, idx_t count, DataChunk &result) {
+	auto types = source.GetTypes();
+	result.Initialize(types);
+	for (idx_t i = 0; i < source.ColumnCount(); i++) {
+		VectorOperations::Copy(source.data[i], result.data[i], offset + count, offset, 0);
+	}
+	result.SetCardinality(count);
+}
+
+void DataTable::MergeStorage(TableCatalogEntry &table, ClientContext &context, LocalAppendStorage &storage) {
+	D_ASSERT(info->indexes.empty());
+	auto &transaction = Transaction::GetTransaction(context);
+	// the amount of rows of the head that are appended before the segments
+	idx_t head_count = 0;
+	if (storage.segment_count > 0) {
+		D_ASSERT(storage.head.size() == STANDARD_VECTOR_SIZE);
+		// release the locks on the segments: the segments can be scanned as soon as they are part of the table
+		storage.states.reset();
+
+		TableAppendState append_state;
+		append_state.append_lock = std::unique_lock<mutex>(append_lock);
+		if (!is_root) {
+			throw TransactionException("Transaction conflict: adding entries to a table that has been altered!");
+		}
+		idx_t row_start = total_rows;
+		// the segments hold complete vectors: the rows of the head first fill up the last vector of the table, or are
+		// appended as a complete vector if the table ends on a vector boundary. This also makes sure that the last
+		// segment of every column holds rows before the segments are linked after it.
+		head_count = STANDARD_VECTOR_SIZE - total_rows % STANDARD_VECTOR_SIZE;
+		append_state.states = unique_ptr<ColumnAppendState[]>(new ColumnAppendState[types.size()]);
+		for (idx_t i = 0; i < types.size(); i++) {
+			columns[i]->InitializeAppend(append_state.states[i]);
+		}
+		append_state.row_start = total_rows;
+		append_state.current_row = total_rows;
+		AppendVersions(transaction, head_count);
+		if (head_count == STANDARD_VECTOR_SIZE) {
+			Append(transaction, storage.head, append_state);
+		} else {
+			DataChunk head;
+			SliceRows(storage.head, 0, head_count, head);
+			Append(transaction, head, append_state);
+		}
+		append_state.states.reset();
+
+		// now link the segments after the last segment of every column
+		D_ASSERT(total_rows % STANDARD_VECTOR_SIZE == 0);
+		for (idx_t i = 0; i < types.size(); i++) {
+			auto &column = *columns[i];
+			lock_guard<mutex> tree_lock(column.data.node_lock);
+			for (auto &segment : storage.segments[i]) {
+				segment->start += total_rows;
+				segment->data->row_start += total_rows;
+				column.statistics->Merge(*segment->stats.statistics);
+				column.data.AppendSegment(move(segment));
+			}
+		}
+		storage.segments.clear();
+		AppendVersions(transaction, storage.segment_count);
+		transaction.PushAppend(this, row_start, total_rows - row_start);
+	}
+	// the remaining rows of the head and the rows that do not fill up a vector go to the transaction-local storage
+	if (head_count < storage.head.size()) {
+		DataChunk head;
+		SliceRows(storage.head, head_count, storage.head.size() - head_count, head);
+		Append(table, context, head);
+	}
+	Append(table, context, storage.tail);
+}
+
 void DataTable::InitializeAppend(Transaction &transaction, TableAppendState &state, idx_t append_count) {
 	// obtain the append lock for this table
 	state.append_lock = std::unique_lock<mutex>(append_lock);
@@ -580,11 +702,15 @@ void DataTable::InitializeAppend(Transaction &transaction, TableAppendState &sta
 	state.row_start = total_rows;
 	state.current_row = state.row_start;
 
+	AppendVersions(transaction, append_count);
+}
+
+void DataTable::AppendVersions(Transaction &transaction, idx_t append_count) {
 	// start writing to the morsels
 	lock_guard<mutex> morsel_lock(versions->node_lock);
 	auto last_morsel = (MorselInfo *)versions->GetLastSegment();
-	D_ASSERT(last_morsel->start <= (idx_t)state.row_start);
-	idx_t current_position = state.row_start - last_morsel->start;
+	D_ASSERT(last_morsel->start <= total_rows);
+	idx_t current_position = total_rows - last_morsel->start;
 	idx_t remaining = append_count;
 	while (true) {
 		idx_t remaining_in_morsel = MorselInfo::MORSEL_SIZE - current_position;
@@ -1055,11 +1181,9 @@ unique_ptr<BaseStatistics> DataTable::GetStatistics(ClientContext &context, colu
 //===--------------------------------------------------------------------===//
 // Checkpoint
 //===--------------------------------------------------------------------===//
-void DataTable::Checkpoint(TableDataWriter &writer) {
-	// checkpoint each individual column
-	for (size_t i = 0; i < columns.size(); i++) {
-		writer.CheckpointColumn(*columns[i], i);
-	}
+void DataTable::Checkpoint(TableDataWriter &writer, idx_t column_index) {
+	D_ASSERT(column_index < columns.size());
+	writer.CheckpointColumn(*columns[column_index], column_index);
 }
 
 void DataTable::CheckpointDeletes(TableDataWriter &writer) {
@@ -22,7 +22,7 @@ unique_ptr<BaseStatistics> StringStatistics::Copy() {
 	memcpy(stats->max, max, MAX_STRING_MINMAX_SIZE);
 	stats->has_unicode = has_unicode;
 	stats->max_string_length = max_string_length;
-	stats->max_string_length = max_string_length;
+	stats->has_overflow_strings = has_overflow_strings;
 	stats->has_null = has_null;
 	return move(stats);
 }
@@ -14,6 +14,7 @@ namespace duckdb {
 StringSegment::StringSegment(DatabaseInstance &db, idx_t row_start, block_id_t block_id)
     : UncompressedSegment(db, PhysicalType::VARCHAR, row_start) {
 	this->max_vector_count = 0;
+	this->segment_size = Storage::BLOCK_SIZE;
 	// the vector_size is given in the size of the dictionary offsets
 	this->vector_size = STANDARD_VECTOR_SIZE * sizeof(int32_t) + sizeof(nullmask_t);
 	this->string_updates = nullptr;
@@ -32,11 +33,11 @@ StringSegment::StringSegment(DatabaseInstance &db, idx_t row_start, block_id_t b
 }
 
 void StringSegment::SetDictionaryOffset(BufferHandle &handle, idx_t offset) {
-	Store<idx_t>(offset, handle.node->buffer + Storage::BLOCK_SIZE - sizeof(idx_t));
+	Store<idx_t>(offset, handle.node->buffer + segment_size - sizeof(idx_t));
 }
 
 idx_t StringSegment::GetDictionaryOffset(BufferHandle &handle) {
-	return Load<idx_t>(handle.node->buffer + Storage::BLOCK_SIZE - sizeof(idx_t));
+	return Load<idx_t>(handle.node->buffer + segment_size - sizeof(idx_t));
 }
 
 StringSegment::~StringSegment() {
@@ -307,7 +308,7 @@ string_location_t StringSegment::FetchStringLocation(data_ptr_t baseptr, int32_t
 		return string_location_t(INVALID_BLOCK, 0);
 	}
 	// look up result in dictionary
-	auto dict_end = baseptr + Storage::BLOCK_SIZE;
+	auto dict_end = baseptr + segment_size;
 	auto dict_pos = dict_end - dict_offset;
 	auto string_length = Load<uint16_t>(dict_pos);
 	string_location_t result;
@@ -322,7 +323,7 @@ string_location_t StringSegment::FetchStringLocation(data_ptr_t baseptr, int32_t
 
 string_t StringSegment::FetchStringFromDict(Vector &result, data_ptr_t baseptr, int32_t dict_offset) {
 	// fetch base data
-	D_ASSERT(dict_offset <= Storage::BLOCK_SIZE);
+	D_ASSERT(idx_t(dict_offset) <= segment_size);
 	string_location_t location = FetchStringLocation(baseptr, dict_offset);
 	return FetchString(result, baseptr, location);
 }
@@ -336,7 +337,7 @@ string_t StringSegment::FetchString(Vector &result, data_ptr_t baseptr, string_l
 			return string_t(nullptr, 0);
 		}
 		// normal string: read string from this block
-		auto dict_end = baseptr + Storage::BLOCK_SIZE;
+		auto dict_end = baseptr + segment_size;
 		auto dict_pos = dict_end - location.offset;
 		auto string_length = Load<uint16_t>(dict_pos);
 
@@ -446,7 +447,7 @@ idx_t StringSegment::Append(SegmentStatistics &stats, Vector &data, idx_t offset
 
 		// now perform the actual append
 		AppendData(*handle, stats, handle->node->buffer + vector_size * vector_index,
-		           handle->node->buffer + Storage::BLOCK_SIZE, current_tuple_count, data, offset, append_count);
+		           handle->node->buffer + segment_size, current_tuple_count, data, offset, append_count);
 
 		count -= append_count;
 		offset += append_count;
@@ -457,8 +458,8 @@ idx_t StringSegment::Append(SegmentStatistics &stats, Vector &data, idx_t offset
 
 idx_t StringSegment::RemainingSpace(BufferHandle &handle) {
 	idx_t used_space = GetDictionaryOffset(handle) + max_vector_count * vector_size;
-	D_ASSERT(Storage::BLOCK_SIZE >= used_space);
-	return Storage::BLOCK_SIZE - used_space;
+	D_ASSERT(segment_size >= used_space);
+	return segment_size - used_space;
 }
 
 static inline void update_string_stats(SegmentStatistics &stats, const string_t &new_value) {
@@ -486,7 +487,7 @@ void StringSegment::AppendData(BufferHandle &handle, SegmentStatistics &stats, d
 			stats.statistics->has_null = true;
 		} else {
 			auto dictionary_offset = GetDictionaryOffset(handle);
-			D_ASSERT(dictionary_offset < Storage::BLOCK_SIZE);
+			D_ASSERT(dictionary_offset < segment_size);
 			// non-null value, check if we can fit it within the block
 			idx_t string_length = sdata[source_idx].GetSize();
 			idx_t total_length = string_length + sizeof(uint16_t);
@@ -506,6 +507,7 @@ void StringSegment::AppendData(BufferHandle &handle, SegmentStatistics &stats, d
 				int32_t offset;
 				// write the string into the current string block
 				WriteString(sdata[source_idx], block, offset);
+				((StringStatistics &)*stats.statistics).has_overflow_strings = true;
 				dictionary_offset += BIG_STRING_MARKER_SIZE;
 				auto dict_pos = end - dictionary_offset;
 
@@ -520,9 +522,9 @@ void StringSegment::AppendData(BufferHandle &handle, SegmentStatistics &stats, d
 				// now write the actual string data into the dictionary
 				memcpy(dict_pos + sizeof(uint16_t), sdata[source_idx].GetDataUnsafe(), string_length);
 			}
-			D_ASSERT(RemainingSpace(handle) <= Storage::BLOCK_SIZE);
+			D_ASSERT(RemainingSpace(handle) <= segment_size);
 			// place the dictionary offset into the set of vectors
-			D_ASSERT(dictionary_offset <= Storage::BLOCK_SIZE);
+			D_ASSERT(dictionary_offset <= segment_size);
 			result_data[target_idx] = dictionary_offset;
 			SetDictionaryOffset(handle, dictionary_offset);
 		}
@@ -736,13 +738,13 @@ void StringSegment::MergeUpdateInfo(UpdateInfo *node, row_t *ids, idx_t update_c
 	// now we perform a merge of the new ids with the old ids
 	auto merge = [&](idx_t id, idx_t aidx, idx_t bidx, idx_t count) {
 		// new_id and old_id are the same, insert the old data in the UpdateInfo
-		D_ASSERT(old_data[bidx].IsValid());
+		D_ASSERT(old_data[bidx].IsValid(segment_size));
 		info_data[count] = old_data[bidx];
 		node->tuples[count] = id;
 	};
 	auto pick_new = [&](idx_t id, idx_t aidx, idx_t count) {
 		// new_id comes before the old id, insert the base table data into the update info
-		D_ASSERT(base_data[aidx].IsValid());
+		D_ASSERT(base_data[aidx].IsValid(segment_size));
 		info_data[count] = base_data[aidx];
 		node->nullmask[id] = base_nullmask[aidx];
 
@@ -750,7 +752,7 @@ void StringSegment::MergeUpdateInfo(UpdateInfo *node, row_t *ids, idx_t update_c
 	};
 	auto pick_old = [&](idx_t id, idx_t bidx, idx_t count) {
 		// old_id comes before new_id, insert the old data
-		D_ASSERT(old_data[bidx].IsValid());
+		D_ASSERT(old_data[bidx].IsValid(segment_size));
 		info_data[count] = old_data[bidx];
 		node->tuples[count] = id;
 	};
@@ -0,0 +1,70 @@
+#include "duckdb/storage/table/local_append_storage.hpp"
+
+#include "duckdb/common/vector_operations/vector_operations.hpp"
+#include "duckdb/storage/data_table.hpp"
+#include "duckdb/storage/table/transient_segment.hpp"
+
+namespace duckdb {
+
+LocalAppendStorage::LocalAppendStorage(DataTable &table)
+    : table(table), segments(table.types.size()),
+      states(unique_ptr<ColumnAppendState[]>(new ColumnAppendState[table.types.size()])), segment_count(0) {
+	head.Initialize(table.types);
+	tail.Initialize(table.types);
+}
+
+LocalAppendStorage::~LocalAppendStorage() {
+}
+
+idx_t LocalAppendStorage::CopyRows(DataChunk &source, idx_t offset, DataChunk &target) {
+	idx_t copy_count = MinValue<idx_t>(source.size() - offset, STANDARD_VECTOR_SIZE - target.size());
+	for (idx_t i = 0; i < source.ColumnCount(); i++) {
+		VectorOperations::Copy(source.data[i], target.data[i], offset + copy_count, offset, target.size());
+	}
+	target.SetCardinality(target.size() + copy_count);
+	return copy_count;
+}
+
+void LocalAppendStorage::Append(DataChunk &chunk) {
+	D_ASSERT(chunk.ColumnCount() == table.types.size());
+	idx_t offset = 0;
+	if (head.size() < STANDARD_VECTOR_SIZE) {
+		offset += CopyRows(chunk, offset, head);
+	}
+	while (offset < chunk.size()) {
+		offset += CopyRows(chunk, offset, tail);
+		if (tail.size() == STANDARD_VECTOR_SIZE) {
+			AppendToSegments(tail);
+			tail.Reset();
+		}
+	}
+}
+
+void LocalAppendStorage::AppendToSegments(DataChunk &chunk) {
+	D_ASSERT(chunk.size() == STANDARD_VECTOR_SIZE);
+	for (idx_t i = 0; i < chunk.ColumnCount(); i++) {
+		auto &column_segments = segments[i];
+		if (column_segments.empty()) {
+			column_segments.push_back(make_unique<TransientSegment>(table.db, table.types[i], 0));
+			column_segments.back()->InitializeAppend(states[i]);
+		}
+		idx_t offset = 0;
+		idx_t count = chunk.size();
+		while (true) {
+			auto &segment = *column_segments.back();
+			idx_t copied_elements = segment.Append(states[i], chunk.data[i], offset, count);
+			if (copied_elements == count) {
+				break;
+			}
+			// the segment is full: continue in a new segment
+			idx_t next_start = segment.start + segment.count;
+			column_segments.push_back(make_unique<TransientSegment>(table.db, table.types[i], next_start));
+			column_segments.back()->InitializeAppend(states[i]);
+			offset += copied_elements;
+			count -= copied_elements;
+		}
+	}
+	segment_count += chunk.size();
+}
+
+} // namespace duckdb
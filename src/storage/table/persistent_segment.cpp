@@ -8,16 +8,24 @@
 #include "duckdb/storage/storage_manager.hpp"
 
 #include "duckdb/storage/numeric_segment.hpp"
+#include "duckdb/storage/compressed_segment.hpp"
+#include "duckdb/storage/compressed_string_segment.hpp"
 #include "duckdb/storage/string_segment.hpp"
 
 namespace duckdb {
 
 PersistentSegment::PersistentSegment(DatabaseInstance &db, block_id_t id, idx_t offset, LogicalType type, idx_t start,
-                                     idx_t count, unique_ptr<BaseStatistics> statistics)
+                                     idx_t count, CompressionType compression, unique_ptr<BaseStatistics> statistics)
     : ColumnSegment(type, ColumnSegmentType::PERSISTENT, start, count, move(statistics)), db(db), block_id(id),
-      offset(offset) {
+      offset(offset), compression(compression) {
 	D_ASSERT(offset == 0);
-	if (type.InternalType() == PhysicalType::VARCHAR) {
+	if (compression != CompressionType::COMPRESSION_UNCOMPRESSED) {
+		if (type.InternalType() == PhysicalType::VARCHAR) {
+			data = make_unique<CompressedStringSegment>(db, start, id, compression, count);
+		} else {
+			data = make_unique<CompressedSegment>(db, type.InternalType(), start, id, compression, count);
+		}
+	} else if (type.InternalType() == PhysicalType::VARCHAR) {
 		data = make_unique<StringSegment>(db, start, id);
 		data->max_vector_count = count / STANDARD_VECTOR_SIZE + (count % STANDARD_VECTOR_SIZE == 0 ? 0 : 1);
 	} else {
@@ -26,6 +34,16 @@ PersistentSegment::PersistentSegment(DatabaseInstance &db, block_id_t id, idx_t
 	data->tuple_count = count;
 }
 
+void PersistentSegment::ReadAhead() {
+	auto read_lock = data->lock.GetSharedLock();
+	if (data->block->BlockId() >= MAXIMUM_BLOCK) {
+		// the segment was updated and converted to an in-memory block: there is nothing to load from disk
+		return;
+	}
+	auto &buffer_manager = BufferManager::GetBufferManager(db);
+	buffer_manager.ReadAhead(data->block);
+}
+
 void PersistentSegment::InitializeScan(ColumnScanState &state) {
 	data->InitializeScan(state);
 }
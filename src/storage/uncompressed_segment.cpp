@@ -349,11 +349,14 @@ void UncompressedSegment::Scan(Transaction &transaction, ColumnScanState &state,
 	if (get_lock) {
 		read_lock = lock.GetSharedLock();
 	}
-	// first fetch the data from the base table
-	FetchBaseData(state, vector_index, result);
 	if (versions && versions[vector_index]) {
+		// first fetch the data from the base table
+		FetchBaseData(state, vector_index, result);
 		// if there are any versions, check if we need to overwrite the data with the versioned data
 		FetchUpdateData(state, transaction.start_time, transaction.transaction_id, versions[vector_index], result);
+	} else {
+		// no versions: the base data can be scanned in any vector format
+		ScanBaseData(state, vector_index, result);
 	}
 }
 
@@ -398,6 +401,21 @@ void UncompressedSegment::IndexScan(ColumnScanState &state, idx_t vector_index,
 //===--------------------------------------------------------------------===//
 // Update
 //===--------------------------------------------------------------------===//
+void UncompressedSegment::RevertAppend(idx_t start_row) {
+	D_ASSERT(start_row >= row_start && start_row <= row_start + tuple_count);
+	idx_t revert_start = start_row - row_start;
+	if (revert_start < tuple_count) {
+		// appends only set the null bits of the rows they append: clear the bits of the reverted rows
+		auto &buffer_manager = BufferManager::GetBufferManager(db);
+		auto handle = buffer_manager.Pin(block);
+		for (idx_t i = revert_start; i < tuple_count; i++) {
+			auto &nullmask = *((nullmask_t *)(handle->node->buffer + (i / STANDARD_VECTOR_SIZE) * vector_size));
+			nullmask[i % STANDARD_VECTOR_SIZE] = false;
+		}
+	}
+	tuple_count = revert_start;
+}
+
 void UncompressedSegment::CleanupUpdate(UpdateInfo *info) {
 	if (info->prev) {
 		// there is a prev info: remove from the chain
@@ -23,3 +23,62 @@ TEST_CASE("Test query profiler", "[api]") {
 	output = con.GetProfilingInformation(ProfilerPrintFormat::JSON);
 	REQUIRE(output.size() > 0);
 }
+
+//! Returns the value of a numeric field of the first operator with the given name in the JSON profiler output
+static idx_t GetOperatorField(const string &json, const string &name, const string &field) {
+	auto name_pos = json.find("\"name\": \"" + name + "\"");
+	REQUIRE(name_pos != string::npos);
+	auto field_pos = json.find("\"" + field + "\":", name_pos);
+	REQUIRE(field_pos != string::npos);
+	return std::stoull(json.substr(field_pos + field.size() + 3));
+}
+
+TEST_CASE("Test runtime join filters on a scan column with a static filter", "[api]") {
+	unique_ptr<QueryResult> result;
+	DuckDB db(nullptr);
+	Connection con(db);
+
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE fact AS SELECT i FROM range(0, 1000000) tbl(i)"));
+	REQUIRE_NO_FAIL(con.Query("CREATE TABLE dim AS SELECT i + 500000 AS k FROM range(0, 10) tbl(i)"));
+
+	con.EnableProfiling();
+	result = con.Query("SELECT COUNT(*) FROM fact JOIN dim ON fact.i = dim.k WHERE fact.i >= 100");
+	REQUIRE(CHECK_COLUMN(result, 0, {10}));
+
+	// the min/max filter of the join still skips the segments outside of the key range
+	auto output = con.GetProfilingInformation(ProfilerPrintFormat::JSON);
+	REQUIRE(GetOperatorField(output, "SEQ_SCAN", "cardinality") < 100000);
+}
+
+TEST_CASE("Test the spilled bytes of the query profiler", "[api]") {
+	unique_ptr<QueryResult> result;
+	auto db_path = TestCreatePath("profiler_spilled_bytes.db");
+	DeleteDatabase(db_path);
+	{
+		DuckDB db(db_path);
+		Connection con(db);
+
+		REQUIRE_NO_FAIL(con.Query("PRAGMA threads=2"));
+		REQUIRE_NO_FAIL(
+		    con.Query("CREATE TABLE integers AS SELECT (i * 7919) % 2000003 AS g, i AS v FROM range(0, 4000000) t(i)"));
+		string query = "SELECT COUNT(*), SUM(s) FROM (SELECT g, SUM(v) AS s FROM integers GROUP BY g) sq";
+
+		// the partitions of the aggregate are evicted to the temporary directory
+		REQUIRE_NO_FAIL(con.Query("PRAGMA memory_limit='48MB'"));
+		con.EnableProfiling();
+		result = con.Query(query);
+		REQUIRE(CHECK_COLUMN(result, 0, {2000003}));
+		auto output = con.GetProfilingInformation(ProfilerPrintFormat::JSON);
+		REQUIRE(GetOperatorField(output, "HASH_GROUP_BY", "spilled_bytes") > 0);
+
+		// nothing is spilled if the aggregate fits in memory
+		con.DisableProfiling();
+		REQUIRE_NO_FAIL(con.Query("PRAGMA memory_limit='1GB'"));
+		con.EnableProfiling();
+		result = con.Query(query);
+		REQUIRE(CHECK_COLUMN(result, 0, {2000003}));
+		output = con.GetProfilingInformation(ProfilerPrintFormat::JSON);
+		REQUIRE(GetOperatorField(output, "HASH_GROUP_BY", "spilled_bytes") == 0);
+	}
+	DeleteDatabase(db_path);
+}